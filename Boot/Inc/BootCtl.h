@@ -0,0 +1,26 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_BOOTCTL_H
+#define INC_7_SEG_BOOTCTL_H
+
+/**
+ * Журнал загрузчика: два сектора (BOOT_CTL_SECTOR, BOOT_CTL_ALT_SECTOR) по очереди.
+ * Записи только дописываются; действующая - верная (CRC32) с наибольшим номером seq.
+ * Когда половина заполнена (512 записей), следующая запись пишется в другую, и только
+ * после этого заполненная стирается: пропадание питания при стирании журнал не теряет.
+ * Используется загрузчиком и приложением (подтверждение образа, запрос обновления).
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "BootLayout.h"
+
+/** Прототипы функций **/
+void              BootCtl_Load           (BootCtl_Record_t *record);
+HAL_StatusTypeDef BootCtl_Write          (const BootCtl_Record_t *record);
+HAL_StatusTypeDef BootCtl_Confirm        (void);
+HAL_StatusTypeDef BootCtl_Request_Update (void);
+
+#endif //INC_7_SEG_BOOTCTL_H
@@ -0,0 +1,78 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_BOOTFLASH_H
+#define INC_7_SEG_BOOTFLASH_H
+
+/**
+ * Минимальный драйвер Flash на регистрах (без HAL): используется загрузчиком,
+ * журналом загрузчика в приложении и записью конфигурации (APP_LL_FLASH).
+ *
+ * Параллелизм (PSIZE) - самый широкий, допустимый для BOOT_FLASH_VRANGE:
+ * 1.8..2.1 В - x8, 2.1..2.7 В - x16, 2.7..3.6 В - x32, с внешним VPP - x64.
+ *
+ * Запись - потоком: Boot_Flash_Stream_Begin() разблокирует контроллер и включает PG,
+ * Boot_Flash_Stream_Write() пишет порции подряд, ожидая между словами только BSY,
+ * Boot_Flash_Stream_End() один раз проверяет флаги ошибок, блокирует Flash и
+ * сравнивает CRC32 записанного (чтение из Flash) с CRC32 исходных данных.
+ * Boot_Flash_Program() - то же одним вызовом.
+ *
+ * Скорость последней записи (только программирование, без проверки) -
+ * Boot_Flash_Get_Stats(), в словах на миллисекунду.
+ *
+ * Хост-порт (BOOT_FLASH_PORT_HOST, тест - test/test_boot.c): стирание сектора и запись
+ * слова выполняет модель Flash теста (Boot_Flash_Host_Erase/Program) - с записью как
+ * битовым И и обрывом питания посреди любой операции; регистры FLASH остаются памятью.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+#include "AppCrc.h"
+
+/** Частные макроопределения */
+#ifndef BOOT_FLASH_VRANGE
+#define BOOT_FLASH_VRANGE      (FLASH_VOLTAGE_RANGE_3)           /// Питание 2.7..3.6 В, без VPP
+#endif
+#define BOOT_FLASH_PSIZE_BYTES (1u << BOOT_FLASH_VRANGE)         /// 1, 2, 4 или 8 байт за операцию
+
+/** Структуры */
+
+/**
+ * @brief Сеанс потоковой записи
+ */
+typedef struct {
+  uint32_t     start;     /// Адрес начала сеанса
+  uint32_t     address;   /// Адрес следующего слова
+  uint32_t     cycles;    /// Тактов ядра на программирование
+  AppCrc_Ctx_t crc;       /// CRC32 исходных данных
+} BootFlash_Stream_t;
+
+/**
+ * @brief Замер последнего завершённого сеанса
+ */
+typedef struct {
+  uint32_t words;         /// Слов записано
+  uint32_t cycles;        /// Тактов ядра (DWT) на программирование (без CRC)
+  uint32_t words_per_ms;  /// Скорость при текущей частоте ядра
+  uint32_t verify_errors; /// Сеансов, не прошедших проверку CRC, с момента запуска
+} BootFlash_Stats_t;
+
+/** Прототипы функций **/
+HAL_StatusTypeDef        Boot_Flash_Erase        (uint32_t sector);
+HAL_StatusTypeDef        Boot_Flash_Program      (uint32_t address, const uint32_t *data, uint32_t words);
+
+void                     Boot_Flash_Stream_Begin (BootFlash_Stream_t *stream, uint32_t address);
+void                     Boot_Flash_Stream_Write (BootFlash_Stream_t *stream, const uint32_t *data, uint32_t words);
+HAL_StatusTypeDef        Boot_Flash_Stream_End   (BootFlash_Stream_t *stream);
+
+const BootFlash_Stats_t *Boot_Flash_Get_Stats    (void);
+
+#ifdef BOOT_FLASH_PORT_HOST
+/// Модель Flash (реализует тест)
+void                     Boot_Flash_Host_Erase   (uint32_t sector);
+void                     Boot_Flash_Host_Program (uint32_t address, uint32_t word);
+#endif
+
+#endif //INC_7_SEG_BOOTFLASH_H
@@ -0,0 +1,87 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_BOOTLAYOUT_H
+#define INC_7_SEG_BOOTLAYOUT_H
+
+/**
+ *  ----------------------------------------------------
+ *  - Карта Flash при сборке с загрузчиком (BOOTLOADER) -
+ *  ----------------------------------------------------
+ *
+ * Sector 0:  16 K @ 0x0800 0000 - загрузчик (7_Seg_Boot.elf)
+ * Sector 1:  16 K @ 0x0800 4000 - журнал загрузчика, половина 0 (записи BootCtl_Record_t, только дозапись)
+ * Sector 2:  16 K @ 0x0800 8000 - конфигурация приложения (AppFlashConfig)
+ * Sector 3:  16 K @ 0x0800 C000 - журнал загрузчика, половина 1
+ * Sector 4:  64 K @ 0x0801 0000 - слот A: исполняемый образ приложения
+ * Sector 5: 128 K @ 0x0802 0000 - слот B: 0x08020000 - принятый новый образ,
+ *                                          0x08030000 - резервная копия предыдущего образа
+ *
+ * Образ компонуется один раз под адрес слота A. "Переключение" слотов выполняет загрузчик:
+ * предыдущий образ копируется в резерв слота B, новый - из слота B в слот A.
+ * При откате резервная копия возвращается в слот A. Каждый шаг фиксируется в журнале,
+ * поэтому после пропадания питания загрузчик продолжает с того же шага.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+
+/** -- Адреса и сектора -- */
+#define BOOT_ADDR            (0x08000000u)
+#define BOOT_CTL_ADDR        (0x08004000u)       /// Журнал, половина 0
+#define BOOT_CTL_SECTOR      (FLASH_SECTOR_1)
+#define BOOT_CTL_ALT_ADDR    (0x0800C000u)       /// Журнал, половина 1
+#define BOOT_CTL_ALT_SECTOR  (FLASH_SECTOR_3)
+#define BOOT_CTL_SIZE        (0x4000u)           /// Размер половины
+
+#define BOOT_CFG_ADDR        (0x08008000u)       /// Новое место конфигурации приложения
+#define BOOT_CFG_SECTOR      (FLASH_SECTOR_2)
+
+#define BOOT_SLOT_A_ADDR     (0x08010000u)
+#define BOOT_SLOT_A_SECTOR   (FLASH_SECTOR_4)
+#define BOOT_SLOT_SIZE       (0x10000u)           /// Максимальный размер образа - 64 КБ
+
+#define BOOT_SLOT_B_ADDR     (0x08020000u)        /// Приём нового образа
+#define BOOT_SLOT_B_SECTOR   (FLASH_SECTOR_5)
+#define BOOT_BACKUP_ADDR     (BOOT_SLOT_B_ADDR + BOOT_SLOT_SIZE)  /// Резерв предыдущего образа
+
+/** -- Политика отката -- */
+#define BOOT_MAX_TRIALS      (3u)   /// Сколько запусков без подтверждения допускается новому образу
+
+/** Перечисления */
+
+/**
+ * @brief Состояние, зафиксированное последней записью журнала
+ */
+typedef enum {
+  BOOT_STATE_CONFIRMED  = 0x00u,  /// Образ в слоте A рабочий - просто запускаем
+  BOOT_STATE_RECEIVING  = 0x01u,  /// Идёт приём образа в слот B (сессия возобновляема)
+  BOOT_STATE_STAGED     = 0x02u,  /// Образ в слоте B принят и проверен по CRC - установить
+  BOOT_STATE_BACKUP     = 0x03u,  /// Резервная копия слота A сделана - копируем B -> A
+  BOOT_STATE_TRIAL      = 0x04u,  /// Новый образ запущен, ждём подтверждения от приложения
+  BOOT_STATE_ROLLBACK   = 0x05u,  /// Новый образ не подтвердился - возвращаем резерв
+  BOOT_STATE_UPDATE_REQ = 0x06u   /// Приложение попросило остаться в загрузчике для обновления
+} BootState_t;
+
+/** Структуры */
+
+/**
+ * @brief Запись журнала загрузчика (8 слов, последнее - CRC32 предыдущих)
+ */
+typedef struct {
+  uint32_t magic;       /// BOOT_CTL_MAGIC
+  uint32_t seq;         /// Номер записи: действующая - с наибольшим номером в обеих половинах
+  uint32_t state;       /// BootState_t
+  uint32_t image_len;   /// Длина образа, к которому относится состояние
+  uint32_t image_crc;   /// CRC32 образа (AppCrc.h)
+  uint32_t trials;      /// Количество запусков неподтверждённого образа
+  uint32_t backup_crc;  /// CRC32 резервной копии (весь слот, BOOT_SLOT_SIZE) - для проверки отката
+  uint32_t crc32;       /// CRC32 слов magic..backup_crc
+} BootCtl_Record_t;
+
+#define BOOT_CTL_MAGIC       (0xB007C7A2u)   /// A2 - запись с номером (журнал в двух секторах)
+#define BOOT_CTL_CRC_WORDS   ((sizeof(BootCtl_Record_t) - sizeof(uint32_t)) / sizeof(uint32_t))
+
+#endif //INC_7_SEG_BOOTLAYOUT_H
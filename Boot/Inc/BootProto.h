@@ -0,0 +1,48 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_BOOTPROTO_H
+#define INC_7_SEG_BOOTPROTO_H
+
+/**
+ *  -----------------------------------------------
+ *  - Протокол обновления по UART (USART1, 115200) -
+ *  -----------------------------------------------
+ *
+ * Кадр (все поля little-endian, длина кратна 4 байтам):
+ *   [0xA5][cmd][len_lo][len_hi] [payload: len байт] [crc32]
+ * crc32 - CRC32 (AppCrc.h) заголовочного слова и payload.
+ * Ответ имеет тот же формат, cmd = команда | 0x80, payload начинается со статуса.
+ *
+ * Приём возобновляемый: после обрыва хост повторяет BEGIN с той же длиной и CRC образа
+ * и получает смещение, с которого продолжать. Хост может отправлять до
+ * BOOT_PROTO_WINDOW кадров DATA, не дожидаясь ответов: пока ядро программирует
+ * Flash, следующие кадры принимаются DMA в кольцевой буфер.
+ *
+ * Реализация хоста: tools/fw_update.py
+ */
+
+#define BOOT_PROTO_SYNC        (0xA5u)
+#define BOOT_PROTO_VERSION     (1u)
+#define BOOT_PROTO_CHUNK       (256u)   /// Максимальный объём данных в одном кадре DATA
+#define BOOT_PROTO_WINDOW      (4u)     /// Кадров DATA "в полёте" без ответа
+#define BOOT_PROTO_MAX_PAYLOAD (BOOT_PROTO_CHUNK + 4u)
+#define BOOT_PROTO_REPLY       (0x80u)
+
+/** Команды */
+#define BOOT_CMD_HELLO         (0x01u)  /// -> []                      <- [status, version, state, slot_size, next_offset]
+#define BOOT_CMD_BEGIN         (0x02u)  /// -> [image_len, image_crc]  <- [status, next_offset]
+#define BOOT_CMD_DATA          (0x03u)  /// -> [offset, data...]       <- [status, next_offset]
+#define BOOT_CMD_END           (0x04u)  /// -> []                      <- [status]  затем установка и запуск
+#define BOOT_CMD_RESET         (0x05u)  /// -> []                      <- [status]  затем сброс
+
+/** Статусы */
+#define BOOT_ST_OK             (0u)
+#define BOOT_ST_ERR_FRAME      (1u)     /// Неверная CRC кадра или длина
+#define BOOT_ST_ERR_STATE      (2u)     /// Команда не к месту (нет сессии, смещение впереди ожидаемого, BEGIN во время установки)
+#define BOOT_ST_ERR_ARGS       (3u)     /// Образ больше слота или длина не кратна 4
+#define BOOT_ST_ERR_FLASH      (4u)     /// Ошибка стирания/программирования
+#define BOOT_ST_ERR_IMAGE      (5u)     /// CRC принятого образа не совпала
+
+#endif //INC_7_SEG_BOOTPROTO_H
@@ -0,0 +1,29 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_BOOTUART_H
+#define INC_7_SEG_BOOTUART_H
+
+/**
+ * USART1 загрузчика: PA9 - TX, PA10 - RX, 115200 8N1, тактирование от HSI 16 МГц.
+ * Приём - DMA2 Stream2 Channel4 в кольцевой буфер (циклический режим),
+ * передача - ожиданием флага TXE (ответы короткие).
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+
+#define BOOT_UART_BAUD      (115200u)
+#define BOOT_UART_RING_SIZE (2048u)    /// Вмещает BOOT_PROTO_WINDOW полных кадров DATA
+
+/** Прототипы функций **/
+void     Boot_Uart_Init      (void);
+void     Boot_Uart_DeInit    (void);
+uint32_t Boot_Uart_Available (void);
+uint8_t  Boot_Uart_Peek      (uint32_t offset);
+void     Boot_Uart_Read      (uint8_t *dst, uint32_t len);
+void     Boot_Uart_Write     (const uint8_t *src, uint32_t len);
+
+#endif //INC_7_SEG_BOOTUART_H
@@ -0,0 +1,580 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ *  ----------------------------------------
+ *  - Загрузчик 7_Seg_Boot (сектор 0, 16 К) -
+ *  ----------------------------------------
+ *
+ * Работает на HSI 16 МГц, без HAL (только регистры и заголовки CMSIS).
+ * Порядок работы:
+ *  1. Клапан закрыт (PB12 = 1), индикатор погашен - до любых других действий.
+ *  2. Доводится до конца шаг обновления/отката, записанный в журнале (BootCtl.h).
+ *  3. Если образ в слоте A рабочий и кнопка K1 не нажата - BOOT_LISTEN_MS ждём HELLO
+ *     по USART1; без HELLO запускаем приложение.
+ *  4. Иначе - режим приёма образа (BootProto.h) до команды END или RESET.
+ */
+
+/** Подключение заголовочных файлов */
+#include <string.h>
+#include "main.h"
+#include "AppCrc.h"
+#include "BootLayout.h"
+#include "BootCtl.h"
+#include "BootFlash.h"
+#include "BootProto.h"
+#include "BootUart.h"
+#include "FaultCapture.h"
+
+/** Частные макроопределения */
+#define BOOT_LISTEN_MS        (300u)    /// Окно ожидания HELLO перед запуском приложения
+#define BOOT_FRAME_TIMEOUT_MS (200u)    /// Недополученный кадр отбрасывается по тайм-ауту
+#define BOOT_RAM_START        (0x20000000u)
+#define BOOT_RAM_END          (0x20010000u)   /// 64 КБ SRAM STM32F401CC
+
+#define BOOT_FRAME_WORDS      ((4u + BOOT_PROTO_MAX_PAYLOAD + 4u) / 4u)
+
+/** Результат обработки кадра */
+typedef enum {
+  BOOT_FRAME_CONTINUE = 0,  /// Остаёмся в режиме приёма
+  BOOT_FRAME_INSTALL  = 1,  /// Образ принят (END) - установить и запустить
+} Boot_Frame_Result_t;
+
+/** Переменные */
+static volatile uint32_t boot_ms = 0;
+
+/** Место дампа отказа приложения (FaultCapture.h): .noinit загрузчика по тому же адресу,
+ *  иначе .bss загрузчика затёр бы дамп до старта приложения */
+__attribute__((section(".noinit"), used))
+static uint8_t boot_noinit_reserve[FAULT_NOINIT_SIZE];
+
+static uint32_t frame[BOOT_FRAME_WORDS];   /// Кадр целиком: заголовок, payload, CRC
+
+static BootCtl_Record_t boot_ctl;          /// Действующая запись журнала
+static uint32_t         boot_next_offset;  /// Сколько байт образа уже записано в слот B
+static uint8_t          boot_session;      /// 1 - BEGIN принят, можно слать DATA
+
+/**
+ * @brief Миллисекундный счётчик (SysTick, 1 кГц от HSI).
+ */
+void SysTick_Handler(void)
+{
+  boot_ms++;
+}
+
+/**
+ * @brief Безопасное состояние выходов: клапан закрыт, разряды индикатора выключены.
+ * @details Выполняется первым. Клапан активен по LOW, поэтому сначала в ODR пишется 1,
+ *          и только потом вывод переводится в режим выхода - без "провала" в 0.
+ */
+static void Boot_Safe_Outputs(void)
+{
+  RCC->AHB1ENR |= RCC_AHB1ENR_GPIOBEN;
+  (void)RCC->AHB1ENR;
+
+  VALVE_GPIO_Port->BSRR = VALVE_Pin;
+  VALVE_GPIO_Port->MODER = (VALVE_GPIO_Port->MODER & ~GPIO_MODER_MODER12) | GPIO_MODER_MODER12_0;
+
+  GPIOB->BSRR  = (uint32_t)(Q1_Pin | Q2_Pin | Q3_Pin) << 16u;
+  GPIOB->MODER = (GPIOB->MODER & ~(GPIO_MODER_MODER0 | GPIO_MODER_MODER1 | GPIO_MODER_MODER2))
+               | GPIO_MODER_MODER0_0 | GPIO_MODER_MODER1_0 | GPIO_MODER_MODER2_0;
+
+  /// K1 - вход с подтяжкой вниз (кнопка активна по HIGH)
+  GPIOB->MODER &= ~GPIO_MODER_MODER10;
+  GPIOB->PUPDR  = (GPIOB->PUPDR & ~GPIO_PUPDR_PUPD10) | GPIO_PUPDR_PUPD10_1;
+}
+
+/**
+ * @brief Кнопка K1 удерживается при сбросе - принудительный вход в режим приёма.
+ */
+static uint8_t Boot_Button_Held(void)
+{
+  const uint32_t start = boot_ms;
+  while (boot_ms - start < 20u)   /// Пауза на установление подтяжки и дребезг
+  {
+  }
+  return (K1_GPIO_Port->IDR & K1_Pin) ? 1u : 0u;
+}
+
+/**
+ * @brief CRC32 области Flash (длина кратна 4).
+ */
+static uint32_t Boot_Crc(const uint32_t address, const uint32_t len)
+{
+  return APP_CRC_Calc((const uint32_t *)address, len / sizeof(uint32_t));
+}
+
+/**
+ * @brief Таблица векторов в слоте A похожа на настоящую: SP в ОЗУ, Reset_Handler в слоте.
+ */
+static uint8_t Boot_App_Looks_Valid(void)
+{
+  const uint32_t sp = *(const volatile uint32_t *)BOOT_SLOT_A_ADDR;
+  const uint32_t pc = *(const volatile uint32_t *)(BOOT_SLOT_A_ADDR + 4u);
+
+  if (sp < BOOT_RAM_START || sp > BOOT_RAM_END)
+  {
+    return 0;
+  }
+  if (pc < BOOT_SLOT_A_ADDR || pc >= BOOT_SLOT_A_ADDR + BOOT_SLOT_SIZE)
+  {
+    return 0;
+  }
+  return 1;
+}
+
+/**
+ * @brief Стирание слота A и копирование в него len байт из src с проверкой CRC.
+ */
+static HAL_StatusTypeDef Boot_Install(const uint32_t src, const uint32_t len, const uint32_t crc)
+{
+  if (Boot_Flash_Erase(BOOT_SLOT_A_SECTOR) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  if (Boot_Flash_Program(BOOT_SLOT_A_ADDR, (const uint32_t *)src, len / sizeof(uint32_t)) != HAL_OK)
+  {
+    return HAL_ERROR;
+  }
+  return (Boot_Crc(BOOT_SLOT_A_ADDR, len) == crc) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+ * @brief Доведение до конца шага, записанного в журнале.
+ * @details Каждый шаг заканчивается новой записью журнала, поэтому после пропадания
+ *          питания в середине копирования шаг просто повторяется целиком.
+ * @retval 1 - слот A можно запускать, 0 - остаться в режиме приёма.
+ */
+static uint8_t Boot_Process_Journal(void)
+{
+  for (;;)
+  {
+    switch (boot_ctl.state)
+    {
+      case BOOT_STATE_STAGED:
+        /// Резервная копия текущего образа (весь слот - длина старого образа неизвестна)
+        if (Boot_App_Looks_Valid())
+        {
+          boot_ctl.backup_crc = Boot_Crc(BOOT_SLOT_A_ADDR, BOOT_SLOT_SIZE);
+          if (Boot_Flash_Program(BOOT_BACKUP_ADDR, (const uint32_t *)BOOT_SLOT_A_ADDR,
+                                 BOOT_SLOT_SIZE / sizeof(uint32_t)) != HAL_OK ||
+              Boot_Crc(BOOT_BACKUP_ADDR, BOOT_SLOT_SIZE) != boot_ctl.backup_crc)
+          {
+            return 0;
+          }
+        }
+        else
+        {
+          boot_ctl.backup_crc = 0u;   /// Откатываться некуда
+        }
+        boot_ctl.state = BOOT_STATE_BACKUP;
+        if (BootCtl_Write(&boot_ctl) != HAL_OK)
+        {
+          return 0;
+        }
+        break;
+
+      case BOOT_STATE_BACKUP:
+        if (Boot_Install(BOOT_SLOT_B_ADDR, boot_ctl.image_len, boot_ctl.image_crc) != HAL_OK)
+        {
+          return 0;
+        }
+        boot_ctl.state  = BOOT_STATE_TRIAL;
+        boot_ctl.trials = 0u;
+        if (BootCtl_Write(&boot_ctl) != HAL_OK)
+        {
+          return 0;
+        }
+        break;
+
+      case BOOT_STATE_TRIAL:
+        if (boot_ctl.trials >= BOOT_MAX_TRIALS)
+        {
+          boot_ctl.state = BOOT_STATE_ROLLBACK;
+          if (BootCtl_Write(&boot_ctl) != HAL_OK)
+          {
+            return 0;
+          }
+          break;
+        }
+        boot_ctl.trials++;
+        if (BootCtl_Write(&boot_ctl) != HAL_OK)
+        {
+          return 0;
+        }
+        return Boot_App_Looks_Valid();
+
+      case BOOT_STATE_ROLLBACK:
+        if (boot_ctl.backup_crc == 0u)
+        {
+          /// Откатываться некуда: ждём новый образ (BEGIN в ROLLBACK не принимается)
+          boot_ctl.state  = BOOT_STATE_UPDATE_REQ;
+          boot_ctl.trials = 0u;
+          (void)BootCtl_Write(&boot_ctl);
+          return 0;
+        }
+        if (Boot_Install(BOOT_BACKUP_ADDR, BOOT_SLOT_SIZE, boot_ctl.backup_crc) != HAL_OK)
+        {
+          return 0;
+        }
+        boot_ctl.state     = BOOT_STATE_CONFIRMED;
+        boot_ctl.image_len = BOOT_SLOT_SIZE;
+        boot_ctl.image_crc = boot_ctl.backup_crc;
+        boot_ctl.trials    = 0u;
+        if (BootCtl_Write(&boot_ctl) != HAL_OK)
+        {
+          return 0;
+        }
+        break;
+
+      case BOOT_STATE_CONFIRMED:
+        if (boot_ctl.image_len != 0u &&
+            Boot_Crc(BOOT_SLOT_A_ADDR, boot_ctl.image_len) != boot_ctl.image_crc)
+        {
+          return 0;
+        }
+        return Boot_App_Looks_Valid();
+
+      case BOOT_STATE_RECEIVING:
+      case BOOT_STATE_UPDATE_REQ:
+      default:
+        return 0;
+    }
+  }
+}
+
+/**
+ * @brief Передача ответа: [SYNC][cmd|0x80][len] payload crc32.
+ */
+static void Boot_Reply(const uint8_t cmd, const uint32_t *payload, const uint32_t words)
+{
+  uint32_t reply[7];   /// Заголовок, до 5 слов payload, CRC
+
+  reply[0] = BOOT_PROTO_SYNC | ((uint32_t)(cmd | BOOT_PROTO_REPLY) << 8u) | ((words * 4u) << 16u);
+  memcpy(&reply[1], payload, words * sizeof(uint32_t));
+  reply[1u + words] = APP_CRC_Calc(reply, 1u + words);
+
+  Boot_Uart_Write((const uint8_t *)reply, (2u + words) * sizeof(uint32_t));
+}
+
+/**
+ * @brief Смещение возобновления: конец последнего записанного (не 0xFF) слова в слоте B.
+ * @details Слова пишутся по порядку, поэтому всё, что до него, уже записано.
+ *          Хвостовые слова 0xFF совпадают со стёртой Flash - их повторная запись безвредна.
+ */
+static uint32_t Boot_Resume_Offset(const uint32_t len)
+{
+  const uint32_t *image = (const uint32_t *)BOOT_SLOT_B_ADDR;
+
+  for (uint32_t word = len / sizeof(uint32_t); word > 0u; word--)
+  {
+    if (image[word - 1u] != 0xFFFFFFFFu)
+    {
+      return word * sizeof(uint32_t);
+    }
+  }
+  return 0u;
+}
+
+/**
+ * @brief Приём одного кадра из кольцевого буфера.
+ * @details Мусор до байта синхронизации пропускается. Кадр, который не пришёл целиком
+ *          за BOOT_FRAME_TIMEOUT_MS или не прошёл CRC, отбрасывается (сдвиг на 1 байт).
+ * @retval Длина payload в байтах, либо -1, если полного верного кадра пока нет.
+ */
+static int32_t Boot_Poll_Frame(void)
+{
+  static uint32_t wait_since = 0;
+  static uint8_t  waiting    = 0;
+
+  while (Boot_Uart_Available() >= 4u)
+  {
+    if (Boot_Uart_Peek(0) != BOOT_PROTO_SYNC)
+    {
+      Boot_Uart_Read(NULL, 1u);
+      continue;
+    }
+
+    const uint32_t len = (uint32_t)Boot_Uart_Peek(2) | ((uint32_t)Boot_Uart_Peek(3) << 8u);
+    if (len > BOOT_PROTO_MAX_PAYLOAD || (len % 4u) != 0u)
+    {
+      Boot_Uart_Read(NULL, 1u);
+      continue;
+    }
+
+    if (Boot_Uart_Available() < len + 8u)
+    {
+      if (!waiting)
+      {
+        waiting    = 1;
+        wait_since = boot_ms;
+      }
+      else if (boot_ms - wait_since > BOOT_FRAME_TIMEOUT_MS)
+      {
+        waiting = 0;
+        Boot_Uart_Read(NULL, 1u);
+        continue;
+      }
+      return -1;
+    }
+    waiting = 0;
+
+    Boot_Uart_Read((uint8_t *)frame, len + 8u);
+    if (APP_CRC_Calc(frame, 1u + len / 4u) == frame[1u + len / 4u])
+    {
+      return (int32_t)len;
+    }
+    /// Кадр повреждён: хост не получит ответа и повторит передачу с последнего подтверждённого смещения
+  }
+  return -1;
+}
+
+/**
+ * @brief BEGIN: новая сессия (стирание слота B) или возобновление прерванной.
+ * @details Только когда установка не идёт (CONFIRMED, RECEIVING, UPDATE_REQ): иначе
+ *          стирание слота B уничтожило бы устанавливаемый образ или резерв для отката.
+ */
+static uint32_t Boot_Cmd_Begin(const uint32_t image_len, const uint32_t image_crc)
+{
+  /// Сектор 5 стирается целиком: в STAGED/BACKUP/TRIAL/ROLLBACK в нём новый образ или резерв
+  if (boot_ctl.state != BOOT_STATE_CONFIRMED && boot_ctl.state != BOOT_STATE_RECEIVING &&
+      boot_ctl.state != BOOT_STATE_UPDATE_REQ)
+  {
+    return BOOT_ST_ERR_STATE;
+  }
+  if (image_len == 0u || image_len > BOOT_SLOT_SIZE || (image_len % 4u) != 0u)
+  {
+    return BOOT_ST_ERR_ARGS;
+  }
+
+  if (boot_ctl.state == BOOT_STATE_RECEIVING &&
+      boot_ctl.image_len == image_len && boot_ctl.image_crc == image_crc)
+  {
+    boot_next_offset = Boot_Resume_Offset(image_len);
+    boot_session     = 1;
+    return BOOT_ST_OK;
+  }
+
+  /// Стирается весь сектор 5: и приём, и старая резервная копия (она больше не нужна)
+  if (Boot_Flash_Erase(BOOT_SLOT_B_SECTOR) != HAL_OK)
+  {
+    return BOOT_ST_ERR_FLASH;
+  }
+  boot_ctl.state      = BOOT_STATE_RECEIVING;
+  boot_ctl.image_len  = image_len;
+  boot_ctl.image_crc  = image_crc;
+  boot_ctl.trials     = 0u;
+  boot_ctl.backup_crc = 0u;
+  if (BootCtl_Write(&boot_ctl) != HAL_OK)
+  {
+    return BOOT_ST_ERR_FLASH;
+  }
+  boot_next_offset = 0u;
+  boot_session     = 1;
+  return BOOT_ST_OK;
+}
+
+/**
+ * @brief DATA: запись фрагмента образа в слот B.
+ * @details Фрагменты, уже записанные (повтор после потерянного ответа), только подтверждаются.
+ */
+static uint32_t Boot_Cmd_Data(const uint32_t offset, const uint32_t *data, const uint32_t len)
+{
+  if (!boot_session)
+  {
+    return BOOT_ST_ERR_STATE;
+  }
+  if ((offset % 4u) != 0u || offset + len > boot_ctl.image_len)
+  {
+    return BOOT_ST_ERR_ARGS;
+  }
+  if (offset > boot_next_offset)
+  {
+    return BOOT_ST_ERR_STATE;   /// Пропущен кадр - хост продолжит с boot_next_offset
+  }
+  if (offset + len <= boot_next_offset)
+  {
+    return BOOT_ST_OK;
+  }
+
+  const uint32_t skip = boot_next_offset - offset;
+  if (Boot_Flash_Program(BOOT_SLOT_B_ADDR + boot_next_offset, data + skip / 4u,
+                         (len - skip) / sizeof(uint32_t)) != HAL_OK)
+  {
+    return BOOT_ST_ERR_FLASH;
+  }
+  boot_next_offset = offset + len;
+  return BOOT_ST_OK;
+}
+
+/**
+ * @brief END: проверка CRC принятого образа и фиксация STAGED в журнале.
+ */
+static uint32_t Boot_Cmd_End(void)
+{
+  if (!boot_session || boot_next_offset != boot_ctl.image_len)
+  {
+    return BOOT_ST_ERR_STATE;
+  }
+  boot_session = 0;
+
+  if (Boot_Crc(BOOT_SLOT_B_ADDR, boot_ctl.image_len) != boot_ctl.image_crc)
+  {
+    /// Сессия испорчена - следующий BEGIN начнёт приём заново, а не возобновит его
+    boot_ctl.image_crc = ~boot_ctl.image_crc;
+    (void)BootCtl_Write(&boot_ctl);
+    return BOOT_ST_ERR_IMAGE;
+  }
+
+  boot_ctl.state  = BOOT_STATE_STAGED;
+  boot_ctl.trials = 0u;
+  return (BootCtl_Write(&boot_ctl) == HAL_OK) ? BOOT_ST_OK : BOOT_ST_ERR_FLASH;
+}
+
+/**
+ * @brief Обработка принятого кадра и отправка ответа.
+ */
+static Boot_Frame_Result_t Boot_Handle_Frame(const uint32_t len)
+{
+  const uint8_t   cmd     = (uint8_t)(frame[0] >> 8u);
+  const uint32_t *payload = &frame[1];
+  uint32_t        reply[5];
+
+  switch (cmd)
+  {
+    case BOOT_CMD_HELLO:
+      reply[0] = BOOT_ST_OK;
+      reply[1] = BOOT_PROTO_VERSION;
+      reply[2] = boot_ctl.state;
+      reply[3] = BOOT_SLOT_SIZE;
+      reply[4] = boot_next_offset;
+      Boot_Reply(cmd, reply, 5u);
+      break;
+
+    case BOOT_CMD_BEGIN:
+      reply[0] = (len == 8u) ? Boot_Cmd_Begin(payload[0], payload[1]) : BOOT_ST_ERR_FRAME;
+      reply[1] = boot_next_offset;
+      Boot_Reply(cmd, reply, 2u);
+      break;
+
+    case BOOT_CMD_DATA:
+      reply[0] = (len > 4u) ? Boot_Cmd_Data(payload[0], &payload[1], len - 4u) : BOOT_ST_ERR_FRAME;
+      reply[1] = boot_next_offset;
+      Boot_Reply(cmd, reply, 2u);
+      break;
+
+    case BOOT_CMD_END:
+      reply[0] = Boot_Cmd_End();
+      Boot_Reply(cmd, reply, 1u);
+      if (reply[0] == BOOT_ST_OK)
+      {
+        return BOOT_FRAME_INSTALL;
+      }
+      break;
+
+    case BOOT_CMD_RESET:
+      reply[0] = BOOT_ST_OK;
+      Boot_Reply(cmd, reply, 1u);
+      NVIC_SystemReset();
+      break;
+
+    default:
+      reply[0] = BOOT_ST_ERR_FRAME;
+      Boot_Reply(cmd, reply, 1u);
+      break;
+  }
+  return BOOT_FRAME_CONTINUE;
+}
+
+/**
+ * @brief Ожидание HELLO перед запуском приложения.
+ * @retval 1 - хост на связи, переходим в режим приёма.
+ */
+static uint8_t Boot_Listen(void)
+{
+  const uint32_t start = boot_ms;
+
+  while (boot_ms - start < BOOT_LISTEN_MS)
+  {
+    const int32_t len = Boot_Poll_Frame();
+    if (len >= 0 && (uint8_t)(frame[0] >> 8u) == BOOT_CMD_HELLO)
+    {
+      (void)Boot_Handle_Frame((uint32_t)len);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Режим приёма образа. Возвращается после успешного END.
+ */
+static void Boot_Update_Loop(void)
+{
+  for (;;)
+  {
+    const int32_t len = Boot_Poll_Frame();
+    if (len >= 0 && Boot_Handle_Frame((uint32_t)len) == BOOT_FRAME_INSTALL)
+    {
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Передача управления приложению в слоте A.
+ * @details Периферия загрузчика возвращается в состояние после сброса (кроме вывода клапана),
+ *          SysTick останавливается, таблица векторов переносится на слот A.
+ */
+static void Boot_Jump(void)
+{
+  const uint32_t sp    = *(const volatile uint32_t *)BOOT_SLOT_A_ADDR;
+  const uint32_t entry = *(const volatile uint32_t *)(BOOT_SLOT_A_ADDR + 4u);
+
+  SysTick->CTRL = 0;
+  SysTick->VAL  = 0;
+  SCB->ICSR     = SCB_ICSR_PENDSTCLR_Msk;
+
+  Boot_Uart_DeInit();
+
+  SCB->VTOR = BOOT_SLOT_A_ADDR;
+  __DSB();
+  __ISB();
+
+  __set_MSP(sp);
+  ((void (*)(void))entry)();
+}
+
+/**
+ * @brief Точка входа загрузчика.
+ */
+int main(void)
+{
+  Boot_Safe_Outputs();
+  SysTick_Config(HSI_VALUE / 1000u);
+  APP_CRC_Init();
+
+  BootCtl_Load(&boot_ctl);
+  Boot_Uart_Init();
+
+  uint8_t run = Boot_Process_Journal();
+
+  if (run && (Boot_Button_Held() || Boot_Listen()))
+  {
+    run = 0;
+  }
+
+  if (!run)
+  {
+    Boot_Update_Loop();
+    run = Boot_Process_Journal();
+  }
+
+  if (run)
+  {
+    Boot_Jump();
+  }
+  NVIC_SystemReset();
+  return 0;
+}
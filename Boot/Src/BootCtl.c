@@ -0,0 +1,188 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include "BootCtl.h"
+#include "BootFlash.h"
+#include "AppCrc.h"
+
+/**
+ * Половины журнала. Записи дописываются в одну; когда она заполнена, новая запись
+ * пишется в начало другой (стёртой) и только потом старая стирается - в любой момент
+ * действующая запись есть хотя бы в одной половине.
+ */
+static const struct {
+  uint32_t addr;
+  uint32_t sector;
+} ctl_half[2] = {
+  { BOOT_CTL_ADDR,     BOOT_CTL_SECTOR     },
+  { BOOT_CTL_ALT_ADDR, BOOT_CTL_ALT_SECTOR },
+};
+
+/** Половина с действующей записью и адрес, куда будет дописана следующая (определяются при BootCtl_Load) */
+static uint8_t  ctl_half_cur  = 0;
+static uint32_t ctl_next_addr = BOOT_CTL_ADDR;
+
+/** Копия действующей записи */
+static BootCtl_Record_t ctl_current;
+
+/**
+ * @brief Проверка записи журнала: маркер и CRC32.
+ */
+static uint8_t BootCtl_Check(const BootCtl_Record_t *record)
+{
+  if (record->magic != BOOT_CTL_MAGIC)
+  {
+    return 0;
+  }
+  if (APP_CRC_Calc((const uint32_t *)record, BOOT_CTL_CRC_WORDS) != record->crc32)
+  {
+    return 0;   /// Запись оборвана пропаданием питания или повреждена
+  }
+  return 1;
+}
+
+/**
+ * @brief Половина журнала полностью стёрта.
+ */
+static uint8_t BootCtl_Half_Blank(const uint8_t half)
+{
+  const uint32_t *word = (const uint32_t *)ctl_half[half].addr;
+
+  for (uint32_t i = 0; i < BOOT_CTL_SIZE / sizeof(uint32_t); i++)
+  {
+    if (word[i] != 0xFFFFFFFFu)
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+ * @brief Поиск действующей записи журнала в обеих половинах.
+ * @details Действующая - верная запись с наибольшим номером seq. Если журнал пуст (первая
+ *          прошивка через ST-LINK), считается, что в слоте A подтверждённый образ
+ *          неизвестной длины (image_len = 0).
+ * @param record Куда скопировать действующую запись.
+ */
+void BootCtl_Load(BootCtl_Record_t *record)
+{
+  uint8_t found = 0;
+
+  ctl_current.magic      = BOOT_CTL_MAGIC;
+  ctl_current.seq        = 0u;
+  ctl_current.state      = BOOT_STATE_CONFIRMED;
+  ctl_current.image_len  = 0u;
+  ctl_current.image_crc  = 0u;
+  ctl_current.trials     = 0u;
+  ctl_current.backup_crc = 0u;
+  ctl_current.crc32      = 0u;
+  ctl_half_cur           = 0;
+  ctl_next_addr          = BOOT_CTL_ADDR;
+
+  for (uint8_t half = 0; half < 2u; half++)
+  {
+    const BootCtl_Record_t *slot = (const BootCtl_Record_t *)ctl_half[half].addr;
+    const BootCtl_Record_t *end  = (const BootCtl_Record_t *)(ctl_half[half].addr + BOOT_CTL_SIZE);
+    uint8_t                 best = 0;   /// В этой половине найдена новая действующая запись
+
+    for (; slot + 1 <= end; slot++)
+    {
+      if (slot->magic == 0xFFFFFFFFu)   /// Стёртая ячейка - дальше половина пуста
+      {
+        break;
+      }
+      if (BootCtl_Check(slot) && (!found || (int32_t)(slot->seq - ctl_current.seq) > 0))
+      {
+        ctl_current = *slot;
+        found       = 1;
+        best        = 1;
+      }
+    }
+    if (best)
+    {
+      ctl_half_cur  = half;
+      ctl_next_addr = (uint32_t)slot;   /// За последней непустой ячейкой (испорченные пропускаются)
+    }
+  }
+
+  *record = ctl_current;
+}
+
+/**
+ * @brief Дописывание новой записи в журнал.
+ * @details Поля magic, seq и crc32 заполняются здесь. Когда половина заполнена, запись
+ *          пишется в начало другой, затем заполненная стирается. Если прошлое стирание
+ *          оборвалось, другая половина сначала стирается (действующая запись - в этой).
+ * @param input_record Новое состояние (state, image_len, image_crc, trials, backup_crc).
+ */
+HAL_StatusTypeDef BootCtl_Write(const BootCtl_Record_t *input_record)
+{
+  BootCtl_Record_t record = *input_record;
+  const uint8_t    old    = ctl_half_cur;
+  uint8_t          moved  = 0;
+
+  record.magic = BOOT_CTL_MAGIC;
+  record.seq   = ctl_current.seq + 1u;
+  record.crc32 = APP_CRC_Calc((const uint32_t *)&record, BOOT_CTL_CRC_WORDS);
+
+  if (ctl_next_addr + sizeof(record) > ctl_half[old].addr + BOOT_CTL_SIZE)
+  {
+    const uint8_t fresh = (uint8_t)(old ^ 1u);
+    if (!BootCtl_Half_Blank(fresh) && Boot_Flash_Erase(ctl_half[fresh].sector) != HAL_OK)
+    {
+      return HAL_ERROR;
+    }
+    ctl_half_cur  = fresh;
+    ctl_next_addr = ctl_half[fresh].addr;
+    moved         = 1;
+  }
+
+  const HAL_StatusTypeDef status =
+    Boot_Flash_Program(ctl_next_addr, (const uint32_t *)&record, sizeof(record) / sizeof(uint32_t));
+
+  ctl_next_addr += sizeof(record);   /// Даже при ошибке ячейка уже испорчена - пропускаем её
+
+  if (status == HAL_OK)
+  {
+    ctl_current = record;
+    if (moved)
+    {
+      /// Ошибка стирания не теряет запись: половина будет стёрта при следующем переходе
+      (void)Boot_Flash_Erase(ctl_half[old].sector);
+    }
+  }
+  return status;
+}
+
+/**
+ * @brief Подтверждение образа приложением.
+ * @details Вызывается приложением после успешного старта. Пишет запись,
+ *          только если образ действительно находится на испытании.
+ */
+HAL_StatusTypeDef BootCtl_Confirm(void)
+{
+  BootCtl_Record_t record;
+  BootCtl_Load(&record);
+
+  if (record.state != BOOT_STATE_TRIAL)
+  {
+    return HAL_OK;
+  }
+  record.state  = BOOT_STATE_CONFIRMED;
+  record.trials = 0u;
+  return BootCtl_Write(&record);
+}
+
+/**
+ * @brief Запрос обновления: после сброса загрузчик останется в режиме приёма образа.
+ */
+HAL_StatusTypeDef BootCtl_Request_Update(void)
+{
+  BootCtl_Record_t record;
+  BootCtl_Load(&record);
+
+  record.state = BOOT_STATE_UPDATE_REQ;
+  return BootCtl_Write(&record);
+}
@@ -0,0 +1,241 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include "BootFlash.h"
+#include "AppRamFunc.h"
+
+/** Все флаги ошибок контроллера Flash */
+#define BOOT_FLASH_ERR_FLAGS (FLASH_FLAG_OPERR  | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | \
+                              FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)
+
+/** PSIZE для диапазона напряжений: значения FLASH_VOLTAGE_RANGE_x и FLASH_PSIZE_x совпадают по порядку */
+#define BOOT_FLASH_PSIZE     ((uint32_t)BOOT_FLASH_VRANGE << FLASH_CR_PSIZE_Pos)
+
+_Static_assert(BOOT_FLASH_VRANGE <= FLASH_VOLTAGE_RANGE_4, "BOOT_FLASH_VRANGE must be FLASH_VOLTAGE_RANGE_1..4");
+
+/** Запись слова во Flash: на МК - по адресу при включённом PG, на ПК - в модель теста */
+#ifdef BOOT_FLASH_PORT_HOST
+#if BOOT_FLASH_PSIZE_BYTES < 4u
+#error "BOOT_FLASH_PORT_HOST: the host flash model takes whole words (FLASH_VOLTAGE_RANGE_3 or _4)"
+#endif
+#define BOOT_FLASH_STORE(address, word)  Boot_Flash_Host_Program((address), (word))
+#else
+#define BOOT_FLASH_STORE(address, word)  (*(__IO uint32_t *)(address) = (word))
+#endif
+
+static BootFlash_Stats_t flash_stats;
+
+/**
+ * @brief Разблокировка контроллера Flash и сброс флагов прошлых операций.
+ */
+static void Boot_Flash_Unlock(void)
+{
+  if (FLASH->CR & FLASH_CR_LOCK)
+  {
+    FLASH->KEYR = FLASH_KEY1;
+    FLASH->KEYR = FLASH_KEY2;
+  }
+  FLASH->SR = FLASH_FLAG_EOP | BOOT_FLASH_ERR_FLAGS;  /// Флаги сбрасываются записью 1
+}
+
+/**
+ * @brief Ожидание окончания операции и проверка ошибок.
+ */
+APP_RAMCODE static HAL_StatusTypeDef Boot_Flash_Wait(void)
+{
+  while (FLASH->SR & FLASH_SR_BSY)
+  {
+  }
+  return (FLASH->SR & BOOT_FLASH_ERR_FLAGS) ? HAL_ERROR : HAL_OK;
+}
+
+/**
+ * @brief Пуск операции, подготовленной в CR, и ожидание её конца.
+ * @details С APP_RAMFUNC - из ОЗУ: до конца стирания выборок из Flash нет,
+ *          прерывания с обработчиками в ОЗУ обслуживаются без задержки.
+ */
+APP_RAMCODE static HAL_StatusTypeDef Boot_Flash_Start(void)
+{
+  FLASH->CR |= FLASH_CR_STRT;
+  return Boot_Flash_Wait();
+}
+
+/**
+ * @brief Сброс кэша данных ART: после стирания и записи в нём могут остаться старые строки.
+ */
+static void Boot_Flash_Flush_Dcache(void)
+{
+  if (FLASH->ACR & FLASH_ACR_DCEN)
+  {
+    FLASH->ACR &= ~FLASH_ACR_DCEN;
+    FLASH->ACR |= FLASH_ACR_DCRST;
+    FLASH->ACR &= ~FLASH_ACR_DCRST;
+    FLASH->ACR |= FLASH_ACR_DCEN;
+  }
+}
+
+/**
+ * @brief Стирание одного сектора.
+ * @param sector Номер сектора (FLASH_SECTOR_x).
+ * @retval HAL_StatusTypeDef - статус операции.
+ */
+HAL_StatusTypeDef Boot_Flash_Erase(const uint32_t sector)
+{
+  Boot_Flash_Unlock();
+
+  FLASH->CR &= ~(FLASH_CR_PSIZE | FLASH_CR_SNB);
+  FLASH->CR |= BOOT_FLASH_PSIZE | FLASH_CR_SER | (sector << FLASH_CR_SNB_Pos);
+
+#ifdef BOOT_FLASH_PORT_HOST
+  Boot_Flash_Host_Erase(sector);
+#endif
+  const HAL_StatusTypeDef status = Boot_Flash_Start();
+
+  FLASH->CR &= ~(FLASH_CR_SER | FLASH_CR_SNB);
+  FLASH->CR |= FLASH_CR_LOCK;
+  Boot_Flash_Flush_Dcache();
+  return status;
+}
+
+/**
+ * @brief Начало сеанса записи: разблокировка, PSIZE и PG включаются один раз.
+ * @param address Адрес первого слова (выровнен на 4).
+ */
+void Boot_Flash_Stream_Begin(BootFlash_Stream_t *stream, const uint32_t address)
+{
+  stream->start   = address;
+  stream->address = address;
+  stream->cycles  = 0;
+  APP_CRC_Ctx_Init(&stream->crc);
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;   /// Счётчик тактов для замера скорости
+  DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+
+  Boot_Flash_Unlock();
+  FLASH->CR &= ~FLASH_CR_PSIZE;
+  FLASH->CR |= BOOT_FLASH_PSIZE | FLASH_CR_PG;
+}
+
+/**
+ * @brief Слова подряд с ожиданием BSY после каждого (внутренний цикл записи).
+ * @details С APP_RAMFUNC - из ОЗУ: пока слово программируется, выборок из Flash нет.
+ * @retval Адрес следующего слова.
+ */
+APP_RAMCODE static uint32_t Boot_Flash_Stream_Words(uint32_t address, const uint32_t *data, uint32_t words)
+{
+  while (words != 0u)
+  {
+#if BOOT_FLASH_PSIZE_BYTES == 8u
+    if (words >= 2u && (address & 7u) == 0u)
+    {
+      FLASH->CR = (FLASH->CR & ~FLASH_CR_PSIZE) | FLASH_PSIZE_DOUBLE_WORD;
+      BOOT_FLASH_STORE(address, data[0]);
+      __ISB();
+      BOOT_FLASH_STORE(address + 4u, data[1]);
+      address += 8u;
+      data    += 2;
+      words   -= 2u;
+    }
+    else
+    {
+      FLASH->CR = (FLASH->CR & ~FLASH_CR_PSIZE) | FLASH_PSIZE_WORD;
+      BOOT_FLASH_STORE(address, *data++);
+      address += 4u;
+      words--;
+    }
+#elif BOOT_FLASH_PSIZE_BYTES == 4u
+    BOOT_FLASH_STORE(address, *data++);
+    address += 4u;
+    words--;
+#else
+    /// x8 / x16: слово - 4 или 2 операции; порядок байт в памяти тот же (little-endian)
+    const uint32_t word = *data++;
+    for (uint32_t shift = 0; shift < 32u; shift += 8u * BOOT_FLASH_PSIZE_BYTES)
+    {
+#if BOOT_FLASH_PSIZE_BYTES == 2u
+      *(__IO uint16_t *)address = (uint16_t)(word >> shift);
+#else
+      *(__IO uint8_t *)address = (uint8_t)(word >> shift);
+#endif
+      address += BOOT_FLASH_PSIZE_BYTES;
+      while (FLASH->SR & FLASH_SR_BSY)
+      {
+      }
+    }
+    words--;
+    continue;
+#endif
+    while (FLASH->SR & FLASH_SR_BSY)
+    {
+    }
+  }
+
+  return address;
+}
+
+/**
+ * @brief Порция данных сеанса: слова пишутся подряд, ошибки проверяет Boot_Flash_Stream_End().
+ * @details При x64 двойное слово - две записи подряд по адресу, кратному 8; одиночное слово
+ *          (нечётный хвост или невыровненный адрес) пишется с PSIZE = x32, это допустимо при VPP.
+ */
+void Boot_Flash_Stream_Write(BootFlash_Stream_t *stream, const uint32_t *data, uint32_t words)
+{
+  const uint32_t start = DWT->CYCCNT;
+
+  stream->address = Boot_Flash_Stream_Words(stream->address, data, words);
+
+  stream->cycles += DWT->CYCCNT - start;   /// Только программирование: CRC в скорость не входит
+  APP_CRC_Accumulate(&stream->crc, data, words);
+}
+
+/**
+ * @brief Конец сеанса: одна проверка флагов ошибок, блокировка и проверка CRC записанного.
+ * @retval HAL_ERROR - ошибка контроллера или записанное не совпало с исходными данными.
+ */
+HAL_StatusTypeDef Boot_Flash_Stream_End(BootFlash_Stream_t *stream)
+{
+  HAL_StatusTypeDef status = Boot_Flash_Wait();
+
+  FLASH->CR &= ~(FLASH_CR_PG | FLASH_CR_PSIZE);
+  FLASH->CR |= BOOT_FLASH_PSIZE | FLASH_CR_LOCK;
+  Boot_Flash_Flush_Dcache();
+
+  const uint32_t words = (stream->address - stream->start) / sizeof(uint32_t);
+  if (status == HAL_OK && APP_CRC_Calc((const uint32_t *)stream->start, words) != stream->crc.crc)
+  {
+    flash_stats.verify_errors++;
+    status = HAL_ERROR;
+  }
+
+  flash_stats.words        = words;
+  flash_stats.cycles       = stream->cycles;
+  flash_stats.words_per_ms = (stream->cycles != 0u)
+                             ? (uint32_t)(((uint64_t)words * (SystemCoreClock / 1000u)) / stream->cycles)
+                             : 0u;
+  return status;
+}
+
+/**
+ * @brief Программирование массива слов подряд (один сеанс).
+ * @param address Адрес во Flash (выровнен на 4).
+ * @param data    Данные.
+ * @param words   Количество слов.
+ * @retval HAL_StatusTypeDef - статус операции, включая проверку CRC записанного.
+ */
+HAL_StatusTypeDef Boot_Flash_Program(const uint32_t address, const uint32_t *data, const uint32_t words)
+{
+  BootFlash_Stream_t stream;
+
+  Boot_Flash_Stream_Begin(&stream, address);
+  Boot_Flash_Stream_Write(&stream, data, words);
+  return Boot_Flash_Stream_End(&stream);
+}
+
+/**
+ * @brief Замер последнего сеанса записи.
+ */
+const BootFlash_Stats_t *Boot_Flash_Get_Stats(void)
+{
+  return &flash_stats;
+}
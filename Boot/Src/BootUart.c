@@ -0,0 +1,122 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include "BootUart.h"
+
+/** Кольцевой буфер приёма: пишет DMA, читает ядро */
+static uint8_t  rx_ring[BOOT_UART_RING_SIZE];
+static uint32_t rx_tail = 0;
+
+/**
+ * @brief Позиция записи DMA в кольцевом буфере.
+ */
+static inline uint32_t Boot_Uart_Head(void)
+{
+  return BOOT_UART_RING_SIZE - DMA2_Stream2->NDTR;
+}
+
+/**
+ * @brief Инициализация USART1 и циклического приёма через DMA.
+ */
+void Boot_Uart_Init(void)
+{
+  RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN | RCC_AHB1ENR_DMA2EN;
+  RCC->APB2ENR |= RCC_APB2ENR_USART1EN;
+  (void)RCC->APB2ENR;                       /// Задержка после включения тактирования
+
+  /// PA9 (TX), PA10 (RX): альтернативная функция AF7, на RX подтяжка вверх (линия в покое - 1)
+  GPIOA->MODER   = (GPIOA->MODER & ~(GPIO_MODER_MODER9 | GPIO_MODER_MODER10))
+                 | GPIO_MODER_MODER9_1 | GPIO_MODER_MODER10_1;
+  GPIOA->AFR[1]  = (GPIOA->AFR[1] & ~(GPIO_AFRH_AFSEL9 | GPIO_AFRH_AFSEL10))
+                 | (7u << GPIO_AFRH_AFSEL9_Pos) | (7u << GPIO_AFRH_AFSEL10_Pos);
+  GPIOA->PUPDR   = (GPIOA->PUPDR & ~GPIO_PUPDR_PUPD10) | GPIO_PUPDR_PUPD10_0;
+
+  /// 115200 8N1, оверсэмплинг 16: BRR = fCK / baud (с округлением)
+  USART1->BRR = (HSI_VALUE + BOOT_UART_BAUD / 2u) / BOOT_UART_BAUD;
+  USART1->CR3 = USART_CR3_DMAR;
+
+  /// DMA2 Stream2 Channel4 = USART1_RX, периферия -> память, циклический режим
+  DMA2_Stream2->CR = 0;
+  while (DMA2_Stream2->CR & DMA_SxCR_EN)
+  {
+  }
+  DMA2->LIFCR         = DMA_LIFCR_CTCIF2 | DMA_LIFCR_CHTIF2 | DMA_LIFCR_CTEIF2 |
+                        DMA_LIFCR_CDMEIF2 | DMA_LIFCR_CFEIF2;
+  DMA2_Stream2->PAR   = (uint32_t)&USART1->DR;
+  DMA2_Stream2->M0AR  = (uint32_t)rx_ring;
+  DMA2_Stream2->NDTR  = BOOT_UART_RING_SIZE;
+  DMA2_Stream2->CR    = (4u << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_MINC | DMA_SxCR_CIRC;
+  DMA2_Stream2->CR   |= DMA_SxCR_EN;
+
+  rx_tail = 0;
+  USART1->CR1 = USART_CR1_UE | USART_CR1_TE | USART_CR1_RE;
+}
+
+/**
+ * @brief Возврат USART1, DMA2 и GPIOA в состояние после сброса перед запуском приложения.
+ * @details GPIOB не сбрасывается: на нём клапан (активный LOW), и в сброшенном
+ *          состоянии вывод с подтяжкой вниз открыл бы клапан до MX_GPIO_Init().
+ */
+void Boot_Uart_DeInit(void)
+{
+  DMA2_Stream2->CR = 0;
+  USART1->CR1      = 0;
+
+  RCC->APB2RSTR |=  RCC_APB2RSTR_USART1RST;
+  RCC->APB2RSTR &= ~RCC_APB2RSTR_USART1RST;
+  RCC->AHB1RSTR |=  (RCC_AHB1RSTR_DMA2RST | RCC_AHB1RSTR_GPIOARST);
+  RCC->AHB1RSTR &= ~(RCC_AHB1RSTR_DMA2RST | RCC_AHB1RSTR_GPIOARST);
+
+  RCC->APB2ENR &= ~RCC_APB2ENR_USART1EN;
+  RCC->AHB1ENR &= ~(RCC_AHB1ENR_DMA2EN | RCC_AHB1ENR_GPIOAEN);
+}
+
+/**
+ * @brief Количество принятых и ещё не прочитанных байт.
+ */
+uint32_t Boot_Uart_Available(void)
+{
+  return (Boot_Uart_Head() + BOOT_UART_RING_SIZE - rx_tail) % BOOT_UART_RING_SIZE;
+}
+
+/**
+ * @brief Чтение байта без извлечения.
+ * @param offset Смещение от текущей позиции чтения (меньше Boot_Uart_Available()).
+ */
+uint8_t Boot_Uart_Peek(const uint32_t offset)
+{
+  return rx_ring[(rx_tail + offset) % BOOT_UART_RING_SIZE];
+}
+
+/**
+ * @brief Извлечение len байт (dst == NULL - просто пропустить).
+ */
+void Boot_Uart_Read(uint8_t *dst, uint32_t len)
+{
+  while (len--)
+  {
+    if (dst != NULL)
+    {
+      *dst++ = rx_ring[rx_tail];
+    }
+    rx_tail = (rx_tail + 1u) % BOOT_UART_RING_SIZE;
+  }
+}
+
+/**
+ * @brief Передача с ожиданием (ответы загрузчика - десятки байт).
+ */
+void Boot_Uart_Write(const uint8_t *src, uint32_t len)
+{
+  while (len--)
+  {
+    while (!(USART1->SR & USART_SR_TXE))
+    {
+    }
+    USART1->DR = *src++;
+  }
+  while (!(USART1->SR & USART_SR_TC))
+  {
+  }
+}
@@ -7,28 +7,93 @@
 
 #include <stdint.h>
 #include "stm32f401xc.h"
+#include "AppAtomic.h"
 
-#define NUMBER_OF_DIG (3)      // Кол-во разрядов
+#ifndef NUMBER_OF_DIG
+#define NUMBER_OF_DIG (3)      // Кол-во разрядов (SPI back-end задаёт своё из CMake)
+#endif
 #define SEG7_DP_BIT   (0x80u)  //
 
+#define SEG7_BLINK_CYCLES (20u)  // Полупериод мигания в циклах мультиплекса (~0.25 с при ~79 Гц на разряд)
+
+/**
+ * @brief Анимация: кадры заранее посчитаны (const, во Flash), в прерывании - только выбор кадра
+ * @details С APP_RAMFUNC кадры и сама структура объявляются с APP_RAMCONST (AppRamFunc.h):
+ *          прерывание читает их и во время стирания Flash.
+ * @param frames      - Кадры: шаблоны сегментов всех разрядов
+ * @param owns        - 1 - разряд берётся из кадра, 0 - из буфера digit_buf (например, число)
+ * @param frame_count - Количество кадров
+ * @param frame_ticks - Сколько циклов мультиплекса держится кадр
+ */
+typedef struct {
+  const uint8_t (*frames)[NUMBER_OF_DIG];
+  uint8_t        owns[NUMBER_OF_DIG];
+  uint8_t        frame_count;
+  uint8_t        frame_ticks;
+} Seg7_Animation_t;
+
+/**
+ * @brief Что показать: публикуется сеттерами целиком (seqlock), прерывание берёт снимок
+ * @param digit      - Шаблоны сегментов разрядов
+ * @param blank      - digit с погашенными мигающими разрядами
+ * @param blink_mask - Мигающие разряды (бит i - разряд i)
+ * @param leds       - Светодиоды состояния (только SPI back-end, Seg7_Spi.h)
+ * @param anim       - Анимация (NULL - нет)
+ */
+typedef struct {
+  uint8_t                 digit [NUMBER_OF_DIG];
+  uint8_t                 blank [NUMBER_OF_DIG];
+  uint8_t                 blink_mask;
+  uint8_t                 leds;
+  const Seg7_Animation_t* anim;
+} Seg7_View_t;
+
 /**
  * @brief Структура для описания семисегментного индикатора
+ * @details Поля до view_lock меняют только сеттеры (основной код), view - под seqlock,
+ *          поля после shown - только прерывание мультиплекса.
  * @param digit_ports      - Порты для разрядов (ключей)
  * @param digit_pins       - Пины для разрядов (ключей)
  * @param digit_buf        - Буфер шаблонов сегментов для каждого разряда
- * @param current_digit    - Текущий активный разряд (для динамики)
  * @param segment_port     - Порт для сегментов (A..G + точка)
  * @param segment_pin_mask - Маска задействованных бит сегментов в ODR
+ * @param blink_mask       - Мигающие разряды (бит i - разряд i)
+ * @param anim             - Текущая анимация (NULL - нет)
+ * @param leds             - Светодиоды состояния (только SPI back-end, Seg7_Spi.h)
+ * @param view_lock        - Seqlock опубликованного вида
+ * @param view             - Опубликованный вид
+ * @param shown            - Последний целый снимок вида в прерывании
+ * @param shown_seq        - Его версия
+ * @param current_digit    - Текущий активный разряд (для динамики)
+ * @param show             - Что сейчас выводится: shown.digit или shown.blank
  */
 typedef struct {
   GPIO_TypeDef* digit_ports [NUMBER_OF_DIG];
   uint16_t      digit_pins  [NUMBER_OF_DIG];
   uint8_t       digit_buf   [NUMBER_OF_DIG];
-  uint8_t       current_digit;
   GPIO_TypeDef* segment_port;
   uint16_t      segment_pin_mask;
+  uint8_t                 blink_mask;
+  const Seg7_Animation_t* anim;
+  uint8_t                 leds;
+
+  AppSeqlock_t            view_lock;
+  Seg7_View_t             view;
+
+  Seg7_View_t             shown;
+  uint32_t                shown_seq;
+  uint8_t                 current_digit;
+  const uint8_t*          show;
+  uint8_t                 blink_hold;
+  const uint8_t*          anim_frame;   /// Текущий кадр анимации
+  const uint8_t*          anim_owns;    /// Какие разряды он занимает
+  uint8_t                 anim_index;
+  uint8_t                 anim_hold;
 } Seg7_Handle_t;
 
+/// Готовые анимации
+extern const Seg7_Animation_t seg7_anim_spinner;   /// Бегущий сегмент по кругу в левом разряде
+
 /**
  * @brief Инициализация дескриптора индикатора
  */
@@ -44,6 +109,18 @@ void Seg7_Init(
 /// Заполнение буфера сегментов по числу (выравнивание по правому краю)
 void Seg7_SetNumber(Seg7_Handle_t* seg7_handle, uint16_t input_number);
 void Seg7_UpdateIndicator(Seg7_Handle_t *seg7_handle);
+/// Погасить выходы индикатора (TIM3 остановлен, например перед сном STOP); вид не меняется
+void Seg7_Off(Seg7_Handle_t *seg7_handle);
 void Seg7_SetDP (Seg7_Handle_t * seg7_handle, uint8_t digit_index, uint8_t on);
+/// Вывод кода аварии: "E" в левом разряде и две цифры кода справа
+void Seg7_SetError(Seg7_Handle_t* seg7_handle, uint8_t error_code);
+/// Вывод текста (до NUMBER_OF_DIG символов, '.' - точка предыдущего разряда), например "Err", "CAL", "PUr"
+void Seg7_SetText (Seg7_Handle_t* seg7_handle, const char* text);
+/// Мигание разрядов: бит i маски - разряд i (0 - без мигания)
+void Seg7_SetBlink(Seg7_Handle_t* seg7_handle, uint8_t digit_mask);
+/// Запуск анимации (NULL - остановить). Повторный вызов с той же анимацией её не перезапускает
+void Seg7_SetAnimation(Seg7_Handle_t* seg7_handle, const Seg7_Animation_t* animation);
+/// Светодиоды состояния третьего регистра цепочки (при прямом подключении не используются)
+void Seg7_SetLeds(Seg7_Handle_t* seg7_handle, uint8_t led_mask);
 
 #endif // INC_7_SEG_7_SEG_DRIVER_H
@@ -0,0 +1,233 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_APPATOMIC_H
+#define INC_7_SEG_APPATOMIC_H
+
+/**
+ *  ------------------------------------------------------
+ *  - Обмен данными между прерываниями и основным кодом   -
+ *  ------------------------------------------------------
+ *
+ * Три примитива без запрета прерываний (Cortex-M4, одно ядро):
+ *
+ *   - атомарная публикация слова: App_Atomic_Publish() / App_Atomic_Load() -
+ *     запись/чтение одного выровненного слова с барьером; App_Atomic_Add(),
+ *     App_Atomic_Exchange(), App_Atomic_Take() - чтение-модификация-запись через
+ *     LDREX/STREX (прерывание между ними сбрасывает монитор - попытка повторяется);
+ *   - seqlock (AppSeqlock_t): один писатель меняет блок данных, читатель узнаёт, что
+ *     прочитал целую версию. Читатель-прерывание не может ждать писателя, которого
+ *     он вытеснил, поэтому при неудаче оставляет прошлый целый снимок;
+ *   - кольцо SPSC (AppSpsc_t): один писатель, один читатель, слова uint32_t. Каждый
+ *     индекс пишет только одна сторона, поэтому хватает публикации индекса после данных.
+ *
+ * На одном ядре важен прежде всего барьер компилятора (volatile и "memory" у __DMB);
+ * DMB дополнительно упорядочивает обращения для DMA.
+ *
+ * Хост-порт (APP_ATOMIC_PORT_HOST): встроенные __atomic GCC вместо LDREX/STREX и
+ * полный барьер вместо DMB - те же функции можно проверять потоками на ПК.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#ifndef APP_ATOMIC_PORT_HOST
+#include "stm32f4xx.h"
+#endif
+
+/** Частные макроопределения */
+#ifdef APP_ATOMIC_PORT_HOST
+#define APP_ATOMIC_DMB()  __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define APP_ATOMIC_DMB()  __DMB()
+#endif
+
+/**
+ * @brief Кольцо SPSC с буфером depth слов (depth - степень двойки), без инициализации в коде.
+ */
+#define APP_SPSC_DEFINE(name, depth)                                                   \
+  _Static_assert((depth) > 0u && ((depth) & ((depth) - 1u)) == 0u,                     \
+                 #name ": SPSC depth must be a power of two");                        \
+  static uint32_t  name##_buf[depth];                                                  \
+  static AppSpsc_t name = { .buf = name##_buf, .mask = (depth) - 1u, .head = 0, .tail = 0 }
+
+/** Структуры */
+
+/**
+ * @brief Seqlock: нечётный номер - писатель внутри блока
+ */
+typedef struct {
+  volatile uint32_t seq;
+} AppSeqlock_t;
+
+/**
+ * @brief Кольцо SPSC
+ */
+typedef struct {
+  uint32_t         *buf;
+  uint32_t          mask;    /// Размер - 1
+  volatile uint32_t head;    /// Пишет только писатель
+  volatile uint32_t tail;    /// Пишет только читатель
+} AppSpsc_t;
+
+/** -- Одно слово -- */
+
+/**
+ * @brief Записать слово после всех предыдущих записей (данные готовы -> флаг/указатель).
+ */
+static inline void App_Atomic_Publish(volatile uint32_t *word, const uint32_t value)
+{
+  APP_ATOMIC_DMB();
+  *word = value;
+}
+
+/**
+ * @brief Прочитать слово до всех последующих чтений (флаг/указатель -> данные).
+ */
+static inline uint32_t App_Atomic_Load(const volatile uint32_t *word)
+{
+  const uint32_t value = *word;
+  APP_ATOMIC_DMB();
+  return value;
+}
+
+/**
+ * @brief word += delta.
+ * @retval Новое значение.
+ */
+static inline uint32_t App_Atomic_Add(volatile uint32_t *word, const uint32_t delta)
+{
+#ifdef APP_ATOMIC_PORT_HOST
+  return __atomic_add_fetch(word, delta, __ATOMIC_SEQ_CST);
+#else
+  uint32_t value;
+  do
+  {
+    value = __LDREXW(word) + delta;
+  } while (__STREXW(value, word) != 0u);
+  APP_ATOMIC_DMB();
+  return value;
+#endif
+}
+
+/**
+ * @brief Заменить слово и вернуть прежнее (забрать флаг/код, не потеряв новый).
+ */
+static inline uint32_t App_Atomic_Exchange(volatile uint32_t *word, const uint32_t value)
+{
+#ifdef APP_ATOMIC_PORT_HOST
+  return __atomic_exchange_n(word, value, __ATOMIC_SEQ_CST);
+#else
+  uint32_t old;
+  do
+  {
+    old = __LDREXW(word);
+  } while (__STREXW(value, word) != 0u);
+  APP_ATOMIC_DMB();
+  return old;
+#endif
+}
+
+/**
+ * @brief Уменьшить счётчик на 1, если он не ноль (забрать одно накопленное событие).
+ * @retval 1 - событие забрано.
+ */
+static inline uint8_t App_Atomic_Take(volatile uint32_t *word)
+{
+#ifdef APP_ATOMIC_PORT_HOST
+  uint32_t value = __atomic_load_n(word, __ATOMIC_SEQ_CST);
+  while (value != 0u)
+  {
+    if (__atomic_compare_exchange_n(word, &value, value - 1u, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+    {
+      return 1u;
+    }
+  }
+  return 0u;
+#else
+  uint32_t value;
+  do
+  {
+    value = __LDREXW(word);
+    if (value == 0u)
+    {
+      __CLREX();
+      return 0u;
+    }
+  } while (__STREXW(value - 1u, word) != 0u);
+  APP_ATOMIC_DMB();
+  return 1u;
+#endif
+}
+
+/** -- Seqlock -- */
+
+static inline void App_Seq_Write_Begin(AppSeqlock_t *lock)
+{
+  lock->seq = lock->seq + 1u;
+  APP_ATOMIC_DMB();
+}
+
+static inline void App_Seq_Write_End(AppSeqlock_t *lock)
+{
+  APP_ATOMIC_DMB();
+  lock->seq = lock->seq + 1u;
+}
+
+/**
+ * @brief Начало чтения: номер версии (передать в App_Seq_Read_Valid()).
+ */
+static inline uint32_t App_Seq_Read_Begin(const AppSeqlock_t *lock)
+{
+  const uint32_t seq = lock->seq;
+  APP_ATOMIC_DMB();
+  return seq;
+}
+
+/**
+ * @brief Конец чтения.
+ * @retval 1 - прочитанное - целая версия seq (писатель не был внутри блока).
+ */
+static inline uint8_t App_Seq_Read_Valid(const AppSeqlock_t *lock, const uint32_t seq)
+{
+  APP_ATOMIC_DMB();
+  return ((seq & 1u) == 0u && lock->seq == seq) ? 1u : 0u;
+}
+
+/** -- Кольцо SPSC -- */
+
+/**
+ * @brief Положить слово (только писатель).
+ * @retval 0 - кольцо полно, слово не записано.
+ */
+static inline uint8_t App_Spsc_Push(AppSpsc_t *ring, const uint32_t value)
+{
+  const uint32_t head = ring->head;
+
+  if (head - App_Atomic_Load(&ring->tail) > ring->mask)
+  {
+    return 0u;
+  }
+  ring->buf[head & ring->mask] = value;
+  App_Atomic_Publish(&ring->head, head + 1u);
+  return 1u;
+}
+
+/**
+ * @brief Забрать слово (только читатель).
+ * @retval 0 - кольцо пусто.
+ */
+static inline uint8_t App_Spsc_Pop(AppSpsc_t *ring, uint32_t *value)
+{
+  const uint32_t tail = ring->tail;
+
+  if (tail == App_Atomic_Load(&ring->head))
+  {
+    return 0u;
+  }
+  *value = ring->buf[tail & ring->mask];
+  App_Atomic_Publish(&ring->tail, tail + 1u);
+  return 1u;
+}
+
+#endif //INC_7_SEG_APPATOMIC_H
@@ -0,0 +1,103 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_APPBENCH_H
+#define INC_7_SEG_APPBENCH_H
+
+/**
+ *  -----------------------------------------------------
+ *  - Замер горячих путей в тактах (опция APP_BENCH)     -
+ *  -----------------------------------------------------
+ *
+ * App_Bench_Run() вызывается из main() сразу после SystemClock_Config() (секция USER CODE
+ * SysInit): частота ядра и задержки Flash уже рабочие, выводы ещё не настроены. На время
+ * замера кода индикатора и автомата тактирование GPIOA/GPIOB снято: записи сегментов,
+ * разрядов и клапана в порты не попадают, выходы (и оставленные загрузчиком) не меняются.
+ *
+ * Замеры - такты ядра (DWT->CYCCNT) за вычетом цены самого замера, прерывания запрещены:
+ *   seg7_update      - шаг мультиплекса Seg7_UpdateIndicator(): число с миганием и анимация;
+ *   seg7_set_number  - Seg7_SetNumber() для каждого числа 0..999;
+ *   button_poll      - Button_Poll_1ms() на трассе с дребезгом (короткое и длинное нажатие),
+ *                      кнопка читается из порта-заглушки в ОЗУ;
+ *   machine/S/E      - Machine_Process() для каждой пары (состояние, событие), из одного исходного
+ *                      контекста на пару (в CONFIG cur_sec = cfg_sec: без записи во Flash);
+ *   cfg_load         - APP_Load_CFG_Flash();
+ *   cfg_save         - APP_Save_CFG_Flash() без изменений (CRC записи и сравнение, без стирания);
+ *   isr_entry        - от записи в NVIC->STIR до первой инструкции обработчика (свободный вектор).
+ * cfg_load и cfg_save замеряются только при действительной записи текущей версии во Flash,
+ * при первом запуске их нет. Каждый замер повторяется, в отчёте - минимум и максимум.
+ *
+ * Калибровка - минимум тактов цикла из 1000 зависимых умножений-сложений в начале и в конце
+ * прогона (поля "calib" и "calib_loops" заголовка). tools/bench_check.py --calibrated делит
+ * замеры на него: сравнение с базой с другой машины или на другой частоте не зависит от тактов.
+ *
+ * Запуск - один замер на сброс, такты от начала Reset_Handler (стартовый код запускает
+ * DWT->CYCCNT первым делом, за загрузчиком счёт идёт от его сброса), без вычета цены замера:
+ *   boot/valve_safe    - клапан закрыт (App_Boot_Valve_Cycles, пишет стартовый код);
+ *   boot/first_display - первая картинка на индикаторе и запущен TIM3 (App_Bench_Boot_Display()),
+ *                        без времени самого App_Bench_Run().
+ *
+ * App_Bench_Report() (после MX_USART1_UART_Init()) печатает результаты в USART1 строками JSON
+ * между "BENCH BEGIN" и "BENCH END"; tools/bench_check.py сохраняет их как базу и сравнивает
+ * с прошлой базой.
+ *
+ * Хост-порт (APP_BENCH_PORT_HOST, программа - test/bench_host.c): те же замеры на ПК, счётчик -
+ * App_Bench_Host_Cycles() (такты процессора ПК), прерывание - App_Bench_Host_Raise() (сигнал,
+ * обработчик вызывает App_Bench_IRQHandler()). Замеров запуска на ПК нет.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+
+/** Частные макроопределения */
+#ifndef APP_BENCH_REPEAT
+#define APP_BENCH_REPEAT  (8u)            /// Повторов каждого замера (автомат, Flash, прерывание)
+#endif
+#define APP_BENCH_IRQ     (I2C2_ER_IRQn)  /// Свободный вектор для замера входа в прерывание
+
+/** Перечисления */
+
+/**
+ * @brief Замеры
+ */
+typedef enum {
+  APP_BENCH_SEG7_UPDATE     = 0,
+  APP_BENCH_SEG7_SET_NUMBER = 1,
+  APP_BENCH_BUTTON_POLL     = 2,
+  APP_BENCH_CFG_LOAD        = 3,
+  APP_BENCH_CFG_SAVE        = 4,
+  APP_BENCH_ISR_ENTRY       = 5,
+  APP_BENCH_BOOT_VALVE_SAFE = 6,
+  APP_BENCH_BOOT_DISPLAY    = 7,
+  APP_BENCH_COUNT
+} AppBench_Id_t;
+
+/** Структуры */
+
+/**
+ * @brief Результат одного замера
+ */
+typedef struct {
+  uint32_t runs;   /// Выполнено замеров
+  uint32_t min;    /// Лучший, такты
+  uint32_t max;    /// Худший, такты
+} AppBench_Slot_t;
+
+/** Внешние переменные */
+extern uint32_t App_Boot_Valve_Cycles;   /// startup_stm32f401xc.s: CYCCNT, когда клапан закрыт
+
+/** Прототипы функций **/
+void App_Bench_Run          (void);
+void App_Bench_Boot_Display (void);
+void App_Bench_Report       (void);
+void App_Bench_IRQHandler   (void);
+
+#ifdef APP_BENCH_PORT_HOST
+/// Счётчик тактов и запрос прерывания (реализует test/bench_host.c)
+uint32_t App_Bench_Host_Cycles (void);
+void     App_Bench_Host_Raise  (void);
+#endif
+
+#endif //INC_7_SEG_APPBENCH_H
@@ -0,0 +1,41 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_APPCONSOLE_H
+#define INC_7_SEG_APPCONSOLE_H
+
+/**
+ *  ---------------------------------------------------
+ *  - Команды сервисной консоли (USART1, 115200 8N1)   -
+ *  ---------------------------------------------------
+ *
+ * Собирается при APP_CONSOLE (опция CMake APP_CONSOLE=ON, только суперцикл).
+ * Ядро приёма и разбора - Console.h, здесь - таблица команд:
+ *
+ *   crc [WORDS]             - такты расчёта CRC: аппаратный блок, DMA, таблица (APP_CRC_Benchmark);
+ *   flash                   - замер последней записи во Flash (APP_LL_FLASH / APP_BOOTLOADER);
+ *   help                    - список команд;
+ *   sched                   - расписание (только с APP_SCHEDULE);
+ *   sched N off             - выключить запись N (0..SCHEDULE_ENTRIES-1);
+ *   sched N DAYS hh:mm      - запись N: DAYS - цифры дней 1..7 (1 - понедельник),
+ *                             например "sched 0 12345 06:30";
+ *   sec [S]                 - время дозирования, с (запись - только в STATE_READY);
+ *   status                  - состояние автомата и счётчики консоли;
+ *   time [D hh:mm[:ss]]     - день недели и время RTC (только с APP_SCHEDULE);
+ *   update                  - сброс в загрузчик для обновления (APP_BOOTLOADER, только в STATE_READY).
+ *
+ * Изменения настроек, как и по Modbus, принимаются только в STATE_READY и пишутся
+ * во Flash после того, как ответ ушёл из очереди (стирание сектора останавливает ядро).
+ * Дамп отказа (FaultCapture.h) в этой сборке идёт через ту же очередь передачи.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "State_Machine.h"
+
+/** Прототипы функций **/
+void    App_Console_Init(MachineState_Context_t *ctx);
+uint8_t App_Console_Poll(void);
+
+#endif //INC_7_SEG_APPCONSOLE_H
@@ -0,0 +1,74 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_APPCRC_H
+#define INC_7_SEG_APPCRC_H
+
+/**
+ *  ------------------------------------
+ *  - Сервис контрольных сумм (CRC32)  -
+ *  ------------------------------------
+ *
+ * Алгоритм соответствует аппаратному блоку CRC STM32F4:
+ *  - полином 0x04C11DB7 (CRC-32/MPEG-2),
+ *  - начальное значение 0xFFFFFFFF,
+ *  - данные подаются 32-битными словами, старшим битом вперёд,
+ *  - без отражения и без финального XOR.
+ *
+ * Поэтому аппаратный и программный (табличный) расчёт дают одинаковый результат,
+ * а контрольная сумма, посчитанная на ПК (tools/), совпадает с посчитанной в МК.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+
+/** Частные макроопределения */
+
+/** -- Выбор реализации -- */
+#ifndef APP_CRC_USE_HW
+#define APP_CRC_USE_HW        (1)     /// 1 - аппаратный блок CRC, 0 - табличный программный расчёт
+#endif
+
+#ifndef APP_CRC_USE_DMA
+#define APP_CRC_USE_DMA       (APP_CRC_USE_HW)  /// 0 - без DMA и без HAL (например, в загрузчике)
+#endif
+
+/** -- Начиная с какого размера блока (в словах) выгоднее отдать подачу данных DMA -- */
+#define APP_CRC_DMA_MIN_WORDS (64u)
+
+/** -- Начальное значение CRC (значение регистра DR после сброса блока) -- */
+#define APP_CRC_INIT_VALUE    (0xFFFFFFFFu)
+
+/** Структуры */
+
+/**
+ * @brief Контекст накопительного расчёта CRC.
+ * @details Позволяет считать CRC большого блока по частям (например, 1 КБ за вызов),
+ *          при этом между частями аппаратный блок может использоваться другими модулями.
+ */
+typedef struct {
+  uint32_t crc;  /// Текущее (промежуточное) значение CRC
+} AppCrc_Ctx_t;
+
+/**
+ * @brief Результаты сравнения аппаратного и программного расчёта (в тактах ядра).
+ */
+typedef struct {
+  uint32_t words;       /// Размер тестового блока в словах
+  uint32_t cycles_hw;   /// Аппаратный блок, подача данных ядром
+  uint32_t cycles_dma;  /// Аппаратный блок, подача данных через DMA
+  uint32_t cycles_sw;   /// Табличный программный расчёт
+  uint8_t  match;       /// 1 - все три способа дали одинаковый результат
+} AppCrc_Bench_t;
+
+/** Прототипы функций **/
+void     APP_CRC_Init        (void);
+uint32_t APP_CRC_Calc        (const uint32_t *data, uint32_t words);
+uint32_t APP_CRC_Calc_Sw     (const uint32_t *data, uint32_t words);
+void     APP_CRC_Ctx_Init    (AppCrc_Ctx_t *ctx);
+void     APP_CRC_Accumulate  (AppCrc_Ctx_t *ctx, const uint32_t *data, uint32_t words);
+void     APP_CRC_Benchmark   (const uint32_t *data, uint32_t words, AppCrc_Bench_t *result);
+
+#endif //INC_7_SEG_APPCRC_H
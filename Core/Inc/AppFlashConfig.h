@@ -28,6 +28,7 @@
 /** Подключение заголовочных файлов */
 #include <stdint.h>
 #include "stm32f4xx_hal.h"
+#include "AppSchedule.h"
 
 /** Перечисления */
 
@@ -42,7 +43,10 @@ typedef enum {
 
 /** -- Контроль целостности **/
 #define APP_CFG_MAGIC   (0x0BADC0DEu) /// Магическое число для валидации данных
-#define APP_CFG_VERSION (1)           /// Версия конфига
+#define APP_CFG_VERSION (3)           /// Версия конфига (2 - добавлена CRC32 всей записи, 3 - расписание)
+#define APP_CFG_VERSION_V2     (2)    /// Версия без расписания: cfg_sec переносится, расписание пустое
+#define APP_CFG_V2_CRC_WORDS   (5u)   /// Слов записи версии 2 под CRC32 (magic..reserved_1)
+#define APP_CFG_VERSION_LEGACY (1)    /// Версия без CRC32: читается при старте и пересохраняется
 
 /** -- Значения по умолчанию -- */
 #define APP_CFG_SEC_DEFAULT (APP_CFG_SEC_MIN)
@@ -52,8 +56,14 @@ typedef enum {
 #define APP_CFG_SEC_MIN (3u)         /// Минимальное  значение
 
 /** -- Размещение памяти -- */
+#ifdef APP_BOOTLOADER
+#include "BootLayout.h"
+#define FLASH_CFG_ADDR     (BOOT_CFG_ADDR)            /// S2 = 16 КБ: S4/S5 заняты слотами A/B загрузчика
+#define FLASH_CFG_SECTOR   (BOOT_CFG_SECTOR)
+#else
 #define FLASH_CFG_ADDR     ((uint32_t)(0x08020000u))  /// S5 = 128 КБ, начало в 0х08020000
 #define FLASH_CFG_SECTOR   (FLASH_SECTOR_5)           /// Сектор хранения данных
+#endif
 #define FLASH_CFG_VRANGE   (FLASH_VOLTAGE_RANGE_3)    /// Диапазон напряжений для работы устройства: от 2,7 до 3,6 В
 
 
@@ -94,13 +104,35 @@ typedef struct {
    */
   uint32_t reserved_1;
   /**
-   * Зарезервированное поле №2.
-   * Предназначено для будущего использования или расширения функциональности структуры.
-   * Не должно использоваться напрямую без явной документации в будущих обновлениях или спецификациях.
+   * Недельное расписание запусков (формат записи - AppSchedule.h), 0 - запись не используется.
+   * Хранится всегда, независимо от сборки: формат записи во Flash не зависит от опций.
+   * Добавлено в версии 3; в записи версии 2 на месте `sched[0]` лежит её crc32.
    */
-  uint32_t reserved_2;
+  uint32_t sched[SCHEDULE_ENTRIES];
+  /**
+   * Контрольная сумма CRC32 (см. AppCrc.h) всех предыдущих полей структуры.
+   * Обязана быть последним полем: считается по словам от `magic` до `sched` включительно.
+   * В отличие от инверсной копии защищает от повреждения любого поля записи.
+   * В версиях 1 и 2 запись кончалась раньше: см. `sched`.
+   */
+  uint32_t crc32;
 } AppFlashConfig_t;
 
+/**
+ * @brief Замер последней записи конфигурации во Flash (стирание и программирование)
+ * @details С APP_RAMFUNC мультиплекс и тик работают всю запись (AppRamFunc.h):
+ *          mux_blocked = 0, ticks - сколько миллисекунд шла запись. Без опции
+ *          прерывания запрещены: mux_blocked = cycles, ticks = 0.
+ */
+typedef struct {
+  uint32_t cycles;        /// Тактов ядра на стирание и запись
+  uint32_t mux_blocked;   /// Из них тактов, когда прерывание TIM3 (мультиплекс) не могло выполниться
+  uint32_t ticks;         /// Тиков SysTick, отсчитанных за запись
+} AppFlashConfig_Stats_t;
+
+/** -- Количество слов записи, покрываемых CRC32 (всё, кроме самого поля crc32) -- */
+#define APP_CFG_CRC_WORDS ((sizeof(AppFlashConfig_t) - sizeof(uint32_t)) / sizeof(uint32_t))
+
 /**
  * Глобальная переменная (RAM - копия), представляющая текущую конфигурацию приложения.
  * С ней работает логика приложения
@@ -110,5 +142,19 @@ extern AppFlashConfig_t GlobalAppConfig;
 /** Прототипы функций **/
 HAL_StatusTypeDef APP_Save_CFG_Flash(void);
 void APP_Load_CFG_Flash(void);
+Validate_t APP_Check_CFG_Flash(void);
+const AppFlashConfig_Stats_t *APP_Get_CFG_Stats(void);
+
+/** -- Запись из логики приложения: со сборкой APP_RTOS2 - запрос потоку persist (AppTasks.h),
+ *    со сборкой APP_SST - событие объекту flash (AppSst.h) -- */
+#if defined(APP_RTOS2)
+void App_Tasks_Request_Save(void);
+#define APP_SAVE_CFG()  App_Tasks_Request_Save()
+#elif defined(APP_SST)
+void App_Sst_Request_Save(void);
+#define APP_SAVE_CFG()  App_Sst_Request_Save()
+#else
+#define APP_SAVE_CFG()  ((void)APP_Save_CFG_Flash())
+#endif
 
 #endif //INC_7_SEG_APPFLASHCONFIG_H
\ No newline at end of file
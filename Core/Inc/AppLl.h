@@ -0,0 +1,108 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_APPLL_H
+#define INC_7_SEG_APPLL_H
+
+/**
+ *  ---------------------------------------------------------
+ *  - Тонкий слой GPIO/TIM/FLASH на LL вместо HAL            -
+ *  ---------------------------------------------------------
+ *
+ * Горячие пути (чтение кнопки, ключ клапана, TIM3 мультиплекса, запись конфигурации)
+ * вызывают функции этого заголовка. Каждая - static inline: с макросом модуля
+ * она разворачивается в запись регистра через stm32f4xx_ll_*.h, без него - в прежний
+ * вызов HAL. Модули выбираются независимо (опции CMake, в Release включены):
+ *
+ *   APP_LL_GPIO  - IDR/BSRR вместо HAL_GPIO_ReadPin()/HAL_GPIO_WritePin();
+ *   APP_LL_TIM   - TIM3: настройка (MX_TIM3_Init), пуск, останов и прерывание без HAL_TIM,
+ *                  из образа уходят stm32f4xx_hal_tim*.c;
+ *   APP_LL_FLASH - стирание и запись конфигурации драйвером на регистрах
+ *                  (Boot/Src/BootFlash.c), из образа уходят stm32f4xx_hal_flash*.c.
+ *
+ * Инициализация остальной периферии (MX_GPIO_Init, USART1, такты) остаётся на HAL:
+ * она выполняется один раз. Сравнение размера и длины горячих функций двух сборок -
+ * цель size_report (tools/size_report.py).
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+#include "stm32f4xx_ll_gpio.h"
+#include "stm32f4xx_ll_tim.h"
+#include "tim.h"
+
+/** -- GPIO -- */
+
+/**
+ * @brief Уровень вывода.
+ * @retval 1 - высокий.
+ */
+static inline uint32_t App_Gpio_Read(GPIO_TypeDef *port, const uint16_t pin)
+{
+#ifdef APP_LL_GPIO
+  return LL_GPIO_IsInputPinSet(port, pin);
+#else
+  return (HAL_GPIO_ReadPin(port, pin) == GPIO_PIN_SET) ? 1u : 0u;
+#endif
+}
+
+/**
+ * @brief Установка уровня вывода одной записью BSRR (атомарно относительно прерываний).
+ */
+static inline void App_Gpio_Write(GPIO_TypeDef *port, const uint16_t pin, const uint32_t high)
+{
+#ifdef APP_LL_GPIO
+  if (high)
+  {
+    LL_GPIO_SetOutputPin(port, pin);
+  }
+  else
+  {
+    LL_GPIO_ResetOutputPin(port, pin);
+  }
+#else
+  HAL_GPIO_WritePin(port, pin, high ? GPIO_PIN_SET : GPIO_PIN_RESET);
+#endif
+}
+
+/** -- TIM3 (мультиплекс индикатора) -- */
+
+static inline void App_Tim3_Start(void)
+{
+#ifdef APP_LL_TIM
+  LL_TIM_EnableIT_UPDATE(TIM3);
+  LL_TIM_EnableCounter(TIM3);
+#else
+  HAL_TIM_Base_Start_IT(&htim3);
+#endif
+}
+
+static inline void App_Tim3_Stop(void)
+{
+#ifdef APP_LL_TIM
+  LL_TIM_DisableIT_UPDATE(TIM3);
+  LL_TIM_DisableCounter(TIM3);
+#else
+  HAL_TIM_Base_Stop_IT(&htim3);
+#endif
+}
+
+#ifdef APP_LL_TIM
+/**
+ * @brief Событие обновления TIM3 (из TIM3_IRQHandler): флаг снимается.
+ * @retval 1 - было обновление при разрешённом прерывании.
+ */
+static inline uint32_t App_Tim3_Take_Update(void)
+{
+  if (LL_TIM_IsActiveFlag_UPDATE(TIM3) && LL_TIM_IsEnabledIT_UPDATE(TIM3))
+  {
+    LL_TIM_ClearFlag_UPDATE(TIM3);
+    return 1u;
+  }
+  return 0u;
+}
+#endif
+
+#endif //INC_7_SEG_APPLL_H
@@ -0,0 +1,78 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_APPPROFILE_H
+#define INC_7_SEG_APPPROFILE_H
+
+/**
+ *  -----------------------------------------------------
+ *  - Худшее время отклика задач (суперцикл и RTOS2)     -
+ *  -----------------------------------------------------
+ *
+ * Одни и те же точки замера в обеих сборках, поэтому таблицы App_Profile[] сравнимы:
+ *   APP_PROFILE_INPUT     - шаг опроса кнопки (граница миллисекунды -> шаг выполнен);
+ *   APP_PROFILE_CONTROL   - событие автомата (граница тика, на которой оно возникло -> обработано);
+ *   APP_PROFILE_TELEMETRY - Modbus и дамп отказа;
+ *   APP_PROFILE_PERSIST   - порция проверки образа и запись конфигурации во Flash.
+ *
+ * Отклик = (тики от release_tick) x период SysTick + доля текущего тика по SysTick->VAL,
+ * т.е. считается от границы тика, на которой работа стала готова, а не от начала её
+ * выполнения. Время выполнения - по DWT->CYCCNT. Всё в тактах ядра (HCLK).
+ *
+ * App_Profile_End_Us() - то же от метки App_Time_Us32() (AppTime.h): суперцикл отмечает
+ * момент события кнопки, срок секундного тика и начало прохода, а не границу тика.
+ * Отклик переводится в такты (шаг - такты одной микросекунды), таблица та же.
+ * Шаг кнопки (APP_PROFILE_INPUT) и сборки RTOS2/SST считают от границы тика.
+ *
+ * Таблица смотрится отладчиком (App_Profile) после прогона; App_Profile_Reset() -
+ * обнулить перед новым замером.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+
+/** Перечисления */
+
+/**
+ * @brief Задачи, для которых ведётся замер
+ */
+typedef enum {
+  APP_PROFILE_INPUT     = 0,
+  APP_PROFILE_CONTROL   = 1,
+  APP_PROFILE_TELEMETRY = 2,
+  APP_PROFILE_PERSIST   = 3,
+  APP_PROFILE_COUNT
+} AppProfile_Task_t;
+
+/** Структуры */
+
+/**
+ * @brief Статистика одной задачи
+ */
+typedef struct {
+  uint32_t runs;                 /// Выполнено работ
+  uint32_t worst_response;       /// Худший отклик от границы тика, такты
+  uint32_t worst_exec;           /// Худшее время выполнения, такты
+  uint32_t last_response;        /// Отклик последней работы, такты
+  uint32_t begin;                /// DWT->CYCCNT в начале текущей работы
+} AppProfile_Slot_t;
+
+extern AppProfile_Slot_t App_Profile[APP_PROFILE_COUNT];
+
+/** Прототипы функций **/
+void App_Profile_Init   (void);
+void App_Profile_Reset  (void);
+void App_Profile_End    (AppProfile_Task_t task, uint32_t release_tick);
+void App_Profile_End_Us (AppProfile_Task_t task, uint32_t release_us);
+
+/**
+ * @brief Начало работы задачи (только отметка DWT).
+ */
+static inline void App_Profile_Begin(const AppProfile_Task_t task)
+{
+  App_Profile[task].begin = DWT->CYCCNT;
+}
+
+#endif //INC_7_SEG_APPPROFILE_H
@@ -0,0 +1,70 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_APPRAMFUNC_H
+#define INC_7_SEG_APPRAMFUNC_H
+
+/**
+ *  ---------------------------------------------------------
+ *  - Код и таблицы в ОЗУ на время стирания Flash            -
+ *  -  (опция APP_RAMFUNC)                                   -
+ *  ---------------------------------------------------------
+ *
+ * Пока стирается сектор конфигурации (1..2 с на 128 КБ), любая выборка из Flash
+ * останавливает шину до конца операции. Поэтому без опции APP_Save_CFG_Flash()
+ * запрещает все прерывания: индикатор гаснет, кнопка не опрашивается, тик стоит.
+ *
+ * С опцией APP_RAMFUNC функции с APP_RAMCODE и таблицы с APP_RAMCONST попадают
+ * в выходную секцию .ramfunc (STM32F401XX_FLASH.ld): она лежит во Flash после кода,
+ * стартовый код копирует её в ОЗУ, как .data. Таблица векторов тоже копируется
+ * в ОЗУ (App_RamFunc_Init() в начале main(), SCB->VTOR). В ОЗУ вынесено:
+ *   - прерывание TIM3 до записи в BSRR: TIM3_IRQHandler, HAL_TIM_PeriodElapsedCallback,
+ *     Seg7_UpdateIndicator и таблицы шаблонов/кадров драйвера индикатора;
+ *   - SysTick с шагом кнопки: SysTick_Handler, HAL_IncTick/HAL_GetTick (AppRamFunc.c),
+ *     HAL_SYSTICK_Callback, Button_Poll_1ms, App_Profile_End;
+ *   - внутренние циклы драйвера Flash: пуск стирания с ожиданием BSY и цикл записи
+ *     слов (Boot/Src/BootFlash.c).
+ * На время стирания и записи в NVIC разрешён только TIM3 (App_RamFunc_Irq_Only());
+ * SysTick - системное исключение, он работает всегда. Остальные прерывания ждут
+ * в состоянии pending, как раньше ждали за __disable_irq().
+ *
+ * Условия (проверяет CMakeLists.txt): суперцикл, APP_LL_GPIO/TIM/FLASH (вызовы HAL
+ * остались бы во Flash), сборка с оптимизацией - static inline помощники (LL, AppAtomic.h,
+ * Seg7_Snapshot, Button_Read_Raw) должны встроиться в функции ОЗУ, а не лечь отдельной
+ * копией в .text. Поэтому APP_RAMCODE ставится только на функции, которые вызываются
+ * извне (обработчики, функции модулей), а не на static inline помощники.
+ * После сборки tools/ramfunc_report.py печатает цену в ОЗУ по функциям и останавливает
+ * сборку, если функция из .ramfunc вызывает код во Flash.
+ *
+ * Без опции макросы пустые: код и таблицы остаются во Flash.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+/** Частные макроопределения */
+#ifdef APP_RAMFUNC
+#ifndef __OPTIMIZE__
+#error "APP_RAMFUNC needs an optimised build: inline helpers of the RAM functions would stay in flash"
+#endif
+/// Функция выполняется из ОЗУ; noinline - иначе компилятор встроит её в вызывающий код во Flash
+#define APP_RAMCODE   __attribute__((section(".ramfunc"), noinline))
+#define APP_RAMCONST  __attribute__((section(".ramfunc.rodata")))   /// Таблица читается из ОЗУ
+#else
+#define APP_RAMCODE
+#define APP_RAMCONST
+#endif
+
+#define APP_RAMFUNC_NVIC_WORDS  (((uint32_t)SPI4_IRQn + 32u) / 32u)   /// Слов ISER/ICER у STM32F401
+#define APP_RAMFUNC_VECTORS     (16u + (uint32_t)SPI4_IRQn + 1u)      /// Исключения ядра + IRQ
+
+/** Прототипы функций **/
+#ifdef APP_RAMFUNC
+void App_RamFunc_Init        (void);
+void App_RamFunc_Irq_Only    (IRQn_Type irq, uint32_t saved[APP_RAMFUNC_NVIC_WORDS]);
+void App_RamFunc_Irq_Restore (const uint32_t saved[APP_RAMFUNC_NVIC_WORDS]);
+#endif
+
+#endif //INC_7_SEG_APPRAMFUNC_H
@@ -0,0 +1,111 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_APPSCHEDULE_H
+#define INC_7_SEG_APPSCHEDULE_H
+
+/**
+ *  ------------------------------------------------------
+ *  - Недельное расписание запусков по RTC и сон STOP     -
+ *  ------------------------------------------------------
+ *
+ * Расписание - SCHEDULE_ENTRIES слов в записи конфигурации (AppFlashConfig_t::sched):
+ *
+ *   биты 0..10  - минута суток (0..1439);
+ *   биты 11..17 - дни недели, бит 0 - понедельник ... бит 6 - воскресенье;
+ *   остальные   - 0. Запись без дней (в т.ч. слово 0) не используется.
+ *
+ * Запуск по расписанию - событие EVENT_SCHEDULE: в READY оно открывает клапан
+ * на cfg_sec, как короткое нажатие. В остальных состояниях и при перегреве
+ * пропускается (автомат занят - повторять некогда, следующий запуск - по расписанию).
+ *
+ * RTC (stm32f4xx_hal_rtc.c, тактирование LSE 32768 Гц, без кварца - LSI) хранит
+ * день недели и время суток в домене резервного питания - сброс МК их не теряет.
+ * Будильник A взведён на ближайшую запись: полное совпадение дня недели, часа и
+ * минуты, поэтому он срабатывает только в нужную минуту недели и будит из STOP.
+ *
+ * Сон: суперцикл после SCHEDULE_IDLE_MS простоя в READY гасит индикатор и
+ * вызывает Schedule_Stop(). Будят будильник (EXTI 17) и любой фронт кнопки K1
+ * (EXTI 10). После пробуждения тактирование восстанавливается (PLL), и цикл
+ * продолжает с того же места; сработавший будильник сразу даёт EVENT_SCHEDULE.
+ *
+ * Хост-порт (SCHEDULE_PORT_HOST, без HAL): RTC заменён моделью дня недели и
+ * времени с тем же будильником; Schedule_Host_Sleep() - "сон" до будильника,
+ * так что год расписания проверяется за доли секунды:
+ *
+ *   cc -DSCHEDULE_PORT_HOST -ICore/Inc Core/Src/AppSchedule.c my_test.c
+ *
+ * Так собран тест test/test_schedule.c (CTest).
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#ifndef SCHEDULE_PORT_HOST
+#include "stm32f4xx_hal.h"
+#endif
+
+/** Частные макроопределения */
+#define SCHEDULE_ENTRIES      (8u)                  /// Записей расписания
+#define SCHEDULE_DAY_MINUTES  (1440u)
+#define SCHEDULE_WEEK_MINUTES (7u * SCHEDULE_DAY_MINUTES)
+#define SCHEDULE_IDLE_MS      (60000u)              /// Простой в READY до сна STOP
+
+#define SCHEDULE_MINUTE_MASK  (0x7FFu)
+#define SCHEDULE_DAYS_POS     (11u)
+#define SCHEDULE_DAYS_MASK    (0x7Fu)
+
+#define SCHEDULE_MONDAY       (0x01u)               /// Маски дней
+#define SCHEDULE_WORKDAYS     (0x1Fu)
+#define SCHEDULE_WEEKEND      (0x60u)
+#define SCHEDULE_EVERY_DAY    (0x7Fu)
+
+/** -- Запись: дни (маска), часы, минуты -- */
+#define SCHEDULE_ENTRY(days, hour, minute) \
+  ((((uint32_t)(days) & SCHEDULE_DAYS_MASK) << SCHEDULE_DAYS_POS) | ((uint32_t)(hour) * 60u + (uint32_t)(minute)))
+
+/** -- Ведомый Modbus должен отвечать всегда: STOP останавливает USART6 -- */
+#ifdef MODBUS_RTU
+#define SCHEDULE_STOP_ENABLED (0)
+#else
+#define SCHEDULE_STOP_ENABLED (1)
+#endif
+
+/** Структуры */
+
+/**
+ * @brief Время недели
+ */
+typedef struct {
+  uint8_t weekday;   /// 1 - понедельник ... 7 - воскресенье (как RTC_WEEKDAY_*)
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t second;
+} Schedule_Time_t;
+
+/** -- Проверка записи: 1 - допустима (в т.ч. пустая) -- */
+static inline uint8_t Schedule_Entry_Valid(const uint32_t entry)
+{
+  return ((entry >> (SCHEDULE_DAYS_POS + 7u)) == 0u &&
+          (entry & SCHEDULE_MINUTE_MASK) < SCHEDULE_DAY_MINUTES) ? 1u : 0u;
+}
+
+/** Прототипы функций **/
+uint32_t Schedule_Minute_Of_Week(const Schedule_Time_t *time);
+uint8_t  Schedule_Next          (const uint32_t *entries, uint32_t count, uint32_t after, uint32_t *next);
+
+void     Schedule_Init          (const uint32_t *entries);
+void     Schedule_Rearm         (void);
+uint8_t  Schedule_Take_Alarm    (void);
+void     Schedule_Get_Time      (Schedule_Time_t *time);
+void     Schedule_Set_Time      (const Schedule_Time_t *time);
+
+#ifdef SCHEDULE_PORT_HOST
+uint32_t Schedule_Host_Sleep    (uint32_t max_s);
+#else
+void     Schedule_Stop          (void);
+void     Schedule_Rtc_IRQHandler(void);
+void     Schedule_Button_IRQHandler(void);
+#endif
+
+#endif //INC_7_SEG_APPSCHEDULE_H
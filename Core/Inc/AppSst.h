@@ -0,0 +1,82 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_APPSST_H
+#define INC_7_SEG_APPSST_H
+
+/**
+ *  ------------------------------------------------------
+ *  - Модули приложения как активные объекты SST         -
+ *  ------------------------------------------------------
+ *
+ * Собирается при APP_SST (опция CMake APP_SST=ON), ядро - Sst.h. main() выполняет ту
+ * же инициализацию, что и в сборке с суперциклом, и вызывает App_Sst_Start().
+ * Приоритеты NVIC (меньше - важнее), все на одном стеке:
+ *
+ *   0  TIM3        - мультиплекс Seg7: его период задаёт таймер, объект без очереди;
+ *   1  SysTick     - источник времени: тик кнопке, секунда и опрос автомату,
+ *                    шаг проверки образа объекту flash;
+ *   2-3            - ADC/DMA, USART6, TIM4 - как в остальных сборках;
+ *   4  button      - шаг Button_Poll_1ms(), событие кнопки -> machine;
+ *   5  machine     - владелец автомата: события, секундный тик, датчики, отказ
+ *                    катушки, Modbus (контекст автомата меняет только он - без мьютексов);
+ *   14 flash       - запись конфигурации (APP_SAVE_CFG()) и порции проверки образа;
+ *   основной цикл  - дамп отказа в USART1 и сон в WFI.
+ *
+ * Долгая работа flash (CRC, сравнение, подготовка записи) вытесняется кнопкой и
+ * автоматом. Стирание сектора останавливает выборку из Flash (один банк) и идёт с
+ * запрещёнными прерываниями - его длительность одинакова во всех сборках.
+ *
+ * Векторы задач - прерывания I2C1/I2C2, периферия I2C в проекте не используется.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+#include "State_Machine.h"
+#include "Sst.h"
+
+/** Частные макроопределения */
+#define APP_SST_PRIO_TICK     (1u)     /// SysTick: выше всех задач, HAL_GetTick() идёт и внутри них
+#define APP_SST_PRIO_BUTTON   (4u)
+#define APP_SST_PRIO_MACHINE  (5u)
+#define APP_SST_PRIO_FLASH    (14u)
+
+#define APP_SST_IRQ_BUTTON    (I2C1_EV_IRQn)
+#define APP_SST_IRQ_MACHINE   (I2C1_ER_IRQn)
+#define APP_SST_IRQ_FLASH     (I2C2_EV_IRQn)
+
+#define APP_SST_DEPTH_BUTTON  (4u)     /// Событий в очередях (степень двойки)
+#define APP_SST_DEPTH_MACHINE (8u)
+#define APP_SST_DEPTH_FLASH   (4u)
+
+#define APP_SST_POLL_MS       (5u)     /// Опрос датчиков, катушки и Modbus в machine
+
+/** Перечисления */
+
+/**
+ * @brief Сигналы событий приложения
+ */
+typedef enum {
+  APP_SIG_TICK     = 0,   /// button:  миллисекунда
+  APP_SIG_EVENT    = 1,   /// machine: событие автомата (par = MachineEvent_t)
+  APP_SIG_TICK_1S  = 2,   /// machine: секундный тик
+  APP_SIG_POLL     = 3,   /// machine: датчики, катушка, Modbus
+  APP_SIG_FAULT    = 4,   /// machine: авария от другого объекта (par = MachineFault_t)
+  APP_SIG_SAVE     = 5,   /// flash:   записать GlobalAppConfig
+  APP_SIG_FW_STEP  = 6    /// flash:   порция проверки образа
+} AppSst_Signal_t;
+
+/** Типы */
+typedef void (*AppSst_Dispatch_t)(MachineEvent_t event);   /// Передача события автомату с трассой
+
+/** Прототипы функций **/
+void App_Sst_Start             (MachineState_Context_t *ctx, AppSst_Dispatch_t dispatch) __attribute__((noreturn));
+void App_Sst_Request_Save      (void);
+void App_Sst_Tick_IRQHandler   (void);
+void App_Sst_Button_IRQHandler (void);
+void App_Sst_Machine_IRQHandler(void);
+void App_Sst_Flash_IRQHandler  (void);
+
+#endif //INC_7_SEG_APPSST_H
@@ -0,0 +1,80 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_APPTASKS_H
+#define INC_7_SEG_APPTASKS_H
+
+/**
+ *  -------------------------------------------------
+ *  - Потоки CMSIS-RTOS2 вместо суперцикла           -
+ *  -------------------------------------------------
+ *
+ * Собирается при APP_RTOS2 (опция CMake APP_RTOS2=ON, ядро RTX5 - RTOS2_RTX_DIR).
+ * main() выполняет ту же инициализацию, что и в сборке с суперциклом, и вызывает
+ * App_Tasks_Start() - дальше работают потоки (приоритет по убыванию):
+ *
+ *   input     - опрос кнопки строго раз в тик (osDelayUntil), пока идёт антидребезг или удержание,
+ *               события -> очередь автомата; кнопка в покое - ждёт фронт K1 (EXTI 10) без таймаута;
+ *   control   - владелец автомата: события из очереди, секундный тик, датчики, отказ катушки;
+ *   telemetry - Modbus и дамп отказа, раз в APP_TASKS_TELEMETRY_MS;
+ *   persist   - порции проверки образа (раз в тик на проходе, затем FW_CHECK_PERIOD_MS сна)
+ *               и запись конфигурации во Flash по запросу (очередь).
+ *
+ * Контекст автомата защищён мьютексом (control и telemetry). Запись конфигурации из автомата
+ * и Modbus идёт через APP_SAVE_CFG() -> очередь persist, так что расчёт CRC и подготовка записи
+ * не задерживают ни кнопку, ни автомат. Стирание сектора само по себе останавливает выборку
+ * команд из Flash (один банк) - его длительность одинакова в обеих сборках.
+ *
+ * Потока display нет: мультиплекс индикатора остаётся в прерывании TIM3, его период задаёт
+ * аппаратный таймер. Поток дрожал бы на время работы input и control, переключал бы контекст
+ * дважды на каждый шаг и будил бы ядро из tickless-сна каждые 4.2 мс. Вид индикатора меняет
+ * control (сеттеры Seg7_* из автомата), TIM3 читает целый снимок под seqlock (7_seg_driver.c).
+ *
+ * Тик ядра - SysTick через интерфейс os_tick (os_systick.c). Поток простоя - tickless:
+ * osKernelSuspend(), сон в WFI до ближайшего таймаута ядра по TIM10 (шаг 10 мкс),
+ * osKernelResume() с числом прошедших тиков. HAL_GetTick() в этой сборке - счётчик тиков ядра.
+ * В покое ближайший таймаут - секундный тик control (или telemetry): ядро не тикает до него,
+ * WFI прерывает только TIM3 мультиплекса (4.2 мс). Статистика сна - App_Tasks_Idle (отладчиком,
+ * как App_Profile); хост-прогон с моделью ядра - test/profile_host.c.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+#include "State_Machine.h"
+
+/** Частные макроопределения */
+#ifdef MODBUS_RTU
+#define APP_TASKS_TELEMETRY_MS  (5u)     /// Период потока telemetry: кадры Modbus
+#else
+#define APP_TASKS_TELEMETRY_MS  (100u)   /// Период потока telemetry: только дамп отказа
+#endif
+#define APP_TASKS_SENSE_MS      (10u)    /// Опрос датчиков и тиков регулятора в потоке control
+#define APP_TASKS_QUEUE_DEPTH   (8u)     /// Сообщений в очереди автомата
+#define APP_TASKS_IDLE_STEP_US  (10u)    /// Шаг счёта TIM10 во сне
+#define APP_TASKS_K1_IRQ_PRIO   (5u)     /// EXTI15_10: фронт K1 будит поток input
+
+/** Типы */
+typedef void (*AppTasks_Dispatch_t)(MachineEvent_t event);   /// Передача события автомату с трассой
+
+/**
+ * @brief Статистика tickless-сна потока простоя
+ */
+typedef struct {
+  uint32_t sleeps;        /// Засыпаний в WFI
+  uint32_t busy;          /// osKernelSuspend() вернул 0 - сна не было
+  uint32_t max_ticks;     /// Самый длинный интервал от osKernelSuspend(), тики
+  uint32_t max_slept;     /// Самый длинный сон за одно WFI, тики
+  uint32_t slept_ticks;   /// Всего проспано с выключенным тиком ядра, тики
+} AppTasks_Idle_t;
+
+extern AppTasks_Idle_t App_Tasks_Idle;
+
+/** Прототипы функций **/
+void App_Tasks_Start          (MachineState_Context_t *ctx, AppTasks_Dispatch_t dispatch) __attribute__((noreturn));
+void App_Tasks_Request_Save   (void);
+void App_Tasks_Idle_IRQHandler(void);
+void App_Tasks_Button_IRQHandler(void);
+
+#endif //INC_7_SEG_APPTASKS_H
@@ -0,0 +1,104 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_APPTIME_H
+#define INC_7_SEG_APPTIME_H
+
+/**
+ *  -----------------------------------------------------
+ *  - Монотонное время в микросекундах, 64 бита (TIM5)   -
+ *  -----------------------------------------------------
+ *
+ * HAL_GetTick() - 32 бита миллисекунд: переполняется через 49 суток, а для времени
+ * клапана и замера отклика грубовата. Здесь TIM5 (32 бита, 1 МГц) считает без остановки,
+ * переполнение (раз в 71.6 мин) прибавляет 1 к старшему слову App_Time_Overflows.
+ * Старшее слово и CNT вместе - 64 бита микросекунд, переполнения нет.
+ *
+ * Чтение без блокировок, из прерывания и из основного кода (App_Time_Us()):
+ *   старшее слово -> CNT и флаг UIF -> старшее слово ещё раз.
+ *   - Изменилось - между чтениями выполнилось прерывание TIM5, читаем заново.
+ *   - Не изменилось, но UIF стоит, а CNT в младшей половине - переполнение уже было,
+ *     а прерывание ещё не выполнилось (читатель в прерывании, прерывания запрещены,
+ *     TIM5 замаскирован на время записи Flash): старшее слово + 1. CNT в старшей
+ *     половине - прочитан до переполнения, старшее слово верно.
+ * Прерывание TIM5 - с наивысшим приоритетом: ни один читатель не вытесняет его между
+ * сбросом UIF и записью старшего слова, поэтому seqlock писателю не нужен.
+ * Условие - чтение короче половины периода CNT (35 мин).
+ *
+ * Для коротких интервалов (отклик, метки событий) хватает App_Time_Us32() - только CNT,
+ * разность беззнаковая, верна до 71 мин.
+ *
+ * В STOP (APP_SCHEDULE) TIM5 стоит, как и тик HAL: время сна не считается.
+ *
+ * Хост-порт (APP_TIME_PORT_HOST, вместе с APP_ATOMIC_PORT_HOST; тест - test/test_app_time.c): вместо TIM5 - структура
+ * App_Time_Host_Tim с теми же CNT и SR; тест двигает счётчик, ставит UIF и вызывает
+ * App_Time_IRQHandler() - переходы через переполнение проверяются на ПК.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "AppAtomic.h"
+
+/** Частные макроопределения */
+#define APP_TIME_HZ         (1000000u)   /// Частота счёта TIM5
+#define APP_TIME_IRQ_PRIO   (0u)         /// Наивысший: читатели не вытесняют запись старшего слова
+#define APP_TIME_HALF       (0x80000000u)
+
+#ifdef APP_TIME_PORT_HOST
+/**
+ * @brief Регистры TIM5, нужные чтению (хост-порт)
+ */
+typedef struct {
+  volatile uint32_t CNT;
+  volatile uint32_t SR;
+} AppTime_Tim_t;
+
+extern AppTime_Tim_t App_Time_Host_Tim;
+#define APP_TIME_TIM        (&App_Time_Host_Tim)
+#define APP_TIME_UIF        (1u)
+#else
+#define APP_TIME_TIM        TIM5
+#define APP_TIME_UIF        TIM_SR_UIF
+#endif
+
+/** Внешние переменные */
+extern volatile uint32_t App_Time_Overflows;   /// Старшее слово: пишет только прерывание TIM5
+
+/** Прототипы функций **/
+void     App_Time_Init         (void);
+void     App_Time_IRQHandler   (void);
+uint32_t App_Time_Seconds      (void);
+
+/**
+ * @brief Микросекунды с App_Time_Init(), 64 бита.
+ */
+static inline uint64_t App_Time_Us(void)
+{
+  uint32_t hi;
+  uint32_t lo;
+  uint32_t uif;
+
+  do
+  {
+    hi  = App_Atomic_Load(&App_Time_Overflows);
+    lo  = APP_TIME_TIM->CNT;
+    uif = APP_TIME_TIM->SR & APP_TIME_UIF;
+  } while (App_Atomic_Load(&App_Time_Overflows) != hi);
+
+  if (uif != 0u && lo < APP_TIME_HALF)
+  {
+    hi++;   /// Переполнение уже было, прерывание TIM5 ещё не выполнено
+  }
+  return ((uint64_t)hi << 32) | lo;
+}
+
+/**
+ * @brief Младшие 32 бита микросекунд: метки и интервалы до 71 мин (разность беззнаковая).
+ */
+static inline uint32_t App_Time_Us32(void)
+{
+  return APP_TIME_TIM->CNT;
+}
+
+#endif //INC_7_SEG_APPTIME_H
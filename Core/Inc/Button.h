@@ -51,4 +51,10 @@ void Button_Init(GPIO_TypeDef* gpio_port, uint16_t gpio_pin, const ActiveLevel_t
  */
 MachineEvent_t Button_Poll_1ms(void);
 
+/**
+ * @brief Кнопка в покое: до следующего фронта на выводе шаги опроса ничего не меняют
+ * @retval 1 - уровень устоялся и совпадает с выводом, кнопка отпущена (или долгое уже выдано)
+ */
+uint8_t Button_Is_Idle(void);
+
 #endif //INC_7_SEG_BUTTON_H
\ No newline at end of file
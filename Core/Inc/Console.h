@@ -0,0 +1,118 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_CONSOLE_H
+#define INC_7_SEG_CONSOLE_H
+
+/**
+ *  ------------------------------------------------------
+ *  - Текстовая консоль: USART1, DMA в обе стороны        -
+ *  ------------------------------------------------------
+ *
+ * Ядро консоли: приём, разбор строки и очередь передачи. Команды задаёт
+ * приложение таблицей (AppConsole.c), ядро о них ничего не знает.
+ *
+ * Приём: DMA2 Stream2 (USART1_RX) по кругу пишет в кольцо CONSOLE_RX_RING, прерываний
+ * на байты нет. Console_Poll() из суперцикла ищет конец строки ('\r' или '\n') и
+ * разбирает её на месте: слова - отрезки кольца (Console_Span_t, с переходом через
+ * конец кольца), в буфер строки ничего не копируется. Команда ищется двоичным поиском
+ * в таблице, отсортированной по имени (порядок проверяет Console_Init()).
+ *
+ * За вызов Console_Poll() - не больше одной строки: вставка 64 байт из нескольких
+ * команд разбирается за несколько проходов цикла. Шаг кнопки идёт в SysTick, и консоль
+ * его не задерживает ни при каком объёме ввода - у неё нет своих прерываний.
+ *
+ * Передача: Console_Write() кладёт байты в кольцо CONSOLE_TX_RING и сразу возвращается;
+ * DMA2 Stream7 (USART1_TX) отдаёт непрерывный кусок кольца, следующий кусок запускает
+ * Console_Poll(), когда поток свободен. Не поместившееся в кольцо отбрасывается
+ * (счётчик tx_dropped).
+ *
+ * Хост-порт (CONSOLE_PORT_HOST, без HAL): вместо USART - дескриптор файла (например,
+ * ведущая сторона pty), read() пишет в то же кольцо, что и DMA:
+ *
+ *   cc -DCONSOLE_PORT_HOST -ICore/Inc Core/Src/Console.c my_test.c
+ *
+ * Так собран тест test/test_console.c (CTest): ввод через pty, в том числе вставка
+ * 64 байт разом, и таблица команд AppConsole.c в каждом варианте сборки.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#if defined(CONSOLE_PORT_HOST) && !defined(USE_HAL_DRIVER)   /// С заголовками HAL (test/) - тип оттуда
+typedef enum {
+  HAL_OK      = 0x00U,
+  HAL_ERROR   = 0x01U,
+  HAL_BUSY    = 0x02U,
+  HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+#else
+#include "stm32f4xx_hal.h"
+#endif
+
+/** Частные макроопределения */
+#define CONSOLE_BAUD      (115200u)
+#define CONSOLE_RX_RING   (256u)    /// Кольцо приёма DMA (степень двойки): ~22 мс потока
+#define CONSOLE_TX_RING   (1024u)   /// Очередь передачи (степень двойки): дамп отказа целиком
+#define CONSOLE_LINE_MAX  (80u)     /// Длиннее - строка отбрасывается до конца
+#define CONSOLE_ARGS_MAX  (6u)      /// Слов в строке, включая имя команды
+
+/** Структуры */
+
+/**
+ * @brief Слово строки прямо в кольце приёма
+ */
+typedef struct {
+  uint16_t pos;   /// Начало в кольце (по модулю CONSOLE_RX_RING)
+  uint16_t len;
+} Console_Span_t;
+
+/**
+ * @brief Разобранная строка: arg[0] - имя команды
+ */
+typedef struct {
+  Console_Span_t arg[CONSOLE_ARGS_MAX];
+  uint8_t        count;
+} Console_Args_t;
+
+typedef void (*Console_Handler_t)(const Console_Args_t *args);
+
+/**
+ * @brief Команда (таблица - по возрастанию name, как strcmp)
+ */
+typedef struct {
+  const char        *name;
+  Console_Handler_t  handler;
+  const char        *help;    /// Строка для "help"
+} Console_Cmd_t;
+
+/**
+ * @brief Счётчики консоли
+ */
+typedef struct {
+  uint16_t lines;         /// Строк разобрано
+  uint16_t unknown;       /// Неизвестных команд
+  uint16_t too_long;      /// Строк длиннее CONSOLE_LINE_MAX
+  uint16_t tx_dropped;    /// Байт ответа не поместилось в очередь
+} Console_Stats_t;
+
+/** Прототипы функций **/
+HAL_StatusTypeDef      Console_Init       (const Console_Cmd_t *table, uint32_t count);
+uint8_t                Console_Poll       (void);
+uint8_t                Console_Tx_Idle    (void);
+void                   Console_Write      (const char *data, uint32_t length);
+void                   Console_Puts       (const char *text);
+void                   Console_Put_Uint   (uint32_t value);
+void                   Console_List       (void);
+
+char                   Console_Span_Char  (const Console_Span_t *span, uint32_t index);
+int32_t                Console_Span_Cmp   (const Console_Span_t *span, const char *text);
+uint8_t                Console_Span_Uint  (const Console_Span_t *span, uint32_t *value);
+
+const Console_Stats_t *Console_Get_Stats  (void);
+
+#ifdef CONSOLE_PORT_HOST
+void                   Console_Host_Attach(int fd);
+#endif
+
+#endif //INC_7_SEG_CONSOLE_H
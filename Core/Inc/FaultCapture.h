@@ -0,0 +1,97 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_FAULTCAPTURE_H
+#define INC_7_SEG_FAULTCAPTURE_H
+
+/**
+ *  -------------------------------------------
+ *  - Захват аварийных исключений (post-mortem) -
+ *  -------------------------------------------
+ *
+ * HardFault/MemManage/BusFault/UsageFault сохраняют в секцию .noinit (ОЗУ, не
+ * обнуляется при старте): стековый кадр исключения, регистры CFSR/HFSR/MMFAR/BFAR,
+ * состояние автомата и клапана, последние FAULT_TRACE_DEPTH записей трассы
+ * (MachineTrace.h) - и перезапускают МК.
+ *
+ * После перезапуска приложение стартует в безопасном режиме: клапан закрыт,
+ * на индикаторе "E1x" (x - номер исключения: 3 - HardFault, 4 - MemManage,
+ * 5 - BusFault, 6 - UsageFault), дамп периодически выводится в USART1 (115200 8N1).
+ * MemManage/BusFault/UsageFault включает Fault_Capture_Init() (SHCSR); отказ до неё
+ * приходит как HardFault, и номер для индикатора берётся по CFSR.
+ * Следующий сброс возвращает обычную работу.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stddef.h>
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+#include "MachineTrace.h"
+
+/** Частные макроопределения */
+#define FAULT_DUMP_MAGIC       (0xDEADFA17u)
+#define FAULT_NOINIT_SIZE      (320u)     /// Размер резерва в .noinit (его же резервирует загрузчик), с запасом на 8 разрядов SPI
+#define FAULT_TRACE_DEPTH      (8u)       /// Последних событий автомата в дампе
+#define FAULT_DUMP_PERIOD_MS   (5000u)    /// Период повторной выдачи дампа в безопасном режиме
+
+/**
+ * Вход обработчика отказа: выбор стека (MSP/PSP) по EXC_RETURN и переход в
+ * Fault_Capture_Handler(frame, exc_return). Всё тело naked-обработчиков FaultCapture.c:
+ * до него не должно выполняться ни одной инструкции, меняющей SP, а C-кода в naked-функции
+ * GCC не допускает - поэтому и "b ." (обработчик не возвращается) внутри того же asm.
+ */
+#define FAULT_CAPTURE_ENTRY()                 \
+  __asm volatile (                            \
+    " tst   lr, #4                      \n"   \
+    " ite   eq                          \n"   \
+    " mrseq r0, msp                     \n"   \
+    " mrsne r0, psp                     \n"   \
+    " mov   r1, lr                      \n"   \
+    " b     Fault_Capture_Handler       \n"   \
+    " b     .                           \n"   \
+  )
+
+/** Структуры */
+
+/**
+ * @brief Аппаратный стековый кадр исключения Cortex-M (без FPU-части)
+ */
+typedef struct {
+  uint32_t r0, r1, r2, r3, r12;
+  uint32_t lr;     /// LR прерванного кода
+  uint32_t pc;     /// Адрес инструкции, на которой произошёл отказ
+  uint32_t xpsr;
+} FaultFrame_t;
+
+/**
+ * @brief Дамп отказа в .noinit
+ */
+typedef struct {
+  uint32_t              magic;        /// FAULT_DUMP_MAGIC - дамп действителен
+  uint32_t              exception;    /// Номер исключения (IPSR)
+  FaultFrame_t          frame;        /// Стековый кадр (нули, если SP указывал вне ОЗУ)
+  uint32_t              sp;           /// Адрес кадра
+  uint32_t              exc_return;   /// EXC_RETURN (LR обработчика)
+  uint32_t              cfsr;         /// SCB->CFSR (MMFSR | BFSR | UFSR)
+  uint32_t              hfsr;         /// SCB->HFSR
+  uint32_t              mmfar;        /// SCB->MMFAR
+  uint32_t              bfar;         /// SCB->BFAR
+  uint64_t              t_us;         /// App_Time_Us() в момент отказа (часы трассы)
+  uint8_t               machine_state;
+  uint8_t               valve_state;
+  uint8_t               cfg_sec;
+  uint8_t               trace_count;  /// Действительных записей в trace[]
+  MachineTrace_Record_t trace[FAULT_TRACE_DEPTH];
+  uint32_t              crc32;        /// CRC32 всех предыдущих полей
+} FaultDump_t;
+
+#define FAULT_DUMP_CRC_WORDS   (offsetof(FaultDump_t, crc32) / sizeof(uint32_t))
+
+/** Прототипы функций **/
+uint8_t Fault_Capture_Init    (void);
+uint8_t Fault_Capture_Code    (void);
+void    Fault_Capture_Poll    (void);
+void    Fault_Capture_Handler (const FaultFrame_t *frame, uint32_t exc_return) __attribute__((noreturn, used));
+
+#endif //INC_7_SEG_FAULTCAPTURE_H
@@ -0,0 +1,59 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_FWIMAGECHECK_H
+#define INC_7_SEG_FWIMAGECHECK_H
+
+/**
+ *  -----------------------------------------
+ *  - Контроль целостности образа прошивки  -
+ *  -----------------------------------------
+ *
+ * После линковки tools/fw_image_crc.py записывает в секцию .fw_footer (последняя
+ * секция региона FLASH, см. STM32F401XX_FLASH.ld) длину образа и его CRC32.
+ * Во время работы образ перечитывается фоново небольшими порциями
+ * (FW_CHECK_CHUNK_BYTES за вызов) в свободные проходы суперцикла,
+ * поэтому проверка не задерживает ни старт, ни 1 мс опрос кнопки.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+
+/** Частные макроопределения */
+#define FW_FOOTER_MAGIC        (0x46574352u)  /// "FWCR" - футер заполнен после линковки
+#define FW_FOOTER_UNSEALED     (0xFFFFFFFFu)  /// Значение-заглушка: образ не прошёл пост-обработку
+
+#define FW_CHECK_CHUNK_BYTES   (1024u)        /// Порция проверки за один свободный проход цикла
+#define FW_CHECK_PERIOD_MS     (60000u)       /// Пауза между полными проходами по образу
+
+/** Перечисления */
+
+/**
+ * @brief Результат очередного шага фоновой проверки
+ */
+typedef enum {
+  FW_CHECK_BUSY     = 0,  /// Проход не завершён (или пауза между проходами)
+  FW_CHECK_PASSED   = 1,  /// Полный проход завершён, CRC совпала
+  FW_CHECK_FAILED   = 2,  /// Полный проход завершён, CRC НЕ совпала (или футер испорчен)
+  FW_CHECK_UNSEALED = 3   /// Образ собран без пост-обработки - проверять не с чем
+} FwCheck_Result_t;
+
+/** Структуры */
+
+/**
+ * @brief Футер образа прошивки (секция .fw_footer)
+ */
+typedef struct {
+  uint32_t magic;      /// FW_FOOTER_MAGIC или FW_FOOTER_UNSEALED
+  uint32_t length;     /// Длина образа в байтах от _fw_image_start до футера
+  uint32_t crc32;      /// CRC32 образа (AppCrc.h)
+  uint32_t crc32_inv;  /// Инверсная копия CRC32 - защита самого футера
+} FwFooter_t;
+
+/** Прототипы функций **/
+void             FW_Check_Init (void);
+FwCheck_Result_t FW_Check_Step (void);
+
+#endif //INC_7_SEG_FWIMAGECHECK_H
@@ -0,0 +1,69 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_HUMIDITYCTL_H
+#define INC_7_SEG_HUMIDITYCTL_H
+
+/**
+ *  ------------------------------------------------
+ *  - Регулятор влажности для STATE_AUTO (ПИД + ШИМ) -
+ *  ------------------------------------------------
+ *
+ * Собирается при ROOM_SENSE. Тактирование - TIM4 (HUM_CTL_TICK_HZ): прерывание только
+ * считает тики, суперцикл передаёт их автомату событием EVENT_CONTROL_TICK.
+ *
+ * Клапан модулируется окнами по HUM_CTL_WINDOW_TICKS тиков: в начале окна arm_pid_f32
+ * (инкрементная форма) по ошибке влажности даёт долю открытия u, u ограничивается [0, 1]
+ * и записывается обратно в состояние регулятора (анти-виндап: интеграл не копится,
+ * пока выход в упоре). Время открытия в окне округляется до тика:
+ *   меньше HUM_CTL_MIN_ON_TICKS - клапан в этом окне не открывается,
+ *   не больше окна минус HUM_CTL_MIN_OFF_TICKS - клапан закрывается в каждом окне.
+ * Поэтому клапан переключается не чаще двух раз за окно и открыт не дольше
+ * HUM_CTL_MAX_OPEN_MS подряд (это же проверяет MachineTrace).
+ *
+ * Коэффициенты подобраны по модели парной test/test_humidity.c: этот регулятор и
+ * arm_pid_f32 в замкнутом контуре на ПК (CTest).
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "arm_math.h"
+#include "RoomSense.h"
+
+/** Частные макроопределения */
+#define HUM_CTL_TICK_HZ        (10u)     /// Частота тиков регулятора (TIM4)
+#define HUM_CTL_WINDOW_TICKS   (300u)    /// Окно модуляции: 30 с
+#define HUM_CTL_MIN_ON_TICKS   (20u)     /// Минимальное время открытия: 2 с
+#define HUM_CTL_MIN_OFF_TICKS  (20u)     /// Минимальное время закрытия: 2 с
+#define HUM_CTL_SETPOINT       (ROOM_SENSE_RH_TARGET)  /// Уставка, 0.1 %
+
+#define HUM_CTL_KP             (0.05f)   /// Доля окна на 1 %RH ошибки
+#define HUM_CTL_KI             (0.06f)   /// Интегральная составляющая за окно
+#define HUM_CTL_KD             (0.0f)
+
+#define HUM_CTL_MAX_OPEN_MS    ((HUM_CTL_WINDOW_TICKS - HUM_CTL_MIN_OFF_TICKS) * (1000u / HUM_CTL_TICK_HZ))
+
+/** Структуры */
+
+/**
+ * @brief Состояние регулятора
+ */
+typedef struct {
+  arm_pid_instance_f32 pid;
+  float32_t            duty;      /// Последний выход регулятора, 0..1
+  uint16_t             tick;      /// Позиция в окне
+  uint16_t             on_ticks;  /// Время открытия в текущем окне
+  uint32_t             switches;  /// Переключений клапана (статистика)
+  uint8_t              valve;     /// 1 - клапан открыт
+} HumidityCtl_t;
+
+/** Прототипы функций **/
+void    Humidity_Ctl_Init             (HumidityCtl_t *ctl);
+uint8_t Humidity_Ctl_Step             (HumidityCtl_t *ctl, int16_t rh_dpct);
+
+void    Humidity_Ctl_Timer_Init       (void);
+void    Humidity_Ctl_Timer_IRQHandler (void);
+uint8_t Humidity_Ctl_Take_Tick        (void);
+
+#endif //INC_7_SEG_HUMIDITYCTL_H
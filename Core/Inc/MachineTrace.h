@@ -0,0 +1,93 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_MACHINETRACE_H
+#define INC_7_SEG_MACHINETRACE_H
+
+/**
+ *  ------------------------------------------------
+ *  - Трасса событий машины состояний и её проверка -
+ *  ------------------------------------------------
+ *
+ * Каждое событие, переданное в Machine_Process(), записывается вместе с результатом:
+ * состоянием машины, клапаном и содержимым индикатора. Трасса хранится в кольцевом
+ * буфере в ОЗУ (последние MACHINE_TRACE_DEPTH записей) и читается отладчиком
+ * или через Machine_Trace_Snapshot().
+ *
+ * Тики EVENT_TICK_1S в STATE_READY не записываются: автомат их игнорирует,
+ * поэтому трасса без них воспроизводится так же. Тики регулятора EVENT_CONTROL_TICK
+ * записываются, только если изменили состояние или клапан.
+ *
+ * Метки - App_Time_Us(): 64 бита микросекунд от TIM5, те же часы, что у меток кнопки
+ * и замеров отклика (App_Time_Us32() - их младшие 32 бита), без переполнения.
+ *
+ * Проверка свойств (Machine_Trace_Checker_Step) не обращается к периферии
+ * и работает одинаково на лету (каждая новая запись) и по готовой трассе
+ * (Machine_Trace_Check), в т.ч. вне МК.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "State_Machine.h"
+#include "7_seg_driver.h"
+#include "AppTime.h"
+
+/** Частные макроопределения */
+#define MACHINE_TRACE_DEPTH      (256u)    /// Записей в кольцевом буфере (степень двойки)
+#define MACHINE_TRACE_OPEN_SLACK (1000000u) /// Допуск сверх cfg_sec на открытый клапан, мкс
+#define MACHINE_TRACE_AUTO_OPEN_MS (28000u) /// Наибольшее открытие в STATE_AUTO (= HUM_CTL_MAX_OPEN_MS), мс
+
+/** Перечисления */
+
+/**
+ * @brief Нарушенное свойство трассы
+ */
+typedef enum {
+  TRACE_OK            = 0,  /// Свойства выполняются
+  TRACE_VALVE_TIMEOUT = 1,  /// Клапан открыт дольше cfg_sec + 1 с (в AUTO - дольше окна регулятора)
+  TRACE_CONFIG_EXIT   = 2,  /// Выход из CONFIG не в READY или AUTO
+  TRACE_VALVE_STATE   = 3,  /// Клапан открыт вне COUNTDOWN и AUTO
+  TRACE_TIME_ORDER    = 4   /// Метки времени идут назад
+} MachineTrace_Violation_t;
+
+/** Структуры */
+
+/**
+ * @brief Запись трассы: событие и состояние после его обработки (16 байт при трёх разрядах)
+ */
+typedef struct {
+  uint64_t t_us;                   /// Время события, мкс (App_Time_Us)
+  uint8_t  event;                  /// MachineEvent_t
+  uint8_t  state;                  /// MachineState_t после обработки
+  uint8_t  valve;                  /// Valve_State_t после обработки
+  uint8_t  cur_sec;                /// Текущее значение секунд
+  uint8_t  cfg_sec;                /// Настроенное значение секунд
+  uint8_t  digits[NUMBER_OF_DIG];  /// Шаблоны сегментов индикатора
+} MachineTrace_Record_t;
+
+/**
+ * @brief Состояние проверки свойств между записями
+ */
+typedef struct {
+  uint64_t last_us;     /// Метка времени предыдущей записи
+  uint64_t open_us;     /// Когда открылся клапан
+  uint32_t open_limit;  /// Сколько он может быть открыт, мкс
+  uint8_t  prev_state;  /// Состояние после предыдущей записи
+  uint8_t  valve_open;  /// 1 - клапан открыт
+  uint8_t  started;     /// 1 - была хотя бы одна запись
+} MachineTrace_Checker_t;
+
+/** Прототипы функций **/
+void                     Machine_Trace_Checker_Init (MachineTrace_Checker_t *checker);
+MachineTrace_Violation_t Machine_Trace_Checker_Step (MachineTrace_Checker_t *checker,
+                                                     const MachineTrace_Record_t *record);
+MachineTrace_Violation_t Machine_Trace_Check        (const MachineTrace_Record_t *trace, uint32_t count,
+                                                     uint32_t *bad_index);
+
+MachineTrace_Violation_t Machine_Trace_Record       (uint64_t t_us, MachineEvent_t event,
+                                                     const MachineState_Context_t *ctx,
+                                                     const Seg7_Handle_t *seg7);
+uint32_t                 Machine_Trace_Snapshot     (MachineTrace_Record_t *dst, uint32_t max_count);
+
+#endif //INC_7_SEG_MACHINETRACE_H
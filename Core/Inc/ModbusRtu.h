@@ -0,0 +1,92 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_MODBUSRTU_H
+#define INC_7_SEG_MODBUSRTU_H
+
+/**
+ *  ---------------------------------------------------
+ *  - Modbus RTU slave для системы управления зданием  -
+ *  ---------------------------------------------------
+ *
+ * Собирается при MODBUS_RTU (опция CMake MODBUS_RTU=ON).
+ *
+ * Выводы: PA11 - USART6_TX, PA12 - USART6_RX (AF8), PA8 - DE/~RE драйвера RS-485.
+ * 115200 бод, 8N1 (USART6 на APB2 = 20 МГц).
+ *
+ * Приём: DMA2 Stream1 (USART6_RX) непрерывно пишет в кольцевой буфер, ядро байты не трогает.
+ * Конец кадра - прерывание IDLE (линия свободна один символ): прерывание только запоминает
+ * позицию DMA, разбор кадра (CRC16, адрес, функция) - в Modbus_Poll() из суперцикла.
+ * Передача: DE = 1, ответ отдаёт DMA2 Stream6 (USART6_TX), прерывание TC снимает DE.
+ * Итого на кадр - два прерывания (IDLE и TC), независимо от длины кадра.
+ *
+ * Функции: 0x03 (чтение holding), 0x04 (чтение input), 0x06 и 0x10 (запись holding).
+ * Регистры отображаются таблицами прямо на поля MachineState_Context_t и счётчики шины
+ * (адрес регистра = индекс в таблице):
+ *   holding 0      - cfg_sec (APP_CFG_SEC_MIN..MAX), запись только в STATE_READY,
+ *                    во Flash сохраняется после отправки ответа;
+ *   input   0..6   - состояние, клапан, cur_sec, код аварии, перегрев, влажность 0.1 %,
+ *                    число открытий клапана;
+ *   input   7..10  - кадров обработано, ошибок CRC, ответов-исключений, потерянных кадров;
+ *   input   11     - температура 0.1 °C (только сборка с ROOM_SENSE).
+ *
+ * Тест на ПК: test/test_modbus.c - этот файл без изменений, USART6 и DMA2 - модель на регистрах за pty.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+#include "State_Machine.h"
+
+/** Частные макроопределения */
+#ifndef MODBUS_SLAVE_ADDR
+#define MODBUS_SLAVE_ADDR       (1u)      /// Адрес устройства на шине (1..247)
+#endif
+#define MODBUS_BAUD             (115200u)
+#define MODBUS_RX_RING          (512u)    /// Кольцевой буфер DMA: два кадра максимальной длины
+#define MODBUS_ADU_MAX          (256u)    /// Максимальный кадр RTU: адрес + PDU 253 + CRC
+#define MODBUS_READ_MAX         (125u)    /// Регистров за одно чтение (ограничение протокола)
+#define MODBUS_FRAME_QUEUE      (4u)      /// Концов кадров, ожидающих суперцикл (степень двойки)
+
+#define MODBUS_DE_PORT          (GPIOA)
+#define MODBUS_DE_PIN           (GPIO_PIN_8)
+
+#if (MODBUS_SLAVE_ADDR < 1u) || (MODBUS_SLAVE_ADDR > 247u)
+#error "MODBUS_SLAVE_ADDR must be 1..247"
+#endif
+
+/** Перечисления */
+
+/**
+ * @brief Коды исключений Modbus
+ */
+typedef enum {
+  MODBUS_EX_NONE             = 0x00,
+  MODBUS_EX_ILLEGAL_FUNCTION = 0x01,  /// Функция не поддерживается
+  MODBUS_EX_ILLEGAL_ADDRESS  = 0x02,  /// Регистра нет в таблице
+  MODBUS_EX_ILLEGAL_VALUE    = 0x03,  /// Неверное количество или значение вне диапазона
+  MODBUS_EX_DEVICE_BUSY      = 0x06   /// Запись не в STATE_READY
+} ModbusException_t;
+
+/** Структуры */
+
+/**
+ * @brief Счётчики шины (отображаются в input-регистры 7..10)
+ */
+typedef struct {
+  uint16_t frames;       /// Кадров с верным CRC, адресованных нам или широковещательных
+  uint16_t crc_errors;   /// Кадров с неверным CRC или короче 4 байт
+  uint16_t exceptions;   /// Отправлено ответов-исключений
+  uint16_t overruns;     /// Кадр потерян: очередь MODBUS_FRAME_QUEUE полна (суперцикл не успел)
+} ModbusRtu_Stats_t;
+
+/** Прототипы функций **/
+void                     Modbus_Init         (MachineState_Context_t *ctx);
+void                     Modbus_Poll         (void);
+void                     Modbus_IRQHandler   (void);
+uint16_t                 Modbus_Crc16        (const uint8_t *data, uint32_t length);
+uint32_t                 Modbus_Process      (const uint8_t *request, uint32_t length, uint8_t *response);
+const ModbusRtu_Stats_t *Modbus_Get_Stats    (void);
+
+#endif //INC_7_SEG_MODBUSRTU_H
@@ -0,0 +1,97 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_ROOMSENSE_H
+#define INC_7_SEG_ROOMSENSE_H
+
+/**
+ *  ---------------------------------------------------
+ *  - Температура и влажность парной: АЦП + DMA + DSP  -
+ *  ---------------------------------------------------
+ *
+ * Собирается при ROOM_SENSE (опция CMake ROOM_SENSE=ON). Нужен SPI back-end индикатора
+ * (SEG7_SPI_BACKEND): при прямом подключении PA0..PA7 заняты сегментами, а других
+ * входов ADC1 на плате нет (PB0/PB1 - разряды).
+ *
+ * Входы: PA0 (ADC1_IN0) - делитель с NTC 10 кОм B3950 (NTC к +3.3 В, 10 кОм к земле),
+ *        PA1 (ADC1_IN1) - ратиометрический датчик влажности (HIH-5030: 0.1515 + 0.00636 * RH).
+ *
+ * Сбор: TIM2 (TRGO, 1 кГц) запускает сканирование двух каналов ADC1, DMA2 Stream4
+ * в режиме двойного буфера (DBM) складывает кадры {T, RH} в два блока по
+ * ROOM_SENSE_BLOCK кадров. Прерывание DMA только отмечает готовый блок; суперцикл
+ * (Room_Sense_Poll) проходит по отсчётам блока один раз:
+ *   разделение каналов -> arm_fir_decimate_q15 (ФНЧ, /8) -> arm_mean_q15 ->
+ *   кусочно-линейная калибровка -> события автомата с гистерезисом.
+ * Новые значения - раз в 64 мс; на обработку блока есть всё время заполнения второго.
+ *
+ * Обработка (Room_Sense_Filter_*, Room_Sense_Lut) не обращается к периферии. Весь путь
+ * на синтетических сигналах - test/test_room_sense.c.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "arm_math.h"
+#include "State_Machine.h"
+
+/** Частные макроопределения */
+#define ROOM_SENSE_CHANNELS      (2u)     /// Температура, влажность
+#define ROOM_SENSE_BLOCK         (64u)    /// Кадров в блоке (половине двойного буфера)
+#define ROOM_SENSE_DECIMATE      (8u)     /// Коэффициент прореживания
+#define ROOM_SENSE_FIR_TAPS      (16u)    /// Длина ФНЧ перед прореживанием
+#define ROOM_SENSE_RATE_HZ       (1000u)  /// Частота запуска сканирования (TIM2)
+
+#define ROOM_SENSE_TEMP_LIMIT    (550)    /// Перегрев, 0.1 °C
+#define ROOM_SENSE_TEMP_HYST     (20)     /// Гистерезис снятия перегрева, 0.1 °C
+#define ROOM_SENSE_RH_TARGET     (950)    /// Целевая влажность, 0.1 %
+#define ROOM_SENSE_RH_HYST       (50)     /// Гистерезис повторного срабатывания, 0.1 %
+
+#if defined(ROOM_SENSE) && !defined(SEG7_BACKEND_SPI)
+#error "ROOM_SENSE needs SEG7_BACKEND_SPI: PA0/PA1 are display segments in the direct GPIO build"
+#endif
+
+_Static_assert(ROOM_SENSE_BLOCK % ROOM_SENSE_DECIMATE == 0, "arm_fir_decimate_q15: block must be a multiple of M");
+
+/** Структуры */
+
+/**
+ * @brief Кусочно-линейная таблица калибровки: x по возрастанию (отсчёт q15), y - величина
+ */
+typedef struct {
+  const q15_t   *x;
+  const int16_t *y;
+  uint8_t        count;
+} RoomSense_Lut_t;
+
+/**
+ * @brief Состояние обработки (фильтры, последние значения, флаги событий)
+ */
+typedef struct {
+  arm_fir_decimate_instance_q15 fir      [ROOM_SENSE_CHANNELS];
+  q15_t                         fir_state[ROOM_SENSE_CHANNELS][ROOM_SENSE_FIR_TAPS + ROOM_SENSE_BLOCK - 1u];
+  q15_t                         in       [ROOM_SENSE_BLOCK];                        /// Отсчёты одного канала
+  q15_t                         out      [ROOM_SENSE_BLOCK / ROOM_SENSE_DECIMATE];  /// После прореживания
+  q15_t                         mean     [ROOM_SENSE_CHANNELS];                     /// Среднее за блок
+  int16_t                       temp_dc;     /// Температура, 0.1 °C
+  int16_t                       rh_dpct;     /// Влажность, 0.1 %
+  uint8_t                       valid;       /// Обработан хотя бы один блок
+  uint8_t                       over_temp;   /// Выдано EVENT_OVER_TEMP, ещё не снято
+  uint8_t                       rh_reached;  /// Выдано EVENT_RH_REACHED, влажность не опускалась
+} RoomSense_Filter_t;
+
+/** Прототипы функций **/
+/// Обработка без периферии
+void           Room_Sense_Filter_Init  (RoomSense_Filter_t *filter);
+void           Room_Sense_Filter_Block (RoomSense_Filter_t *filter, const uint16_t *frames);
+MachineEvent_t Room_Sense_Filter_Event (RoomSense_Filter_t *filter);
+int16_t        Room_Sense_Lut          (const RoomSense_Lut_t *lut, q15_t x);
+
+/// Сбор на МК
+void           Room_Sense_Init           (void);
+void           Room_Sense_Pause          (void);
+void           Room_Sense_Resume         (void);
+MachineEvent_t Room_Sense_Poll           (void);
+void           Room_Sense_DMA_IRQHandler (void);
+const RoomSense_Filter_t *Room_Sense_Get (void);
+
+#endif //INC_7_SEG_ROOMSENSE_H
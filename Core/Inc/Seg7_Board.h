@@ -0,0 +1,91 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_SEG7_BOARD_H
+#define INC_7_SEG_SEG7_BOARD_H
+
+/**
+ *  ------------------------------------------
+ *  - Описание платы для драйвера индикатора  -
+ *  ------------------------------------------
+ *
+ * Порты заданы базовыми адресами (*_BASE), биты - номерами: это целые константы,
+ * поэтому разводку можно разобрать препроцессором. Значения должны совпадать
+ * с метками в main.h / 7_Seg.ioc (сверяется _Static_assert в 7_seg_driver.c).
+ *
+ * Если все сегменты A..P на одном порту подряд (в порядке A, B, ... P), а все разряды -
+ * на одном порту, собирается быстрый путь: шаг мультиплексирования - ровно две
+ * 32-битные записи в BSRR (сегменты, затем разряды), без чтения-модификации ODR.
+ * Иначе используется общий путь по массивам дескриптора (Seg7_Init).
+ */
+
+/** Подключение заголовочных файлов */
+#include "stm32f401xc.h"
+
+/** -- Сегменты: A..G, P (точка) -- */
+#define SEG7_SEG_A_PORT   (GPIOA_BASE)
+#define SEG7_SEG_A_BIT    (0)
+#define SEG7_SEG_B_PORT   (GPIOA_BASE)
+#define SEG7_SEG_B_BIT    (1)
+#define SEG7_SEG_C_PORT   (GPIOA_BASE)
+#define SEG7_SEG_C_BIT    (2)
+#define SEG7_SEG_D_PORT   (GPIOA_BASE)
+#define SEG7_SEG_D_BIT    (3)
+#define SEG7_SEG_E_PORT   (GPIOA_BASE)
+#define SEG7_SEG_E_BIT    (4)
+#define SEG7_SEG_F_PORT   (GPIOA_BASE)
+#define SEG7_SEG_F_BIT    (5)
+#define SEG7_SEG_G_PORT   (GPIOA_BASE)
+#define SEG7_SEG_G_BIT    (6)
+#define SEG7_SEG_P_PORT   (GPIOA_BASE)
+#define SEG7_SEG_P_BIT    (7)
+
+/** -- Разряды (ключи): Q1..Q3 -- */
+#define SEG7_DIG_1_PORT   (GPIOB_BASE)
+#define SEG7_DIG_1_BIT    (0)
+#define SEG7_DIG_2_PORT   (GPIOB_BASE)
+#define SEG7_DIG_2_BIT    (1)
+#define SEG7_DIG_3_PORT   (GPIOB_BASE)
+#define SEG7_DIG_3_BIT    (2)
+
+/** -- Разбор разводки -- */
+#if (SEG7_SEG_B_PORT == SEG7_SEG_A_PORT) && (SEG7_SEG_B_BIT == SEG7_SEG_A_BIT + 1) && \
+    (SEG7_SEG_C_PORT == SEG7_SEG_A_PORT) && (SEG7_SEG_C_BIT == SEG7_SEG_A_BIT + 2) && \
+    (SEG7_SEG_D_PORT == SEG7_SEG_A_PORT) && (SEG7_SEG_D_BIT == SEG7_SEG_A_BIT + 3) && \
+    (SEG7_SEG_E_PORT == SEG7_SEG_A_PORT) && (SEG7_SEG_E_BIT == SEG7_SEG_A_BIT + 4) && \
+    (SEG7_SEG_F_PORT == SEG7_SEG_A_PORT) && (SEG7_SEG_F_BIT == SEG7_SEG_A_BIT + 5) && \
+    (SEG7_SEG_G_PORT == SEG7_SEG_A_PORT) && (SEG7_SEG_G_BIT == SEG7_SEG_A_BIT + 6) && \
+    (SEG7_SEG_P_PORT == SEG7_SEG_A_PORT) && (SEG7_SEG_P_BIT == SEG7_SEG_A_BIT + 7)
+#define SEG7_BOARD_SEG_PACKED (1)   /// Байт шаблона ложится в порт сдвигом
+#else
+#define SEG7_BOARD_SEG_PACKED (0)
+#endif
+
+#if (SEG7_DIG_2_PORT == SEG7_DIG_1_PORT) && (SEG7_DIG_3_PORT == SEG7_DIG_1_PORT)
+#define SEG7_BOARD_DIG_SAME_PORT (1)
+#else
+#define SEG7_BOARD_DIG_SAME_PORT (0)
+#endif
+
+#if defined(SEG7_BACKEND_SPI)
+#define SEG7_BOARD_FAST_PATH  (0)   /// Индикатор на 74HC595 (Seg7_Spi.h), выводы GPIO не используются
+#else
+#define SEG7_BOARD_FAST_PATH  (SEG7_BOARD_SEG_PACKED && SEG7_BOARD_DIG_SAME_PORT)
+#endif
+
+/** -- Маски быстрого пути -- */
+#define SEG7_BOARD_SEG_GPIO   ((GPIO_TypeDef *)SEG7_SEG_A_PORT)
+#define SEG7_BOARD_SEG_SHIFT  (SEG7_SEG_A_BIT)
+#define SEG7_BOARD_SEG_MASK   (0xFFu << SEG7_BOARD_SEG_SHIFT)
+
+#define SEG7_BOARD_DIG_GPIO   ((GPIO_TypeDef *)SEG7_DIG_1_PORT)
+#define SEG7_BOARD_DIG_MASK   ((1u << SEG7_DIG_1_BIT) | (1u << SEG7_DIG_2_BIT) | (1u << SEG7_DIG_3_BIT))
+
+/**
+ * @brief Слово BSRR порта разрядов: включить разряд bit, выключить остальные
+ */
+#define SEG7_BOARD_DIG_BSRR(bit) \
+  (((uint32_t)(SEG7_BOARD_DIG_MASK & ~(1u << (bit))) << 16) | (1u << (bit)))
+
+#endif //INC_7_SEG_SEG7_BOARD_H
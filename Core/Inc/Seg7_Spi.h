@@ -0,0 +1,48 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_SEG7_SPI_H
+#define INC_7_SEG_SEG7_SPI_H
+
+/**
+ *  -------------------------------------------------------------
+ *  - Второй back-end индикатора: цепочка 74HC595 по SPI1 + DMA  -
+ *  -------------------------------------------------------------
+ *
+ * Собирается при SEG7_BACKEND_SPI (опция CMake SEG7_SPI_BACKEND=ON).
+ * API Seg7_* не меняется, число разрядов - NUMBER_OF_DIG (до 8).
+ *
+ * Цепочка (первым выдвигается байт самого дальнего регистра):
+ *   MOSI -> [сегменты] -> [разряды] -> [светодиоды состояния]
+ *   кадр SPI: { светодиоды, разряды, сегменты }, старшим битом вперёд.
+ *
+ * Выводы: PB3 - SCK (SPI1, AF5), PB5 - MOSI (SPI1, AF5), PB4 - RCLK (TIM3_CH1, AF2).
+ * PB3 в этой сборке отдан SPI1, поэтому SWO недоступен.
+ *
+ * Шаг мультиплекса (прерывание TIM3 по переполнению): три байта кадра в буфер
+ * и запуск DMA2 Stream3 (SPI1_TX) - одинаково при любом числе разрядов.
+ * Защёлка - аппаратная: TIM3_CH1 в режиме PWM2 даёт фронт RCLK при CNT = CCR1,
+ * т.е. через один такт счётчика (~0.42 мс) после начала передачи, когда кадр уже
+ * целиком в регистрах. Выходы 74HC595 меняются только по этому фронту.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+#include "7_seg_driver.h"
+
+/** Частные макроопределения */
+#define SEG7_SPI_FRAME_BYTES     (3u)   /// Светодиоды, разряды, сегменты
+#define SEG7_SPI_BAUD_DIV        (SPI_CR1_BR_1 | SPI_CR1_BR_0)  /// fPCLK2/16: 20 МГц / 16 = 1.25 МГц, кадр ~20 мкс
+#define SEG7_SPI_LATCH_CCR       (1u)   /// Такт TIM3, на котором защёлкивается кадр
+#define SEG7_SPI_DIGIT_ACTIVE_LOW (0)   /// 1 - ключи разрядов открываются нулём
+
+_Static_assert(NUMBER_OF_DIG <= 8, "SPI back-end: one digit-select byte supports up to 8 digits");
+
+/** Прототипы функций **/
+void Seg7_Spi_Init  (void);
+void Seg7_Spi_Push  (uint8_t digit, uint8_t pattern, uint8_t leds);
+void Seg7_Spi_Off   (void);
+
+#endif //INC_7_SEG_SEG7_SPI_H
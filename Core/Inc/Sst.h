@@ -0,0 +1,109 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_SST_H
+#define INC_7_SEG_SST_H
+
+/**
+ *  ---------------------------------------------------------
+ *  - Ядро активных объектов с выполнением до завершения     -
+ *  ---------------------------------------------------------
+ *
+ * Задача SST - функция-обработчик с собственной очередью событий и приоритетом.
+ * Задача не блокируется и не имеет своего стека: каждое событие обрабатывается
+ * до конца, после чего управление возвращается. Поэтому все задачи и прерывания
+ * работают на одном стеке (MSP), а вытеснение делает сам NVIC:
+ *
+ *   - каждой задаче отдан свободный вектор прерывания (периферия, которой в
+ *     проекте нет), его приоритет NVIC = приоритет задачи;
+ *   - Sst_Post() кладёт событие в очередь и выставляет pending этого вектора;
+ *   - если задача приоритетнее текущего кода, она вытесняет его сразу, иначе
+ *     запускается при возврате из более важной работы (хвостовой вызов NVIC);
+ *   - обработчик вектора вызывает Sst_Task_Activate(): разобрать очередь.
+ *
+ * Один вектор PendSV дал бы только один уровень вытеснения, отдельные векторы
+ * дают столько уровней, сколько задач, без планировщика в программе.
+ *
+ * Очередь - кольцо с номером последовательности в каждой ячейке: писатели
+ * (прерывания и задачи любых приоритетов) резервируют ячейку атомарным
+ * сравнением-обменом индекса (LDREX/STREX), читатель один - сама задача.
+ * Запрета прерываний при отправке нет.
+ *
+ * Хост-порт (SST_PORT_HOST, без HAL): вместо NVIC - маска готовых задач и
+ * текущий приоритет. Отправка задаче важнее текущей выполняет её сразу
+ * (вложенным вызовом), прерывание моделирует Sst_Host_Isr(), - порядок
+ * обработки детерминирован, как на кристалле:
+ *
+ *   cc -DSST_PORT_HOST -ICore/Inc Core/Src/Sst.c my_test.c
+ */
+
+/** Подключение заголовочных файлов */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#ifdef SST_PORT_HOST
+typedef int IRQn_Type;
+typedef enum {
+  HAL_OK      = 0x00U,
+  HAL_ERROR   = 0x01U,
+  HAL_BUSY    = 0x02U,
+  HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+#else
+#include "stm32f4xx_hal.h"
+#endif
+
+/** Частные макроопределения */
+#define SST_HOST_MAX_TASKS   (8u)      /// Задач в хост-порту
+#define SST_HOST_THREAD_PRIO (0xFFu)   /// Приоритет "основного цикла" в хост-порту
+
+/** Структуры */
+
+/**
+ * @brief Событие: передаётся по значению, в очередь копируется целиком
+ */
+typedef struct {
+  uint16_t sig;     /// Сигнал (перечисление приложения)
+  uint16_t par;     /// Параметр сигнала
+  uint32_t stamp;   /// Метка приложения (например, тик выпуска для AppProfile)
+} Sst_Evt_t;
+
+/**
+ * @brief Ячейка очереди
+ */
+typedef struct {
+  atomic_uint seq;  /// Номер последовательности: ячейка свободна / заполнена
+  Sst_Evt_t   evt;
+} Sst_Slot_t;
+
+typedef struct Sst_Task Sst_Task_t;
+typedef void (*Sst_Handler_t)(Sst_Task_t *task, const Sst_Evt_t *evt);
+
+/**
+ * @brief Задача (активный объект)
+ */
+struct Sst_Task {
+  Sst_Handler_t handler;   /// Обработчик события
+  Sst_Slot_t   *ring;      /// Хранилище очереди (размер - степень двойки)
+  uint32_t      mask;      /// Размер очереди - 1
+  atomic_uint   tail;      /// Следующая ячейка для записи (писатели)
+  uint32_t      head;      /// Следующая ячейка для чтения (только сама задача)
+  atomic_uint   lost;      /// Событий потеряно: очередь была полна
+  IRQn_Type     irq;       /// Вектор задачи (хост-порт: номер в таблице)
+  uint8_t       prio;      /// Приоритет NVIC: меньше - важнее
+};
+
+/** Прототипы функций **/
+HAL_StatusTypeDef Sst_Task_Init    (Sst_Task_t *task, Sst_Handler_t handler, Sst_Slot_t *ring,
+                                    uint32_t depth, IRQn_Type irq, uint8_t prio);
+HAL_StatusTypeDef Sst_Post         (Sst_Task_t *task, uint16_t sig, uint16_t par, uint32_t stamp);
+void              Sst_Task_Activate(Sst_Task_t *task);
+
+#ifdef SST_PORT_HOST
+void              Sst_Host_Reset   (void);
+void              Sst_Host_Isr     (uint8_t prio, void (*isr)(void));
+uint8_t           Sst_Host_Current (void);
+#endif
+
+#endif //INC_7_SEG_SST_H
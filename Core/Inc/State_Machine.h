@@ -13,6 +13,7 @@
 /* -- Частные макроопределения -- */
 /* -- Значения по умолчанию -- */
 #define DEFAULT_TIME  (3) /// Значение времени по умолчанию для cfg_sec в Machine_State_Context
+#define CONFIG_ITEM_AUTO (0) /// Пункт "Aut" в CONFIG (cur_sec = 0): вход в STATE_AUTO, только с ROOM_SENSE
 
 /** -- Макроопределения для клапана -- */
 #define VALVE_GPIO_PORT (VALVE_GPIO_Port)  /// Порт клапана
@@ -26,7 +27,9 @@
 typedef enum {
   STATE_READY     = 0, /// Готовность. Ожидание внешнего события.
   STATE_COUNTDOWN = 1, /// Состояние временного исполнения. Обратного отсчёта по заданному таймеру.
-  STATE_CONFIG    = 2  /// Состояние конфигурации параметров машины. (Времени исполнения)
+  STATE_CONFIG    = 2, /// Состояние конфигурации параметров машины. (Времени исполнения)
+  STATE_FAULT     = 3, /// Авария. Клапан заблокирован закрытым, на индикаторе код ошибки.
+  STATE_AUTO      = 4  /// Поддержание влажности регулятором (HumidityCtl.h), только с ROOM_SENSE.
 } MachineState_t;
 
 /**
@@ -37,7 +40,12 @@ typedef enum {
   EVENT_NONE = 0,           /// Нет события (по-умолчанию)
   EVENT_BTN_SHRT_PRESS = 1, /// Короткое нажатие кнопки
   EVENT_BTN_LONG_PRESS = 2, /// Долгое нажатие кнопки
-  EVENT_TICK_1S        = 3  /// 1-секундный тик таймера
+  EVENT_TICK_1S        = 3, /// 1-секундный тик таймера
+  EVENT_OVER_TEMP      = 4, /// Перегрев парной (RoomSense.h): пар не подаётся
+  EVENT_TEMP_OK        = 5, /// Температура опустилась ниже порога с гистерезисом
+  EVENT_RH_REACHED     = 6, /// Влажность достигла цели: дозирование заканчивается досрочно
+  EVENT_CONTROL_TICK   = 7, /// Тик регулятора влажности (TIM4, HUM_CTL_TICK_HZ)
+  EVENT_SCHEDULE       = 8  /// Запуск по расписанию (AppSchedule.h): в READY - как короткое нажатие
 } MachineEvent_t;           /// События для машины состояний
 
 /**
@@ -49,6 +57,21 @@ typedef enum {
   OPEN   = 1     /// Клапана открыт
 } Valve_State_t; /// Состояние клапана
 
+/**
+ * @brief Коды аварий (отображаются на индикаторе как "E" + две цифры)
+ *
+ */
+typedef enum {
+  FAULT_NONE           = 0,  /// Аварии нет
+  FAULT_FW_CRC         = 1,  /// Контрольная сумма образа прошивки во Flash не совпала
+  FAULT_LOGIC          = 2,  /// Нарушено свойство автомата (MachineTrace.h), только отладочная сборка (DEBUG)
+  FAULT_COIL_OPEN      = 3,  /// Обрыв катушки клапана: тока нет (ValveMonitor.h)
+  FAULT_COIL_SHORT     = 4,  /// Замыкание катушки: ток выше допустимого
+  FAULT_COIL_NO_INRUSH = 5,  /// Нет провала тока втягивания: якорь не сдвинулся
+  FAULT_VALVE_DRIVER   = 6,  /// После закрытия ток не пропал: ключ клапана не выключился
+  FAULT_CRASH          = 10  /// Перезапуск после отказа ядра: код = 10 + номер исключения (FaultCapture.h)
+} MachineFault_t;    /// Код аварии
+
 /** Окончание перечислений */
 
 /** Структуры */
@@ -60,6 +83,10 @@ typedef struct {
   Valve_State_t  valve_state  ; /// Текущее состояние клапана
   uint8_t cfg_sec ; /// Настроенное значение времени (секунд) отсчёта
   uint8_t cur_sec ; /// Текущее значение времени (секунд)
+  MachineFault_t fault_code; /// Код аварии (действителен в STATE_FAULT)
+  uint8_t over_temp; /// Перегрев: запуск отсчёта запрещён до EVENT_TEMP_OK
+  int16_t rh_dpct;   /// Последняя измеренная влажность, 0.1 % (вход регулятора в STATE_AUTO)
+  uint16_t valve_opens; /// Открытий клапана с момента запуска (счётчик для Modbus)
 }MachineState_Context_t;
 
 
@@ -69,4 +96,10 @@ typedef struct {
  */
 void Machine_Process (MachineState_Context_t* ctx, MachineEvent_t event);
 
+/**
+ * @brief Перевод машины в аварийное состояние: клапан закрывается, кнопка игнорируется.
+ *        Выход из аварии - только сброс МК.
+ */
+void Machine_Raise_Fault (MachineState_Context_t* ctx, MachineFault_t fault_code);
+
 #endif //INC_7_SEG_STATE_MACHINE_H
\ No newline at end of file
@@ -0,0 +1,87 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef INC_7_SEG_VALVEMONITOR_H
+#define INC_7_SEG_VALVEMONITOR_H
+
+/**
+ *  ---------------------------------------------------------
+ *  - Контроль тока катушки клапана на каждом переключении   -
+ *  ---------------------------------------------------------
+ *
+ * Собирается при VALVE_MONITOR (опция CMake VALVE_MONITOR=ON, нужен SEG7_SPI_BACKEND:
+ * вход PA2 при прямом подключении индикатора занят сегментом C).
+ *
+ * PA2 (ADC1_IN2) - выход усилителя шунта в цепи катушки. Valve_Set() сразу после записи
+ * в PB12 запускает пачку из VALVE_MON_SAMPLES преобразований ADC1 (непрерывный режим,
+ * DMA2 Stream4) - VALVE_MON_BURST_US после фронта. Между переключениями АЦП катушку
+ * не измеряет. При сборке с ROOM_SENSE сбор температуры/влажности на время пачки
+ * приостанавливается (ADC1 и DMA2 Stream4 общие).
+ *
+ * Окно ~2.5 мс рассчитано на быстрый клапан: L/R катушки до ~0.6 мс, якорь трогается
+ * в первые ~1.5 мс. Провал ищется до последней четверти окна, последняя четверть
+ * (1.9..2.5 мс) - ток удержания. Пачка и разбор укладываются в VALVE_MON_DETECT_MAX_US.
+ *
+ * Разбор - в прерывании окончания пачки (arm_max_q15, arm_mean_q15, поиск провала):
+ *   открытие: пик < VALVE_MON_OPEN_MA              -> FAULT_COIL_OPEN  (обрыв)
+ *             пик >= VALVE_MON_SHORT_MA или ток
+ *             удержания > VALVE_MON_HOLD_MAX_MA    -> FAULT_COIL_SHORT (замыкание)
+ *             нет нарастания с нуля или провала
+ *             тока при втягивании якоря            -> FAULT_COIL_NO_INRUSH (якорь не сдвинулся)
+ *   закрытие: ток в конце пачки > VALVE_MON_OPEN_MA -> FAULT_VALVE_DRIVER (ключ не закрылся)
+ * При отказе клапан закрывается прямо в прерывании, код аварии забирает суперцикл.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include "arm_math.h"
+#include "State_Machine.h"
+
+/** Частные макроопределения */
+#define VALVE_MON_SAMPLES        (160u)   /// Отсчётов в пачке
+#define VALVE_MON_SAMPLE_NS      (15600u) /// 144 + 12 тактов АЦП на 10 МГц
+#define VALVE_MON_BURST_US       ((VALVE_MON_SAMPLES * VALVE_MON_SAMPLE_NS) / 1000u)   /// ~2.5 мс
+#define VALVE_MON_ANALYSE_US     (250u)   /// Разбор в прерывании с запасом (~4000 тактов на 20 МГц)
+#define VALVE_MON_DETECT_MAX_US  (3000u)  /// От фронта PB12 до кода отказа
+#define VALVE_MON_DIP_SAMPLES    (VALVE_MON_SAMPLES - VALVE_MON_SAMPLES / 4u)   /// Провал - до окна удержания
+
+#define VALVE_MON_FULL_SCALE_MA  (660u)   /// Ток при полной шкале АЦП (0.1 Ом x 50 -> 3.3 В)
+#define VALVE_MON_OPEN_MA        (30u)    /// Меньше - тока нет (обрыв / клапан обесточен)
+#define VALVE_MON_SHORT_MA       (620u)   /// Пик больше - замыкание катушки
+#define VALVE_MON_HOLD_MAX_MA    (450u)   /// Ток удержания больше - витковое замыкание
+#define VALVE_MON_DIP_PCT        (10u)    /// Провал при втягивании якоря, % от пика
+#define VALVE_MON_RISE_PCT       (50u)    /// Первый отсчёт не выше, % от пика (индуктивное нарастание)
+
+_Static_assert(VALVE_MON_BURST_US + VALVE_MON_ANALYSE_US <= VALVE_MON_DETECT_MAX_US,
+               "valve coil burst and analysis must finish within VALVE_MON_DETECT_MAX_US");
+
+/** Ток в мА -> отсчёт q15 (12 бит << 3) */
+#define VALVE_MON_Q15(ma)        ((q15_t)(((uint32_t)(ma) * 32760u) / VALVE_MON_FULL_SCALE_MA))
+
+#if defined(VALVE_MONITOR) && !defined(SEG7_BACKEND_SPI)
+#error "VALVE_MONITOR needs SEG7_BACKEND_SPI: PA2 is a display segment in the direct GPIO build"
+#endif
+
+/** Структуры */
+
+/**
+ * @brief Результат разбора последней пачки (для отладки)
+ */
+typedef struct {
+  q15_t          peak;       /// Максимум тока
+  q15_t          hold;       /// Среднее последней четверти пачки
+  q15_t          first;      /// Первый отсчёт
+  uint8_t        dip;        /// Найден провал после пика
+  uint8_t        opening;    /// Пачка снята на открытии
+  MachineFault_t fault;      /// FAULT_NONE или код отказа
+} ValveMonitor_Result_t;
+
+/** Прототипы функций **/
+void           Valve_Monitor_Init            (void);
+void           Valve_Monitor_Start           (uint8_t opening);
+uint8_t        Valve_Monitor_DMA_IRQHandler  (void);
+MachineFault_t Valve_Monitor_Poll            (void);
+MachineFault_t Valve_Monitor_Analyse         (ValveMonitor_Result_t *result, q15_t *samples, uint8_t opening);
+
+#endif //INC_7_SEG_VALVEMONITOR_H
@@ -3,7 +3,38 @@
 //
 
 #include "../Inc/7_seg_driver.h"
+#include "Seg7_Board.h"
+#include "main.h"
+#include "AppRamFunc.h"
 #include <string.h>
+#if defined(SEG7_BACKEND_SPI)
+#include "Seg7_Spi.h"
+#endif
+
+/* Описание платы должно совпадать с метками CubeMX (main.h) */
+#define SEG7_BOARD_CHECK(pin, bit) _Static_assert((pin) == (1u << (bit)), "Seg7_Board.h does not match main.h: " #pin)
+SEG7_BOARD_CHECK(A_Pin,  SEG7_SEG_A_BIT);
+SEG7_BOARD_CHECK(B_Pin,  SEG7_SEG_B_BIT);
+SEG7_BOARD_CHECK(C_Pin,  SEG7_SEG_C_BIT);
+SEG7_BOARD_CHECK(D_Pin,  SEG7_SEG_D_BIT);
+SEG7_BOARD_CHECK(E_Pin,  SEG7_SEG_E_BIT);
+SEG7_BOARD_CHECK(F_Pin,  SEG7_SEG_F_BIT);
+SEG7_BOARD_CHECK(G_Pin,  SEG7_SEG_G_BIT);
+SEG7_BOARD_CHECK(P_Pin,  SEG7_SEG_P_BIT);
+SEG7_BOARD_CHECK(Q1_Pin, SEG7_DIG_1_BIT);
+SEG7_BOARD_CHECK(Q2_Pin, SEG7_DIG_2_BIT);
+SEG7_BOARD_CHECK(Q3_Pin, SEG7_DIG_3_BIT);
+
+#if SEG7_BOARD_FAST_PATH
+_Static_assert(NUMBER_OF_DIG == 3, "Seg7_Board.h describes exactly three digits");
+
+/* Слова BSRR порта разрядов для каждого шага: свой разряд включить, остальные выключить */
+APP_RAMCONST static const uint32_t digit_bsrr[NUMBER_OF_DIG] = {
+  [0] = SEG7_BOARD_DIG_BSRR(SEG7_DIG_1_BIT),
+  [1] = SEG7_BOARD_DIG_BSRR(SEG7_DIG_2_BIT),
+  [2] = SEG7_BOARD_DIG_BSRR(SEG7_DIG_3_BIT)
+};
+#endif
 
 /* Segment codes for digits (generic pattern; actual bit mapping depends on PCB wiring) */
 static const uint8_t digits_code[] = {
@@ -19,16 +50,155 @@ static const uint8_t digits_code[] = {
   [9] = 0x6F
 };
 
-/* Примеры символов (если понадобятся позже) /
-static const uint8_t symbols_code[] = {
-  [0] = 0x77, // A
-  [1] = 0x7C, // b
-  [2] = 0x39, // C
-  [3] = 0x5E, // d
-  [4] = 0x79, // E
-  [5] = 0x71, // F
-  [6] = 0x74, // h
-}; */
+/* Код буквы "E" для вывода аварий */
+#define SEG7_CODE_E (0x79u)
+
+/* Шрифт ASCII 0x20..0x7F (бит 0 - A ... бит 6 - G). Буквы, которые на 7 сегментах
+ * не различаются по регистру, рисуются одинаково; неотображаемые символы - пусто. */
+#define SEG7_FONT_FIRST (0x20u)
+static const uint8_t seg7_font[0x80u - SEG7_FONT_FIRST] = {
+  /* ' '  !     "     #     $     %     &     '  */
+  0x00, 0x86, 0x22, 0x00, 0x6D, 0x00, 0x00, 0x02,
+  /*  (   )     *     +     ,     -     .     /  */
+  0x39, 0x0F, 0x00, 0x46, 0x80, 0x40, 0x80, 0x52,
+  /*  0   1     2     3     4     5     6     7  */
+  0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07,
+  /*  8   9     :     ;     <     =     >     ?  */
+  0x7F, 0x6F, 0x00, 0x00, 0x58, 0x48, 0x4C, 0x53,
+  /*  @   A     B     C     D     E     F     G  */
+  0x5F, 0x77, 0x7C, 0x39, 0x5E, 0x79, 0x71, 0x3D,
+  /*  H   I     J     K     L     M     N     O  */
+  0x76, 0x06, 0x1E, 0x75, 0x38, 0x37, 0x37, 0x3F,
+  /*  P   Q     R     S     T     U     V     W  */
+  0x73, 0x67, 0x50, 0x6D, 0x78, 0x3E, 0x3E, 0x7E,
+  /*  X   Y     Z     [     \     ]     ^     _  */
+  0x76, 0x6E, 0x5B, 0x39, 0x64, 0x0F, 0x23, 0x08,
+  /*  `   a     b     c     d     e     f     g  */
+  0x20, 0x5F, 0x7C, 0x58, 0x5E, 0x7B, 0x71, 0x6F,
+  /*  h   i     j     k     l     m     n     o  */
+  0x74, 0x04, 0x0E, 0x75, 0x30, 0x54, 0x54, 0x5C,
+  /*  p   q     r     s     t     u     v     w  */
+  0x73, 0x67, 0x50, 0x6D, 0x78, 0x1C, 0x1C, 0x1C,
+  /*  x   y     z     {     |     }     ~    DEL */
+  0x76, 0x6E, 0x5B, 0x46, 0x30, 0x70, 0x01, 0x00
+};
+
+/* Анимация "бегущий сегмент" в левом разряде: A -> B -> C -> D -> E -> F, 8 циклов (~0.1 с) на кадр.
+ * Остальные разряды показывают digit_buf (например, оставшиеся секунды). */
+APP_RAMCONST static const uint8_t seg7_spinner_frames[][NUMBER_OF_DIG] = {
+  { 0x01, 0, 0 }, { 0x02, 0, 0 }, { 0x04, 0, 0 },
+  { 0x08, 0, 0 }, { 0x10, 0, 0 }, { 0x20, 0, 0 }
+};
+
+APP_RAMCONST const Seg7_Animation_t seg7_anim_spinner = {
+  .frames      = seg7_spinner_frames,
+  .owns        = { 1, 0, 0 },
+  .frame_count = (uint8_t)(sizeof(seg7_spinner_frames) / sizeof(seg7_spinner_frames[0])),
+  .frame_ticks = 8
+};
+
+/* Пустой кадр "ничей": используется, когда анимация не запущена, чтобы в прерывании не было проверки на NULL */
+APP_RAMCONST static const uint8_t seg7_no_frame[NUMBER_OF_DIG] = { 0 };
+
+#if SEG7_BOARD_FAST_PATH
+/* Слово BSRR порта сегментов для каждого из 256 шаблонов: единицы - set, нули - reset */
+#define SEG7_BSRR(p)   (((uint32_t)(p) << SEG7_BOARD_SEG_SHIFT) | \
+                        ((uint32_t)(~(p) & 0xFFu) << (SEG7_BOARD_SEG_SHIFT + 16u)))
+#define SEG7_BSRR4(p)  SEG7_BSRR(p),      SEG7_BSRR((p) + 1),      SEG7_BSRR((p) + 2),      SEG7_BSRR((p) + 3)
+#define SEG7_BSRR16(p) SEG7_BSRR4(p),     SEG7_BSRR4((p) + 4),     SEG7_BSRR4((p) + 8),     SEG7_BSRR4((p) + 12)
+#define SEG7_BSRR64(p) SEG7_BSRR16(p),    SEG7_BSRR16((p) + 16),   SEG7_BSRR16((p) + 32),   SEG7_BSRR16((p) + 48)
+
+APP_RAMCONST static const uint32_t segment_bsrr[256] = {
+  SEG7_BSRR64(0), SEG7_BSRR64(64), SEG7_BSRR64(128), SEG7_BSRR64(192)
+};
+#endif
+
+/**
+ * @brief Publishes the whole view after any change made by a setter.
+ * @details Written under the seqlock in one go: the interrupt either takes the complete new
+ *          view or keeps showing its last complete snapshot - never half a number.
+ */
+static void Seg7_Commit(Seg7_Handle_t* seg7_handle)
+{
+  Seg7_View_t* view = &seg7_handle->view;
+
+  App_Seq_Write_Begin(&seg7_handle->view_lock);
+  for (uint8_t i = 0; i < NUMBER_OF_DIG; ++i)
+  {
+    view->digit[i] = seg7_handle->digit_buf[i];
+    view->blank[i] = (seg7_handle->blink_mask & (1u << i)) ? 0u : seg7_handle->digit_buf[i];
+  }
+  view->blink_mask = seg7_handle->blink_mask;
+  view->leds       = seg7_handle->leds;
+  view->anim       = seg7_handle->anim;
+  App_Seq_Write_End(&seg7_handle->view_lock);
+}
+
+/**
+ * @brief Takes a snapshot of the published view when its version has changed (interrupt side).
+ * @details The setter being preempted is never waited for: if the snapshot is torn,
+ *          the previous one stays and the copy is retried on the next step.
+ */
+static inline void Seg7_Snapshot(Seg7_Handle_t* seg7_handle)
+{
+  const uint32_t seq = App_Seq_Read_Begin(&seg7_handle->view_lock);
+
+  if (seq == seg7_handle->shown_seq)
+  {
+    return;
+  }
+
+  const Seg7_View_t view = seg7_handle->view;
+  if (!App_Seq_Read_Valid(&seg7_handle->view_lock, seq))
+  {
+    return;
+  }
+
+  if (view.anim != seg7_handle->shown.anim)
+  {
+    seg7_handle->anim_index = 0;
+    seg7_handle->anim_hold  = 0;
+    seg7_handle->anim_frame = (view.anim != NULL) ? view.anim->frames[0] : seg7_no_frame;
+    seg7_handle->anim_owns  = (view.anim != NULL) ? view.anim->owns      : seg7_no_frame;
+  }
+  if (view.blink_mask != seg7_handle->shown.blink_mask)
+  {
+    seg7_handle->blink_hold = 0;
+  }
+  if (view.blink_mask == 0u)
+  {
+    seg7_handle->show = seg7_handle->shown.digit;
+  }
+
+  seg7_handle->shown     = view;
+  seg7_handle->shown_seq = seq;
+}
+
+/**
+ * @brief End of a full multiplexing cycle: advances the animation and the blink phase.
+ * @details Only counters and precomputed tables - no pattern arithmetic in the interrupt.
+ */
+static inline void Seg7_CycleEnd(Seg7_Handle_t* seg7_handle)
+{
+  const Seg7_Animation_t* anim = seg7_handle->shown.anim;
+
+  if (anim != NULL && ++seg7_handle->anim_hold >= anim->frame_ticks)
+  {
+    seg7_handle->anim_hold = 0;
+    if (++seg7_handle->anim_index >= anim->frame_count)
+    {
+      seg7_handle->anim_index = 0;
+    }
+    seg7_handle->anim_frame = anim->frames[seg7_handle->anim_index];
+  }
+
+  if (seg7_handle->shown.blink_mask && ++seg7_handle->blink_hold >= SEG7_BLINK_CYCLES)
+  {
+    seg7_handle->blink_hold = 0;
+    seg7_handle->show = (seg7_handle->show == seg7_handle->shown.digit) ? seg7_handle->shown.blank
+                                                                        : seg7_handle->shown.digit;
+  }
+}
 
 /**
  * @brief Initializes the structure that describes the 7-segment indicator.
@@ -50,11 +220,20 @@ void Seg7_Init(
 
   seg7_handle->segment_port     = segment_port;
   seg7_handle->segment_pin_mask = segment_pin_mask;
+  seg7_handle->show             = seg7_handle->shown.digit;
+  seg7_handle->anim_frame       = seg7_no_frame;
+  seg7_handle->anim_owns        = seg7_no_frame;
 
   for (int8_t i = 0; i < NUMBER_OF_DIG; ++i) {
     seg7_handle->digit_ports[i] = digit_ports[i];  /// Rewrite digit ports
     seg7_handle->digit_pins [i] = digit_pins [i];  /// Rewrite digit pins
   }
+
+  Seg7_Commit(seg7_handle);   /// Версия 2: прерывание возьмёт пустой вид при первом шаге
+
+#if defined(SEG7_BACKEND_SPI)
+  Seg7_Spi_Init();
+#endif
 }
 
 /**
@@ -71,6 +250,7 @@ void Seg7_SetNumber(Seg7_Handle_t* seg7_handle, uint16_t input_number)
   if (input_number == 0)
   {
     seg7_handle->digit_buf[NUMBER_OF_DIG - 1] = digits_code[0];
+    Seg7_Commit(seg7_handle);
     return;
   }
 
@@ -81,34 +261,80 @@ void Seg7_SetNumber(Seg7_Handle_t* seg7_handle, uint16_t input_number)
     input_number /= 10;
   }
 
+  Seg7_Commit(seg7_handle);
 }
 
 
-void Seg7_UpdateIndicator(Seg7_Handle_t *seg7_handle)
+/**
+ * @brief Switches every digit and segment output off.
+ * @details Call with TIM3 stopped (before STOP mode the pins keep their levels, one digit
+ *          would stay lit). The view is untouched: once TIM3 runs again the next step shows it.
+ * @param seg7_handle - Pointer to the 7-segment indicator handle structure.
+ */
+void Seg7_Off(Seg7_Handle_t *seg7_handle)
 {
-  /// Off all digits а нужно ли выключать все цифры ?
+#if defined(SEG7_BACKEND_SPI)
+  (void)seg7_handle;
+  Seg7_Spi_Off();
+#else
   for (int8_t i = 0; i < NUMBER_OF_DIG; ++i)
   {
     seg7_handle->digit_ports[i]->BSRR = (uint32_t)seg7_handle->digit_pins[i] << 16;
   }
+  seg7_handle->segment_port->BSRR = (uint32_t)seg7_handle->segment_pin_mask << 16;
+#endif
+}
+
+/**
+ * @brief One multiplexing step: shows the next digit (called from the TIM3 interrupt).
+ * @details Fast path (Seg7_Board.h): exactly two 32-bit BSRR stores - segments, then digits.
+ *          BSRR is write-only, so there is no ODR read-modify-write race with other writers of the port.
+ *          Between the two stores the previous digit shows the new pattern for one bus cycle - not visible.
+ *          SPI back-end (Seg7_Spi.h): one 3-byte DMA frame, latched into the 74HC595 chain by TIM3_CH1.
+ * @param seg7_handle - Pointer to the 7-segment indicator handle structure.
+ */
+APP_RAMCODE void Seg7_UpdateIndicator(Seg7_Handle_t *seg7_handle)
+{
+  Seg7_Snapshot(seg7_handle);
 
   /// Перезапишу в отдельную переменную чтобы проще было работать.
-  uint8_t current_digit = seg7_handle->current_digit;
+  const uint8_t current_digit = seg7_handle->current_digit;
+
+  /// Шаблон разряда: из кадра анимации, если разряд ей занят, иначе из буфера (с учётом мигания)
+  const uint8_t pattern = seg7_handle->anim_owns[current_digit] ? seg7_handle->anim_frame[current_digit]
+                                                                : seg7_handle->show[current_digit];
 
-  /// Очистим биты порта , отвечающие за вывод символа через маску.
-  seg7_handle->segment_port->ODR &= ~seg7_handle->segment_pin_mask;
+#if defined(SEG7_BACKEND_SPI)
+  /// Весь шаг - один кадр в цепочку сдвиговых регистров, цена не зависит от числа разрядов
+  Seg7_Spi_Push(current_digit, pattern, seg7_handle->shown.leds);
+#elif SEG7_BOARD_FAST_PATH
+  /// Сегменты: единицы шаблона - установить, нули - сбросить, одной записью (слово из таблицы)
+  SEG7_BOARD_SEG_GPIO->BSRR = segment_bsrr[pattern];
 
-  /// Запишем биты порта, отвечающие за вывод символа, требуемый символ через маску
-  seg7_handle->segment_port->ODR |= seg7_handle->digit_buf[current_digit] & seg7_handle->segment_pin_mask;
+  /// Разряды: текущий включить, остальные выключить, одной записью
+  SEG7_BOARD_DIG_GPIO->BSRR = digit_bsrr[current_digit];
+#else
+  /// Общий путь: разряды на разных портах - гасим по одному
+  for (int8_t i = 0; i < NUMBER_OF_DIG; ++i)
+  {
+    seg7_handle->digit_ports[i]->BSRR = (uint32_t)seg7_handle->digit_pins[i] << 16;
+  }
+
+  /// Сегменты через BSRR в пределах маски (без чтения-модификации ODR)
+  const uint32_t masked = pattern & seg7_handle->segment_pin_mask;
+  seg7_handle->segment_port->BSRR = masked |
+                                    ((uint32_t)(~masked & seg7_handle->segment_pin_mask) << 16);
 
   /// Включаем текущий транзистор на отображение
   seg7_handle->digit_ports[current_digit]->BSRR = (uint32_t)(seg7_handle->digit_pins[current_digit]);
+#endif
 
   /// Увеличивем значение символа в структуре в пределах количества символов для последующих вызовов
   seg7_handle->current_digit++;
   if (seg7_handle->current_digit >= NUMBER_OF_DIG)
   {
     seg7_handle->current_digit = 0;
+    Seg7_CycleEnd(seg7_handle);
   }
 
 }
@@ -129,4 +355,107 @@ void Seg7_SetDP (Seg7_Handle_t * seg7_handle,const uint8_t digit_index, uint8_t
     seg7_handle->digit_buf[digit_index] &= (uint8_t)~SEG7_DP_BIT;
   }
 
-}
\ No newline at end of file
+  Seg7_Commit(seg7_handle);
+}
+
+/**
+ * @brief Displays a fault code as "E" followed by two decimal digits (e.g. "E01").
+ * @param seg7_handle - Pointer to the 7-segment indicator handle structure.
+ * @param error_code  - Fault code, 0..99
+ */
+void Seg7_SetError(Seg7_Handle_t* seg7_handle, uint8_t error_code)
+{
+  if (error_code > 99u)
+  {
+    error_code = 99u;
+  }
+
+  /// Код аварии показывается один: без мигания и анимации (публикуется вместе с цифрами)
+  seg7_handle->anim       = NULL;
+  seg7_handle->blink_mask = 0;
+
+  /// Разряды между "E" и кодом (NUMBER_OF_DIG > 3) - пустые, а не остаток прежнего числа
+  memset(seg7_handle->digit_buf, 0, sizeof(seg7_handle->digit_buf));
+  seg7_handle->digit_buf[0]                 = SEG7_CODE_E;
+  seg7_handle->digit_buf[NUMBER_OF_DIG - 2] = digits_code[error_code / 10u];
+  seg7_handle->digit_buf[NUMBER_OF_DIG - 1] = digits_code[error_code % 10u];
+  Seg7_Commit(seg7_handle);
+}
+
+/**
+ * @brief Displays a short text, left aligned (e.g. "Err", "CAL", "PUr").
+ * @details A '.' lights the decimal point of the previous character instead of taking a digit.
+ *          Characters outside the font are shown blank.
+ * @param seg7_handle - Pointer to the 7-segment indicator handle structure.
+ * @param text        - Zero-terminated string.
+ */
+void Seg7_SetText(Seg7_Handle_t* seg7_handle, const char* text)
+{
+  uint8_t digit = 0;
+
+  memset(seg7_handle->digit_buf, 0, sizeof(seg7_handle->digit_buf));
+
+  for (; *text != '\0'; ++text)
+  {
+    const uint8_t ch = (uint8_t)*text;
+
+    if (ch == '.' && digit > 0)
+    {
+      seg7_handle->digit_buf[digit - 1] |= SEG7_DP_BIT;
+      continue;
+    }
+    if (digit >= NUMBER_OF_DIG)
+    {
+      break;
+    }
+    seg7_handle->digit_buf[digit++] = (ch >= SEG7_FONT_FIRST && ch < 0x80u) ? seg7_font[ch - SEG7_FONT_FIRST] : 0u;
+  }
+
+  Seg7_Commit(seg7_handle);
+}
+
+/**
+ * @brief Sets which digits blink (bit i - digit i). 0 stops blinking.
+ */
+void Seg7_SetBlink(Seg7_Handle_t* seg7_handle, const uint8_t digit_mask)
+{
+  if (seg7_handle->blink_mask == digit_mask)
+  {
+    return;
+  }
+
+  seg7_handle->blink_mask = digit_mask;
+  Seg7_Commit(seg7_handle);
+}
+
+/**
+ * @brief Starts a precomputed animation (NULL stops it).
+ * @details Calling again with the running animation does not restart it, so the caller
+ *          may set it on every state machine step. The interrupt restarts the frame
+ *          counters when it sees a new animation in the published view.
+ */
+void Seg7_SetAnimation(Seg7_Handle_t* seg7_handle, const Seg7_Animation_t* animation)
+{
+  if (seg7_handle->anim == animation)
+  {
+    return;
+  }
+
+  seg7_handle->anim = animation;
+  Seg7_Commit(seg7_handle);
+}
+
+/**
+ * @brief Sets the status LEDs driven by the third register of the SPI chain.
+ * @details Picked up by the interrupt on the next multiplexing step; ignored by the direct GPIO back-end.
+ */
+void Seg7_SetLeds(Seg7_Handle_t* seg7_handle, const uint8_t led_mask)
+{
+  if (seg7_handle->leds == led_mask)
+  {
+    return;
+  }
+
+  seg7_handle->leds = led_mask;
+  Seg7_Commit(seg7_handle);
+}
@@ -0,0 +1,418 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include <string.h>
+#include "AppBench.h"
+#include "7_seg_driver.h"
+#include "Button.h"
+#include "State_Machine.h"
+#include "AppFlashConfig.h"
+#include "AppCrc.h"
+#include "usart.h"
+
+/** Автомат: состояния и события, для которых есть замер (STATE_AUTO - только с ROOM_SENSE) */
+#define BENCH_STATES      (STATE_FAULT + 1)
+#define BENCH_EVENTS      (EVENT_SCHEDULE + 1)
+
+/** Шагов мультиплекса на проход: полный период мигания */
+#define BENCH_SEG7_STEPS  (2u * SEG7_BLINK_CYCLES * NUMBER_OF_DIG)
+
+/** Шагов калибровочного цикла: его такты - единица, в которой замеры сравниваются между машинами */
+#define BENCH_CALIB_LOOPS (1000u)
+
+/** Порты, снимаемые с тактирования на время замера */
+#define BENCH_GPIO_EN     (RCC_AHB1ENR_GPIOAEN | RCC_AHB1ENR_GPIOBEN)
+
+/** Счётчик тактов и программный запрос прерывания: на ПК (APP_BENCH_PORT_HOST) - средства хоста */
+#ifdef APP_BENCH_PORT_HOST
+#define BENCH_CYCLES()    App_Bench_Host_Cycles()
+#define BENCH_RAISE_IRQ() App_Bench_Host_Raise()
+#else
+#define BENCH_CYCLES()    (DWT->CYCCNT)
+#define BENCH_RAISE_IRQ() (NVIC->STIR = APP_BENCH_IRQ)
+#endif
+
+/**
+ * @brief Замер одного вызова: два чтения счётчика тактов вокруг него, прерывания запрещены.
+ */
+#define BENCH_MEASURE(slot, call)                     \
+  do                                                  \
+  {                                                   \
+    __disable_irq();                                  \
+    const uint32_t bench_t0 = BENCH_CYCLES();         \
+    call;                                             \
+    const uint32_t bench_t1 = BENCH_CYCLES();         \
+    __enable_irq();                                   \
+    App_Bench_Add((slot), bench_t1 - bench_t0);       \
+  } while (0)
+
+static AppBench_Slot_t   bench[APP_BENCH_COUNT];
+static AppBench_Slot_t   bench_machine[BENCH_STATES][BENCH_EVENTS];
+static uint32_t          bench_overhead;     /// Цена пары чтений счётчика без кода между ними
+static volatile uint32_t bench_irq_stamp;    /// Счётчик на входе в обработчик APP_BENCH_IRQ
+static uint32_t          bench_run_cycles;   /// Длительность App_Bench_Run(), из запуска вычитается
+static AppBench_Slot_t   bench_calib;        /// Калибровочный цикл (в начале и в конце прогона)
+static volatile uint32_t bench_calib_sink;   /// Результат цикла, чтобы его не выбросил компилятор
+
+static const char *const bench_names[APP_BENCH_COUNT] = {
+  "seg7_update", "seg7_set_number", "button_poll", "cfg_load", "cfg_save", "isr_entry",
+  "boot/valve_safe", "boot/first_display"
+};
+static const char *const bench_state_names[BENCH_STATES] = { "READY", "COUNTDOWN", "CONFIG", "FAULT" };
+static const char *const bench_event_names[BENCH_EVENTS] = {
+  "NONE", "BTN_SHRT_PRESS", "BTN_LONG_PRESS", "TICK_1S", "OVER_TEMP",
+  "TEMP_OK", "RH_REACHED", "CONTROL_TICK", "SCHEDULE"
+};
+
+/**
+ * @brief Трасса кнопки: уровень на выводе и сколько миллисекунд он держится.
+ * @details Отрезки по 1..3 мс - дребезг контактов; ожидаются одно короткое и одно длинное нажатие.
+ */
+static const struct {
+  uint8_t  level;
+  uint16_t ms;
+} bench_button_trace[] = {
+  { 0,   50 },
+  { 1,    2 }, { 0, 1 }, { 1,    3 }, { 0, 2 }, { 1,  150 },   /// Короткое нажатие
+  { 0,    1 }, { 1, 2 }, { 0,  100 },
+  { 1,    3 }, { 0, 1 }, { 1, 1200 },                          /// Длинное нажатие
+  { 0,    2 }, { 1, 1 }, { 0,  100 },
+};
+
+/**
+ * @brief Учёт одного замера.
+ */
+static void App_Bench_Add(AppBench_Slot_t *slot, uint32_t cycles)
+{
+  cycles = (cycles > bench_overhead) ? cycles - bench_overhead : 0u;
+
+  if (slot->runs == 0u || cycles < slot->min)
+  {
+    slot->min = cycles;
+  }
+  if (cycles > slot->max)
+  {
+    slot->max = cycles;
+  }
+  slot->runs++;
+}
+
+/**
+ * @brief Калибровочный цикл: BENCH_CALIB_LOOPS зависимых шагов линейного конгруэнтного генератора.
+ * @details Пустая asm-вставка держит значение в регистре на каждом шаге - цикл не сворачивается
+ *          и не векторизуется, его такты отражают частоту и конвейер ядра в этом прогоне.
+ */
+static __attribute__((noinline)) uint32_t App_Bench_Calib_Loop(uint32_t x)
+{
+  for (uint32_t i = 0; i < BENCH_CALIB_LOOPS; i++)
+  {
+    x = x * 1664525u + 1013904223u;
+    __asm volatile ("" : "+r" (x));
+  }
+  return x;
+}
+
+/**
+ * @brief Замер калибровочного цикла, минимум копится в bench_calib.
+ */
+static void App_Bench_Calibrate(void)
+{
+  for (uint32_t run = 0; run < APP_BENCH_REPEAT; run++)
+  {
+    BENCH_MEASURE(&bench_calib, bench_calib_sink = App_Bench_Calib_Loop(run));
+  }
+}
+
+/**
+ * @brief Индикатор: шаг мультиплекса и заполнение буфера числом.
+ */
+static void App_Bench_Seg7(void)
+{
+  static Seg7_Handle_t bench_seg7;
+  GPIO_TypeDef  *ports[NUMBER_OF_DIG];
+  uint16_t       pins[NUMBER_OF_DIG];
+
+  for (uint32_t i = 0; i < NUMBER_OF_DIG; i++)
+  {
+    ports[i] = Q1_GPIO_Port;
+    pins[i]  = (uint16_t)(Q1_Pin << i);
+  }
+  Seg7_Init(&bench_seg7, ports, pins, A_GPIO_Port, 0xFF);
+
+  /// Число с мигающим разрядом, затем анимация: оба пути выбора шаблона
+  Seg7_SetNumber(&bench_seg7, 123);
+  Seg7_SetBlink(&bench_seg7, 1u);
+  for (uint32_t i = 0; i < BENCH_SEG7_STEPS; i++)
+  {
+    BENCH_MEASURE(&bench[APP_BENCH_SEG7_UPDATE], Seg7_UpdateIndicator(&bench_seg7));
+  }
+  Seg7_SetBlink(&bench_seg7, 0u);
+  Seg7_SetAnimation(&bench_seg7, &seg7_anim_spinner);
+  for (uint32_t i = 0; i < BENCH_SEG7_STEPS; i++)
+  {
+    BENCH_MEASURE(&bench[APP_BENCH_SEG7_UPDATE], Seg7_UpdateIndicator(&bench_seg7));
+  }
+  Seg7_SetAnimation(&bench_seg7, NULL);
+
+  for (uint16_t number = 0; number < 1000u; number++)
+  {
+    BENCH_MEASURE(&bench[APP_BENCH_SEG7_SET_NUMBER], Seg7_SetNumber(&bench_seg7, number));
+  }
+}
+
+/**
+ * @brief Кнопка: шаг 1 мс на трассе с дребезгом, вывод - порт-заглушка в ОЗУ.
+ */
+static void App_Bench_Button(void)
+{
+  static GPIO_TypeDef bench_port;
+
+  bench_port.IDR = 0;
+  Button_Init(&bench_port, K1_Pin, HIGH);
+
+  for (uint32_t i = 0; i < sizeof(bench_button_trace) / sizeof(bench_button_trace[0]); i++)
+  {
+    bench_port.IDR = bench_button_trace[i].level ? K1_Pin : 0u;
+    for (uint32_t ms = 0; ms < bench_button_trace[i].ms; ms++)
+    {
+      BENCH_MEASURE(&bench[APP_BENCH_BUTTON_POLL], (void)Button_Poll_1ms());
+    }
+  }
+}
+
+/**
+ * @brief Автомат: каждая пара (состояние, событие) из типичного контекста этого состояния.
+ */
+static void App_Bench_Machine(void)
+{
+  for (uint32_t state = 0; state < BENCH_STATES; state++)
+  {
+    for (uint32_t event = 0; event < BENCH_EVENTS; event++)
+    {
+      for (uint32_t run = 0; run < APP_BENCH_REPEAT; run++)
+      {
+        MachineState_Context_t ctx = {
+          .machine_state = (MachineState_t)state,
+          .valve_state   = (state == STATE_COUNTDOWN) ? OPEN : CLOSED,
+          .cfg_sec       = APP_CFG_SEC_MIN,
+          .cur_sec       = APP_CFG_SEC_MIN,   /// В CONFIG долгое нажатие не меняет cfg_sec - без записи во Flash
+          .fault_code    = (state == STATE_FAULT) ? FAULT_LOGIC : FAULT_NONE,
+          .rh_dpct       = 500,
+        };
+        BENCH_MEASURE(&bench_machine[state][event], Machine_Process(&ctx, (MachineEvent_t)event));
+      }
+    }
+  }
+}
+
+/**
+ * @brief Вход в прерывание: программный запрос APP_BENCH_IRQ, остальные прерывания маскированы BASEPRI.
+ */
+static void App_Bench_Isr(void)
+{
+  NVIC_SetPriority(APP_BENCH_IRQ, 0);
+  NVIC_EnableIRQ(APP_BENCH_IRQ);
+  __set_BASEPRI(1u << (8u - __NVIC_PRIO_BITS));   /// Пропускается только приоритет 0
+
+  for (uint32_t run = 0; run < APP_BENCH_REPEAT; run++)
+  {
+    const uint32_t t0 = BENCH_CYCLES();
+    BENCH_RAISE_IRQ();
+    __DSB();
+    __ISB();
+    App_Bench_Add(&bench[APP_BENCH_ISR_ENTRY], bench_irq_stamp - t0);
+  }
+
+  __set_BASEPRI(0);
+  NVIC_DisableIRQ(APP_BENCH_IRQ);
+}
+
+/**
+ * @brief Конфигурация во Flash: загрузка и сохранение без изменений.
+ */
+static void App_Bench_Config(void)
+{
+  APP_CRC_Init();   /// Проверка записи считает CRC32; main() позже инициализирует блок повторно
+
+  if (APP_Check_CFG_Flash() != VALID)
+  {
+    return;         /// Загрузка записала бы запись по умолчанию, а TIM3 ещё не настроен
+  }
+  for (uint32_t run = 0; run < APP_BENCH_REPEAT; run++)
+  {
+    /// CRC может считаться через DMA с ожиданием по HAL_GetTick() - прерывания здесь не запрещаются
+    const uint32_t t0 = BENCH_CYCLES();
+    APP_Load_CFG_Flash();
+    const uint32_t t1 = BENCH_CYCLES();
+    (void)APP_Save_CFG_Flash();
+    const uint32_t t2 = BENCH_CYCLES();
+
+    App_Bench_Add(&bench[APP_BENCH_CFG_LOAD], t1 - t0);
+    App_Bench_Add(&bench[APP_BENCH_CFG_SAVE], t2 - t1);
+  }
+}
+
+/**
+ * @brief Все замеры (до MX_GPIO_Init(), см. AppBench.h).
+ */
+void App_Bench_Run(void)
+{
+  AppBench_Slot_t calibrate = { 0 };
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+  const uint32_t run_t0 = BENCH_CYCLES();
+
+  memset(bench, 0, sizeof(bench));
+  memset(bench_machine, 0, sizeof(bench_machine));
+  memset(&bench_calib, 0, sizeof(bench_calib));
+  bench_overhead = 0;
+  for (uint32_t run = 0; run < APP_BENCH_REPEAT; run++)
+  {
+    BENCH_MEASURE(&calibrate, (void)0);
+  }
+  bench_overhead = calibrate.min;
+  App_Bench_Calibrate();
+
+  /// Записи индикатора и клапана уходят в порты без тактирования - выводы не меняются
+  const uint32_t gpio_en = RCC->AHB1ENR & BENCH_GPIO_EN;
+  RCC->AHB1ENR &= ~BENCH_GPIO_EN;
+  __DSB();
+
+  App_Bench_Seg7();
+  App_Bench_Button();
+  App_Bench_Machine();
+
+  RCC->AHB1ENR |= gpio_en;
+  __DSB();
+
+  App_Bench_Isr();
+  App_Bench_Config();
+  App_Bench_Calibrate();   /// Второй раз - частота могла смениться за прогон, берётся минимум
+
+  bench_run_cycles = BENCH_CYCLES() - run_t0;
+}
+
+/**
+ * @brief Замеры запуска: вызывать сразу после первой картинки и App_Tim3_Start().
+ * @details Один замер на сброс (runs = 1, min = max), цена замера не вычитается.
+ */
+void App_Bench_Boot_Display(void)
+{
+  const uint32_t now = DWT->CYCCNT;
+
+  bench[APP_BENCH_BOOT_VALVE_SAFE] = (AppBench_Slot_t){ 1u, App_Boot_Valve_Cycles, App_Boot_Valve_Cycles };
+  bench[APP_BENCH_BOOT_DISPLAY]    = (AppBench_Slot_t){ 1u, now - bench_run_cycles, now - bench_run_cycles };
+}
+
+/**
+ * @brief Обработчик APP_BENCH_IRQ: только отметка времени входа.
+ */
+void App_Bench_IRQHandler(void)
+{
+  bench_irq_stamp = BENCH_CYCLES();
+}
+
+/**
+ * @brief Запись строки в буфер, возвращает конец.
+ */
+static char *App_Bench_Put_Str(char *dst, const char *src)
+{
+  while (*src)
+  {
+    *dst++ = *src++;
+  }
+  return dst;
+}
+
+/**
+ * @brief Запись беззнакового числа в десятичном виде, возвращает конец.
+ */
+static char *App_Bench_Put_Uint(char *dst, uint32_t value)
+{
+  char     digits[10];
+  uint32_t count = 0;
+
+  do
+  {
+    digits[count++] = (char)('0' + value % 10u);
+    value /= 10u;
+  } while (value != 0u);
+
+  while (count != 0u)
+  {
+    *dst++ = digits[--count];
+  }
+  return dst;
+}
+
+static void App_Bench_Send(char *line, const char *end)
+{
+  HAL_UART_Transmit(&huart1, (uint8_t *)line, (uint16_t)(end - line), 100);
+}
+
+/**
+ * @brief Строка результата: {"name":"<prefix><name>","runs":N,"min":N,"max":N}
+ */
+static void App_Bench_Send_Slot(const char *prefix, const char *name, const AppBench_Slot_t *slot)
+{
+  char  line[96];
+  char *p = line;
+
+  if (slot->runs == 0u)
+  {
+    return;
+  }
+  p = App_Bench_Put_Str(p, "{\"name\":\"");
+  p = App_Bench_Put_Str(p, prefix);
+  p = App_Bench_Put_Str(p, name);
+  p = App_Bench_Put_Str(p, "\",\"runs\":");
+  p = App_Bench_Put_Uint(p, slot->runs);
+  p = App_Bench_Put_Str(p, ",\"min\":");
+  p = App_Bench_Put_Uint(p, slot->min);
+  p = App_Bench_Put_Str(p, ",\"max\":");
+  p = App_Bench_Put_Uint(p, slot->max);
+  p = App_Bench_Put_Str(p, "}\r\n");
+  App_Bench_Send(line, p);
+}
+
+/**
+ * @brief Отчёт в USART1 (блокирующая передача, до запуска консоли и Modbus).
+ */
+void App_Bench_Report(void)
+{
+  char  line[96];
+  char *p = line;
+
+  p = App_Bench_Put_Str(p, "BENCH BEGIN\r\n{\"hclk\":");
+  p = App_Bench_Put_Uint(p, SystemCoreClock);
+  p = App_Bench_Put_Str(p, ",\"overhead\":");
+  p = App_Bench_Put_Uint(p, bench_overhead);
+  p = App_Bench_Put_Str(p, ",\"calib\":");
+  p = App_Bench_Put_Uint(p, bench_calib.min);
+  p = App_Bench_Put_Str(p, ",\"calib_loops\":");
+  p = App_Bench_Put_Uint(p, BENCH_CALIB_LOOPS);
+  p = App_Bench_Put_Str(p, "}\r\n");
+  App_Bench_Send(line, p);
+
+  for (uint32_t id = 0; id < APP_BENCH_COUNT; id++)
+  {
+    App_Bench_Send_Slot("", bench_names[id], &bench[id]);
+  }
+  for (uint32_t state = 0; state < BENCH_STATES; state++)
+  {
+    for (uint32_t event = 0; event < BENCH_EVENTS; event++)
+    {
+      char  prefix[32];   /// "machine/<состояние>/"
+      char *q = App_Bench_Put_Str(prefix, "machine/");
+      q       = App_Bench_Put_Str(q, bench_state_names[state]);
+      *q++    = '/';
+      *q      = '\0';
+      App_Bench_Send_Slot(prefix, bench_event_names[event], &bench_machine[state][event]);
+    }
+  }
+
+  p = App_Bench_Put_Str(line, "BENCH END\r\n");
+  App_Bench_Send(line, p);
+}
@@ -0,0 +1,418 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include "AppConsole.h"
+#include "Console.h"
+#include "AppFlashConfig.h"
+#include "AppTime.h"
+#include "AppCrc.h"
+#ifdef APP_SCHEDULE
+#include "AppSchedule.h"
+#endif
+#if defined(APP_LL_FLASH) || defined(APP_BOOTLOADER)
+#include "BootFlash.h"
+#endif
+#ifdef APP_BOOTLOADER
+#include "BootCtl.h"
+#endif
+
+static MachineState_Context_t *console_ctx;
+static uint8_t                 console_save_cfg;   /// Настройки изменены - сохранить, когда ответ уйдёт
+#ifdef APP_BOOTLOADER
+static uint8_t                 console_reset;      /// Запрошено обновление - сброс, когда ответ уйдёт
+#endif
+
+static const char *const state_names[] = { "READY", "COUNTDOWN", "CONFIG", "FAULT", "AUTO" };
+
+/**
+ * @brief Настройки меняются только в покое, как и по Modbus.
+ * @retval 1 - можно менять.
+ */
+static uint8_t App_Console_Ready(void)
+{
+  if (console_ctx->machine_state != STATE_READY)
+  {
+    Console_Puts("ERR busy, only in READY\r\n");
+    return 0u;
+  }
+  return 1u;
+}
+
+#ifdef APP_SCHEDULE
+/** Две цифры с ведущим нулём */
+static void App_Console_Put_2(const uint32_t value)
+{
+  const char text[2] = { (char)('0' + (value / 10u) % 10u), (char)('0' + value % 10u) };
+  Console_Write(text, sizeof(text));
+}
+
+/**
+ * @brief Время "hh:mm" или "hh:mm:ss" (секунды необязательны).
+ * @retval 1 - разобрано и в допустимых пределах.
+ */
+static uint8_t App_Console_Clock(const Console_Span_t *span, Schedule_Time_t *time)
+{
+  uint32_t parts[3] = { 0, 0, 0 };
+  uint32_t count    = 0;
+  uint32_t digits   = 0;
+
+  for (uint32_t i = 0; i < span->len; i++)
+  {
+    const char c = Console_Span_Char(span, i);
+    if (c == ':' && digits != 0u && count < 2u)
+    {
+      count++;
+      digits = 0;
+    }
+    else if (c >= '0' && c <= '9' && digits < 2u)
+    {
+      parts[count] = parts[count] * 10u + (uint32_t)(c - '0');
+      digits++;
+    }
+    else
+    {
+      return 0u;
+    }
+  }
+  if (digits == 0u || count == 0u || parts[0] > 23u || parts[1] > 59u || parts[2] > 59u)
+  {
+    return 0u;
+  }
+  time->hour   = (uint8_t)parts[0];
+  time->minute = (uint8_t)parts[1];
+  time->second = (uint8_t)parts[2];
+  return 1u;
+}
+
+static void App_Console_Put_Entry(const uint32_t index, const uint32_t entry)
+{
+  Console_Put_Uint(index);
+  Console_Puts(": ");
+  if ((entry >> SCHEDULE_DAYS_POS) == 0u)
+  {
+    Console_Puts("off\r\n");
+    return;
+  }
+  for (uint32_t day = 0; day < 7u; day++)
+  {
+    if (entry & (1uL << (SCHEDULE_DAYS_POS + day)))
+    {
+      Console_Put_Uint(day + 1u);
+    }
+  }
+  Console_Puts(" ");
+  App_Console_Put_2((entry & SCHEDULE_MINUTE_MASK) / 60u);
+  Console_Puts(":");
+  App_Console_Put_2((entry & SCHEDULE_MINUTE_MASK) % 60u);
+  Console_Puts("\r\n");
+}
+
+/**
+ * @brief sched | sched N off | sched N DAYS hh:mm
+ */
+static void App_Console_Sched(const Console_Args_t *args)
+{
+  if (args->count == 1u)
+  {
+    for (uint32_t i = 0; i < SCHEDULE_ENTRIES; i++)
+    {
+      App_Console_Put_Entry(i, GlobalAppConfig.sched[i]);
+    }
+    return;
+  }
+
+  uint32_t index;
+  uint32_t entry = 0;
+  if (!Console_Span_Uint(&args->arg[1], &index) || index >= SCHEDULE_ENTRIES)
+  {
+    Console_Puts("ERR entry index\r\n");
+    return;
+  }
+
+  if (args->count == 3u && Console_Span_Cmp(&args->arg[2], "off") == 0)
+  {
+    entry = 0;
+  }
+  else if (args->count == 4u)
+  {
+    Schedule_Time_t time;
+    uint32_t        days = 0;
+
+    for (uint32_t i = 0; i < args->arg[2].len; i++)
+    {
+      const char c = Console_Span_Char(&args->arg[2], i);
+      if (c < '1' || c > '7')
+      {
+        days = 0;
+        break;
+      }
+      days |= 1uL << (uint32_t)(c - '1');
+    }
+    if (days == 0u || !App_Console_Clock(&args->arg[3], &time) || time.second != 0u)
+    {
+      Console_Puts("ERR usage: sched N DAYS hh:mm\r\n");
+      return;
+    }
+    entry = SCHEDULE_ENTRY(days, time.hour, time.minute);
+  }
+  else
+  {
+    Console_Puts("ERR usage: sched N off | sched N DAYS hh:mm\r\n");
+    return;
+  }
+
+  if (!App_Console_Ready())
+  {
+    return;
+  }
+  GlobalAppConfig.sched[index] = entry;
+  Schedule_Rearm();
+  console_save_cfg = 1;
+  App_Console_Put_Entry(index, entry);
+}
+
+/**
+ * @brief time | time D hh:mm[:ss]
+ */
+static void App_Console_Time(const Console_Args_t *args)
+{
+  Schedule_Time_t time;
+
+  if (args->count == 3u)
+  {
+    uint32_t weekday;
+    if (!Console_Span_Uint(&args->arg[1], &weekday) || weekday < 1u || weekday > 7u ||
+        !App_Console_Clock(&args->arg[2], &time))
+    {
+      Console_Puts("ERR usage: time D hh:mm[:ss]\r\n");
+      return;
+    }
+    time.weekday = (uint8_t)weekday;
+    Schedule_Set_Time(&time);
+  }
+  else if (args->count != 1u)
+  {
+    Console_Puts("ERR usage: time D hh:mm[:ss]\r\n");
+    return;
+  }
+
+  Schedule_Get_Time(&time);
+  Console_Put_Uint(time.weekday);
+  Console_Puts(" ");
+  App_Console_Put_2(time.hour);
+  Console_Puts(":");
+  App_Console_Put_2(time.minute);
+  Console_Puts(":");
+  App_Console_Put_2(time.second);
+  Console_Puts("\r\n");
+}
+#endif /* APP_SCHEDULE */
+
+/**
+ * @brief crc | crc WORDS - такты аппаратного, DMA и программного расчёта CRC (APP_CRC_Benchmark).
+ * @details Блок - начало Flash (загрузчик или прошивка), по умолчанию 1024 слова.
+ */
+static void App_Console_Crc(const Console_Args_t *args)
+{
+  AppCrc_Bench_t result;
+  uint32_t       words = 1024u;
+
+  if (args->count > 2u ||
+      (args->count == 2u && (!Console_Span_Uint(&args->arg[1], &words) || words == 0u || words > 16384u)))
+  {
+    Console_Puts("ERR usage: crc [1..16384]\r\n");
+    return;
+  }
+
+  APP_CRC_Benchmark((const uint32_t *)FLASH_BASE, words, &result);
+  Console_Puts("crc words ");
+  Console_Put_Uint(result.words);
+  Console_Puts(" hw ");
+  Console_Put_Uint(result.cycles_hw);
+  Console_Puts(" dma ");
+  Console_Put_Uint(result.cycles_dma);
+  Console_Puts(" sw ");
+  Console_Put_Uint(result.cycles_sw);
+  Console_Puts(result.match ? " match\r\n" : " MISMATCH\r\n");
+}
+
+#if defined(APP_LL_FLASH) || defined(APP_BOOTLOADER)
+/**
+ * @brief Замер последней записи во Flash драйвером на регистрах (BootFlash.h).
+ */
+static void App_Console_Flash(const Console_Args_t *args)
+{
+  const BootFlash_Stats_t *stats = Boot_Flash_Get_Stats();
+  (void)args;
+
+  Console_Puts("flash x");
+  Console_Put_Uint(8u * BOOT_FLASH_PSIZE_BYTES);
+  Console_Puts(" words ");
+  Console_Put_Uint(stats->words);
+  Console_Puts(" cycles ");
+  Console_Put_Uint(stats->cycles);
+  Console_Puts(" words/ms ");
+  Console_Put_Uint(stats->words_per_ms);
+  Console_Puts(" verify_errors ");
+  Console_Put_Uint(stats->verify_errors);
+
+  /// Последняя запись конфигурации: сколько мультиплекс и тик стояли (0 и рост тиков - APP_RAMFUNC)
+  const AppFlashConfig_Stats_t *cfg = APP_Get_CFG_Stats();
+  Console_Puts("\r\ncfg save cycles ");
+  Console_Put_Uint(cfg->cycles);
+  Console_Puts(" mux_blocked ");
+  Console_Put_Uint(cfg->mux_blocked);
+  Console_Puts(" ticks ");
+  Console_Put_Uint(cfg->ticks);
+  Console_Puts("\r\n");
+}
+#endif
+
+#ifdef APP_BOOTLOADER
+/**
+ * @brief Запрос обновления: запись UPDATE_REQ в журнал и сброс в загрузчик (только в READY).
+ * @details После сброса загрузчик ждёт образ на этом же USART1 (tools/fw_update.py).
+ */
+static void App_Console_Update(const Console_Args_t *args)
+{
+  (void)args;
+  if (!App_Console_Ready())
+  {
+    return;
+  }
+  if (BootCtl_Request_Update() != HAL_OK)
+  {
+    Console_Puts("ERR flash\r\n");
+    return;
+  }
+  Console_Puts("update: reset to bootloader\r\n");
+  console_reset = 1;
+}
+#endif
+
+static void App_Console_Help(const Console_Args_t *args)
+{
+  (void)args;
+  Console_List();
+}
+
+/**
+ * @brief sec | sec S
+ */
+static void App_Console_Sec(const Console_Args_t *args)
+{
+  if (args->count == 2u)
+  {
+    uint32_t value;
+    if (!Console_Span_Uint(&args->arg[1], &value) || value < APP_CFG_SEC_MIN || value > APP_CFG_SEC_MAX)
+    {
+      Console_Puts("ERR range\r\n");
+      return;
+    }
+    if (!App_Console_Ready())
+    {
+      return;
+    }
+    /// Новое cfg_sec индикатор покажет на ближайшем EVENT_TICK_1S
+    console_ctx->cfg_sec = (uint8_t)value;
+    if (GlobalAppConfig.cfg_sec != console_ctx->cfg_sec)
+    {
+      GlobalAppConfig.cfg_sec = console_ctx->cfg_sec;
+      console_save_cfg        = 1;
+    }
+  }
+  else if (args->count != 1u)
+  {
+    Console_Puts("ERR usage: sec [S]\r\n");
+    return;
+  }
+
+  Console_Puts("sec ");
+  Console_Put_Uint(console_ctx->cfg_sec);
+  Console_Puts("\r\n");
+}
+
+static void App_Console_Status(const Console_Args_t *args)
+{
+  const Console_Stats_t *stats = Console_Get_Stats();
+  (void)args;
+
+  Console_Puts("state ");
+  Console_Puts(state_names[console_ctx->machine_state]);
+  Console_Puts(" valve ");
+  Console_Puts(console_ctx->valve_state == OPEN ? "open" : "closed");
+  Console_Puts(" sec ");
+  Console_Put_Uint(console_ctx->cfg_sec);
+  Console_Puts(" cur ");
+  Console_Put_Uint(console_ctx->cur_sec);
+  Console_Puts(" fault ");
+  Console_Put_Uint(console_ctx->fault_code);
+  Console_Puts(" opens ");
+  Console_Put_Uint(console_ctx->valve_opens);
+  Console_Puts(" up ");
+  Console_Put_Uint(App_Time_Seconds());
+  Console_Puts("\r\nconsole lines ");
+  Console_Put_Uint(stats->lines);
+  Console_Puts(" unknown ");
+  Console_Put_Uint(stats->unknown);
+  Console_Puts(" too_long ");
+  Console_Put_Uint(stats->too_long);
+  Console_Puts(" tx_dropped ");
+  Console_Put_Uint(stats->tx_dropped);
+  Console_Puts("\r\n");
+}
+
+/** Таблица команд: строго по возрастанию имени (двоичный поиск, проверяет Console_Init) */
+static const Console_Cmd_t app_commands[] = {
+  { "crc",    App_Console_Crc,    "[WORDS] CRC cycles: hardware, DMA, software table" },
+#if defined(APP_LL_FLASH) || defined(APP_BOOTLOADER)
+  { "flash",  App_Console_Flash,  "last flash write: parallelism, words/ms, verify errors, cfg save stall" },
+#endif
+  { "help",   App_Console_Help,   "list commands" },
+#ifdef APP_SCHEDULE
+  { "sched",  App_Console_Sched,  "[N off | N DAYS hh:mm] dosing schedule" },
+#endif
+  { "sec",    App_Console_Sec,    "[S] dosing time, s" },
+  { "status", App_Console_Status, "machine state, counters, uptime s" },
+#ifdef APP_SCHEDULE
+  { "time",   App_Console_Time,   "[D hh:mm[:ss]] RTC weekday (1 = Mon) and time" },
+#endif
+#ifdef APP_BOOTLOADER
+  { "update", App_Console_Update, "reset to the bootloader and wait for a new image" },
+#endif
+};
+
+void App_Console_Init(MachineState_Context_t *ctx)
+{
+  console_ctx      = ctx;
+  console_save_cfg = 0;
+  if (Console_Init(app_commands, sizeof(app_commands) / sizeof(app_commands[0])) != HAL_OK)
+  {
+    Error_Handler();   /// Таблица не отсортирована - ошибка сборки, а не работы
+  }
+  Console_Puts("\r\nsteam console, type help\r\n");
+}
+
+/**
+ * @brief Шаг консоли из суперцикла.
+ * @retval 1 - оператор за консолью (выполнена строка или ответ ещё уходит).
+ */
+uint8_t App_Console_Poll(void)
+{
+  const uint8_t handled = Console_Poll();
+  const uint8_t idle    = Console_Tx_Idle();
+
+  if (console_save_cfg && idle)
+  {
+    console_save_cfg = 0;
+    APP_SAVE_CFG();
+  }
+#ifdef APP_BOOTLOADER
+  if (console_reset && idle)
+  {
+    NVIC_SystemReset();
+  }
+#endif
+  return (handled || !idle) ? 1u : 0u;
+}
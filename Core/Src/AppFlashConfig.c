@@ -4,10 +4,19 @@
 #include "AppFlashConfig.h"
 #include <string.h>
 #include "tim.h"
+#include "AppCrc.h"
+#include "AppLl.h"
+#include "AppRamFunc.h"
+#ifdef APP_LL_FLASH
+#include "BootFlash.h"
+#endif
 
 /** Глобальная RAM копия данных */
 AppFlashConfig_t GlobalAppConfig;
 
+/** Замер последней записи */
+static AppFlashConfig_Stats_t cfg_stats;
+
 /**
  * @brief Возвращает указатель на структуру конфигурации расположенную во Flash - памяти.
  * @details Static inline — встраивается компилятором для оптимизации производительности
@@ -40,6 +49,11 @@ static Validate_t APP_Check_CFG_Valid(const AppFlashConfig_t *config)
   {
     return INVALID;
   }
+  /// Контрольная сумма всей записи (ловит повреждение любого поля, а не только cfg_sec)
+  if (APP_CRC_Calc((const uint32_t *)config, APP_CFG_CRC_WORDS) != config->crc32)
+  {
+    return INVALID;
+  }
   /// Диапазон минимального значения
   if (config->cfg_sec  < APP_CFG_SEC_MIN)
   {
@@ -55,10 +69,71 @@ static Validate_t APP_Check_CFG_Valid(const AppFlashConfig_t *config)
   {
     return INVALID;
   }
+  /// Записи расписания: минута суток и дни недели в своих полях
+  for (uint32_t i = 0; i < SCHEDULE_ENTRIES; i++)
+  {
+    if (!Schedule_Entry_Valid(config->sched[i]))
+    {
+      return INVALID;
+    }
+  }
   /// Вернуть валидность при успешной проверке
   return VALID;
 }
 
+/**
+ * @brief Проверка записи версии 2 (без расписания, CRC32 сразу за `reserved_1`).
+ * @param config Указатель на конфигурационную структуру для проверки.
+ * @retval Валидность записи версии 2.
+ */
+static Validate_t APP_Check_CFG_V2(const AppFlashConfig_t *config)
+{
+  const uint32_t *words = (const uint32_t *)config;
+
+  if (config->magic   != APP_CFG_MAGIC          ||
+      config->version != APP_CFG_VERSION_V2     ||
+      APP_CRC_Calc(words, APP_CFG_V2_CRC_WORDS) != words[APP_CFG_V2_CRC_WORDS] ||
+      config->cfg_sec  < APP_CFG_SEC_MIN        ||
+      config->cfg_sec  > APP_CFG_SEC_MAX        ||
+      ~config->cfg_sec != config->cfg_sec_inv)
+  {
+    return INVALID;
+  }
+  return VALID;
+}
+
+/**
+ * @brief Проверка записи старого формата (версия 1, без CRC32).
+ * @details Нужна, чтобы после обновления прошивки не терять настройку пользователя:
+ *          такая запись читается один раз при старте и пересохраняется в новом формате.
+ * @param config Указатель на конфигурационную структуру для проверки.
+ * @retval Валидность записи версии 1.
+ */
+static Validate_t APP_Check_CFG_Legacy(const AppFlashConfig_t *config)
+{
+  if (config->magic   != APP_CFG_MAGIC          ||
+      config->version != APP_CFG_VERSION_LEGACY ||
+      config->cfg_sec  < APP_CFG_SEC_MIN        ||
+      config->cfg_sec  > APP_CFG_SEC_MAX        ||
+      ~config->cfg_sec != config->cfg_sec_inv)
+  {
+    return INVALID;
+  }
+  return VALID;
+}
+
+/**
+ * @brief Заполнение служебных полей и расчёт CRC32 записи в RAM-копии.
+ */
+static void APP_Seal_CFG(AppFlashConfig_t *config)
+{
+  config->cfg_sec_inv = ~config->cfg_sec;   // Инверсная копия для контроля целостности данных
+  config->magic       = APP_CFG_MAGIC;      // Магическое число
+  config->version     = APP_CFG_VERSION;    // Версия структуры конфигурации
+  config->reserved_1  = 0u;                 // Обнуление резервного поля
+  config->crc32       = APP_CRC_Calc((const uint32_t *)config, APP_CFG_CRC_WORDS);
+}
+
 /**
  * @brief   Стирает сектор Flash памяти, где хранится конфигурация
  * @details Выполняет полное стирание указанного сектора Flash-памяти.\n
@@ -67,6 +142,10 @@ static Validate_t APP_Check_CFG_Valid(const AppFlashConfig_t *config)
  */
 static HAL_StatusTypeDef APP_Erase_CFG_Flash(void)
 {
+#ifdef APP_LL_FLASH
+  /// Драйвер на регистрах: сброс флагов, SER/STRT и ожидание BSY - внутри
+  return Boot_Flash_Erase(FLASH_CFG_SECTOR);
+#else
   uint32_t Error = 0;                                      // Переменная для хранения кода ошибки
   FLASH_EraseInitTypeDef EraseInitStruct = {0};            // Структура инициализации стирания
 
@@ -97,6 +176,7 @@ static HAL_StatusTypeDef APP_Erase_CFG_Flash(void)
    * @retval Hal_StatusTypeDef - Общий статус операции
    */
   return HAL_FLASHEx_Erase(&EraseInitStruct, &Error);
+#endif
 }
 
 /**
@@ -112,13 +192,17 @@ static HAL_StatusTypeDef APP_Write_CFG_Flash(const AppFlashConfig_t *input_confi
   /// Это необходимо т.к. Flash память программируется словами (32 бита)
   const uint32_t *local_config_pointer = (const uint32_t *)input_config;
 
-  /// Адрес во Flash-памяти, куда будет производиться запись
-  uint32_t address = FLASH_CFG_ADDR;
-
   /// Вычисляем количество 32-битных слов в структуре конфигурации
   /// Деление на 4u (sizeof(uint32_t)) - т.к. работаем с 32-битными словами
   const uint32_t numbers_of_word = (uint32_t)((sizeof(*input_config)+3u)/4u);
 
+#ifdef APP_LL_FLASH
+  /// Одна разблокировка и проверка ошибок на всю запись, между словами - только BSY
+  return Boot_Flash_Program(FLASH_CFG_ADDR, local_config_pointer, numbers_of_word);
+#else
+  /// Адрес во Flash-памяти, куда будет производиться запись
+  uint32_t address = FLASH_CFG_ADDR;
+
   /// Последовательная запись каждого слова конфигурации во Flash
   for (uint32_t i = 0; i < numbers_of_word; i++)
   {
@@ -136,6 +220,7 @@ static HAL_StatusTypeDef APP_Write_CFG_Flash(const AppFlashConfig_t *input_confi
   }
   /// Все слова успешно записаны
   return HAL_OK;
+#endif
 }
 
 /**
@@ -161,12 +246,16 @@ HAL_StatusTypeDef APP_Save_CFG_Flash(void)
   {
     GlobalAppConfig.cfg_sec = APP_CFG_SEC_MAX;  // Защита верхней границы
   }
-  //Установка защитных и служебных полей структуры
-  GlobalAppConfig.cfg_sec_inv = ~GlobalAppConfig.cfg_sec; // Инверсная копия для контроля целостности данных
-  GlobalAppConfig.magic       = APP_CFG_MAGIC;            // Версия структуры конфигурации
-  GlobalAppConfig.version     = APP_CFG_VERSION;          // Обнуление резервных полей
-  GlobalAppConfig.reserved_1  = 0u;
-  GlobalAppConfig.reserved_2  = 0u;
+  for (uint32_t i = 0; i < SCHEDULE_ENTRIES; i++)
+  {
+    if (!Schedule_Entry_Valid(GlobalAppConfig.sched[i]))
+    {
+      GlobalAppConfig.sched[i] = 0u;            // Недопустимая запись расписания - выключена
+    }
+  }
+  // Установка защитных и служебных полей структуры, CRC32 считается последней
+  // (до запрета прерываний: расчёт может идти через DMA с ожиданием по HAL_GetTick)
+  APP_Seal_CFG(&GlobalAppConfig);
 
   // 2. Проверка необходимости записи: избегаем избыточного программирования Flash.
   //    Получаем указатель на текущую конфигурацию во Flash-памяти.
@@ -181,21 +270,37 @@ HAL_StatusTypeDef APP_Save_CFG_Flash(void)
   }
 
   // 3. Подготовка критической секции: атомарный участок кода
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;   // Счётчик тактов для замера записи
+  DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+#ifdef APP_RAMFUNC
+  // Стирание, мультиплекс и тик с кнопкой выполняются из ОЗУ (AppRamFunc.h):
+  // в NVIC остаётся только TIM3, остальные прерывания ждут конца записи
+  uint32_t App_Irq_Saved[APP_RAMFUNC_NVIC_WORDS];
+  App_RamFunc_Irq_Only(TIM3_IRQn, App_Irq_Saved);
+#else
   // На время erase программ выключаем TIM3-IRQ (мультиплекс) и запрещаем прерывания
-  HAL_TIM_Base_Stop_IT(&htim3);
+  App_Tim3_Stop();
   __disable_irq();
+#endif
+  const uint32_t App_Start_Cycles = DWT->CYCCNT;
+  const uint32_t App_Start_Tick   = HAL_GetTick();
 
   // 4.   Работа с памятью
   // 4.1. Разблокировка Flash для последующих операций стирания и записи данных
+  //      (драйвер на регистрах разблокирует и блокирует Flash сам, на каждую операцию)
+#ifdef APP_LL_FLASH
+  HAL_StatusTypeDef App_CurrStatus = HAL_OK;
+#else
   HAL_StatusTypeDef App_CurrStatus = HAL_FLASH_Unlock();
 
   // Обработка ошибки разблокировки: восстанавливаем систему и выходим
   if (App_CurrStatus != HAL_OK)
   {
     __enable_irq();                // Разрешаем прерывания
-    HAL_TIM_Base_Start_IT(&htim3); // Запускаем таймер мультиплексирования
+    App_Tim3_Start();              // Запускаем таймер мультиплексирования
     return App_CurrStatus;         // Возвращаем статус ошибки
   }
+#endif
 
   // 4.2. Стираем целевой сектор Flash-памяти
   App_CurrStatus = APP_Erase_CFG_Flash();
@@ -207,9 +312,19 @@ HAL_StatusTypeDef APP_Save_CFG_Flash(void)
   }
 
   // 4.3. Завершение работы с памятью: блокировка и восстановление системы
+#ifndef APP_LL_FLASH
   (void)HAL_FLASH_Lock();         // Блокируем Flash для защиты от случайных изменений
+#endif
+  cfg_stats.cycles = DWT->CYCCNT - App_Start_Cycles;
+  cfg_stats.ticks  = HAL_GetTick() - App_Start_Tick;
+#ifdef APP_RAMFUNC
+  App_RamFunc_Irq_Restore(App_Irq_Saved);   // Отложенные прерывания выполнятся здесь
+  cfg_stats.mux_blocked = 0;
+#else
   __enable_irq();                 // Восстанавливаем прерывания
-  HAL_TIM_Base_Start_IT(&htim3);  // Запускаем таймер для мультиплексирования
+  App_Tim3_Start();               // Запускаем таймер для мультиплексирования
+  cfg_stats.mux_blocked = cfg_stats.cycles;
+#endif
 
   // 5. Финальная верификация: проверка валидности записанных данных
   if (App_CurrStatus == HAL_OK &&
@@ -233,6 +348,8 @@ HAL_StatusTypeDef APP_Save_CFG_Flash(void)
  * - Извлечение указателя на текущую конфигурацию из Flash.
  * - Проверка валидности извлеченных данных.
  * - В случае валидности    - копирование данных в глобальную переменную.
+ * - Запись версии 2 (без расписания) или 1 (без CRC32) - перенос `cfg_sec`
+ *   и пересохранение в текущем формате с пустым расписанием.
  * - В случае не валидности - инициализация конфигурации значениями по умолчанию
  *   и сохранение в память.
  */
@@ -244,14 +361,31 @@ void APP_Load_CFG_Flash(void)
   {
     GlobalAppConfig = *flashConfig;
   }
+  else if (APP_Check_CFG_V2(flashConfig) == VALID || APP_Check_CFG_Legacy(flashConfig) == VALID)
+  {
+    GlobalAppConfig.cfg_sec = flashConfig->cfg_sec;
+    (void)APP_Save_CFG_Flash();       /// Запись старого формата - сохранили значение пользователя в версии 3
+  }
   else
   {
-    GlobalAppConfig.magic       = APP_CFG_MAGIC;
-    GlobalAppConfig.version     = APP_CFG_VERSION;
-    GlobalAppConfig.cfg_sec     = APP_CFG_SEC_DEFAULT;
-    GlobalAppConfig.cfg_sec_inv = ~GlobalAppConfig.cfg_sec;
-    GlobalAppConfig.reserved_1  = 0u;
-    GlobalAppConfig.reserved_2  = 0u;
+    GlobalAppConfig.cfg_sec = APP_CFG_SEC_DEFAULT;
     (void)APP_Save_CFG_Flash();       /// Первый старт прошивки или битый блок - записали дефолтное значение
   }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Проверка записи во Flash без загрузки.
+ * @retval VALID - действительная запись текущей версии: APP_Load_CFG_Flash() только прочитает её.
+ */
+Validate_t APP_Check_CFG_Flash(void)
+{
+  return APP_Check_CFG_Valid(APP_Get_CFG_Addr());
+}
+
+/**
+ * @brief Замер последней записи конфигурации (такты, блокировка мультиплекса, тики).
+ */
+const AppFlashConfig_Stats_t *APP_Get_CFG_Stats(void)
+{
+  return &cfg_stats;
+}
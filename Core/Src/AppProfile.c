@@ -0,0 +1,95 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include <string.h>
+#include "AppProfile.h"
+#include "AppRamFunc.h"
+#include "AppTime.h"
+
+AppProfile_Slot_t App_Profile[APP_PROFILE_COUNT];
+
+static uint32_t profile_cycles_per_us;   /// Тактов ядра в микросекунде (App_Profile_End_Us)
+
+/**
+ * @brief Включение счётчика тактов DWT и сброс таблицы.
+ * @details Счётчик не обнуляется: его запускает стартовый код, и от сброса по нему
+ *          считаются такты запуска (AppBench.c). Профиль берёт только разности.
+ */
+void App_Profile_Init(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+  profile_cycles_per_us = SystemCoreClock / APP_TIME_HZ;
+
+  App_Profile_Reset();
+}
+
+/**
+ * @brief Обнулить статистику (например, после прогрева, перед замером).
+ */
+void App_Profile_Reset(void)
+{
+  memset(App_Profile, 0, sizeof(App_Profile));
+}
+
+/**
+ * @brief Тактов с границы тика release_tick до текущего момента.
+ * @details SysTick считает вниз от LOAD; перезагрузка между чтениями VAL и номера тика
+ *          видна по росту VAL - тогда читаем заново.
+ */
+APP_RAMCODE static uint32_t App_Profile_Since(const uint32_t release_tick)
+{
+  uint32_t val;
+  uint32_t tick;
+
+  do
+  {
+    val  = SysTick->VAL;
+    tick = HAL_GetTick();
+  } while (SysTick->VAL > val);
+
+  const uint32_t period = SysTick->LOAD + 1u;
+  return (tick - release_tick) * period + (period - 1u - val);
+}
+
+/**
+ * @brief Учёт одной работы: время выполнения и отклик в тактах.
+ */
+static inline void App_Profile_Record(AppProfile_Slot_t *slot, const uint32_t exec, const uint32_t response)
+{
+  slot->runs++;
+  slot->last_response = response;
+  if (exec > slot->worst_exec)
+  {
+    slot->worst_exec = exec;
+  }
+  if (response > slot->worst_response)
+  {
+    slot->worst_response = response;
+  }
+}
+
+/**
+ * @brief Конец работы задачи.
+ * @param release_tick Номер тика (HAL_GetTick()), на котором работа стала готова.
+ */
+APP_RAMCODE void App_Profile_End(const AppProfile_Task_t task, const uint32_t release_tick)
+{
+  AppProfile_Slot_t *slot = &App_Profile[task];
+  const uint32_t     exec = DWT->CYCCNT - slot->begin;
+
+  App_Profile_Record(slot, exec, App_Profile_Since(release_tick));
+}
+
+/**
+ * @brief Конец работы задачи, готовность - метка времени в микросекундах.
+ * @param release_us App_Time_Us32() в момент, когда работа стала готова.
+ */
+void App_Profile_End_Us(const AppProfile_Task_t task, const uint32_t release_us)
+{
+  AppProfile_Slot_t *slot = &App_Profile[task];
+  const uint32_t     exec = DWT->CYCCNT - slot->begin;
+
+  App_Profile_Record(slot, exec, (App_Time_Us32() - release_us) * profile_cycles_per_us);
+}
@@ -0,0 +1,75 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include <string.h>
+#include "AppRamFunc.h"
+#include "stm32f4xx_hal.h"
+
+/* Таблица векторов в ОЗУ: VTOR требует выравнивания на степень двойки не меньше размера таблицы */
+_Static_assert(APP_RAMFUNC_VECTORS * 4u <= 512u, "RAM vector table does not fit the 512-byte alignment");
+static uint32_t ram_vectors[APP_RAMFUNC_VECTORS] __attribute__((aligned(512)));
+
+/**
+ * @brief Копия таблицы векторов (флеш-образа или слота загрузчика) в ОЗУ.
+ * @details Вызывается в начале main(), до HAL_Init(): вход в прерывание читает вектор
+ *          из ОЗУ и во время стирания Flash. Сами обработчики остаются там, где их
+ *          положил компоновщик: во время стирания без остановки работают только
+ *          обработчики из .ramfunc.
+ */
+void App_RamFunc_Init(void)
+{
+  memcpy(ram_vectors, (const void *)SCB->VTOR, sizeof(ram_vectors));
+
+  __disable_irq();
+  SCB->VTOR = (uint32_t)ram_vectors;
+  __DSB();
+  __ISB();
+  __enable_irq();
+}
+
+/**
+ * @brief В NVIC остаётся разрешённым только irq (на время стирания и записи Flash).
+ * @param saved Маски ISER до вызова - для App_RamFunc_Irq_Restore().
+ * @details Запрещённые так прерывания не теряются: флаг pending остаётся и обработчик
+ *          выполнится после восстановления.
+ */
+void App_RamFunc_Irq_Only(const IRQn_Type irq, uint32_t saved[APP_RAMFUNC_NVIC_WORDS])
+{
+  for (uint32_t i = 0; i < APP_RAMFUNC_NVIC_WORDS; i++)
+  {
+    saved[i] = NVIC->ISER[i];
+    const uint32_t keep = (i == ((uint32_t)irq >> 5)) ? (1uL << ((uint32_t)irq & 0x1Fu)) : 0u;
+    NVIC->ICER[i] = saved[i] & ~keep;
+  }
+  __DSB();   /// Запрет вступил в силу до первой операции с Flash
+  __ISB();
+}
+
+/**
+ * @brief Возврат масок NVIC, сохранённых App_RamFunc_Irq_Only().
+ */
+void App_RamFunc_Irq_Restore(const uint32_t saved[APP_RAMFUNC_NVIC_WORDS])
+{
+  for (uint32_t i = 0; i < APP_RAMFUNC_NVIC_WORDS; i++)
+  {
+    NVIC->ISER[i] = saved[i];
+  }
+}
+
+/**
+ * @brief Тик HAL из ОЗУ (weak-версия HAL лежит во Flash): SysTick_Handler вызывает его
+ *        и во время стирания.
+ */
+APP_RAMCODE void HAL_IncTick(void)
+{
+  uwTick += (uint32_t)uwTickFreq;
+}
+
+/**
+ * @brief Миллисекунды HAL из ОЗУ: их читают шаг кнопки и профилировщик в SysTick.
+ */
+APP_RAMCODE uint32_t HAL_GetTick(void)
+{
+  return uwTick;
+}
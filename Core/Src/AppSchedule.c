@@ -0,0 +1,390 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include "AppSchedule.h"
+#if defined(SCHEDULE_PORT_HOST) && !defined(APP_ATOMIC_PORT_HOST)
+#define APP_ATOMIC_PORT_HOST
+#endif
+#include "AppAtomic.h"
+
+static const uint32_t   *sched_entries;   /// Расписание (GlobalAppConfig.sched)
+static uint8_t           rtc_ready;       /// RTC запущен: без него работают только кнопки
+static volatile uint32_t alarm_pending;   /// Будильник сработал (прерывание RTC -> суперцикл)
+
+/**
+ * @brief Будильник сработал: запуск отдаст Schedule_Take_Alarm().
+ */
+static void Schedule_Alarm_Fired(void)
+{
+  App_Atomic_Publish(&alarm_pending, 1u);
+}
+
+#ifdef SCHEDULE_PORT_HOST
+
+/** -- Хост-порт: модель RTC - секунда недели и будильник на полное совпадение -- */
+#define SCHEDULE_HOST_WEEK_S (SCHEDULE_WEEK_MINUTES * 60u)
+
+static uint32_t host_now_s;
+static uint8_t  host_alarm_on;
+static uint32_t host_alarm_s;
+
+static uint8_t Schedule_Rtc_Init(void)
+{
+  host_alarm_on = 0;
+  return 1u;
+}
+
+static void Schedule_Rtc_Read(Schedule_Time_t *time)
+{
+  time->weekday = (uint8_t)(host_now_s / 86400u + 1u);
+  time->hour    = (uint8_t)(host_now_s % 86400u / 3600u);
+  time->minute  = (uint8_t)(host_now_s % 3600u / 60u);
+  time->second  = (uint8_t)(host_now_s % 60u);
+}
+
+static void Schedule_Rtc_Write(const Schedule_Time_t *time)
+{
+  host_now_s = Schedule_Minute_Of_Week(time) * 60u + time->second;
+}
+
+static void Schedule_Rtc_Arm(const uint8_t on, const uint32_t at)
+{
+  host_alarm_on = on;
+  host_alarm_s  = at * 60u;
+}
+
+/**
+ * @brief "Сон": время идёт до будильника, но не дольше max_s секунд.
+ * @details Будильник, как у RTC, срабатывает при совпадении времени и остаётся
+ *          взведённым на ту же минуту следующей недели.
+ * @retval Сколько секунд прошло.
+ */
+uint32_t Schedule_Host_Sleep(const uint32_t max_s)
+{
+  uint32_t until = (host_alarm_s + SCHEDULE_HOST_WEEK_S - host_now_s) % SCHEDULE_HOST_WEEK_S;
+  if (until == 0u)
+  {
+    until = SCHEDULE_HOST_WEEK_S;   /// Совпадение на этой секунде уже было
+  }
+
+  if (host_alarm_on && until <= max_s)
+  {
+    host_now_s = host_alarm_s;
+    Schedule_Alarm_Fired();
+    return until;
+  }
+
+  host_now_s = (host_now_s + max_s) % SCHEDULE_HOST_WEEK_S;
+  return max_s;
+}
+
+#else
+
+/** -- Порт STM32F4: RTC на HAL, сон STOP -- */
+#include "main.h"
+
+#define SCHEDULE_RTC_MARKER  (0x5CEDu)    /// RTC_BKP_DR0: календарь заведён
+#define SCHEDULE_EXTI_BUTTON (K1_Pin)     /// Линия EXTI кнопки = номер вывода
+#define SCHEDULE_IRQ_PRIO    (3u)
+
+_Static_assert(K1_Pin == GPIO_PIN_10, "AppSchedule.c: K1 wake-up is wired to EXTI10 (PB10)");
+
+void SystemClock_Config(void);            /// main.c
+
+static RTC_HandleTypeDef hrtc;
+
+static void Schedule_Rtc_Write(const Schedule_Time_t *time);
+
+/**
+ * @brief Тактирование и запуск RTC; календарь, заведённый раньше, не трогается.
+ * @retval 1 - RTC работает.
+ */
+static uint8_t Schedule_Rtc_Init(void)
+{
+  RCC_OscInitTypeDef       osc      = {0};
+  RCC_PeriphCLKInitTypeDef clk      = {0};
+  uint32_t                 sync_div = 255u;   /// LSE: 32768 / 128 / 256 = 1 Гц
+
+  HAL_PWR_EnableBkUpAccess();
+
+  osc.OscillatorType       = RCC_OSCILLATORTYPE_LSE;
+  osc.LSEState             = RCC_LSE_ON;
+  osc.PLL.PLLState         = RCC_PLL_NONE;
+  clk.PeriphClockSelection = RCC_PERIPHCLK_RTC;
+  clk.RTCClockSelection    = RCC_RTCCLKSOURCE_LSE;
+
+  if (HAL_RCC_OscConfig(&osc) != HAL_OK)
+  {
+    /// Кварца нет: LSI (~32 кГц, разброс до 10 %) - расписание работает, но часы уходят
+    osc.OscillatorType    = RCC_OSCILLATORTYPE_LSI;
+    osc.LSIState          = RCC_LSI_ON;
+    clk.RTCClockSelection = RCC_RTCCLKSOURCE_LSI;
+    sync_div              = 249u;             /// 32000 / 128 / 250 = 1 Гц
+    if (HAL_RCC_OscConfig(&osc) != HAL_OK)
+    {
+      return 0u;
+    }
+  }
+
+  /// Смена источника сбрасывает домен резервного питания (и календарь), тот же - нет
+  if (HAL_RCCEx_PeriphCLKConfig(&clk) != HAL_OK)
+  {
+    return 0u;
+  }
+  __HAL_RCC_RTC_ENABLE();
+
+  hrtc.Instance            = RTC;
+  hrtc.Init.HourFormat     = RTC_HOURFORMAT_24;
+  hrtc.Init.AsynchPrediv   = 127u;
+  hrtc.Init.SynchPrediv    = sync_div;
+  hrtc.Init.OutPut         = RTC_OUTPUT_DISABLE;
+  hrtc.Init.OutPutPolarity = RTC_OUTPUT_POLARITY_HIGH;
+  hrtc.Init.OutPutType     = RTC_OUTPUT_TYPE_OPENDRAIN;
+  if (HAL_RTC_Init(&hrtc) != HAL_OK)
+  {
+    return 0u;
+  }
+
+  /// Первое включение или разряд VBAT: часы с понедельника 00:00, до установки времени
+  if (HAL_RTCEx_BKUPRead(&hrtc, RTC_BKP_DR0) != SCHEDULE_RTC_MARKER)
+  {
+    const Schedule_Time_t monday = { .weekday = 1u };
+    Schedule_Rtc_Write(&monday);
+  }
+
+  HAL_NVIC_SetPriority(RTC_Alarm_IRQn, SCHEDULE_IRQ_PRIO, 0);
+  HAL_NVIC_EnableIRQ(RTC_Alarm_IRQn);
+  return 1u;
+}
+
+static void Schedule_Rtc_Read(Schedule_Time_t *time)
+{
+  RTC_TimeTypeDef rtc_time = {0};
+  RTC_DateTypeDef rtc_date = {0};
+
+  (void)HAL_RTC_GetTime(&hrtc, &rtc_time, RTC_FORMAT_BIN);
+  (void)HAL_RTC_GetDate(&hrtc, &rtc_date, RTC_FORMAT_BIN);   /// Обязательно после GetTime: отпускает теневые регистры
+
+  time->weekday = rtc_date.WeekDay;
+  time->hour    = rtc_time.Hours;
+  time->minute  = rtc_time.Minutes;
+  time->second  = rtc_time.Seconds;
+}
+
+static void Schedule_Rtc_Write(const Schedule_Time_t *time)
+{
+  RTC_TimeTypeDef rtc_time = {0};
+  RTC_DateTypeDef rtc_date = {0};
+
+  rtc_time.Hours          = time->hour;
+  rtc_time.Minutes        = time->minute;
+  rtc_time.Seconds        = time->second;
+  rtc_time.DayLightSaving = RTC_DAYLIGHTSAVING_NONE;
+  rtc_time.StoreOperation = RTC_STOREOPERATION_RESET;
+
+  rtc_date.WeekDay = time->weekday;   /// Дата расписанию не нужна: день недели RTC считает сам
+  rtc_date.Month   = RTC_MONTH_JANUARY;
+  rtc_date.Date    = 1u;
+  rtc_date.Year    = 0u;
+
+  if (HAL_RTC_SetTime(&hrtc, &rtc_time, RTC_FORMAT_BIN) == HAL_OK &&
+      HAL_RTC_SetDate(&hrtc, &rtc_date, RTC_FORMAT_BIN) == HAL_OK)
+  {
+    HAL_RTCEx_BKUPWrite(&hrtc, RTC_BKP_DR0, SCHEDULE_RTC_MARKER);
+  }
+}
+
+/**
+ * @brief Будильник A на минуту недели at (секунда 0) или выключить его.
+ */
+static void Schedule_Rtc_Arm(const uint8_t on, const uint32_t at)
+{
+  RTC_AlarmTypeDef alarm = {0};
+
+  (void)HAL_RTC_DeactivateAlarm(&hrtc, RTC_ALARM_A);
+  if (!on)
+  {
+    return;
+  }
+
+  alarm.AlarmTime.Hours     = (uint8_t)((at % SCHEDULE_DAY_MINUTES) / 60u);
+  alarm.AlarmTime.Minutes   = (uint8_t)(at % 60u);
+  alarm.AlarmTime.Seconds   = 0u;
+  alarm.AlarmMask           = RTC_ALARMMASK_NONE;           /// День недели, час, минута, секунда
+  alarm.AlarmSubSecondMask  = RTC_ALARMSUBSECONDMASK_ALL;
+  alarm.AlarmDateWeekDaySel = RTC_ALARMDATEWEEKDAYSEL_WEEKDAY;
+  alarm.AlarmDateWeekDay    = (uint8_t)(at / SCHEDULE_DAY_MINUTES + 1u);
+  alarm.Alarm               = RTC_ALARM_A;
+  (void)HAL_RTC_SetAlarm_IT(&hrtc, &alarm, RTC_FORMAT_BIN);
+}
+
+/**
+ * @brief Сон STOP до будильника или фронта кнопки.
+ * @details Вызывать из суперцикла в READY, TIM3 остановлен и индикатор погашен
+ *          (в STOP выводы держат уровни). SysTick на время сна остановлен: тики
+ *          HAL не догоняют время сна, отсчёты по HAL_GetTick() продолжаются с места.
+ */
+void Schedule_Stop(void)
+{
+  /// K1 (PB10) - EXTI 10 по обоим фронтам: только пробуждение, нажатие разберёт Button_Poll_1ms()
+  __HAL_RCC_SYSCFG_CLK_ENABLE();
+  SYSCFG->EXTICR[2] = (SYSCFG->EXTICR[2] & ~SYSCFG_EXTICR3_EXTI10) | SYSCFG_EXTICR3_EXTI10_PB;
+  EXTI->RTSR |= SCHEDULE_EXTI_BUTTON;
+  EXTI->FTSR |= SCHEDULE_EXTI_BUTTON;
+  EXTI->PR    = SCHEDULE_EXTI_BUTTON;
+  EXTI->IMR  |= SCHEDULE_EXTI_BUTTON;
+  HAL_NVIC_SetPriority(EXTI15_10_IRQn, SCHEDULE_IRQ_PRIO, 0);
+  HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
+
+  HAL_SuspendTick();
+  HAL_PWREx_EnableFlashPowerDown();
+  HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+
+  /// Проснулись на HSI 16 МГц: PLL и делители шин - как при старте
+  SystemClock_Config();
+  HAL_ResumeTick();
+
+  HAL_NVIC_DisableIRQ(EXTI15_10_IRQn);
+  EXTI->IMR &= ~SCHEDULE_EXTI_BUTTON;
+  EXTI->PR   = SCHEDULE_EXTI_BUTTON;
+}
+
+void Schedule_Rtc_IRQHandler(void)
+{
+  HAL_RTC_AlarmIRQHandler(&hrtc);
+}
+
+void Schedule_Button_IRQHandler(void)
+{
+  EXTI->PR = SCHEDULE_EXTI_BUTTON;
+}
+
+void HAL_RTC_AlarmAEventCallback(RTC_HandleTypeDef *rtc)
+{
+  (void)rtc;
+  Schedule_Alarm_Fired();
+}
+
+#endif /* SCHEDULE_PORT_HOST */
+
+/**
+ * @brief Минута недели: 0 - понедельник 00:00 ... SCHEDULE_WEEK_MINUTES - 1.
+ */
+uint32_t Schedule_Minute_Of_Week(const Schedule_Time_t *time)
+{
+  return (uint32_t)(time->weekday - 1u) * SCHEDULE_DAY_MINUTES + (uint32_t)time->hour * 60u + time->minute;
+}
+
+/**
+ * @brief Ближайший запуск строго после минуты недели after (с переходом через воскресенье).
+ * @param entries Записи расписания (недопустимые и пустые пропускаются).
+ * @param next    Минута недели запуска.
+ * @retval 1 - запуск есть.
+ */
+uint8_t Schedule_Next(const uint32_t *entries, const uint32_t count, const uint32_t after, uint32_t *next)
+{
+  uint32_t best = SCHEDULE_WEEK_MINUTES + 1u;   /// Минут до запуска
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    if (!Schedule_Entry_Valid(entries[i]))
+    {
+      continue;
+    }
+    const uint32_t days   = (entries[i] >> SCHEDULE_DAYS_POS) & SCHEDULE_DAYS_MASK;
+    const uint32_t minute = entries[i] & SCHEDULE_MINUTE_MASK;
+
+    for (uint32_t day = 0; day < 7u; day++)
+    {
+      if ((days & (1u << day)) == 0u)
+      {
+        continue;
+      }
+      const uint32_t at   = day * SCHEDULE_DAY_MINUTES + minute;
+      uint32_t       wait = (at + SCHEDULE_WEEK_MINUTES - after) % SCHEDULE_WEEK_MINUTES;
+      if (wait == 0u)
+      {
+        wait = SCHEDULE_WEEK_MINUTES;   /// Эта же минута - только через неделю
+      }
+      if (wait < best)
+      {
+        best  = wait;
+        *next = at;
+      }
+    }
+  }
+  return (best <= SCHEDULE_WEEK_MINUTES) ? 1u : 0u;
+}
+
+/**
+ * @brief Запуск RTC и взвод будильника на ближайшую запись.
+ * @param entries SCHEDULE_ENTRIES записей; их изменение - затем Schedule_Rearm().
+ */
+void Schedule_Init(const uint32_t *entries)
+{
+  sched_entries = entries;
+  rtc_ready     = Schedule_Rtc_Init();
+  Schedule_Rearm();
+}
+
+/**
+ * @brief Взвести будильник на первую запись после текущей минуты (или выключить).
+ */
+void Schedule_Rearm(void)
+{
+  if (!rtc_ready)
+  {
+    return;
+  }
+
+  Schedule_Time_t now;
+  uint32_t        at = 0;
+
+  Schedule_Rtc_Read(&now);
+  const uint8_t on = Schedule_Next(sched_entries, SCHEDULE_ENTRIES, Schedule_Minute_Of_Week(&now), &at);
+  Schedule_Rtc_Arm(on, at);
+}
+
+/**
+ * @brief Забрать срабатывание будильника (из суперцикла).
+ * @details Следующий будильник считается от текущего времени, как и в
+ *          Schedule_Rearm(), поэтому правка расписания между срабатыванием и этим
+ *          вызовом не теряет и не повторяет запуск.
+ * @retval 1 - наступила минута запуска: передать автомату EVENT_SCHEDULE.
+ */
+uint8_t Schedule_Take_Alarm(void)
+{
+  if (App_Atomic_Exchange(&alarm_pending, 0u) == 0u)
+  {
+    return 0u;
+  }
+  Schedule_Rearm();
+  return 1u;
+}
+
+void Schedule_Get_Time(Schedule_Time_t *time)
+{
+  const Schedule_Time_t none = {0};
+
+  if (!rtc_ready)
+  {
+    *time = none;
+    return;
+  }
+  Schedule_Rtc_Read(time);
+}
+
+/**
+ * @brief Установить день недели и время; будильник пересчитывается.
+ */
+void Schedule_Set_Time(const Schedule_Time_t *time)
+{
+  if (!rtc_ready || time->weekday < 1u || time->weekday > 7u ||
+      time->hour > 23u || time->minute > 59u || time->second > 59u)
+  {
+    return;
+  }
+  Schedule_Rtc_Write(time);
+  Schedule_Rearm();
+}
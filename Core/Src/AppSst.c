@@ -0,0 +1,249 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include "AppSst.h"
+#include "Button.h"
+#include "AppFlashConfig.h"
+#include "AppProfile.h"
+#include "FwImageCheck.h"
+#include "FaultCapture.h"
+#ifdef ROOM_SENSE
+#include "RoomSense.h"
+#include "HumidityCtl.h"
+#endif
+#ifdef VALVE_MONITOR
+#include "ValveMonitor.h"
+#endif
+#ifdef MODBUS_RTU
+#include "ModbusRtu.h"
+#endif
+#ifdef APP_BOOTLOADER
+#include "BootCtl.h"
+#endif
+
+static MachineState_Context_t *machine;
+static AppSst_Dispatch_t       dispatch;
+
+static Sst_Task_t button_task;
+static Sst_Task_t machine_task;
+static Sst_Task_t flash_task;
+
+static Sst_Slot_t button_ring[APP_SST_DEPTH_BUTTON];
+static Sst_Slot_t machine_ring[APP_SST_DEPTH_MACHINE];
+static Sst_Slot_t flash_ring[APP_SST_DEPTH_FLASH];
+
+static volatile uint8_t  running;          /// Задачи созданы: SysTick может отправлять события
+static volatile uint8_t  fw_step_queued;   /// Шаг проверки образа уже в очереди flash
+static uint32_t          last_tick1s;
+
+/**
+ * @brief Кнопка: шаг на каждый тик, событие - автомату с тем же тиком выпуска.
+ */
+static void App_Sst_Button(Sst_Task_t *task, const Sst_Evt_t *evt)
+{
+  (void)task;
+
+  App_Profile_Begin(APP_PROFILE_INPUT);
+  const MachineEvent_t event = Button_Poll_1ms();
+  App_Profile_End(APP_PROFILE_INPUT, evt->stamp);
+
+  if (event != EVENT_NONE)
+  {
+    (void)Sst_Post(&machine_task, APP_SIG_EVENT, (uint16_t)event, evt->stamp);
+  }
+}
+
+/**
+ * @brief Датчики, отказ катушки и Modbus: раз в APP_SST_POLL_MS.
+ */
+static void App_Sst_Machine_Poll(const uint32_t release)
+{
+#ifdef ROOM_SENSE
+  const MachineEvent_t sense_event = Room_Sense_Poll();
+  if (sense_event != EVENT_NONE)
+  {
+    dispatch(sense_event);
+  }
+
+  machine->rh_dpct = Room_Sense_Get()->rh_dpct;
+  while (Humidity_Ctl_Take_Tick())
+  {
+    dispatch(EVENT_CONTROL_TICK);
+  }
+#endif
+
+#ifdef VALVE_MONITOR
+  const MachineFault_t coil_fault = Valve_Monitor_Poll();
+  if (coil_fault != FAULT_NONE)
+  {
+    Machine_Raise_Fault(machine, coil_fault);
+  }
+#endif
+
+  App_Profile_Begin(APP_PROFILE_TELEMETRY);
+#ifdef MODBUS_RTU
+  Modbus_Poll();
+#endif
+  App_Profile_End(APP_PROFILE_TELEMETRY, release);
+}
+
+/**
+ * @brief Автомат: единственный объект, который меняет его контекст.
+ */
+static void App_Sst_Machine(Sst_Task_t *task, const Sst_Evt_t *evt)
+{
+  (void)task;
+
+  switch ((AppSst_Signal_t)evt->sig)
+  {
+    case APP_SIG_EVENT:
+      App_Profile_Begin(APP_PROFILE_CONTROL);
+      dispatch((MachineEvent_t)evt->par);
+      App_Profile_End(APP_PROFILE_CONTROL, evt->stamp);
+      break;
+
+    case APP_SIG_TICK_1S:
+      App_Profile_Begin(APP_PROFILE_CONTROL);
+      dispatch(EVENT_TICK_1S);
+      App_Profile_End(APP_PROFILE_CONTROL, evt->stamp);
+      break;
+
+    case APP_SIG_FAULT:
+      Machine_Raise_Fault(machine, (MachineFault_t)evt->par);
+      break;
+
+    case APP_SIG_POLL:
+      App_Sst_Machine_Poll(evt->stamp);
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Flash: запись конфигурации и фоновая проверка образа.
+ * @details Запись читает GlobalAppConfig, который автомат может поменять, вытеснив
+ *          её; такое изменение само отправляет новый APP_SIG_SAVE, и следующая
+ *          запись сохранит последнее значение.
+ */
+static void App_Sst_Flash(Sst_Task_t *task, const Sst_Evt_t *evt)
+{
+  (void)task;
+#ifdef APP_BOOTLOADER
+  static uint8_t boot_confirmed = 0;
+#endif
+
+  App_Profile_Begin(APP_PROFILE_PERSIST);
+
+  if (evt->sig == APP_SIG_SAVE)
+  {
+    (void)APP_Save_CFG_Flash();
+    App_Profile_End(APP_PROFILE_PERSIST, evt->stamp);
+    return;
+  }
+
+  fw_step_queued = 0;
+  const FwCheck_Result_t fw_check = FW_Check_Step();
+  App_Profile_End(APP_PROFILE_PERSIST, evt->stamp);
+
+  if (fw_check == FW_CHECK_FAILED)
+  {
+    (void)Sst_Post(&machine_task, APP_SIG_FAULT, FAULT_FW_CRC, evt->stamp);
+  }
+#ifdef APP_BOOTLOADER
+  if (!boot_confirmed && fw_check == FW_CHECK_PASSED)
+  {
+    boot_confirmed = (BootCtl_Confirm() == HAL_OK) ? 1u : 0u;
+  }
+#endif
+}
+
+/**
+ * @brief Запрос записи конфигурации (APP_SAVE_CFG()): значение уже в GlobalAppConfig.
+ */
+void App_Sst_Request_Save(void)
+{
+  (void)Sst_Post(&flash_task, APP_SIG_SAVE, 0u, HAL_GetTick());
+}
+
+/**
+ * @brief Из SysTick_Handler после HAL_IncTick(): события времени всем объектам.
+ */
+void App_Sst_Tick_IRQHandler(void)
+{
+  if (!running)
+  {
+    return;
+  }
+
+  const uint32_t now = HAL_GetTick();
+
+  (void)Sst_Post(&button_task, APP_SIG_TICK, 0u, now);
+
+  if ((now - last_tick1s) >= 1000u)
+  {
+    last_tick1s += 1000u;   /// Не приравнять к now, а прибавить 1000
+    (void)Sst_Post(&machine_task, APP_SIG_TICK_1S, 0u, last_tick1s);
+  }
+
+  if ((now % APP_SST_POLL_MS) == 0u)
+  {
+    (void)Sst_Post(&machine_task, APP_SIG_POLL, 0u, now);
+  }
+
+  /// Не больше одного шага проверки в очереди: запросам записи всегда есть место
+  if (!fw_step_queued)
+  {
+    fw_step_queued = 1;
+    (void)Sst_Post(&flash_task, APP_SIG_FW_STEP, 0u, now);
+  }
+}
+
+void App_Sst_Button_IRQHandler(void)
+{
+  Sst_Task_Activate(&button_task);
+}
+
+void App_Sst_Machine_IRQHandler(void)
+{
+  Sst_Task_Activate(&machine_task);
+}
+
+void App_Sst_Flash_IRQHandler(void)
+{
+  Sst_Task_Activate(&flash_task);
+}
+
+/**
+ * @brief Запуск объектов; дальше - основной цикл простоя, не возвращается.
+ * @param ctx      Контекст автомата (его меняет только объект machine).
+ * @param dispatch Передача события автомату с трассой (Machine_Dispatch() из main.c).
+ */
+void App_Sst_Start(MachineState_Context_t *ctx, const AppSst_Dispatch_t dispatch_event)
+{
+  machine  = ctx;
+  dispatch = dispatch_event;
+
+  /// SysTick выше всех задач (в т.ч. для ожиданий по HAL_GetTick() внутри flash)
+  if (HAL_InitTick(APP_SST_PRIO_TICK) != HAL_OK ||
+      Sst_Task_Init(&flash_task,   App_Sst_Flash,   flash_ring,   APP_SST_DEPTH_FLASH,
+                    APP_SST_IRQ_FLASH,   APP_SST_PRIO_FLASH)   != HAL_OK ||
+      Sst_Task_Init(&machine_task, App_Sst_Machine, machine_ring, APP_SST_DEPTH_MACHINE,
+                    APP_SST_IRQ_MACHINE, APP_SST_PRIO_MACHINE) != HAL_OK ||
+      Sst_Task_Init(&button_task,  App_Sst_Button,  button_ring,  APP_SST_DEPTH_BUTTON,
+                    APP_SST_IRQ_BUTTON,  APP_SST_PRIO_BUTTON)  != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  last_tick1s = HAL_GetTick();
+  running     = 1;
+
+  for (;;)
+  {
+    Fault_Capture_Poll();
+    __WFI();   /// Будит любое прерывание, в т.ч. SysTick каждую миллисекунду
+  }
+}
@@ -0,0 +1,440 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include "AppTasks.h"
+#include "cmsis_os2.h"
+#include "Button.h"
+#include "AppFlashConfig.h"
+#include "AppProfile.h"
+#include "FwImageCheck.h"
+#include "FaultCapture.h"
+#ifdef ROOM_SENSE
+#include "RoomSense.h"
+#include "HumidityCtl.h"
+#endif
+#ifdef VALVE_MONITOR
+#include "ValveMonitor.h"
+#endif
+#ifdef MODBUS_RTU
+#include "ModbusRtu.h"
+#endif
+#ifdef APP_BOOTLOADER
+#include "BootCtl.h"
+#endif
+
+#define APP_TASKS_K1_EXTI     (K1_Pin)     /// Линия EXTI кнопки = номер вывода
+#define APP_TASKS_FLAG_K1     (0x0001u)    /// Флаг потока input: фронт на K1
+
+_Static_assert(K1_Pin == GPIO_PIN_10, "AppTasks.c: K1 wake-up is wired to EXTI10 (PB10)");
+
+/**
+ * @brief Сообщение потоку control: событие автомата или авария.
+ */
+typedef struct {
+  MachineEvent_t event;     /// Событие (если fault == FAULT_NONE)
+  MachineFault_t fault;     /// Авария от другого потока
+  uint32_t       release;   /// Тик, на котором событие возникло (для AppProfile)
+} AppTasks_Msg_t;
+
+static MachineState_Context_t *machine;
+static AppTasks_Dispatch_t     dispatch;
+
+static osMessageQueueId_t control_queue;   /// input, persist -> control
+static osMessageQueueId_t persist_queue;   /// Запросы записи конфигурации (тик запроса)
+static osMutexId_t        ctx_mutex;       /// Контекст автомата: control и telemetry
+static osThreadId_t       input_thread;    /// Его будит фронт K1 (EXTI10)
+
+/** Остаток сна в шагах TIM10, не набравший целого тика ядра */
+static uint32_t idle_carry;
+
+AppTasks_Idle_t App_Tasks_Idle;
+
+static const osMutexAttr_t ctx_mutex_attr = {
+  .name      = "machine",
+  .attr_bits = osMutexPrioInherit,
+};
+
+static const osThreadAttr_t input_attr     = { .name = "input",     .stack_size = 512u,  .priority = osPriorityHigh };
+static const osThreadAttr_t control_attr   = { .name = "control",   .stack_size = 1024u, .priority = osPriorityAboveNormal };
+static const osThreadAttr_t telemetry_attr = { .name = "telemetry", .stack_size = 768u,  .priority = osPriorityBelowNormal };
+static const osThreadAttr_t persist_attr   = { .name = "persist",   .stack_size = 768u,  .priority = osPriorityLow };
+
+/**
+ * @brief Сообщение в очередь автомата; из потоков, без ожидания (при переполнении теряется).
+ */
+static void App_Tasks_Post(const MachineEvent_t event, const MachineFault_t fault, const uint32_t release)
+{
+  const AppTasks_Msg_t msg = { .event = event, .fault = fault, .release = release };
+  (void)osMessageQueuePut(control_queue, &msg, 0u, 0u);
+}
+
+/**
+ * @brief Ожидание фронта K1 без таймаута.
+ * @details Линия разрешается до повторной проверки покоя: фронт после последнего шага
+ *          либо уже виден на выводе (ожидания нет), либо поднимет флаг потока.
+ */
+static void App_Tasks_Wait_K1(void)
+{
+  (void)osThreadFlagsClear(APP_TASKS_FLAG_K1);
+  EXTI->PR   = APP_TASKS_K1_EXTI;
+  EXTI->IMR |= APP_TASKS_K1_EXTI;
+
+  if (Button_Is_Idle())
+  {
+    (void)osThreadFlagsWait(APP_TASKS_FLAG_K1, osFlagsWaitAny, osWaitForever);
+  }
+  EXTI->IMR &= ~APP_TASKS_K1_EXTI;
+}
+
+/**
+ * @brief Кнопка: шаг строго на каждом тике, пока идёт антидребезг или удержание. Если поток
+ *        опоздал, osDelayUntil() возвращается сразу и шаги догоняются - как в суперцикле.
+ *        В покое (Button_Is_Idle()) поток ждёт фронт K1 и не ограничивает tickless-сон тиком.
+ */
+static void App_Input_Thread(void *argument)
+{
+  (void)argument;
+  uint32_t next = osKernelGetTickCount();
+
+  for (;;)
+  {
+    if (Button_Is_Idle())
+    {
+      App_Tasks_Wait_K1();
+      next = osKernelGetTickCount();   /// Шаги - снова с ближайшей границы тика
+    }
+    next++;
+    (void)osDelayUntil(next);
+
+    App_Profile_Begin(APP_PROFILE_INPUT);
+    const MachineEvent_t event = Button_Poll_1ms();
+    App_Profile_End(APP_PROFILE_INPUT, next);
+
+    if (event != EVENT_NONE)
+    {
+      App_Tasks_Post(event, FAULT_NONE, next);
+    }
+  }
+}
+
+/**
+ * @brief Автомат: события из очереди, секундный тик, датчики и отказ катушки.
+ */
+static void App_Control_Thread(void *argument)
+{
+  (void)argument;
+  uint32_t       next_1s = osKernelGetTickCount() + 1000u;
+  AppTasks_Msg_t msg;
+
+  for (;;)
+  {
+    const int32_t left = (int32_t)(next_1s - osKernelGetTickCount());
+    uint32_t      wait = (left > 0) ? (uint32_t)left : 0u;
+#if defined(ROOM_SENSE) || defined(VALVE_MONITOR)
+    if (wait > APP_TASKS_SENSE_MS)
+    {
+      wait = APP_TASKS_SENSE_MS;
+    }
+#endif
+    const osStatus_t got = osMessageQueueGet(control_queue, &msg, NULL, wait);
+
+    (void)osMutexAcquire(ctx_mutex, osWaitForever);
+
+    if (got == osOK)
+    {
+      App_Profile_Begin(APP_PROFILE_CONTROL);
+      if (msg.fault != FAULT_NONE)
+      {
+        Machine_Raise_Fault(machine, msg.fault);
+      }
+      else
+      {
+        dispatch(msg.event);
+      }
+      App_Profile_End(APP_PROFILE_CONTROL, msg.release);
+    }
+
+    if ((int32_t)(osKernelGetTickCount() - next_1s) >= 0)
+    {
+      App_Profile_Begin(APP_PROFILE_CONTROL);
+      dispatch(EVENT_TICK_1S);
+      App_Profile_End(APP_PROFILE_CONTROL, next_1s);
+      next_1s += 1000u;
+    }
+
+#ifdef ROOM_SENSE
+    const MachineEvent_t sense_event = Room_Sense_Poll();
+    if (sense_event != EVENT_NONE)
+    {
+      dispatch(sense_event);
+    }
+
+    machine->rh_dpct = Room_Sense_Get()->rh_dpct;
+    while (Humidity_Ctl_Take_Tick())
+    {
+      dispatch(EVENT_CONTROL_TICK);
+    }
+#endif
+
+#ifdef VALVE_MONITOR
+    const MachineFault_t coil_fault = Valve_Monitor_Poll();
+    if (coil_fault != FAULT_NONE)
+    {
+      Machine_Raise_Fault(machine, coil_fault);
+    }
+#endif
+
+    (void)osMutexRelease(ctx_mutex);
+  }
+}
+
+/**
+ * @brief Modbus (под мьютексом контекста) и дамп отказа.
+ */
+static void App_Telemetry_Thread(void *argument)
+{
+  (void)argument;
+  uint32_t next = osKernelGetTickCount();
+
+  for (;;)
+  {
+    next += APP_TASKS_TELEMETRY_MS;
+    (void)osDelayUntil(next);
+
+    App_Profile_Begin(APP_PROFILE_TELEMETRY);
+#ifdef MODBUS_RTU
+    (void)osMutexAcquire(ctx_mutex, osWaitForever);
+    Modbus_Poll();
+    (void)osMutexRelease(ctx_mutex);
+#endif
+    Fault_Capture_Poll();
+    App_Profile_End(APP_PROFILE_TELEMETRY, next);
+  }
+}
+
+/**
+ * @brief Запись конфигурации по запросу, в остальное время - порции проверки образа.
+ * @details Порция - на каждом тике, пока идёт проход; между проходами поток спит
+ *          FW_CHECK_PERIOD_MS. Образ без печати или с ошибкой больше не проверяется -
+ *          тогда поток ждёт только запросы записи.
+ */
+static void App_Persist_Thread(void *argument)
+{
+  (void)argument;
+  uint32_t due      = osKernelGetTickCount() + 1u;
+  uint8_t  checking = 1;   /// 0 - проверка образа остановлена
+#ifdef APP_BOOTLOADER
+  uint8_t  boot_confirmed = 0;
+#endif
+
+  for (;;)
+  {
+    uint32_t      requested;
+    const int32_t left    = (int32_t)(due - osKernelGetTickCount());
+    const uint32_t timeout = !checking ? osWaitForever : (left > 0) ? (uint32_t)left : 0u;
+
+    if (osMessageQueueGet(persist_queue, &requested, NULL, timeout) == osOK)
+    {
+      App_Profile_Begin(APP_PROFILE_PERSIST);
+      (void)APP_Save_CFG_Flash();
+      App_Profile_End(APP_PROFILE_PERSIST, requested);
+      continue;
+    }
+
+    App_Profile_Begin(APP_PROFILE_PERSIST);
+    const FwCheck_Result_t fw_check = FW_Check_Step();
+    App_Profile_End(APP_PROFILE_PERSIST, due);
+
+    const uint32_t now = osKernelGetTickCount();
+    due      = now + ((fw_check == FW_CHECK_PASSED) ? FW_CHECK_PERIOD_MS : 1u);
+    checking = (fw_check == FW_CHECK_BUSY || fw_check == FW_CHECK_PASSED) ? 1u : 0u;
+
+    if (fw_check == FW_CHECK_FAILED)
+    {
+      App_Tasks_Post(EVENT_NONE, FAULT_FW_CRC, now);
+    }
+#ifdef APP_BOOTLOADER
+    if (!boot_confirmed && fw_check == FW_CHECK_PASSED)
+    {
+      boot_confirmed = (BootCtl_Confirm() == HAL_OK) ? 1u : 0u;
+    }
+#endif
+  }
+}
+
+/**
+ * @brief Запрос записи конфигурации (APP_SAVE_CFG()): значение уже в GlobalAppConfig.
+ * @details Если запрос уже ждёт в очереди, второй не нужен - запишется последнее значение.
+ */
+void App_Tasks_Request_Save(void)
+{
+  const uint32_t requested = osKernelGetTickCount();
+  (void)osMessageQueuePut(persist_queue, &requested, 0u, 0u);
+}
+
+/**
+ * @brief TIM10 - таймер пробуждения из tickless-сна: счёт шагами APP_TASKS_IDLE_STEP_US,
+ *        один проход (OPM).
+ */
+static void App_Tasks_Idle_Timer_Init(void)
+{
+  __HAL_RCC_TIM10_CLK_ENABLE();
+
+  TIM10->CR1 = 0;
+  TIM10->PSC = HAL_RCC_GetPCLK2Freq() / (1000000u / APP_TASKS_IDLE_STEP_US) - 1u;   /// APB2 без делителя: такт таймера = PCLK2
+  TIM10->EGR = TIM_EGR_UG;
+  TIM10->SR  = 0;
+
+  HAL_NVIC_SetPriority(TIM1_UP_TIM10_IRQn, 15, 0);
+  HAL_NVIC_EnableIRQ(TIM1_UP_TIM10_IRQn);
+}
+
+/**
+ * @brief Прерывание TIM10: только будит ядро из WFI. UIF не сбрасывается - по нему
+ *        поток простоя узнаёт, что проспал весь интервал.
+ */
+void App_Tasks_Idle_IRQHandler(void)
+{
+  TIM10->DIER = 0;
+}
+
+/**
+ * @brief K1 (PB10) - EXTI 10 по обоим фронтам: только будит поток input, дребезг разберут
+ *        его шаги Button_Poll_1ms(). Линию снова разрешает поток, когда кнопка в покое.
+ */
+static void App_Tasks_Button_Init(void)
+{
+  __HAL_RCC_SYSCFG_CLK_ENABLE();
+  SYSCFG->EXTICR[2] = (SYSCFG->EXTICR[2] & ~SYSCFG_EXTICR3_EXTI10) | SYSCFG_EXTICR3_EXTI10_PB;
+  EXTI->IMR  &= ~APP_TASKS_K1_EXTI;
+  EXTI->RTSR |= APP_TASKS_K1_EXTI;
+  EXTI->FTSR |= APP_TASKS_K1_EXTI;
+  EXTI->PR    = APP_TASKS_K1_EXTI;
+  HAL_NVIC_SetPriority(EXTI15_10_IRQn, APP_TASKS_K1_IRQ_PRIO, 0);
+  HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
+}
+
+/**
+ * @brief Прерывание EXTI15_10: фронт K1. Линия запрещается до следующего покоя кнопки -
+ *        дребезг не будит ядро на каждом фронте.
+ */
+void App_Tasks_Button_IRQHandler(void)
+{
+  EXTI->IMR &= ~APP_TASKS_K1_EXTI;
+  EXTI->PR   = APP_TASKS_K1_EXTI;
+  (void)osThreadFlagsSet(input_thread, APP_TASKS_FLAG_K1);
+}
+
+/**
+ * @brief Поток простоя RTX (заменяет слабый из RTX_Config.c): tickless-сон.
+ */
+__NO_RETURN void osRtxIdleThread(void *argument)
+{
+  (void)argument;
+  const uint32_t steps_per_tick = (1000000u / osKernelGetTickFreq()) / APP_TASKS_IDLE_STEP_US;
+  const uint32_t max_ticks      = 0xFFFFu / steps_per_tick;
+
+  for (;;)
+  {
+    uint32_t ticks = osKernelSuspend();   /// Тик ядра выключен до osKernelResume()
+    uint32_t slept = 0;
+
+    if (ticks != 0u)
+    {
+      if (ticks > max_ticks)
+      {
+        ticks = max_ticks;                /// В т.ч. osWaitForever - нет ни одного таймаута
+      }
+      App_Tasks_Idle.sleeps++;
+      if (ticks > App_Tasks_Idle.max_ticks)
+      {
+        App_Tasks_Idle.max_ticks = ticks;
+      }
+      const uint32_t span = ticks * steps_per_tick - idle_carry;
+
+      TIM10->CNT  = 0;
+      TIM10->ARR  = span - 1u;
+      TIM10->SR   = 0;
+      TIM10->DIER = TIM_DIER_UIE;
+      TIM10->CR1  = TIM_CR1_OPM | TIM_CR1_CEN;
+
+      __WFI();                            /// TIM10 или любое другое прерывание (TIM3, DMA, USART)
+
+      const uint32_t elapsed = (TIM10->SR & TIM_SR_UIF) ? span : TIM10->CNT;
+      TIM10->CR1  = 0;
+      TIM10->DIER = 0;
+
+      const uint32_t total = idle_carry + elapsed;
+      slept      = total / steps_per_tick;
+      idle_carry = total % steps_per_tick;
+      App_Tasks_Idle.slept_ticks += slept;
+      if (slept > App_Tasks_Idle.max_slept)
+      {
+        App_Tasks_Idle.max_slept = slept;
+      }
+    }
+    else
+    {
+      App_Tasks_Idle.busy++;
+    }
+
+    osKernelResume(slept);
+  }
+}
+
+/**
+ * @brief SysTick принадлежит ядру (os_systick.c): HAL свой тик не заводит.
+ */
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
+{
+  (void)TickPriority;
+  return HAL_OK;
+}
+
+/**
+ * @brief Миллисекунды HAL = тики ядра (OS_TICK_FREQ = 1000). До запуска ядра - 0.
+ */
+uint32_t HAL_GetTick(void)
+{
+  return (osKernelGetState() > osKernelReady) ? osKernelGetTickCount() : 0u;
+}
+
+/**
+ * @brief Запуск ядра и потоков; не возвращается.
+ * @param ctx      Контекст автомата (его меняет только поток control).
+ * @param dispatch Передача события автомату с трассой (Machine_Dispatch() из main.c).
+ */
+void App_Tasks_Start(MachineState_Context_t *ctx, const AppTasks_Dispatch_t dispatch_event)
+{
+  machine  = ctx;
+  dispatch = dispatch_event;
+
+  App_Tasks_Idle_Timer_Init();
+  App_Tasks_Button_Init();
+
+  if (osKernelInitialize() != osOK)
+  {
+    Error_Handler();
+  }
+
+  ctx_mutex     = osMutexNew(&ctx_mutex_attr);
+  control_queue = osMessageQueueNew(APP_TASKS_QUEUE_DEPTH, sizeof(AppTasks_Msg_t), NULL);
+  persist_queue = osMessageQueueNew(1u, sizeof(uint32_t), NULL);
+
+  input_thread  = osThreadNew(App_Input_Thread, NULL, &input_attr);
+
+  if (ctx_mutex == NULL || control_queue == NULL || persist_queue == NULL || input_thread == NULL ||
+      osThreadNew(App_Control_Thread,   NULL, &control_attr)   == NULL ||
+      osThreadNew(App_Telemetry_Thread, NULL, &telemetry_attr) == NULL ||
+      osThreadNew(App_Persist_Thread,   NULL, &persist_attr)   == NULL)
+  {
+    Error_Handler();
+  }
+
+  (void)osKernelStart();
+  Error_Handler();
+  for (;;)
+  {
+  }
+}
@@ -0,0 +1,66 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include "AppTime.h"
+#ifndef APP_TIME_PORT_HOST
+#include "stm32f4xx_hal.h"
+#endif
+
+volatile uint32_t App_Time_Overflows;
+
+#ifdef APP_TIME_PORT_HOST
+AppTime_Tim_t App_Time_Host_Tim;
+#endif
+
+/**
+ * @brief TIM5: 1 МГц, счёт до 0xFFFFFFFF, прерывание по переполнению.
+ * @details Такт APB1 x2 (делитель APB1 = 2): 20 МГц / 20 = 1 МГц. Вызывать до первого
+ *          чтения времени (в начале USER CODE 2, до запуска TIM3 и кнопки).
+ */
+void App_Time_Init(void)
+{
+  App_Time_Overflows = 0;
+
+#ifdef APP_TIME_PORT_HOST
+  App_Time_Host_Tim.CNT = 0;
+  App_Time_Host_Tim.SR  = 0;
+#else
+  __HAL_RCC_TIM5_CLK_ENABLE();
+
+  const uint32_t tim_clk = HAL_RCC_GetPCLK1Freq() * 2u;
+  TIM5->CR1  = 0;
+  TIM5->PSC  = tim_clk / APP_TIME_HZ - 1u;
+  TIM5->ARR  = 0xFFFFFFFFu;
+  TIM5->CNT  = 0;
+  TIM5->EGR  = TIM_EGR_UG;    /// Загрузка PSC; UIF от UG сбрасывается ниже
+  TIM5->SR   = 0;
+  TIM5->DIER = TIM_DIER_UIE;
+
+  HAL_NVIC_SetPriority(TIM5_IRQn, APP_TIME_IRQ_PRIO, 0);
+  HAL_NVIC_EnableIRQ(TIM5_IRQn);
+  TIM5->CR1  = TIM_CR1_CEN;
+#endif
+}
+
+/**
+ * @brief Прерывание TIM5: переполнение CNT - старшее слово + 1.
+ * @details Сначала сброс UIF, потом запись слова: читатель, вытесненный между ними,
+ *          увидит смену слова и прочитает заново (см. AppTime.h).
+ */
+void App_Time_IRQHandler(void)
+{
+  if (APP_TIME_TIM->SR & APP_TIME_UIF)
+  {
+    APP_TIME_TIM->SR = ~(uint32_t)APP_TIME_UIF;
+    App_Atomic_Publish(&App_Time_Overflows, App_Time_Overflows + 1u);
+  }
+}
+
+/**
+ * @brief Целые секунды с App_Time_Init() (время работы для консоли и телеметрии).
+ */
+uint32_t App_Time_Seconds(void)
+{
+  return (uint32_t)(App_Time_Us() / APP_TIME_HZ);
+}
@@ -3,6 +3,8 @@
 //
 
 #include "Button.h"
+#include "AppLl.h"
+#include "AppRamFunc.h"
 
 /** Глобальная переменная контекста кнопки **/
 static ButtonContext_t Button = {0};
@@ -20,7 +22,7 @@ void Button_Init(GPIO_TypeDef* gpio_port, uint16_t gpio_pin, const ActiveLevel_t
   Button.level     = active_level;
 
   /// Инициализируем начальное состояние из реального чтения GPIO
-  const ButtonState_t init_state = (HAL_GPIO_ReadPin(gpio_port, gpio_pin) == GPIO_PIN_SET) ? BTN_PRESSED : BTN_RELEASED;
+  const ButtonState_t init_state = App_Gpio_Read(gpio_port, gpio_pin) ? BTN_PRESSED : BTN_RELEASED;
 
   /// Коррекция по активному уровню
   Button.state = (active_level == HIGH) ? init_state : ((init_state == BTN_PRESSED) ? BTN_RELEASED : BTN_PRESSED);
@@ -37,18 +39,18 @@ void Button_Init(GPIO_TypeDef* gpio_port, uint16_t gpio_pin, const ActiveLevel_t
 
 static inline ButtonState_t Button_Read_Raw(void)
 {
-  /// Прочли текущее состояние кнопки
-  const GPIO_PinState pin_state = HAL_GPIO_ReadPin(Button.gpio_port, Button.gpio_pin);
+  /// Прочли текущее состояние кнопки (с APP_LL_GPIO - одно чтение IDR, без вызова)
+  const uint32_t pin_high = App_Gpio_Read(Button.gpio_port, Button.gpio_pin);
 
   /// Eсли Active Level HIGH; HIGH - PRESSED,  LOW = REALESED
   /// Eсли Active Level LOW ; LOW  - PRESSED, HIGH = REALESED
   if (Button.level == HIGH)
   {
-    return pin_state == GPIO_PIN_SET ? BTN_PRESSED : BTN_RELEASED;
+    return pin_high ? BTN_PRESSED : BTN_RELEASED;
   }
   else
   {
-    return pin_state == GPIO_PIN_RESET ? BTN_PRESSED : BTN_RELEASED;
+    return pin_high ? BTN_RELEASED : BTN_PRESSED;
   }
 }
 
@@ -66,7 +68,7 @@ static inline ButtonState_t Button_Read_Raw(void)
  * проталкиваем счётчик ЗА порог (stable_time_ms++) - это делает событие одноразовым на данный фронт.
  *
  */
-MachineEvent_t Button_Poll_1ms(void)
+APP_RAMCODE MachineEvent_t Button_Poll_1ms(void)
 {
   static ButtonState_t Prev_State;
   const  ButtonState_t Curr_State = Button_Read_Raw();
@@ -125,4 +127,23 @@ MachineEvent_t Button_Poll_1ms(void)
   }
 
   return event;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief   Кнопка в покое - шаги Button_Poll_1ms() можно не вызывать до фронта на выводе
+ * @details Уровень прошёл антидребезг (stable_time_ms уже за порогом), вывод читается тем же
+ *          уровнем, и событие в этом удержании больше не ожидается: кнопка отпущена, либо
+ *          нажата, но LONG уже выдан. Шаг в таком состоянии только копит счётчики за порогом.
+ *          Сборка APP_RTOS2 в покое не опрашивает кнопку, а ждёт фронт K1 по EXTI (AppTasks.c).
+ * @retval 1 - в покое, 0 - идёт антидребезг или удержание
+ */
+uint8_t Button_Is_Idle(void)
+{
+  if (Button.stable_time_ms <= BTN_DEBOUNCE_MS)
+    return 0;
+
+  if (Button.state == BTN_PRESSED && !Button.long_state_flag)
+    return 0;                            /// Удержание ещё считается до BTN_LONG_MS
+
+  return (Button_Read_Raw() == Button.state) ? 1u : 0u;
+}
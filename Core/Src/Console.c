@@ -0,0 +1,439 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include "Console.h"
+#include <stddef.h>
+#include <string.h>
+
+#define CONSOLE_RX_MASK (CONSOLE_RX_RING - 1u)
+#define CONSOLE_TX_MASK (CONSOLE_TX_RING - 1u)
+
+_Static_assert((CONSOLE_RX_RING & CONSOLE_RX_MASK) == 0u, "CONSOLE_RX_RING must be a power of two");
+_Static_assert((CONSOLE_TX_RING & CONSOLE_TX_MASK) == 0u, "CONSOLE_TX_RING must be a power of two");
+_Static_assert(CONSOLE_LINE_MAX < CONSOLE_RX_RING, "a line must fit into the RX ring");
+
+static struct {
+  const Console_Cmd_t *table;
+  uint32_t             count;
+
+  uint8_t         rx_ring[CONSOLE_RX_RING];   /// Пишет DMA (хост-порт - read())
+  uint16_t        line;                       /// Начало текущей строки
+  uint16_t        scan;                       /// Первый непросмотренный байт
+  uint8_t         dropping;                   /// Строка длиннее CONSOLE_LINE_MAX: ждём её конца
+
+  uint8_t         tx_ring[CONSOLE_TX_RING];
+  uint16_t        tx_head;                    /// Сюда пишет Console_Write()
+  uint16_t        tx_tail;                    /// Начало куска, отданного DMA
+  uint16_t        tx_len;                     /// Длина этого куска (0 - DMA свободен)
+
+  Console_Stats_t stats;
+} Console;
+
+#ifdef CONSOLE_PORT_HOST
+
+/** -- Хост-порт: дескриптор файла вместо USART1, read() - вместо DMA приёма -- */
+#include <errno.h>
+#include <unistd.h>
+
+static int      host_fd = -1;
+static uint16_t host_rx_head;
+
+void Console_Host_Attach(const int fd)
+{
+  host_fd = fd;
+}
+
+static void Console_Port_Init(void)
+{
+  host_rx_head = 0;
+}
+
+/**
+ * @brief Позиция записи "DMA": всё, что уже пришло, - в кольцо (как DMA, без оглядки на читателя).
+ */
+static uint16_t Console_Port_Rx_Head(void)
+{
+  for (;;)
+  {
+    const ssize_t got = read(host_fd, &Console.rx_ring[host_rx_head], CONSOLE_RX_RING - host_rx_head);
+    if (got <= 0)
+    {
+      return host_rx_head;
+    }
+    host_rx_head = (uint16_t)((host_rx_head + (uint32_t)got) & CONSOLE_RX_MASK);
+  }
+}
+
+static uint8_t Console_Port_Tx_Busy(void)
+{
+  return 0u;
+}
+
+static void Console_Port_Tx_Start(const uint8_t *data, uint32_t length)
+{
+  while (length > 0u)
+  {
+    const ssize_t put = write(host_fd, data, length);
+    if (put < 0 && errno != EAGAIN && errno != EINTR)
+    {
+      return;
+    }
+    if (put > 0)
+    {
+      data   += put;
+      length -= (uint32_t)put;
+    }
+  }
+}
+
+#else
+
+/** -- Порт STM32F4: USART1 (CubeMX, usart.c) + DMA2 Stream2/Stream7 -- */
+
+/**
+ * @brief DMA2 Stream2 Channel4 = USART1_RX по кругу, Stream7 Channel4 = USART1_TX.
+ * @details USART1 уже настроен MX_USART1_UART_Init(): добавляются только запросы DMA.
+ */
+static void Console_Port_Init(void)
+{
+  __HAL_RCC_DMA2_CLK_ENABLE();
+
+  DMA2_Stream2->CR = 0;
+  while (DMA2_Stream2->CR & DMA_SxCR_EN)
+  {
+  }
+  DMA2->LIFCR = DMA_LIFCR_CTCIF2 | DMA_LIFCR_CHTIF2 | DMA_LIFCR_CTEIF2 | DMA_LIFCR_CDMEIF2 | DMA_LIFCR_CFEIF2;
+  DMA2_Stream2->PAR  = (uint32_t)&USART1->DR;
+  DMA2_Stream2->M0AR = (uint32_t)Console.rx_ring;
+  DMA2_Stream2->NDTR = CONSOLE_RX_RING;
+  DMA2_Stream2->CR   = (4u << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_MINC | DMA_SxCR_CIRC | DMA_SxCR_EN;
+
+  DMA2_Stream7->CR = 0;
+  while (DMA2_Stream7->CR & DMA_SxCR_EN)
+  {
+  }
+  DMA2_Stream7->PAR = (uint32_t)&USART1->DR;
+  DMA2_Stream7->CR  = (4u << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_DIR_0 | DMA_SxCR_MINC;
+
+  (void)USART1->SR;
+  (void)USART1->DR;   /// Сброс ORE, если байт пришёл до включения DMA
+  USART1->CR3 |= USART_CR3_DMAR | USART_CR3_DMAT;
+}
+
+static uint16_t Console_Port_Rx_Head(void)
+{
+  return (uint16_t)((CONSOLE_RX_RING - DMA2_Stream2->NDTR) & CONSOLE_RX_MASK);
+}
+
+/**
+ * @brief Поток передачи занят: EN снимается сам по окончании NDTR байт.
+ */
+static uint8_t Console_Port_Tx_Busy(void)
+{
+  return (DMA2_Stream7->CR & DMA_SxCR_EN) ? 1u : 0u;
+}
+
+static void Console_Port_Tx_Start(const uint8_t *data, const uint32_t length)
+{
+  DMA2->HIFCR        = DMA_HIFCR_CTCIF7 | DMA_HIFCR_CHTIF7 | DMA_HIFCR_CTEIF7 |
+                       DMA_HIFCR_CDMEIF7 | DMA_HIFCR_CFEIF7;
+  DMA2_Stream7->M0AR = (uint32_t)data;
+  DMA2_Stream7->NDTR = length;
+  DMA2_Stream7->CR  |= DMA_SxCR_EN;
+}
+
+#endif /* CONSOLE_PORT_HOST */
+
+/**
+ * @brief Отдать DMA следующий непрерывный кусок очереди, если прошлый ушёл.
+ */
+static void Console_Tx_Kick(void)
+{
+  if (Console.tx_len != 0u)
+  {
+    if (Console_Port_Tx_Busy())
+    {
+      return;
+    }
+    Console.tx_tail = (uint16_t)((Console.tx_tail + Console.tx_len) & CONSOLE_TX_MASK);
+    Console.tx_len  = 0;
+  }
+  if (Console.tx_head == Console.tx_tail)
+  {
+    return;
+  }
+
+  /// До конца кольца или до head: DMA идёт без перехода через конец
+  Console.tx_len = (Console.tx_head > Console.tx_tail) ? (uint16_t)(Console.tx_head - Console.tx_tail)
+                                                       : (uint16_t)(CONSOLE_TX_RING - Console.tx_tail);
+  Console_Port_Tx_Start(&Console.tx_ring[Console.tx_tail], Console.tx_len);
+}
+
+/**
+ * @brief Команда по имени: двоичный поиск в отсортированной таблице.
+ */
+static const Console_Cmd_t *Console_Find(const Console_Span_t *name)
+{
+  uint32_t lo = 0;
+  uint32_t hi = Console.count;
+
+  while (lo < hi)
+  {
+    const uint32_t mid = (lo + hi) / 2u;
+    const int32_t  cmp = Console_Span_Cmp(name, Console.table[mid].name);
+
+    if (cmp == 0)
+    {
+      return &Console.table[mid];
+    }
+    if (cmp < 0)
+    {
+      hi = mid;
+    }
+    else
+    {
+      lo = mid + 1u;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Разбор строки на месте: слова - отрезки кольца, затем вызов команды.
+ */
+static void Console_Exec(const uint16_t start, const uint16_t length)
+{
+  Console_Args_t args;
+  uint16_t       i = 0;
+
+  args.count = 0;
+  while (i < length)
+  {
+    const char c = (char)Console.rx_ring[(start + i) & CONSOLE_RX_MASK];
+    if (c == ' ' || c == '\t')
+    {
+      i++;
+      continue;
+    }
+    if (args.count == CONSOLE_ARGS_MAX)
+    {
+      Console_Puts("ERR too many arguments\r\n");
+      return;
+    }
+
+    Console_Span_t *span = &args.arg[args.count++];
+    span->pos = (uint16_t)((start + i) & CONSOLE_RX_MASK);
+    span->len = 0;
+    while (i < length)
+    {
+      const char w = (char)Console.rx_ring[(start + i) & CONSOLE_RX_MASK];
+      if (w == ' ' || w == '\t')
+      {
+        break;
+      }
+      span->len++;
+      i++;
+    }
+  }
+
+  if (args.count == 0u)
+  {
+    return;
+  }
+  Console.stats.lines++;
+
+  const Console_Cmd_t *cmd = Console_Find(&args.arg[0]);
+  if (cmd == NULL)
+  {
+    Console.stats.unknown++;
+    Console_Puts("ERR unknown command, see help\r\n");
+    return;
+  }
+  cmd->handler(&args);
+}
+
+/**
+ * @brief Проверка таблицы команд и запуск приёма.
+ * @param table Команды по возрастанию имени (strcmp), без повторов.
+ * @return HAL_ERROR, если таблица не отсортирована: двоичный поиск её не найдёт.
+ */
+HAL_StatusTypeDef Console_Init(const Console_Cmd_t *table, const uint32_t count)
+{
+  for (uint32_t i = 1; i < count; i++)
+  {
+    if (strcmp(table[i - 1u].name, table[i].name) >= 0)
+    {
+      return HAL_ERROR;
+    }
+  }
+
+  memset(&Console, 0, sizeof(Console));
+  Console.table = table;
+  Console.count = count;
+  Console_Port_Init();
+  return HAL_OK;
+}
+
+/**
+ * @brief Продвинуть передачу и разобрать не больше одной принятой строки (из суперцикла).
+ * @details Байты сверх CONSOLE_RX_RING между вызовами DMA перезапишет (например, на время
+ *          стирания сектора Flash) - такая строка разберётся с искажением.
+ * @retval 1 - выполнена строка.
+ */
+uint8_t Console_Poll(void)
+{
+  Console_Tx_Kick();
+
+  const uint16_t head = Console_Port_Rx_Head();
+
+  while (Console.scan != head)
+  {
+    const uint16_t at = Console.scan;
+    const uint8_t  c  = Console.rx_ring[at];
+    Console.scan = (uint16_t)((at + 1u) & CONSOLE_RX_MASK);
+
+    if (c == '\r' || c == '\n')
+    {
+      const uint16_t start  = Console.line;
+      const uint16_t length = (uint16_t)((at - start) & CONSOLE_RX_MASK);
+      Console.line = Console.scan;
+
+      if (Console.dropping)
+      {
+        Console.dropping = 0;
+        Console.stats.too_long++;
+        Console_Puts("ERR line too long\r\n");
+        return 1u;
+      }
+      if (length == 0u)
+      {
+        continue;   /// Пустая строка или '\n' после '\r'
+      }
+      Console_Exec(start, length);
+      return 1u;
+    }
+
+    if (((uint32_t)(Console.scan - Console.line) & CONSOLE_RX_MASK) > CONSOLE_LINE_MAX)
+    {
+      Console.dropping = 1;
+      Console.line     = Console.scan;
+    }
+  }
+  return 0u;
+}
+
+/**
+ * @brief Очередь передачи пуста и DMA свободен.
+ */
+uint8_t Console_Tx_Idle(void)
+{
+  Console_Tx_Kick();
+  return (Console.tx_len == 0u && Console.tx_head == Console.tx_tail) ? 1u : 0u;
+}
+
+/**
+ * @brief Положить байты в очередь передачи (не ждёт; лишнее отбрасывается).
+ */
+void Console_Write(const char *data, const uint32_t length)
+{
+  for (uint32_t i = 0; i < length; i++)
+  {
+    const uint16_t next = (uint16_t)((Console.tx_head + 1u) & CONSOLE_TX_MASK);
+    if (next == Console.tx_tail)
+    {
+      Console.stats.tx_dropped += (uint16_t)(length - i);
+      break;
+    }
+    Console.tx_ring[Console.tx_head] = (uint8_t)data[i];
+    Console.tx_head = next;
+  }
+  Console_Tx_Kick();
+}
+
+void Console_Puts(const char *text)
+{
+  Console_Write(text, (uint32_t)strlen(text));
+}
+
+void Console_Put_Uint(uint32_t value)
+{
+  char  digits[10];
+  char *p = &digits[sizeof(digits)];
+
+  do
+  {
+    *--p   = (char)('0' + value % 10u);
+    value /= 10u;
+  } while (value != 0u);
+  Console_Write(p, (uint32_t)(&digits[sizeof(digits)] - p));
+}
+
+/**
+ * @brief Список команд с подсказками (для команды "help").
+ */
+void Console_List(void)
+{
+  for (uint32_t i = 0; i < Console.count; i++)
+  {
+    Console_Puts(Console.table[i].name);
+    Console_Puts(" - ");
+    Console_Puts(Console.table[i].help);
+    Console_Puts("\r\n");
+  }
+}
+
+/**
+ * @brief Символ слова (index < span->len).
+ */
+char Console_Span_Char(const Console_Span_t *span, const uint32_t index)
+{
+  return (char)Console.rx_ring[(span->pos + index) & CONSOLE_RX_MASK];
+}
+
+/**
+ * @brief Сравнение слова со строкой, как strcmp().
+ */
+int32_t Console_Span_Cmp(const Console_Span_t *span, const char *text)
+{
+  for (uint32_t i = 0; i < span->len; i++)
+  {
+    const uint8_t a = (uint8_t)Console_Span_Char(span, i);
+    const uint8_t b = (uint8_t)text[i];
+    if (a != b)
+    {
+      return (int32_t)a - (int32_t)b;   /// Конец text (0) тоже сюда: слово длиннее
+    }
+  }
+  return (text[span->len] == '\0') ? 0 : -1;
+}
+
+/**
+ * @brief Десятичное число без знака (до 9 цифр).
+ * @retval 1 - слово целиком число.
+ */
+uint8_t Console_Span_Uint(const Console_Span_t *span, uint32_t *value)
+{
+  uint32_t result = 0;
+
+  if (span->len == 0u || span->len > 9u)
+  {
+    return 0u;
+  }
+  for (uint32_t i = 0; i < span->len; i++)
+  {
+    const char c = Console_Span_Char(span, i);
+    if (c < '0' || c > '9')
+    {
+      return 0u;
+    }
+    result = result * 10u + (uint32_t)(c - '0');
+  }
+  *value = result;
+  return 1u;
+}
+
+const Console_Stats_t *Console_Get_Stats(void)
+{
+  return &Console.stats;
+}
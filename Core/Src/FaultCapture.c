@@ -0,0 +1,275 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include <string.h>
+#include "FaultCapture.h"
+#include "AppCrc.h"
+#include "AppTime.h"
+#include "usart.h"
+#ifdef APP_CONSOLE
+#include "Console.h"
+#endif
+
+extern MachineState_Context_t Machine_State;
+
+/** Дамп переживает сброс: секция .noinit не обнуляется стартовым кодом */
+__attribute__((section(".noinit")))
+static union {
+  FaultDump_t dump;
+  uint8_t     reserve[FAULT_NOINIT_SIZE];
+} fault_noinit;
+
+_Static_assert(sizeof(FaultDump_t) <= FAULT_NOINIT_SIZE, "FaultDump_t does not fit FAULT_NOINIT_SIZE");
+
+/** Копия дампа предыдущего запуска (в .noinit признак сбрасывается сразу при старте) */
+static FaultDump_t fault_last;
+static uint8_t     fault_pending = 0;
+static uint32_t    fault_sent_ms = 0;
+static uint8_t     fault_sent    = 0;
+
+/**
+ * @brief Общий обработчик отказов (вызывается из FAULT_CAPTURE_ENTRY).
+ * @details Клапан закрывается первым действием. Для CRC используется программный
+ *          расчёт - аппаратный блок и DMA могли быть заняты в момент отказа.
+ * @param frame      Стековый кадр исключения.
+ * @param exc_return Значение LR на входе в обработчик.
+ */
+void Fault_Capture_Handler(const FaultFrame_t *frame, const uint32_t exc_return)
+{
+  VALVE_GPIO_Port->BSRR = VALVE_Pin;   /// Клапан закрыт (активный LOW)
+
+  FaultDump_t *dump = &fault_noinit.dump;
+  memset(dump, 0, sizeof(*dump));
+
+  dump->exception  = __get_IPSR() & 0x1FFu;
+  dump->sp         = (uint32_t)frame;
+  dump->exc_return = exc_return;
+  dump->cfsr       = SCB->CFSR;
+  dump->hfsr       = SCB->HFSR;
+  dump->mmfar      = SCB->MMFAR;
+  dump->bfar       = SCB->BFAR;
+  dump->t_us       = App_Time_Us();   /// TIM5 читается и из отказа: чтение без блокировок
+
+  /// Кадр читаем, только если SP в пределах ОЗУ (при переполнении стека он может быть мусором)
+  if ((uint32_t)frame >= SRAM1_BASE && (uint32_t)frame + sizeof(FaultFrame_t) <= SRAM1_BASE + 0x10000u)
+  {
+    dump->frame = *frame;
+  }
+
+  dump->machine_state = (uint8_t)Machine_State.machine_state;
+  dump->valve_state   = (uint8_t)Machine_State.valve_state;
+  dump->cfg_sec       = Machine_State.cfg_sec;
+  dump->trace_count   = (uint8_t)Machine_Trace_Snapshot(dump->trace, FAULT_TRACE_DEPTH);
+
+  dump->magic = FAULT_DUMP_MAGIC;
+  dump->crc32 = APP_CRC_Calc_Sw((const uint32_t *)dump, FAULT_DUMP_CRC_WORDS);
+
+  __DSB();
+  NVIC_SystemReset();
+}
+
+/**
+ * Обработчики отказов без пролога: SP на входе указывает ровно на стековый кадр.
+ * Генерация этих обработчиков в stm32f4xx_it.c выключена в 7_Seg.ioc - CubeMX добавил
+ * бы после пользовательского кода C-цикл, недопустимый в naked-функции.
+ */
+__attribute__((naked)) void HardFault_Handler(void)
+{
+  FAULT_CAPTURE_ENTRY();
+}
+
+__attribute__((naked)) void MemManage_Handler(void)
+{
+  FAULT_CAPTURE_ENTRY();
+}
+
+__attribute__((naked)) void BusFault_Handler(void)
+{
+  FAULT_CAPTURE_ENTRY();
+}
+
+__attribute__((naked)) void UsageFault_Handler(void)
+{
+  FAULT_CAPTURE_ENTRY();
+}
+
+/**
+ * @brief Проверка дампа после сброса и включение обработчиков отказов.
+ * @details Вызывать в начале main(). Действительный дамп копируется, а признак в .noinit
+ *          стирается: безопасный режим длится до следующего сброса.
+ *          После сброса MemManage/BusFault/UsageFault выключены в SHCSR и любой отказ
+ *          приходит как HardFault (FORCED) - включаем, чтобы дамп получил свой номер.
+ * @retval 1 - предыдущий запуск завершился отказом, нужен безопасный режим.
+ */
+uint8_t Fault_Capture_Init(void)
+{
+  const FaultDump_t *dump = &fault_noinit.dump;
+
+  SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_USGFAULTENA_Msk;
+  __DSB();
+  __ISB();
+
+  fault_pending = 0;
+  if (dump->magic == FAULT_DUMP_MAGIC &&
+      APP_CRC_Calc_Sw((const uint32_t *)dump, FAULT_DUMP_CRC_WORDS) == dump->crc32)
+  {
+    fault_last    = *dump;
+    fault_pending = 1;
+  }
+  fault_noinit.dump.magic = 0;
+
+  return fault_pending;
+}
+
+/**
+ * @brief Код аварии для индикатора: 10 + номер исключения (E13 - HardFault и т.д.).
+ * @details HardFault с FORCED - эскалация отказа, выключенного в SHCSR или случившегося
+ *          до Fault_Capture_Init(): номер берётся по CFSR (E14 - MMFSR, E15 - BFSR, E16 - UFSR).
+ */
+uint8_t Fault_Capture_Code(void)
+{
+  uint32_t exception = fault_last.exception;
+
+  if (exception == 3u && (fault_last.hfsr & SCB_HFSR_FORCED_Msk))
+  {
+    if (fault_last.cfsr & SCB_CFSR_MEMFAULTSR_Msk)
+    {
+      exception = 4u;
+    }
+    else if (fault_last.cfsr & SCB_CFSR_BUSFAULTSR_Msk)
+    {
+      exception = 5u;
+    }
+    else if (fault_last.cfsr & SCB_CFSR_USGFAULTSR_Msk)
+    {
+      exception = 6u;
+    }
+  }
+  return (uint8_t)(FAULT_CRASH + (exception % 10u));
+}
+
+/**
+ * @brief Запись "ключ=XXXXXXXX " в буфер строки.
+ */
+static char *Fault_Put_Hex(char *dst, const char *key, const uint32_t value)
+{
+  static const char hex[] = "0123456789ABCDEF";
+
+  while (*key)
+  {
+    *dst++ = *key++;
+  }
+  *dst++ = '=';
+  for (int32_t shift = 28; shift >= 0; shift -= 4)
+  {
+    *dst++ = hex[(value >> shift) & 0xFu];
+  }
+  *dst++ = ' ';
+  return dst;
+}
+
+/**
+ * @brief Запись "ключ=XXXXXXXXXXXXXXXX " (64 бита) в буфер строки.
+ */
+static char *Fault_Put_Hex64(char *dst, const char *key, const uint64_t value)
+{
+  static const char hex[] = "0123456789ABCDEF";
+
+  while (*key)
+  {
+    *dst++ = *key++;
+  }
+  *dst++ = '=';
+  for (int32_t shift = 60; shift >= 0; shift -= 4)
+  {
+    *dst++ = hex[(value >> shift) & 0xFu];
+  }
+  *dst++ = ' ';
+  return dst;
+}
+
+/**
+ * @brief Отправка строки дампа с переводом строки.
+ */
+static void Fault_Send_Line(char *line, char *end)
+{
+  *end++ = '\r';
+  *end++ = '\n';
+#ifdef APP_CONSOLE
+  Console_Write(line, (uint32_t)(end - line));   /// USART1 занят DMA консоли: через её очередь
+#else
+  HAL_UART_Transmit(&huart1, (uint8_t *)line, (uint16_t)(end - line), 100);
+#endif
+}
+
+/**
+ * @brief Текстовый дамп в USART1.
+ */
+static void Fault_Send_Dump(void)
+{
+  char  line[112];
+  char *p;
+
+  p = line;
+  p = Fault_Put_Hex(p, "FAULT exc", fault_last.exception);
+  p = Fault_Put_Hex64(p, "t_us", fault_last.t_us);
+  p = Fault_Put_Hex(p, "sp", fault_last.sp);
+  p = Fault_Put_Hex(p, "exc_ret", fault_last.exc_return);
+  Fault_Send_Line(line, p);
+
+  p = line;
+  p = Fault_Put_Hex(p, "pc", fault_last.frame.pc);
+  p = Fault_Put_Hex(p, "lr", fault_last.frame.lr);
+  p = Fault_Put_Hex(p, "xpsr", fault_last.frame.xpsr);
+  p = Fault_Put_Hex(p, "r12", fault_last.frame.r12);
+  Fault_Send_Line(line, p);
+
+  p = line;
+  p = Fault_Put_Hex(p, "r0", fault_last.frame.r0);
+  p = Fault_Put_Hex(p, "r1", fault_last.frame.r1);
+  p = Fault_Put_Hex(p, "r2", fault_last.frame.r2);
+  p = Fault_Put_Hex(p, "r3", fault_last.frame.r3);
+  Fault_Send_Line(line, p);
+
+  p = line;
+  p = Fault_Put_Hex(p, "cfsr", fault_last.cfsr);
+  p = Fault_Put_Hex(p, "hfsr", fault_last.hfsr);
+  p = Fault_Put_Hex(p, "mmfar", fault_last.mmfar);
+  p = Fault_Put_Hex(p, "bfar", fault_last.bfar);
+  Fault_Send_Line(line, p);
+
+  p = line;
+  p = Fault_Put_Hex(p, "state", fault_last.machine_state);
+  p = Fault_Put_Hex(p, "valve", fault_last.valve_state);
+  p = Fault_Put_Hex(p, "cfg_sec", fault_last.cfg_sec);
+  Fault_Send_Line(line, p);
+
+  for (uint32_t i = 0; i < fault_last.trace_count && i < FAULT_TRACE_DEPTH; i++)
+  {
+    const MachineTrace_Record_t *record = &fault_last.trace[i];
+    p = line;
+    p = Fault_Put_Hex64(p, "ev t_us", record->t_us);
+    p = Fault_Put_Hex(p, "e/s/v/cur", ((uint32_t)record->event << 24) | ((uint32_t)record->state << 16) |
+                                      ((uint32_t)record->valve << 8) | record->cur_sec);
+    Fault_Send_Line(line, p);
+  }
+}
+
+/**
+ * @brief Выдача дампа в безопасном режиме: сразу и далее раз в FAULT_DUMP_PERIOD_MS.
+ * @details Вызывать из суперцикла; без дампа ничего не делает.
+ */
+void Fault_Capture_Poll(void)
+{
+  if (!fault_pending)
+  {
+    return;
+  }
+  if (!fault_sent || (HAL_GetTick() - fault_sent_ms) >= FAULT_DUMP_PERIOD_MS)
+  {
+    fault_sent    = 1;
+    fault_sent_ms = HAL_GetTick();
+    Fault_Send_Dump();
+  }
+}
@@ -0,0 +1,129 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include "FwImageCheck.h"
+#include "AppCrc.h"
+
+/** Символы компоновщика: начало образа и начало секции футера */
+extern const uint32_t _fw_image_start[];
+extern const uint32_t _fw_footer[];
+
+/**
+ * Футер образа. До пост-обработки содержит заглушку (как стёртая Flash),
+ * tools/fw_image_crc.py перезаписывает секцию реальными длиной и CRC32.
+ * volatile обязателен: иначе компилятор подставит значения заглушки на этапе сборки.
+ */
+__attribute__((section(".fw_footer"), used))
+const volatile FwFooter_t fw_footer = {
+  .magic     = FW_FOOTER_UNSEALED,
+  .length    = 0xFFFFFFFFu,
+  .crc32     = 0xFFFFFFFFu,
+  .crc32_inv = 0xFFFFFFFFu
+};
+
+/** Контекст фоновой проверки */
+static struct {
+  AppCrc_Ctx_t    crc;          /// Накопленная CRC текущего прохода
+  const uint32_t *cursor;       /// Следующее непроверенное слово
+  uint32_t        words_left;   /// Сколько слов осталось до конца образа
+  uint32_t        pause_from;   /// HAL_GetTick() завершения предыдущего прохода
+  uint8_t         sealed;       /// 1 - футер заполнен, проверять есть с чем
+  uint8_t         paused;       /// 1 - ждём FW_CHECK_PERIOD_MS до следующего прохода
+  uint8_t         failed;       /// 1 - несовпадение уже обнаружено, проверка остановлена
+} FwCheck;
+
+/**
+ * @brief Начало нового прохода по образу.
+ */
+static void FW_Check_Restart(void)
+{
+  APP_CRC_Ctx_Init(&FwCheck.crc);
+  FwCheck.cursor     = _fw_image_start;
+  FwCheck.words_left = fw_footer.length / sizeof(uint32_t);
+  FwCheck.paused     = 0;
+}
+
+/**
+ * @brief Инициализация фоновой проверки образа.
+ * @details Проверяется только сам футер (несколько сравнений), чтение образа
+ *          начинается с первого свободного прохода суперцикла.
+ */
+void FW_Check_Init(void)
+{
+  const uint32_t image_len = (uint32_t)_fw_footer - (uint32_t)_fw_image_start;
+
+  FwCheck.failed = 0;
+  FwCheck.sealed = (fw_footer.magic == FW_FOOTER_MAGIC) ? 1u : 0u;
+
+  if (FwCheck.sealed)
+  {
+    /// Футер сам может быть повреждён: сверяем длину с картой памяти и инверсную копию
+    if (fw_footer.length != image_len || fw_footer.crc32 != ~fw_footer.crc32_inv)
+    {
+      FwCheck.failed = 1;
+    }
+  }
+
+  FW_Check_Restart();
+}
+
+/**
+ * @brief Шаг фоновой проверки: обработка не более FW_CHECK_CHUNK_BYTES образа.
+ * @details Вызывать из суперцикла в проходах, где не было другой работы.
+ *          Результат FW_CHECK_FAILED возвращается один раз, после чего проверка останавливается.
+ * @retval FwCheck_Result_t - состояние проверки.
+ */
+FwCheck_Result_t FW_Check_Step(void)
+{
+  if (!FwCheck.sealed)
+  {
+    return FW_CHECK_UNSEALED;
+  }
+
+  if (FwCheck.failed)
+  {
+    if (FwCheck.failed == 1u)
+    {
+      FwCheck.failed = 2u;    /// Сообщаем об ошибке однократно
+      return FW_CHECK_FAILED;
+    }
+    return FW_CHECK_BUSY;
+  }
+
+  if (FwCheck.paused)
+  {
+    if ((HAL_GetTick() - FwCheck.pause_from) < FW_CHECK_PERIOD_MS)
+    {
+      return FW_CHECK_BUSY;
+    }
+    FW_Check_Restart();
+  }
+
+  /// Очередная порция образа
+  uint32_t words = FW_CHECK_CHUNK_BYTES / sizeof(uint32_t);
+  if (words > FwCheck.words_left)
+  {
+    words = FwCheck.words_left;
+  }
+
+  APP_CRC_Accumulate(&FwCheck.crc, FwCheck.cursor, words);
+  FwCheck.cursor     += words;
+  FwCheck.words_left -= words;
+
+  if (FwCheck.words_left != 0u)
+  {
+    return FW_CHECK_BUSY;
+  }
+
+  /// Проход завершён - сравниваем и уходим на паузу
+  FwCheck.paused     = 1;
+  FwCheck.pause_from = HAL_GetTick();
+
+  if (FwCheck.crc.crc != fw_footer.crc32)
+  {
+    FwCheck.failed = 2u;
+    return FW_CHECK_FAILED;
+  }
+  return FW_CHECK_PASSED;
+}
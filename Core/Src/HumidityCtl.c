@@ -0,0 +1,119 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include <string.h>
+#include "HumidityCtl.h"
+#include "MachineTrace.h"
+#include "AppAtomic.h"
+
+_Static_assert(HUM_CTL_MIN_ON_TICKS + HUM_CTL_MIN_OFF_TICKS <= HUM_CTL_WINDOW_TICKS,
+               "HumidityCtl: minimum on/off times do not fit the window");
+_Static_assert(HUM_CTL_MAX_OPEN_MS == MACHINE_TRACE_AUTO_OPEN_MS,
+               "MachineTrace.h: MACHINE_TRACE_AUTO_OPEN_MS does not match HumidityCtl.h");
+
+/** Тики TIM4, ещё не переданные автомату (пишет прерывание, забирает суперцикл) */
+static volatile uint32_t hum_ctl_ticks_pending = 0;
+
+/**
+ * @brief Сброс регулятора: клапан закрыт, новое окно начнётся со следующего тика.
+ */
+void Humidity_Ctl_Init(HumidityCtl_t *ctl)
+{
+  memset(ctl, 0, sizeof(*ctl));
+
+  ctl->pid.Kp = HUM_CTL_KP;
+  ctl->pid.Ki = HUM_CTL_KI;
+  ctl->pid.Kd = HUM_CTL_KD;
+  arm_pid_init_f32(&ctl->pid, 1);
+}
+
+/**
+ * @brief Один тик регулятора.
+ * @param rh_dpct Измеренная влажность, 0.1 %.
+ * @retval 1 - клапан должен быть открыт.
+ */
+uint8_t Humidity_Ctl_Step(HumidityCtl_t *ctl, const int16_t rh_dpct)
+{
+  if (ctl->tick == 0u)
+  {
+    const float32_t error = (float32_t)(HUM_CTL_SETPOINT - rh_dpct) * 0.1f;   /// %RH
+    float32_t       duty  = arm_pid_f32(&ctl->pid, error);
+
+    if (duty > 1.0f)
+    {
+      duty = 1.0f;
+    }
+    else if (duty < 0.0f)
+    {
+      duty = 0.0f;
+    }
+    ctl->pid.state[2] = duty;   /// Анти-виндап: следующий шаг продолжается от ограниченного выхода
+    ctl->duty         = duty;
+
+    uint32_t on_ticks = (uint32_t)(duty * (float32_t)HUM_CTL_WINDOW_TICKS + 0.5f);
+    if (on_ticks < HUM_CTL_MIN_ON_TICKS)
+    {
+      on_ticks = 0;
+    }
+    if (on_ticks > HUM_CTL_WINDOW_TICKS - HUM_CTL_MIN_OFF_TICKS)
+    {
+      on_ticks = HUM_CTL_WINDOW_TICKS - HUM_CTL_MIN_OFF_TICKS;
+    }
+    ctl->on_ticks = (uint16_t)on_ticks;
+  }
+
+  const uint8_t open = (ctl->tick < ctl->on_ticks) ? 1u : 0u;
+  if (open != ctl->valve)
+  {
+    ctl->valve = open;
+    ctl->switches++;
+  }
+
+  if (++ctl->tick >= HUM_CTL_WINDOW_TICKS)
+  {
+    ctl->tick = 0;
+  }
+  return open;
+}
+
+/**
+ * @brief TIM4: прерывание по переполнению с частотой HUM_CTL_TICK_HZ.
+ * @details Такт APB1 x2 (делитель APB1 = 2): 20 МГц / 20000 = 1 кГц, / 100 = 10 Гц.
+ */
+void Humidity_Ctl_Timer_Init(void)
+{
+  __HAL_RCC_TIM4_CLK_ENABLE();
+
+  const uint32_t tim_clk = HAL_RCC_GetPCLK1Freq() * 2u;
+  TIM4->CR1  = 0;
+  TIM4->PSC  = tim_clk / 1000u - 1u;
+  TIM4->ARR  = 1000u / HUM_CTL_TICK_HZ - 1u;
+  TIM4->EGR  = TIM_EGR_UG;
+  TIM4->SR   = 0;
+  TIM4->DIER = TIM_DIER_UIE;
+
+  HAL_NVIC_SetPriority(TIM4_IRQn, 3, 0);
+  HAL_NVIC_EnableIRQ(TIM4_IRQn);
+  TIM4->CR1  = TIM_CR1_CEN;
+}
+
+/**
+ * @brief Прерывание TIM4: только счёт тиков.
+ */
+void Humidity_Ctl_Timer_IRQHandler(void)
+{
+  if (TIM4->SR & TIM_SR_UIF)
+  {
+    TIM4->SR = ~(uint32_t)TIM_SR_UIF;
+    hum_ctl_ticks_pending++;
+  }
+}
+
+/**
+ * @brief Забрать один накопленный тик (вызывать из суперцикла до возврата 0).
+ */
+uint8_t Humidity_Ctl_Take_Tick(void)
+{
+  return App_Atomic_Take(&hum_ctl_ticks_pending);   /// LDREX/STREX: тик из прерывания не теряется
+}
@@ -0,0 +1,155 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include <string.h>
+#include "MachineTrace.h"
+
+/** Кольцевой буфер трассы и проверка на лету */
+static struct {
+  MachineTrace_Record_t  ring[MACHINE_TRACE_DEPTH];
+  uint32_t               written;   /// Всего записей с момента старта
+  MachineTrace_Checker_t checker;
+} Trace;
+
+/**
+ * @brief Начальное состояние проверки: READY, клапан закрыт.
+ */
+void Machine_Trace_Checker_Init(MachineTrace_Checker_t *checker)
+{
+  memset(checker, 0, sizeof(*checker));
+  checker->prev_state = STATE_READY;
+}
+
+/**
+ * @brief Проверка очередной записи трассы.
+ * @details Только арифметика над записями - никакой периферии.
+ * @retval MachineTrace_Violation_t - первое нарушенное свойство или TRACE_OK.
+ */
+MachineTrace_Violation_t Machine_Trace_Checker_Step(MachineTrace_Checker_t *checker,
+                                                    const MachineTrace_Record_t *record)
+{
+  MachineTrace_Violation_t result = TRACE_OK;
+
+  if (checker->started && record->t_us < checker->last_us)
+  {
+    result = TRACE_TIME_ORDER;
+  }
+
+  /// Клапан: открывается только в COUNTDOWN (не дольше cfg_sec + допуск)
+  /// и в AUTO (не дольше окна регулятора без минимального закрытия + допуск)
+  if (record->valve == OPEN)
+  {
+    if (!checker->valve_open)
+    {
+      checker->valve_open = 1;
+      checker->open_us    = record->t_us;
+      checker->open_limit = ((record->state == STATE_AUTO) ? MACHINE_TRACE_AUTO_OPEN_MS * 1000u
+                                                           : (uint32_t)record->cfg_sec * APP_TIME_HZ) +
+                            MACHINE_TRACE_OPEN_SLACK;
+    }
+    if (record->state != STATE_COUNTDOWN && record->state != STATE_AUTO)
+    {
+      result = TRACE_VALVE_STATE;
+    }
+    else if (result == TRACE_OK && record->t_us - checker->open_us > checker->open_limit)
+    {
+      result = TRACE_VALVE_TIMEOUT;
+    }
+  }
+  else
+  {
+    checker->valve_open = 0;
+  }
+
+  /// CONFIG завершается только переходом в READY (с сохранением), в AUTO (пункт "Aut") или аварией
+  if (checker->prev_state == STATE_CONFIG && record->state != STATE_CONFIG &&
+      record->state != STATE_READY && record->state != STATE_AUTO && record->state != STATE_FAULT)
+  {
+    result = TRACE_CONFIG_EXIT;
+  }
+
+  checker->prev_state = record->state;
+  checker->last_us    = record->t_us;
+  checker->started    = 1;
+  return result;
+}
+
+/**
+ * @brief Проверка готовой трассы (например, снимка кольцевого буфера).
+ * @param bad_index Индекс первой записи с нарушением (может быть NULL).
+ */
+MachineTrace_Violation_t Machine_Trace_Check(const MachineTrace_Record_t *trace, const uint32_t count,
+                                             uint32_t *bad_index)
+{
+  MachineTrace_Checker_t checker;
+  Machine_Trace_Checker_Init(&checker);
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    const MachineTrace_Violation_t result = Machine_Trace_Checker_Step(&checker, &trace[i]);
+    if (result != TRACE_OK)
+    {
+      if (bad_index != NULL)
+      {
+        *bad_index = i;
+      }
+      return result;
+    }
+  }
+  return TRACE_OK;
+}
+
+/**
+ * @brief Запись события и результата его обработки в трассу с проверкой свойств.
+ * @details Вызывать сразу после Machine_Process() с тем же событием.
+ * @retval MachineTrace_Violation_t - нарушение, обнаруженное на этой записи.
+ */
+MachineTrace_Violation_t Machine_Trace_Record(const uint64_t t_us, const MachineEvent_t event,
+                                              const MachineState_Context_t *ctx,
+                                              const Seg7_Handle_t *seg7)
+{
+  if (event == EVENT_TICK_1S && ctx->machine_state == STATE_READY &&
+      Trace.checker.prev_state == STATE_READY)
+  {
+    return TRACE_OK;   /// Пустой тик: в READY автомат его игнорирует
+  }
+  if (event == EVENT_CONTROL_TICK && ctx->machine_state == Trace.checker.prev_state &&
+      (ctx->valve_state == OPEN) == (Trace.checker.valve_open != 0u))
+  {
+    return TRACE_OK;   /// Тик регулятора без переключения клапана
+  }
+
+  MachineTrace_Record_t *record = &Trace.ring[Trace.written % MACHINE_TRACE_DEPTH];
+
+  record->t_us    = t_us;
+  record->event   = (uint8_t)event;
+  record->state   = (uint8_t)ctx->machine_state;
+  record->valve   = (uint8_t)ctx->valve_state;
+  record->cur_sec = ctx->cur_sec;
+  record->cfg_sec = ctx->cfg_sec;
+  memcpy(record->digits, seg7->digit_buf, sizeof(record->digits));
+
+  Trace.written++;
+  return Machine_Trace_Checker_Step(&Trace.checker, record);
+}
+
+/**
+ * @brief Копия трассы от старой записи к новой.
+ * @retval Количество скопированных записей.
+ */
+uint32_t Machine_Trace_Snapshot(MachineTrace_Record_t *dst, const uint32_t max_count)
+{
+  uint32_t count = (Trace.written < MACHINE_TRACE_DEPTH) ? Trace.written : MACHINE_TRACE_DEPTH;
+  if (count > max_count)
+  {
+    count = max_count;
+  }
+
+  const uint32_t first = Trace.written - count;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    dst[i] = Trace.ring[(first + i) % MACHINE_TRACE_DEPTH];
+  }
+  return count;
+}
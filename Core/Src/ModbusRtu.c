@@ -0,0 +1,503 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include <stddef.h>
+#include <string.h>
+#include "ModbusRtu.h"
+#include "AppFlashConfig.h"
+#include "AppAtomic.h"
+#ifdef ROOM_SENSE
+#include "RoomSense.h"
+#endif
+
+_Static_assert((MODBUS_RX_RING & (MODBUS_RX_RING - 1u)) == 0u, "MODBUS_RX_RING must be a power of two");
+_Static_assert((MODBUS_FRAME_QUEUE & (MODBUS_FRAME_QUEUE - 1u)) == 0u, "MODBUS_FRAME_QUEUE must be a power of two");
+
+/** CRC-16/MODBUS (полином 0xA001 отражённый, начальное 0xFFFF): байт за шаг по таблице */
+static const uint16_t crc16_table[256] = {
+  0x0000u, 0xC0C1u, 0xC181u, 0x0140u, 0xC301u, 0x03C0u, 0x0280u, 0xC241u,
+  0xC601u, 0x06C0u, 0x0780u, 0xC741u, 0x0500u, 0xC5C1u, 0xC481u, 0x0440u,
+  0xCC01u, 0x0CC0u, 0x0D80u, 0xCD41u, 0x0F00u, 0xCFC1u, 0xCE81u, 0x0E40u,
+  0x0A00u, 0xCAC1u, 0xCB81u, 0x0B40u, 0xC901u, 0x09C0u, 0x0880u, 0xC841u,
+  0xD801u, 0x18C0u, 0x1980u, 0xD941u, 0x1B00u, 0xDBC1u, 0xDA81u, 0x1A40u,
+  0x1E00u, 0xDEC1u, 0xDF81u, 0x1F40u, 0xDD01u, 0x1DC0u, 0x1C80u, 0xDC41u,
+  0x1400u, 0xD4C1u, 0xD581u, 0x1540u, 0xD701u, 0x17C0u, 0x1680u, 0xD641u,
+  0xD201u, 0x12C0u, 0x1380u, 0xD341u, 0x1100u, 0xD1C1u, 0xD081u, 0x1040u,
+  0xF001u, 0x30C0u, 0x3180u, 0xF141u, 0x3300u, 0xF3C1u, 0xF281u, 0x3240u,
+  0x3600u, 0xF6C1u, 0xF781u, 0x3740u, 0xF501u, 0x35C0u, 0x3480u, 0xF441u,
+  0x3C00u, 0xFCC1u, 0xFD81u, 0x3D40u, 0xFF01u, 0x3FC0u, 0x3E80u, 0xFE41u,
+  0xFA01u, 0x3AC0u, 0x3B80u, 0xFB41u, 0x3900u, 0xF9C1u, 0xF881u, 0x3840u,
+  0x2800u, 0xE8C1u, 0xE981u, 0x2940u, 0xEB01u, 0x2BC0u, 0x2A80u, 0xEA41u,
+  0xEE01u, 0x2EC0u, 0x2F80u, 0xEF41u, 0x2D00u, 0xEDC1u, 0xEC81u, 0x2C40u,
+  0xE401u, 0x24C0u, 0x2580u, 0xE541u, 0x2700u, 0xE7C1u, 0xE681u, 0x2640u,
+  0x2200u, 0xE2C1u, 0xE381u, 0x2340u, 0xE101u, 0x21C0u, 0x2080u, 0xE041u,
+  0xA001u, 0x60C0u, 0x6180u, 0xA141u, 0x6300u, 0xA3C1u, 0xA281u, 0x6240u,
+  0x6600u, 0xA6C1u, 0xA781u, 0x6740u, 0xA501u, 0x65C0u, 0x6480u, 0xA441u,
+  0x6C00u, 0xACC1u, 0xAD81u, 0x6D40u, 0xAF01u, 0x6FC0u, 0x6E80u, 0xAE41u,
+  0xAA01u, 0x6AC0u, 0x6B80u, 0xAB41u, 0x6900u, 0xA9C1u, 0xA881u, 0x6840u,
+  0x7800u, 0xB8C1u, 0xB981u, 0x7940u, 0xBB01u, 0x7BC0u, 0x7A80u, 0xBA41u,
+  0xBE01u, 0x7EC0u, 0x7F80u, 0xBF41u, 0x7D00u, 0xBDC1u, 0xBC81u, 0x7C40u,
+  0xB401u, 0x74C0u, 0x7580u, 0xB541u, 0x7700u, 0xB7C1u, 0xB681u, 0x7640u,
+  0x7200u, 0xB2C1u, 0xB381u, 0x7340u, 0xB101u, 0x71C0u, 0x7080u, 0xB041u,
+  0x5000u, 0x90C1u, 0x9181u, 0x5140u, 0x9301u, 0x53C0u, 0x5280u, 0x9241u,
+  0x9601u, 0x56C0u, 0x5780u, 0x9741u, 0x5500u, 0x95C1u, 0x9481u, 0x5440u,
+  0x9C01u, 0x5CC0u, 0x5D80u, 0x9D41u, 0x5F00u, 0x9FC1u, 0x9E81u, 0x5E40u,
+  0x5A00u, 0x9AC1u, 0x9B81u, 0x5B40u, 0x9901u, 0x59C0u, 0x5880u, 0x9841u,
+  0x8801u, 0x48C0u, 0x4980u, 0x8941u, 0x4B00u, 0x8BC1u, 0x8A81u, 0x4A40u,
+  0x4E00u, 0x8EC1u, 0x8F81u, 0x4F40u, 0x8D01u, 0x4DC0u, 0x4C80u, 0x8C41u,
+  0x4400u, 0x84C1u, 0x8581u, 0x4540u, 0x8701u, 0x47C0u, 0x4680u, 0x8641u,
+  0x8201u, 0x42C0u, 0x4380u, 0x8341u, 0x4100u, 0x81C1u, 0x8081u, 0x4040u
+};
+
+/** Откуда берётся регистр: база, к которой прибавляется смещение поля */
+typedef enum {
+  MODBUS_SRC_MACHINE = 0,   /// MachineState_Context_t
+  MODBUS_SRC_BUS     = 1,   /// ModbusRtu_Stats_t
+  MODBUS_SRC_SENSE   = 2,   /// RoomSense_Filter_t
+  MODBUS_SRC_COUNT
+} ModbusSource_t;
+
+/** Регистр = поле существующей структуры (1 или 2 байта), для записи - допустимый диапазон */
+typedef struct {
+  uint8_t  source;
+  uint8_t  offset;
+  uint8_t  size;
+  uint16_t min;
+  uint16_t max;
+} ModbusReg_t;
+
+#define MODBUS_FIELD(src, type, field, lo, hi) \
+  { (src), (uint8_t)offsetof(type, field), (uint8_t)sizeof(((type *)0)->field), (lo), (hi) }
+#define MODBUS_RO(src, type, field)  MODBUS_FIELD(src, type, field, 0u, 0u)
+
+static const ModbusReg_t holding_regs[] = {
+  MODBUS_FIELD(MODBUS_SRC_MACHINE, MachineState_Context_t, cfg_sec, APP_CFG_SEC_MIN, APP_CFG_SEC_MAX),
+};
+
+static const ModbusReg_t input_regs[] = {
+  MODBUS_RO(MODBUS_SRC_MACHINE, MachineState_Context_t, machine_state),
+  MODBUS_RO(MODBUS_SRC_MACHINE, MachineState_Context_t, valve_state),
+  MODBUS_RO(MODBUS_SRC_MACHINE, MachineState_Context_t, cur_sec),
+  MODBUS_RO(MODBUS_SRC_MACHINE, MachineState_Context_t, fault_code),
+  MODBUS_RO(MODBUS_SRC_MACHINE, MachineState_Context_t, over_temp),
+  MODBUS_RO(MODBUS_SRC_MACHINE, MachineState_Context_t, rh_dpct),
+  MODBUS_RO(MODBUS_SRC_MACHINE, MachineState_Context_t, valve_opens),
+  MODBUS_RO(MODBUS_SRC_BUS,     ModbusRtu_Stats_t,      frames),
+  MODBUS_RO(MODBUS_SRC_BUS,     ModbusRtu_Stats_t,      crc_errors),
+  MODBUS_RO(MODBUS_SRC_BUS,     ModbusRtu_Stats_t,      exceptions),
+  MODBUS_RO(MODBUS_SRC_BUS,     ModbusRtu_Stats_t,      overruns),
+#ifdef ROOM_SENSE
+  MODBUS_RO(MODBUS_SRC_SENSE,   RoomSense_Filter_t,     temp_dc),
+#endif
+};
+
+#define MODBUS_HOLDING_COUNT  (sizeof(holding_regs) / sizeof(holding_regs[0]))
+#define MODBUS_INPUT_COUNT    (sizeof(input_regs) / sizeof(input_regs[0]))
+
+/** Концы кадров: позиции DMA в кольце по IDLE (пишет прерывание, забирает суперцикл) */
+APP_SPSC_DEFINE(modbus_frames, MODBUS_FRAME_QUEUE);
+
+/** Состояние порта: кольцо пишет DMA, очередь кадров - прерывание, остальное - суперцикл */
+static struct {
+  uint8_t              rx_ring[MODBUS_RX_RING];
+  uint8_t              rx_frame[MODBUS_ADU_MAX];
+  uint8_t              tx_frame[MODBUS_ADU_MAX];
+  uint16_t             rx_tail;                        /// Начало следующего кадра в кольце
+  uint16_t             idle_end;                       /// Позиция DMA на прошлом IDLE
+  volatile uint8_t     tx_busy;                        /// DE = 1, ответ ещё уходит
+  uint8_t              save_cfg;                       /// cfg_sec изменён - сохранить после ответа
+  uint8_t             *base[MODBUS_SRC_COUNT];
+  ModbusRtu_Stats_t    stats;
+} Modbus;
+
+/**
+ * @brief CRC-16/MODBUS.
+ * @retval CRC; в кадре передаётся младшим байтом вперёд.
+ */
+uint16_t Modbus_Crc16(const uint8_t *data, uint32_t length)
+{
+  uint16_t crc = 0xFFFFu;
+
+  while (length--)
+  {
+    crc = (uint16_t)((crc >> 8) ^ crc16_table[(crc ^ *data++) & 0xFFu]);
+  }
+  return crc;
+}
+
+/** Значение регистра (поле 1 или 2 байта, знаковые - как есть в дополнительном коде) */
+static uint16_t Modbus_Reg_Read(const ModbusReg_t *reg)
+{
+  const uint8_t *base  = Modbus.base[reg->source];
+  uint16_t       value = 0;
+
+  if (base == NULL)
+  {
+    return 0;
+  }
+
+  const uint8_t *field = base + reg->offset;
+  if (reg->size == 1u)
+  {
+    value = *field;
+  }
+  else
+  {
+    memcpy(&value, field, sizeof(value));   /// enum - 4 байта: младшие два (little-endian)
+  }
+  return value;
+}
+
+static void Modbus_Reg_Write(const ModbusReg_t *reg, const uint16_t value)
+{
+  uint8_t *field = Modbus.base[reg->source] + reg->offset;
+
+  if (reg->size == 1u)
+  {
+    *field = (uint8_t)value;
+  }
+  else
+  {
+    memcpy(field, &value, sizeof(value));
+  }
+}
+
+static inline uint16_t Modbus_Get16(const uint8_t *p)
+{
+  return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+static inline void Modbus_Put16(uint8_t *p, const uint16_t value)
+{
+  p[0] = (uint8_t)(value >> 8);
+  p[1] = (uint8_t)value;
+}
+
+/**
+ * @brief 0x03 / 0x04: чтение подряд идущих регистров таблицы.
+ * @retval Длина ответа без CRC или 0 (код исключения - в *ex).
+ */
+static uint32_t Modbus_Read(const ModbusReg_t *table, const uint32_t table_count,
+                            const uint8_t *request, const uint32_t length,
+                            uint8_t *response, ModbusException_t *ex)
+{
+  const uint16_t first = Modbus_Get16(&request[2]);
+  const uint16_t count = Modbus_Get16(&request[4]);
+
+  if (length != 8u || count == 0u || count > MODBUS_READ_MAX)
+  {
+    *ex = MODBUS_EX_ILLEGAL_VALUE;
+    return 0;
+  }
+  if ((uint32_t)first + count > table_count)
+  {
+    *ex = MODBUS_EX_ILLEGAL_ADDRESS;
+    return 0;
+  }
+
+  response[2] = (uint8_t)(count * 2u);
+  for (uint32_t i = 0; i < count; i++)
+  {
+    Modbus_Put16(&response[3u + i * 2u], Modbus_Reg_Read(&table[first + i]));
+  }
+  return 3u + count * 2u;
+}
+
+/**
+ * @brief Запись holding-регистров: все значения проверяются до записи первого.
+ * @param values Значения в порядке кадра (старший байт первым).
+ */
+static ModbusException_t Modbus_Write(const uint16_t first, const uint16_t count, const uint8_t *values)
+{
+  if ((uint32_t)first + count > MODBUS_HOLDING_COUNT)
+  {
+    return MODBUS_EX_ILLEGAL_ADDRESS;
+  }
+  for (uint32_t i = 0; i < count; i++)
+  {
+    const uint16_t value = Modbus_Get16(&values[i * 2u]);
+    if (value < holding_regs[first + i].min || value > holding_regs[first + i].max)
+    {
+      return MODBUS_EX_ILLEGAL_VALUE;
+    }
+  }
+
+  /// Настройки меняются только в покое: не вмешиваемся в отсчёт, CONFIG и аварию
+  const MachineState_Context_t *ctx = (const MachineState_Context_t *)Modbus.base[MODBUS_SRC_MACHINE];
+  if (ctx->machine_state != STATE_READY)
+  {
+    return MODBUS_EX_DEVICE_BUSY;
+  }
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    Modbus_Reg_Write(&holding_regs[first + i], Modbus_Get16(&values[i * 2u]));
+  }
+
+  /// Новое cfg_sec индикатор покажет на ближайшем EVENT_TICK_1S
+  if (GlobalAppConfig.cfg_sec != ctx->cfg_sec)
+  {
+    GlobalAppConfig.cfg_sec = ctx->cfg_sec;
+    Modbus.save_cfg         = 1;
+  }
+  return MODBUS_EX_NONE;
+}
+
+/**
+ * @brief Разбор одного кадра RTU и формирование ответа.
+ * @details Не обращается к периферии. Кадр с неверным CRC, чужой адрес и широковещательный
+ *          запрос (адрес 0, только запись) ответа не получают.
+ * @param request  Кадр целиком, с адресом и CRC.
+ * @param response Буфер MODBUS_ADU_MAX байт.
+ * @retval Длина ответа с CRC или 0 - отвечать не нужно.
+ */
+uint32_t Modbus_Process(const uint8_t *request, const uint32_t length, uint8_t *response)
+{
+  if (length < 4u || length > MODBUS_ADU_MAX ||
+      Modbus_Crc16(request, length - 2u) != (uint16_t)(request[length - 2u] | (request[length - 1u] << 8)))
+  {
+    Modbus.stats.crc_errors++;
+    return 0;
+  }
+
+  const uint8_t address = request[0];
+  if (address != MODBUS_SLAVE_ADDR && address != 0u)
+  {
+    return 0;
+  }
+  Modbus.stats.frames++;
+
+  const uint8_t    function = request[1];
+  ModbusException_t ex      = MODBUS_EX_NONE;
+  uint32_t         pdu_end  = 0;
+
+  response[0] = MODBUS_SLAVE_ADDR;
+  response[1] = function;
+
+  switch (function)
+  {
+    case 0x03:
+      pdu_end = Modbus_Read(holding_regs, MODBUS_HOLDING_COUNT, request, length, response, &ex);
+    break;
+
+    case 0x04:
+      pdu_end = Modbus_Read(input_regs, MODBUS_INPUT_COUNT, request, length, response, &ex);
+    break;
+
+    case 0x06:
+      if (length != 8u)
+      {
+        ex = MODBUS_EX_ILLEGAL_VALUE;
+        break;
+      }
+      ex = Modbus_Write(Modbus_Get16(&request[2]), 1u, &request[4]);
+      memcpy(&response[2], &request[2], 4u);   /// Ответ - эхо адреса и значения
+      pdu_end = 6u;
+    break;
+
+    case 0x10:
+    {
+      const uint16_t count = Modbus_Get16(&request[4]);
+      if (length < 9u || count == 0u || count > 123u ||
+          request[6] != count * 2u || length != 9u + request[6])
+      {
+        ex = MODBUS_EX_ILLEGAL_VALUE;
+        break;
+      }
+      ex = Modbus_Write(Modbus_Get16(&request[2]), count, &request[7]);
+      memcpy(&response[2], &request[2], 4u);   /// Ответ - адрес и количество
+      pdu_end = 6u;
+    }
+    break;
+
+    default:
+      ex = MODBUS_EX_ILLEGAL_FUNCTION;
+    break;
+  }
+
+  if (address == 0u)
+  {
+    return 0;
+  }
+  if (ex != MODBUS_EX_NONE)
+  {
+    response[1] = (uint8_t)(function | 0x80u);
+    response[2] = (uint8_t)ex;
+    pdu_end     = 3u;
+    Modbus.stats.exceptions++;
+  }
+
+  const uint16_t crc = Modbus_Crc16(response, pdu_end);
+  response[pdu_end]      = (uint8_t)crc;
+  response[pdu_end + 1u] = (uint8_t)(crc >> 8);
+  return pdu_end + 2u;
+}
+
+/**
+ * @brief Ответ: DE = 1, DMA2 Stream6 отдаёт кадр, DE снимается по TC в Modbus_IRQHandler().
+ */
+static void Modbus_Transmit(const uint32_t length)
+{
+  Modbus.tx_busy = 1;
+  MODBUS_DE_PORT->BSRR = MODBUS_DE_PIN;
+
+  DMA2_Stream6->CR &= ~DMA_SxCR_EN;
+  while (DMA2_Stream6->CR & DMA_SxCR_EN)
+  {
+  }
+  DMA2->HIFCR = DMA_HIFCR_CTCIF6 | DMA_HIFCR_CHTIF6 | DMA_HIFCR_CTEIF6 | DMA_HIFCR_CDMEIF6 | DMA_HIFCR_CFEIF6;
+  DMA2_Stream6->NDTR = length;
+
+  USART6->SR   = ~(uint32_t)USART_SR_TC;
+  USART6->CR1 |= USART_CR1_TCIE;
+  DMA2_Stream6->CR |= DMA_SxCR_EN;
+}
+
+/**
+ * @brief USART6 + DMA2 Stream1/Stream6, вывод DE. Приём начинается сразу.
+ * @param ctx Контекст автомата: на его поля отображаются регистры.
+ */
+void Modbus_Init(MachineState_Context_t *ctx)
+{
+  memset(&Modbus, 0, sizeof(Modbus));
+  Modbus.base[MODBUS_SRC_MACHINE] = (uint8_t *)ctx;
+  Modbus.base[MODBUS_SRC_BUS]     = (uint8_t *)&Modbus.stats;
+#ifdef ROOM_SENSE
+  Modbus.base[MODBUS_SRC_SENSE]   = (uint8_t *)Room_Sense_Get();   /// Только чтение
+#endif
+
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+  __HAL_RCC_USART6_CLK_ENABLE();
+  __HAL_RCC_DMA2_CLK_ENABLE();
+
+  /// PA8 - DE/~RE: приёмник включён, пока не отвечаем
+  HAL_GPIO_WritePin(MODBUS_DE_PORT, MODBUS_DE_PIN, GPIO_PIN_RESET);
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+  GPIO_InitStruct.Pin   = MODBUS_DE_PIN;
+  GPIO_InitStruct.Mode  = GPIO_MODE_OUTPUT_PP;
+  GPIO_InitStruct.Pull  = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+  HAL_GPIO_Init(MODBUS_DE_PORT, &GPIO_InitStruct);
+
+  /// PA11 - TX, PA12 - RX (подтяжка: выход RO драйвера в Z, пока DE = 1)
+  GPIO_InitStruct.Pin       = GPIO_PIN_11 | GPIO_PIN_12;
+  GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;
+  GPIO_InitStruct.Pull      = GPIO_PULLUP;
+  GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_HIGH;
+  GPIO_InitStruct.Alternate = GPIO_AF8_USART6;
+  HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+  /// USART6: 8N1, приём и передача через DMA, прерывание только IDLE (TC - на время ответа)
+  USART6->CR1 = 0;
+  USART6->BRR = (HAL_RCC_GetPCLK2Freq() + MODBUS_BAUD / 2u) / MODBUS_BAUD;
+  USART6->CR2 = 0;
+  USART6->CR3 = USART_CR3_DMAR | USART_CR3_DMAT;
+
+  /// DMA2 Stream1 Channel5 = USART6_RX: кольцо, байты
+  DMA2_Stream1->CR = 0;
+  while (DMA2_Stream1->CR & DMA_SxCR_EN)
+  {
+  }
+  DMA2->LIFCR = DMA_LIFCR_CTCIF1 | DMA_LIFCR_CHTIF1 | DMA_LIFCR_CTEIF1 | DMA_LIFCR_CDMEIF1 | DMA_LIFCR_CFEIF1;
+  DMA2_Stream1->PAR  = (uint32_t)&USART6->DR;
+  DMA2_Stream1->M0AR = (uint32_t)Modbus.rx_ring;
+  DMA2_Stream1->NDTR = MODBUS_RX_RING;
+  DMA2_Stream1->CR   = (5u << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_MINC | DMA_SxCR_CIRC | DMA_SxCR_EN;
+
+  /// DMA2 Stream6 Channel5 = USART6_TX: память -> периферия, запускается на каждый ответ
+  DMA2_Stream6->CR = 0;
+  while (DMA2_Stream6->CR & DMA_SxCR_EN)
+  {
+  }
+  DMA2_Stream6->PAR  = (uint32_t)&USART6->DR;
+  DMA2_Stream6->M0AR = (uint32_t)Modbus.tx_frame;
+  DMA2_Stream6->CR   = (5u << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_DIR_0 | DMA_SxCR_MINC;
+
+  HAL_NVIC_SetPriority(USART6_IRQn, 3, 0);
+  HAL_NVIC_EnableIRQ(USART6_IRQn);
+  USART6->CR1 = USART_CR1_UE | USART_CR1_TE | USART_CR1_RE | USART_CR1_IDLEIE;
+}
+
+/**
+ * @brief Прерывание USART6: IDLE - конец кадра в очередь, TC - ответ ушёл, DE = 0.
+ */
+void Modbus_IRQHandler(void)
+{
+  const uint32_t sr = USART6->SR;
+
+  if (sr & USART_SR_IDLE)
+  {
+    (void)USART6->DR;   /// SR, затем DR - сброс IDLE (и ORE/FE/NE)
+    const uint16_t end = (uint16_t)((MODBUS_RX_RING - DMA2_Stream1->NDTR) & (MODBUS_RX_RING - 1u));
+
+    if (end != Modbus.idle_end)
+    {
+      Modbus.idle_end = end;
+      if (!App_Spsc_Push(&modbus_frames, end))
+      {
+        Modbus.stats.overruns++;
+      }
+    }
+  }
+
+  if ((USART6->CR1 & USART_CR1_TCIE) && (sr & USART_SR_TC))
+  {
+    USART6->CR1 &= ~USART_CR1_TCIE;
+    MODBUS_DE_PORT->BSRR = (uint32_t)MODBUS_DE_PIN << 16;
+    Modbus.tx_busy = 0;
+  }
+}
+
+/**
+ * @brief Обработка принятых кадров (вызывать из суперцикла).
+ * @details Кадр копируется из кольца, разбирается и получает ответ. Запись cfg_sec
+ *          во Flash (с запретом прерываний на стирание) - только после ухода ответа.
+ */
+void Modbus_Poll(void)
+{
+  if (Modbus.save_cfg && !Modbus.tx_busy)
+  {
+    Modbus.save_cfg = 0;
+    APP_SAVE_CFG();
+  }
+
+  uint32_t end;
+  while (!Modbus.tx_busy && App_Spsc_Pop(&modbus_frames, &end))
+  {
+    const uint32_t length = (end - Modbus.rx_tail) & (MODBUS_RX_RING - 1u);
+
+    if (length > MODBUS_ADU_MAX)
+    {
+      Modbus.stats.crc_errors++;   /// Склеенные кадры - такого RTU не бывает
+      Modbus.rx_tail = (uint16_t)end;
+      continue;
+    }
+
+    const uint32_t first_part = MODBUS_RX_RING - Modbus.rx_tail;
+    if (length <= first_part)
+    {
+      memcpy(Modbus.rx_frame, &Modbus.rx_ring[Modbus.rx_tail], length);
+    }
+    else
+    {
+      memcpy(Modbus.rx_frame, &Modbus.rx_ring[Modbus.rx_tail], first_part);
+      memcpy(&Modbus.rx_frame[first_part], Modbus.rx_ring, length - first_part);
+    }
+    Modbus.rx_tail = (uint16_t)end;
+
+    const uint32_t reply = Modbus_Process(Modbus.rx_frame, length, Modbus.tx_frame);
+    if (reply != 0u)
+    {
+      Modbus_Transmit(reply);
+    }
+  }
+}
+
+/**
+ * @brief Счётчики шины (для отладки; те же значения - в input-регистрах).
+ */
+const ModbusRtu_Stats_t *Modbus_Get_Stats(void)
+{
+  return &Modbus.stats;
+}
@@ -0,0 +1,296 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include <string.h>
+#include "RoomSense.h"
+
+#define ROOM_SENSE_STALE_MS  (500u)   /// Нет новых блоков дольше - считаем датчики потерянными
+
+/**
+ * ФНЧ перед прореживанием: окно Хэмминга, 16 отводов, срез ~50 Гц при 1 кГц,
+ * коэффициент передачи на постоянном токе 1.0 (сумма 32766).
+ */
+static const q15_t room_sense_fir[ROOM_SENSE_FIR_TAPS] = {
+  112, 243, 618, 1293, 2217, 3225, 4089, 4586,
+  4586, 4089, 3225, 2217, 1293, 618, 243, 112
+};
+
+/** NTC 10 кОм B3950 к +3.3 В, 10 кОм к земле: отсчёт (q15) -> 0.1 °C, от -10 до +120 °C */
+static const q15_t   temp_lut_x[] = {  4800,  7510, 10857, 14537, 18163, 21410, 24109,
+                                      26237, 27858, 29067, 29963, 30624, 31114, 31479 };
+static const int16_t temp_lut_y[] = {  -100,     0,   100,   200,   300,   400,   500,
+                                         600,   700,   800,   900,  1000,  1100,  1200 };
+
+/** HIH-5030 от 3.3 В: Vout / Vdd = 0.1515 + 0.00636 * RH -> 0.1 % */
+static const q15_t   rh_lut_x[] = { 4963, 15381, 25799 };
+static const int16_t rh_lut_y[] = {    0,   500,  1000 };
+
+static const RoomSense_Lut_t temp_lut = { temp_lut_x, temp_lut_y, (uint8_t)(sizeof(temp_lut_x) / sizeof(temp_lut_x[0])) };
+static const RoomSense_Lut_t rh_lut   = { rh_lut_x,   rh_lut_y,   (uint8_t)(sizeof(rh_lut_x)   / sizeof(rh_lut_x[0]))   };
+
+_Static_assert(sizeof(temp_lut_x) == sizeof(temp_lut_y), "temp_lut: x and y differ in length");
+_Static_assert(sizeof(rh_lut_x)   == sizeof(rh_lut_y),   "rh_lut: x and y differ in length");
+
+/** Сбор: двойной буфер DMA и признаки готовых блоков (пишет прерывание, сбрасывает суперцикл) */
+static struct {
+  uint16_t           buf[2][ROOM_SENSE_BLOCK * ROOM_SENSE_CHANNELS];
+  volatile uint8_t   ready[2];
+  volatile uint32_t  overruns;      /// Блок не успели обработать до следующего
+  volatile uint32_t  dma_errors;
+  uint32_t           last_block_ms;
+  RoomSense_Filter_t filter;
+} Sense;
+
+/**
+ * @brief Кусочно-линейная интерполяция по таблице (за краями - крайние значения).
+ */
+int16_t Room_Sense_Lut(const RoomSense_Lut_t *lut, const q15_t x)
+{
+  if (x <= lut->x[0])
+  {
+    return lut->y[0];
+  }
+  if (x >= lut->x[lut->count - 1u])
+  {
+    return lut->y[lut->count - 1u];
+  }
+
+  uint8_t lo = 0;
+  uint8_t hi = (uint8_t)(lut->count - 1u);
+  while ((uint8_t)(hi - lo) > 1u)
+  {
+    const uint8_t mid = (uint8_t)((lo + hi) / 2u);
+    if (x < lut->x[mid])
+    {
+      hi = mid;
+    }
+    else
+    {
+      lo = mid;
+    }
+  }
+
+  return (int16_t)(lut->y[lo] + ((int32_t)(lut->y[hi] - lut->y[lo]) * (x - lut->x[lo])) /
+                                (lut->x[hi] - lut->x[lo]));
+}
+
+/**
+ * @brief Начальное состояние обработки: пустые линии задержки, значений нет.
+ */
+void Room_Sense_Filter_Init(RoomSense_Filter_t *filter)
+{
+  memset(filter, 0, sizeof(*filter));
+
+  for (uint32_t ch = 0; ch < ROOM_SENSE_CHANNELS; ch++)
+  {
+    arm_fir_decimate_init_q15(&filter->fir[ch], ROOM_SENSE_FIR_TAPS, ROOM_SENSE_DECIMATE,
+                              room_sense_fir, filter->fir_state[ch], ROOM_SENSE_BLOCK);
+  }
+}
+
+/**
+ * @brief Обработка одного блока кадров {T, RH}: единственный проход по отсчётам.
+ * @param frames ROOM_SENSE_BLOCK кадров по ROOM_SENSE_CHANNELS 12-битных отсчётов.
+ */
+void Room_Sense_Filter_Block(RoomSense_Filter_t *filter, const uint16_t *frames)
+{
+  for (uint32_t ch = 0; ch < ROOM_SENSE_CHANNELS; ch++)
+  {
+    for (uint32_t i = 0; i < ROOM_SENSE_BLOCK; i++)
+    {
+      filter->in[i] = (q15_t)(frames[i * ROOM_SENSE_CHANNELS + ch] << 3);   /// 12 бит -> q15
+    }
+    arm_fir_decimate_q15(&filter->fir[ch], filter->in, filter->out, ROOM_SENSE_BLOCK);
+    arm_mean_q15(filter->out, ROOM_SENSE_BLOCK / ROOM_SENSE_DECIMATE, &filter->mean[ch]);
+  }
+
+  filter->temp_dc = Room_Sense_Lut(&temp_lut, filter->mean[0]);
+  filter->rh_dpct = Room_Sense_Lut(&rh_lut,   filter->mean[1]);
+  filter->valid   = 1;
+}
+
+/**
+ * @brief Событие автомата по последним значениям (не больше одного за вызов).
+ * @details Перегрев снимается после остывания на ROOM_SENSE_TEMP_HYST; цель по влажности
+ *          срабатывает повторно только после падения на ROOM_SENSE_RH_HYST.
+ */
+MachineEvent_t Room_Sense_Filter_Event(RoomSense_Filter_t *filter)
+{
+  if (!filter->valid)
+  {
+    return EVENT_NONE;
+  }
+
+  if (!filter->over_temp && filter->temp_dc >= ROOM_SENSE_TEMP_LIMIT)
+  {
+    filter->over_temp = 1;
+    return EVENT_OVER_TEMP;
+  }
+  if (filter->over_temp && filter->temp_dc <= ROOM_SENSE_TEMP_LIMIT - ROOM_SENSE_TEMP_HYST)
+  {
+    filter->over_temp = 0;
+    return EVENT_TEMP_OK;
+  }
+
+  if (!filter->rh_reached && filter->rh_dpct >= ROOM_SENSE_RH_TARGET)
+  {
+    filter->rh_reached = 1;
+    return EVENT_RH_REACHED;
+  }
+  if (filter->rh_reached && filter->rh_dpct <= ROOM_SENSE_RH_TARGET - ROOM_SENSE_RH_HYST)
+  {
+    filter->rh_reached = 0;
+  }
+  return EVENT_NONE;
+}
+
+/**
+ * @brief Запуск сбора: PA0/PA1 - аналоговые входы, ADC1 по TRGO TIM2, DMA2 Stream4 (DBM).
+ * @details Вызывать после MX_GPIO_Init(): PA0/PA1 переводятся из выходов сегментов в аналог.
+ */
+void Room_Sense_Init(void)
+{
+  Room_Sense_Filter_Init(&Sense.filter);
+  Sense.last_block_ms = HAL_GetTick();
+
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+  __HAL_RCC_ADC1_CLK_ENABLE();
+  __HAL_RCC_DMA2_CLK_ENABLE();
+  __HAL_RCC_TIM2_CLK_ENABLE();
+
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+  GPIO_InitStruct.Pin  = GPIO_PIN_0 | GPIO_PIN_1;
+  GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+  HAL_NVIC_SetPriority(DMA2_Stream4_IRQn, 2, 0);
+  HAL_NVIC_EnableIRQ(DMA2_Stream4_IRQn);
+
+  Room_Sense_Resume();
+}
+
+/**
+ * @brief Остановка сбора: ADC1 и DMA2 Stream4 освобождаются (например, для ValveMonitor.h).
+ * @details Недозаполненный буфер отбрасывается; отметки готовых буферов сохраняются.
+ */
+void Room_Sense_Pause(void)
+{
+  TIM2->CR1 = 0;
+  ADC1->CR2 = 0;
+  DMA2_Stream4->CR &= ~DMA_SxCR_EN;
+  while (DMA2_Stream4->CR & DMA_SxCR_EN)
+  {
+  }
+  DMA2->HIFCR = DMA_HIFCR_CTCIF4 | DMA_HIFCR_CHTIF4 | DMA_HIFCR_CTEIF4 | DMA_HIFCR_CDMEIF4 | DMA_HIFCR_CFEIF4;
+}
+
+/**
+ * @brief (Пере)запуск сбора: настройка ADC1, DMA2 Stream4 и TIM2 с нуля, запись - с буфера 0.
+ */
+void Room_Sense_Resume(void)
+{
+  /// ADC1: PCLK2 / 2 = 10 МГц, скан IN0, IN1 по 480 тактов (высокоомный делитель NTC)
+  ADC->CCR    &= ~ADC_CCR_ADCPRE;
+  ADC1->CR2    = 0;
+  ADC1->CR1    = ADC_CR1_SCAN;
+  ADC1->SMPR2  = (7u << ADC_SMPR2_SMP0_Pos) | (7u << ADC_SMPR2_SMP1_Pos);
+  ADC1->SQR1   = (ROOM_SENSE_CHANNELS - 1u) << ADC_SQR1_L_Pos;
+  ADC1->SQR3   = (0u << ADC_SQR3_SQ1_Pos) | (1u << ADC_SQR3_SQ2_Pos);
+
+  /// DMA2 Stream4 Channel0 = ADC1: периферия -> память, полуслова, двойной буфер
+  DMA2_Stream4->CR = 0;
+  while (DMA2_Stream4->CR & DMA_SxCR_EN)
+  {
+  }
+  DMA2_Stream4->PAR  = (uint32_t)&ADC1->DR;
+  DMA2_Stream4->M0AR = (uint32_t)Sense.buf[0];
+  DMA2_Stream4->M1AR = (uint32_t)Sense.buf[1];
+  DMA2_Stream4->NDTR = ROOM_SENSE_BLOCK * ROOM_SENSE_CHANNELS;
+  DMA2_Stream4->CR   = (0u << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_PL_1 | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 |
+                       DMA_SxCR_MINC | DMA_SxCR_CIRC | DMA_SxCR_DBM | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+  DMA2->HIFCR = DMA_HIFCR_CTCIF4 | DMA_HIFCR_CHTIF4 | DMA_HIFCR_CTEIF4 | DMA_HIFCR_CDMEIF4 | DMA_HIFCR_CFEIF4;
+  DMA2_Stream4->CR  |= DMA_SxCR_EN;
+
+  /// Запуск по фронту TIM2_TRGO (EXTSEL = 0110), запросы DMA без остановки
+  ADC1->CR2 = ADC_CR2_DMA | ADC_CR2_DDS | ADC_CR2_EXTEN_0 | (6u << ADC_CR2_EXTSEL_Pos) | ADC_CR2_ADON;
+
+  /// TIM2: такт APB1 x2 (делитель APB1 = 2) -> 1 МГц -> ROOM_SENSE_RATE_HZ, TRGO по переполнению
+  const uint32_t tim_clk = HAL_RCC_GetPCLK1Freq() * 2u;
+  TIM2->CR1 = 0;
+  TIM2->PSC = tim_clk / 1000000u - 1u;
+  TIM2->ARR = 1000000u / ROOM_SENSE_RATE_HZ - 1u;
+  TIM2->CR2 = TIM_CR2_MMS_1;
+  TIM2->EGR = TIM_EGR_UG;
+  TIM2->CR1 = TIM_CR1_CEN;
+}
+
+/**
+ * @brief Прерывание DMA2 Stream4: отметка заполненного буфера, отсчёты не трогаются.
+ * @details CT указывает буфер, который DMA заполняет сейчас - готов другой.
+ */
+void Room_Sense_DMA_IRQHandler(void)
+{
+  const uint32_t flags = DMA2->HISR;
+  DMA2->HIFCR = DMA_HIFCR_CTCIF4 | DMA_HIFCR_CHTIF4 | DMA_HIFCR_CTEIF4 | DMA_HIFCR_CDMEIF4 | DMA_HIFCR_CFEIF4;
+
+  if (flags & DMA_HISR_TCIF4)
+  {
+    const uint8_t done = (DMA2_Stream4->CR & DMA_SxCR_CT) ? 0u : 1u;
+    if (Sense.ready[done])
+    {
+      Sense.overruns++;
+    }
+    Sense.ready[done] = 1;
+  }
+  if (flags & DMA_HISR_TEIF4)
+  {
+    Sense.dma_errors++;   /// Поток остановлен; блоки перестанут приходить (см. ROOM_SENSE_STALE_MS)
+  }
+}
+
+/**
+ * @brief Обработка готовых блоков (по порядку заполнения) и выдача событий (вызывать из суперцикла).
+ * @details Если блоки не приходят дольше ROOM_SENSE_STALE_MS, выдаётся EVENT_OVER_TEMP:
+ *          без датчиков пар не подаётся.
+ * @retval MachineEvent_t - событие для автомата или EVENT_NONE.
+ */
+MachineEvent_t Room_Sense_Poll(void)
+{
+  const uint32_t now = HAL_GetTick();
+
+  /// Опоздание на блок: готовы оба, старший - тот, в который DMA пишет сейчас (CT)
+  const uint8_t older = (DMA2_Stream4->CR & DMA_SxCR_CT) ? 1u : 0u;
+  for (uint8_t n = 0; n < 2u; n++)
+  {
+    const uint8_t i = (uint8_t)(older ^ n);
+    if (Sense.ready[i])
+    {
+      Room_Sense_Filter_Block(&Sense.filter, Sense.buf[i]);
+      Sense.ready[i]      = 0;
+      Sense.last_block_ms = now;
+    }
+  }
+
+  if ((now - Sense.last_block_ms) > ROOM_SENSE_STALE_MS)
+  {
+    Sense.filter.valid = 0;
+    if (!Sense.filter.over_temp)
+    {
+      Sense.filter.over_temp = 1;
+      return EVENT_OVER_TEMP;
+    }
+    return EVENT_NONE;
+  }
+
+  return Room_Sense_Filter_Event(&Sense.filter);
+}
+
+/**
+ * @brief Последние значения (для индикации и отладки).
+ */
+const RoomSense_Filter_t *Room_Sense_Get(void)
+{
+  return &Sense.filter;
+}
@@ -0,0 +1,112 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include "Seg7_Spi.h"
+
+/** Выбор разряда: байт для регистра разрядов (готовая таблица, без сдвигов в прерывании) */
+#define SEG7_SPI_SEL(i) ((uint8_t)(SEG7_SPI_DIGIT_ACTIVE_LOW ? ~(1u << (i)) : (1u << (i))))
+
+static const uint8_t digit_select[8] = {
+  SEG7_SPI_SEL(0), SEG7_SPI_SEL(1), SEG7_SPI_SEL(2), SEG7_SPI_SEL(3),
+  SEG7_SPI_SEL(4), SEG7_SPI_SEL(5), SEG7_SPI_SEL(6), SEG7_SPI_SEL(7)
+};
+
+/** Кадр для DMA: предыдущая передача (~20 мкс) давно закончена к следующему шагу мультиплекса */
+static uint8_t spi_frame[SEG7_SPI_FRAME_BYTES];
+
+/**
+ * @brief Инициализация SPI1 (только передача), DMA2 Stream3 и защёлки TIM3_CH1.
+ * @details Вызывается из Seg7_Init(); TIM3 к этому моменту уже настроен MX_TIM3_Init().
+ */
+void Seg7_Spi_Init(void)
+{
+  __HAL_RCC_GPIOB_CLK_ENABLE();
+  __HAL_RCC_SPI1_CLK_ENABLE();
+  __HAL_RCC_DMA2_CLK_ENABLE();
+
+  /// PB3 - SCK, PB5 - MOSI (AF5), PB4 - RCLK (TIM3_CH1, AF2)
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+  GPIO_InitStruct.Pin       = GPIO_PIN_3 | GPIO_PIN_5;
+  GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;
+  GPIO_InitStruct.Pull      = GPIO_NOPULL;
+  GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_HIGH;
+  GPIO_InitStruct.Alternate = GPIO_AF5_SPI1;
+  HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+
+  GPIO_InitStruct.Pin       = GPIO_PIN_4;
+  GPIO_InitStruct.Alternate = GPIO_AF2_TIM3;
+  HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+
+  /// SPI1: ведущий, режим 0 (74HC595 защёлкивает бит по фронту SRCLK), 8 бит, старшим битом вперёд
+  SPI1->CR1 = 0;
+  SPI1->CR1 = SPI_CR1_MSTR | SPI_CR1_SSM | SPI_CR1_SSI | SPI_CR1_BIDIMODE | SPI_CR1_BIDIOE |
+              SEG7_SPI_BAUD_DIV;
+  SPI1->CR2 = SPI_CR2_TXDMAEN;
+  SPI1->CR1 |= SPI_CR1_SPE;
+
+  /// DMA2 Stream3 Channel3 = SPI1_TX: память -> периферия, байты, инкремент памяти
+  DMA2_Stream3->CR = 0;
+  while (DMA2_Stream3->CR & DMA_SxCR_EN)
+  {
+  }
+  DMA2_Stream3->PAR  = (uint32_t)&SPI1->DR;
+  DMA2_Stream3->M0AR = (uint32_t)spi_frame;
+  DMA2_Stream3->CR   = (3u << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_DIR_0 | DMA_SxCR_MINC;
+
+  /// TIM3_CH1 - PWM2: низкий уровень до CCR1, высокий после - фронт RCLK раз в период мультиплекса
+  TIM3->CCMR1 = (TIM3->CCMR1 & ~(TIM_CCMR1_OC1M | TIM_CCMR1_CC1S)) |
+                TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1M_0 | TIM_CCMR1_OC1PE;
+  TIM3->CCR1  = SEG7_SPI_LATCH_CCR;
+  TIM3->CCER |= TIM_CCER_CC1E;
+}
+
+/**
+ * @brief Отправка кадра одного шага мультиплекса (вызывается из прерывания TIM3).
+ * @details Только запись трёх байт и перезапуск потока DMA; защёлка - аппаратная.
+ * @param digit   Номер разряда.
+ * @param pattern Шаблон сегментов.
+ * @param leds    Светодиоды состояния.
+ */
+void Seg7_Spi_Push(const uint8_t digit, const uint8_t pattern, const uint8_t leds)
+{
+  spi_frame[0] = leds;
+  spi_frame[1] = digit_select[digit];
+  spi_frame[2] = pattern;
+
+  DMA2_Stream3->CR &= ~DMA_SxCR_EN;
+  DMA2->LIFCR       = DMA_LIFCR_CTCIF3 | DMA_LIFCR_CHTIF3 | DMA_LIFCR_CTEIF3 |
+                      DMA_LIFCR_CDMEIF3 | DMA_LIFCR_CFEIF3;
+  DMA2_Stream3->NDTR = SEG7_SPI_FRAME_BYTES;
+  DMA2_Stream3->CR  |= DMA_SxCR_EN;
+}
+
+/**
+ * @brief Погасить цепочку: пустой кадр и защёлка вручную (TIM3 остановлен).
+ * @details Защёлка - принудительный уровень OC1 (низкий, затем высокий = фронт RCLK),
+ *          после чего канал возвращается в PWM2 для следующего запуска TIM3.
+ */
+void Seg7_Spi_Off(void)
+{
+  spi_frame[0] = 0u;
+  spi_frame[1] = (uint8_t)(SEG7_SPI_DIGIT_ACTIVE_LOW ? 0xFFu : 0x00u);
+  spi_frame[2] = 0u;
+
+  DMA2_Stream3->CR &= ~DMA_SxCR_EN;
+  DMA2->LIFCR       = DMA_LIFCR_CTCIF3 | DMA_LIFCR_CHTIF3 | DMA_LIFCR_CTEIF3 |
+                      DMA_LIFCR_CDMEIF3 | DMA_LIFCR_CFEIF3;
+  DMA2_Stream3->NDTR = SEG7_SPI_FRAME_BYTES;
+  DMA2_Stream3->CR  |= DMA_SxCR_EN;
+
+  while ((DMA2->LISR & DMA_LISR_TCIF3) == 0u)
+  {
+  }
+  while ((SPI1->SR & SPI_SR_TXE) == 0u || (SPI1->SR & SPI_SR_BSY) != 0u)
+  {
+  }
+
+  const uint32_t pwm2 = TIM3->CCMR1;
+  TIM3->CCMR1 = (pwm2 & ~TIM_CCMR1_OC1M) | TIM_CCMR1_OC1M_2;                      /// Принудительно низкий
+  TIM3->CCMR1 = (pwm2 & ~TIM_CCMR1_OC1M) | TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1M_0;   /// Принудительно высокий
+  TIM3->CCMR1 = pwm2;
+}
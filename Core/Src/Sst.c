@@ -0,0 +1,211 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include "Sst.h"
+
+#ifdef SST_PORT_HOST
+
+/** -- Хост-порт: таблица задач, маска готовых и текущий приоритет вместо NVIC -- */
+static Sst_Task_t *host_tasks[SST_HOST_MAX_TASKS];
+static uint32_t    host_count;
+static uint32_t    host_ready;
+static uint8_t     host_current = SST_HOST_THREAD_PRIO;
+
+/**
+ * @brief Запустить все готовые задачи важнее текущего приоритета, самую важную первой.
+ * @details Как NVIC при возврате из прерывания: задача выполняется с приоритетом,
+ *          равным своему, поэтому отправка из неё более важной задаче вытесняет её сразу.
+ */
+static void Sst_Host_Schedule(void)
+{
+  for (;;)
+  {
+    Sst_Task_t *next = NULL;
+    uint32_t    bit  = 0;
+
+    for (uint32_t i = 0; i < host_count; i++)
+    {
+      if ((host_ready & (1u << i)) && host_tasks[i]->prio < host_current &&
+          (next == NULL || host_tasks[i]->prio < next->prio))
+      {
+        next = host_tasks[i];
+        bit  = 1u << i;
+      }
+    }
+    if (next == NULL)
+    {
+      return;
+    }
+
+    host_ready &= ~bit;
+    const uint8_t preempted = host_current;
+    host_current = next->prio;
+    Sst_Task_Activate(next);
+    host_current = preempted;
+  }
+}
+
+static void Sst_Port_Enable(Sst_Task_t *task)
+{
+  task->irq                = (IRQn_Type)host_count;
+  host_tasks[host_count++] = task;
+}
+
+static void Sst_Port_Pend(const Sst_Task_t *task)
+{
+  host_ready |= 1u << (uint32_t)task->irq;
+  Sst_Host_Schedule();
+}
+
+/**
+ * @brief Забыть все задачи (между тестами).
+ */
+void Sst_Host_Reset(void)
+{
+  host_count   = 0;
+  host_ready   = 0;
+  host_current = SST_HOST_THREAD_PRIO;
+}
+
+/**
+ * @brief Выполнить isr как прерывание с приоритетом prio; отложенные им задачи
+ *        запускаются при "возврате", если они важнее прерванного кода.
+ */
+void Sst_Host_Isr(const uint8_t prio, void (*isr)(void))
+{
+  const uint8_t preempted = host_current;
+  host_current = prio;
+  isr();
+  host_current = preempted;
+  Sst_Host_Schedule();
+}
+
+/**
+ * @brief Приоритет кода, выполняющегося сейчас (SST_HOST_THREAD_PRIO - основной цикл).
+ */
+uint8_t Sst_Host_Current(void)
+{
+  return host_current;
+}
+
+#else
+
+/** -- Порт Cortex-M: вектор задачи в NVIC -- */
+static void Sst_Port_Enable(Sst_Task_t *task)
+{
+  HAL_NVIC_SetPriority(task->irq, task->prio, 0);
+  HAL_NVIC_ClearPendingIRQ(task->irq);
+  HAL_NVIC_EnableIRQ(task->irq);
+}
+
+static void Sst_Port_Pend(const Sst_Task_t *task)
+{
+  NVIC_SetPendingIRQ(task->irq);
+}
+
+#endif /* SST_PORT_HOST */
+
+/**
+ * @brief Инициализация задачи и разрешение её вектора.
+ * @param ring  Хранилище очереди на depth ячеек.
+ * @param depth Размер очереди: степень двойки.
+ * @param irq   Свободный вектор, обработчик которого вызывает Sst_Task_Activate(task)
+ *              (в хост-порту не используется).
+ * @param prio  Приоритет задачи = приоритет NVIC вектора.
+ * @return HAL_ERROR при неверном размере очереди.
+ */
+HAL_StatusTypeDef Sst_Task_Init(Sst_Task_t *task, const Sst_Handler_t handler, Sst_Slot_t *ring,
+                                const uint32_t depth, const IRQn_Type irq, const uint8_t prio)
+{
+  if (depth == 0u || (depth & (depth - 1u)) != 0u)
+  {
+    return HAL_ERROR;
+  }
+
+  task->handler = handler;
+  task->ring    = ring;
+  task->mask    = depth - 1u;
+  task->head    = 0;
+  task->irq     = irq;
+  task->prio    = prio;
+  atomic_init(&task->tail, 0u);
+  atomic_init(&task->lost, 0u);
+
+  for (uint32_t i = 0; i < depth; i++)
+  {
+    atomic_init(&ring[i].seq, i);   /// Ячейка i свободна для записи номер i
+  }
+
+  Sst_Port_Enable(task);
+  return HAL_OK;
+}
+
+/**
+ * @brief Отправка события задаче: из прерываний и задач любого приоритета.
+ * @details Ячейка резервируется сравнением-обменом tail; прерывание между LDREX и
+ *          STREX сбрасывает монитор, и попытка повторяется. Пока ячейка не
+ *          заполнена, читатель останавливается на ней; её писатель после
+ *          заполнения снова выставляет pending, так что события не теряются.
+ * @return HAL_BUSY, если очередь полна (событие отброшено, task->lost + 1).
+ */
+HAL_StatusTypeDef Sst_Post(Sst_Task_t *task, const uint16_t sig, const uint16_t par, const uint32_t stamp)
+{
+  uint32_t    pos = atomic_load_explicit(&task->tail, memory_order_relaxed);
+  Sst_Slot_t *slot;
+
+  for (;;)
+  {
+    slot = &task->ring[pos & task->mask];
+    const int32_t diff = (int32_t)(atomic_load_explicit(&slot->seq, memory_order_acquire) - pos);
+
+    if (diff == 0)
+    {
+      if (atomic_compare_exchange_weak_explicit(&task->tail, &pos, pos + 1u,
+                                                memory_order_relaxed, memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (diff < 0)
+    {
+      atomic_fetch_add_explicit(&task->lost, 1u, memory_order_relaxed);
+      return HAL_BUSY;
+    }
+    else
+    {
+      pos = atomic_load_explicit(&task->tail, memory_order_relaxed);   /// Ячейку занял другой писатель
+    }
+  }
+
+  slot->evt.sig   = sig;
+  slot->evt.par   = par;
+  slot->evt.stamp = stamp;
+  atomic_store_explicit(&slot->seq, pos + 1u, memory_order_release);
+
+  Sst_Port_Pend(task);
+  return HAL_OK;
+}
+
+/**
+ * @brief Разбор очереди задачи: каждое событие - до завершения обработчика.
+ *        Вызывается из обработчика вектора задачи (хост-порт - из планировщика).
+ */
+void Sst_Task_Activate(Sst_Task_t *task)
+{
+  for (;;)
+  {
+    Sst_Slot_t *slot = &task->ring[task->head & task->mask];
+
+    if (atomic_load_explicit(&slot->seq, memory_order_acquire) != task->head + 1u)
+    {
+      return;   /// Пусто или ячейка ещё заполняется
+    }
+
+    const Sst_Evt_t evt = slot->evt;
+    atomic_store_explicit(&slot->seq, task->head + task->mask + 1u, memory_order_release);
+    task->head++;
+
+    task->handler(task, &evt);
+  }
+}
@@ -6,6 +6,13 @@
 #include <State_Machine.h>
 #include <7_seg_driver.h>
 #include <AppFlashConfig.h>
+#include <AppLl.h>
+#ifdef ROOM_SENSE
+#include <HumidityCtl.h>
+#endif
+#ifdef VALVE_MONITOR
+#include <ValveMonitor.h>
+#endif
 
 /**
   * @brief Дескриптор структуры для управления 7-сегментным индикатором.
@@ -18,6 +25,11 @@
   */
 extern Seg7_Handle_t seg7_handle;
 
+#ifdef ROOM_SENSE
+/** Регулятор влажности STATE_AUTO: сбрасывается при каждом входе в состояние */
+static HumidityCtl_t humidity_ctl;
+#endif
+
 /**
   * @brief Функция для установки состояния клапана и обновления контекста машины состояний.
   *
@@ -33,7 +45,17 @@ extern Seg7_Handle_t seg7_handle;
   */
 static inline void Valve_Set (MachineState_Context_t* ctx, const Valve_State_t Valve_state_set)
 {
-  HAL_GPIO_WritePin(VALVE_GPIO_PORT, VALVE_PIN, (Valve_state_set ? GPIO_PIN_RESET : GPIO_PIN_SET));
+  App_Gpio_Write(VALVE_GPIO_PORT, VALVE_PIN, (Valve_state_set ? 0u : 1u));   /// Клапан открыт низким уровнем
+  if (Valve_state_set == OPEN && ctx->valve_state != OPEN)
+  {
+    ctx->valve_opens++;
+  }
+#ifdef VALVE_MONITOR
+  if (Valve_state_set != ctx->valve_state)
+  {
+    Valve_Monitor_Start(Valve_state_set == OPEN);   /// Пачка тока катушки - сразу после фронта
+  }
+#endif
   ctx->valve_state = Valve_state_set;
 }
 
@@ -88,10 +110,19 @@ static inline uint8_t cfg_next_3_6 (const uint8_t input_value)
   */
 void Machine_Process (MachineState_Context_t* ctx, const MachineEvent_t event)
 {
+  if (event == EVENT_OVER_TEMP)               /// Признак перегрева действует во всех состояниях
+  {
+    ctx->over_temp = 1;
+  }
+  else if (event == EVENT_TEMP_OK)
+  {
+    ctx->over_temp = 0;
+  }
+
   switch (ctx->machine_state)
   {
     case STATE_READY:
-      if (event == EVENT_BTN_SHRT_PRESS)
+      if ((event == EVENT_BTN_SHRT_PRESS || event == EVENT_SCHEDULE) && !ctx->over_temp)
       {
         ctx->machine_state = STATE_COUNTDOWN; /// 1. Перейти в состояние обратного отсчёта
 
@@ -109,9 +140,9 @@ void Machine_Process (MachineState_Context_t* ctx, const MachineEvent_t event)
 
     case STATE_COUNTDOWN:
 
-      if (event == EVENT_BTN_SHRT_PRESS)
+      if (event == EVENT_BTN_SHRT_PRESS || event == EVENT_OVER_TEMP || event == EVENT_RH_REACHED)
       {
-        ctx->machine_state  = STATE_READY;
+        ctx->machine_state  = STATE_READY;   /// Остановка кнопкой, по перегреву или по влажности
         Valve_Set(ctx, CLOSED);
         //ctx->valve_state = CLOSED;
       }
@@ -137,36 +168,109 @@ void Machine_Process (MachineState_Context_t* ctx, const MachineEvent_t event)
     case STATE_CONFIG:
       if (event == EVENT_BTN_SHRT_PRESS)
       {
+#ifdef ROOM_SENSE
+        /// После последнего значения времени - пункт "Aut", за ним снова первое
+        ctx->cur_sec = (ctx->cur_sec == DEFAULT_TIME+2) ? CONFIG_ITEM_AUTO : cfg_next_3_6(ctx->cur_sec);
+#else
         ctx->cur_sec = cfg_next_3_6(ctx->cur_sec); /// Шаг по кругу
+#endif
+      }
+#ifdef ROOM_SENSE
+      else if (event == EVENT_BTN_LONG_PRESS && ctx->cur_sec == CONFIG_ITEM_AUTO)
+      {
+        Humidity_Ctl_Init(&humidity_ctl);          /// cfg_sec не меняется: "Aut" - режим, а не время
+        ctx->machine_state = ctx->over_temp ? STATE_READY : STATE_AUTO;
       }
+#endif
       else if (event == EVENT_BTN_LONG_PRESS)
       {
         if (ctx->cfg_sec != ctx->cur_sec)
         {
           ctx->cfg_sec = ctx->cur_sec;
           GlobalAppConfig.cfg_sec = ctx->cfg_sec; /// Обновили RAM-копию
-          APP_Save_CFG_Flash();
+          APP_SAVE_CFG();
         }
         ctx->machine_state = STATE_READY;
       }
     break;
 
 
+#ifdef ROOM_SENSE
+    case STATE_AUTO:
+      if (event == EVENT_BTN_SHRT_PRESS || event == EVENT_OVER_TEMP)
+      {
+        ctx->machine_state = STATE_READY;          /// Выход кнопкой или по перегреву
+        Valve_Set(ctx, CLOSED);
+      }
+      else if (event == EVENT_CONTROL_TICK)
+      {
+        Valve_Set(ctx, Humidity_Ctl_Step(&humidity_ctl, ctx->rh_dpct) ? OPEN : CLOSED);
+      }
+    break;
+#endif
+
+    case STATE_FAULT:                           /// Авария: любые события игнорируются,
+      Valve_Set(ctx, CLOSED);                   /// клапан удерживается закрытым
+      Seg7_SetError(&seg7_handle, (uint8_t)ctx->fault_code);
+    return;
+
+
     default: /// Страховка - сброс автомата в READY
       ctx->machine_state = STATE_READY;
     break;
   }
 
-  Seg7_SetNumber(&seg7_handle,        /// Установить текущее значение числа секунд
-    (ctx->machine_state == STATE_READY) ? ctx->cfg_sec : ctx -> cur_sec);
+  if (ctx->machine_state == STATE_READY && ctx->over_temp)
+  {
+    Seg7_SetText(&seg7_handle, "Hot");   /// Перегрев: запуск запрещён
+  }
+#ifdef ROOM_SENSE
+  else if (ctx->machine_state == STATE_AUTO)
+  {
+    Seg7_SetNumber(&seg7_handle, (uint16_t)((ctx->rh_dpct > 0) ? ctx->rh_dpct / 10 : 0));   /// Влажность, %
+  }
+  else if (ctx->machine_state == STATE_CONFIG && ctx->cur_sec == CONFIG_ITEM_AUTO)
+  {
+    Seg7_SetText(&seg7_handle, "Aut");
+  }
+#endif
+  else
+  {
+    Seg7_SetNumber(&seg7_handle,        /// Установить текущее значение числа секунд
+      (ctx->machine_state == STATE_READY) ? ctx->cfg_sec : ctx -> cur_sec);
+  }
 
   if (ctx->machine_state == STATE_CONFIG)
   {
     Seg7_SetDP(&seg7_handle, NUMBER_OF_DIG-1, 1);
+    Seg7_SetBlink(&seg7_handle, 1u << (NUMBER_OF_DIG-1));   /// Редактируемое значение мигает
   }
   else
   {
     Seg7_SetDP(&seg7_handle, NUMBER_OF_DIG-1, 0);
+    Seg7_SetBlink(&seg7_handle, 0);
   }
+
+  /// Пока клапан открыт - в левом разряде бежит сегмент, справа оставшиеся секунды
+  Seg7_SetAnimation(&seg7_handle, (ctx->valve_state == OPEN) ? &seg7_anim_spinner : NULL);
 }
 
+
+
+/**
+  * @brief Функция перевода машины состояний в аварийное состояние.
+  *
+  * @details Закрывает клапан независимо от текущего состояния, запоминает код аварии
+  *          и выводит его на индикатор ("E" + две цифры кода).
+  *          Дальнейшие события в STATE_FAULT игнорируются до сброса МК.
+  *
+  * @param ctx Указатель на структуру контекста состояния машины.
+  * @param fault_code Код аварии.
+  */
+void Machine_Raise_Fault (MachineState_Context_t* ctx, const MachineFault_t fault_code)
+{
+  Valve_Set(ctx, CLOSED);
+  ctx->fault_code    = fault_code;
+  ctx->machine_state = STATE_FAULT;
+  Seg7_SetError(&seg7_handle, (uint8_t)fault_code);
+}
@@ -0,0 +1,203 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include "ValveMonitor.h"
+#include "AppAtomic.h"
+#ifdef ROOM_SENSE
+#include "RoomSense.h"
+#endif
+
+/** Пачка отсчётов и результат (пишет прерывание, код отказа забирает суперцикл) */
+static struct {
+  uint16_t                burst[VALVE_MON_SAMPLES];
+  volatile uint8_t        busy;       /// Пачка идёт, ADC1 и DMA2 Stream4 заняты
+  uint8_t                 opening;
+  volatile uint32_t       pending;    /// Отказ (MachineFault_t), ещё не переданный автомату
+  ValveMonitor_Result_t   last;
+} Monitor;
+
+/**
+ * @brief Разбор пачки тока катушки.
+ * @details Не обращается к периферии. Ток удержания - среднее последней четверти пачки;
+ *          провал ищется до неё (VALVE_MON_DIP_SAMPLES) как падение ниже пика-до-сих-пор
+ *          на VALVE_MON_DIP_PCT.
+ * @param samples Отсчёты q15 (VALVE_MON_SAMPLES).
+ * @param opening 1 - пачка снята на открытии, 0 - на закрытии.
+ * @retval MachineFault_t - FAULT_NONE или код отказа.
+ */
+MachineFault_t Valve_Monitor_Analyse(ValveMonitor_Result_t *result, q15_t *samples, const uint8_t opening)
+{
+  uint32_t peak_index;
+
+  arm_max_q15(samples, VALVE_MON_SAMPLES, &result->peak, &peak_index);
+  arm_mean_q15(&samples[VALVE_MON_SAMPLES - VALVE_MON_SAMPLES / 4u], VALVE_MON_SAMPLES / 4u, &result->hold);
+  result->first   = samples[0];
+  result->opening = opening;
+  result->dip     = 0;
+  result->fault   = FAULT_NONE;
+
+  if (!opening)
+  {
+    if (result->hold > VALVE_MON_Q15(VALVE_MON_OPEN_MA))
+    {
+      result->fault = FAULT_VALVE_DRIVER;
+    }
+    return result->fault;
+  }
+
+  if (result->peak < VALVE_MON_Q15(VALVE_MON_OPEN_MA))
+  {
+    result->fault = FAULT_COIL_OPEN;
+    return result->fault;
+  }
+  if (result->peak >= VALVE_MON_Q15(VALVE_MON_SHORT_MA) ||
+      result->hold > VALVE_MON_Q15(VALVE_MON_HOLD_MAX_MA))
+  {
+    result->fault = FAULT_COIL_SHORT;
+    return result->fault;
+  }
+
+  /// Провал тока: якорь сдвинулся и наводит встречную ЭДС
+  q15_t running_max = 0;
+  for (uint32_t i = 0; i < VALVE_MON_DIP_SAMPLES; i++)
+  {
+    if (samples[i] > running_max)
+    {
+      running_max = samples[i];
+    }
+    else if (running_max >= VALVE_MON_Q15(VALVE_MON_OPEN_MA) &&
+             (int32_t)samples[i] * 100 < (int32_t)running_max * (int32_t)(100u - VALVE_MON_DIP_PCT))
+    {
+      result->dip = 1;
+      break;
+    }
+  }
+
+  if (!result->dip ||
+      (int32_t)result->first * 100 > (int32_t)result->peak * (int32_t)VALVE_MON_RISE_PCT)
+  {
+    result->fault = FAULT_COIL_NO_INRUSH;
+  }
+  return result->fault;
+}
+
+/**
+ * @brief PA2 - аналоговый вход, тактирование ADC1 и DMA2, прерывание DMA2 Stream4.
+ */
+void Valve_Monitor_Init(void)
+{
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+  __HAL_RCC_ADC1_CLK_ENABLE();
+  __HAL_RCC_DMA2_CLK_ENABLE();
+
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+  GPIO_InitStruct.Pin  = GPIO_PIN_2;
+  GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+  HAL_NVIC_SetPriority(DMA2_Stream4_IRQn, 2, 0);
+  HAL_NVIC_EnableIRQ(DMA2_Stream4_IRQn);
+}
+
+/**
+ * @brief Запуск пачки сразу после записи в пин клапана (вызывается из Valve_Set()).
+ * @details Незаконченная пачка предыдущего переключения отбрасывается.
+ * @param opening 1 - клапан открывается, 0 - закрывается.
+ */
+void Valve_Monitor_Start(const uint8_t opening)
+{
+  HAL_NVIC_DisableIRQ(DMA2_Stream4_IRQn);   /// Окончание старой пачки не должно вклиниться в настройку
+
+#ifdef ROOM_SENSE
+  if (!Monitor.busy)
+  {
+    Room_Sense_Pause();
+  }
+#endif
+  Monitor.busy    = 1;
+  Monitor.opening = opening;
+
+  ADC1->CR2 = 0;
+  DMA2_Stream4->CR = 0;
+  while (DMA2_Stream4->CR & DMA_SxCR_EN)
+  {
+  }
+  DMA2->HIFCR = DMA_HIFCR_CTCIF4 | DMA_HIFCR_CHTIF4 | DMA_HIFCR_CTEIF4 | DMA_HIFCR_CDMEIF4 | DMA_HIFCR_CFEIF4;
+
+  /// ADC1: один канал IN2, непрерывно, 144 такта выборки (PCLK2 / 2 = 10 МГц -> 15.6 мкс на отсчёт)
+  ADC->CCR   &= ~ADC_CCR_ADCPRE;
+  ADC1->CR2   = ADC_CR2_ADON;
+  ADC1->CR1   = 0;
+  ADC1->SMPR2 = (ADC1->SMPR2 & ~ADC_SMPR2_SMP2) | (6u << ADC_SMPR2_SMP2_Pos);
+  ADC1->SQR1  = 0;
+  ADC1->SQR3  = 2u << ADC_SQR3_SQ1_Pos;
+
+  /// DMA2 Stream4 Channel0: одна пачка, без кольца
+  DMA2_Stream4->PAR  = (uint32_t)&ADC1->DR;
+  DMA2_Stream4->M0AR = (uint32_t)Monitor.burst;
+  DMA2_Stream4->NDTR = VALVE_MON_SAMPLES;
+  DMA2_Stream4->CR   = (0u << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_PL_1 | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 |
+                       DMA_SxCR_MINC | DMA_SxCR_TCIE | DMA_SxCR_TEIE | DMA_SxCR_EN;
+
+  /// Регистры выше заняли больше tSTAB (3 мкс) после ADON - можно запускать
+  ADC1->CR2 = ADC_CR2_ADON | ADC_CR2_CONT | ADC_CR2_DMA;
+  ADC1->CR2 |= ADC_CR2_SWSTART;
+
+  HAL_NVIC_EnableIRQ(DMA2_Stream4_IRQn);
+}
+
+/**
+ * @brief Прерывание DMA2 Stream4 во время пачки: остановка АЦП, разбор, при отказе - клапан закрыт.
+ * @retval 1 - прерывание относилось к пачке (иначе его обрабатывает RoomSense).
+ */
+uint8_t Valve_Monitor_DMA_IRQHandler(void)
+{
+  if (!Monitor.busy)
+  {
+    return 0;
+  }
+
+  const uint32_t flags = DMA2->HISR;
+  DMA2->HIFCR = DMA_HIFCR_CTCIF4 | DMA_HIFCR_CHTIF4 | DMA_HIFCR_CTEIF4 | DMA_HIFCR_CDMEIF4 | DMA_HIFCR_CFEIF4;
+  ADC1->CR2 = 0;
+
+  if (flags & DMA_HISR_TCIF4)
+  {
+    q15_t *samples = (q15_t *)Monitor.burst;   /// 12 бит -> q15 на месте
+    for (uint32_t i = 0; i < VALVE_MON_SAMPLES; i++)
+    {
+      samples[i] = (q15_t)(Monitor.burst[i] << 3);
+    }
+
+    if (Valve_Monitor_Analyse(&Monitor.last, samples, Monitor.opening) != FAULT_NONE)
+    {
+      VALVE_GPIO_Port->BSRR = VALVE_Pin;   /// Клапан закрыт (активный LOW), не дожидаясь автомата
+      if (Monitor.pending == FAULT_NONE)
+      {
+        Monitor.pending = (uint32_t)Monitor.last.fault;
+      }
+    }
+  }
+
+  Monitor.busy = 0;
+#ifdef ROOM_SENSE
+  Room_Sense_Resume();
+#endif
+  return 1;
+}
+
+/**
+ * @brief Код отказа катушки для автомата (вызывать из суперцикла).
+ * @retval FAULT_NONE или код отказа (выдаётся один раз).
+ */
+MachineFault_t Valve_Monitor_Poll(void)
+{
+  if (Monitor.pending == FAULT_NONE)
+  {
+    return FAULT_NONE;
+  }
+  /// Обмен, а не чтение и сброс: отказ новой пачки между ними не потеряется
+  return (MachineFault_t)App_Atomic_Exchange(&Monitor.pending, FAULT_NONE);
+}
@@ -19,6 +19,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 #include "tim.h"
+#include "usart.h"
 #include "gpio.h"
 
 /* Private includes ----------------------------------------------------------*/
@@ -27,6 +28,43 @@
 #include "State_Machine.h"
 #include "AppFlashConfig.h"
 #include "Button.h"
+#include "AppCrc.h"
+#include "FwImageCheck.h"
+#include "MachineTrace.h"
+#include "FaultCapture.h"
+#include "AppProfile.h"
+#include "AppTime.h"
+#include "AppAtomic.h"
+#include "AppLl.h"
+#include "AppRamFunc.h"
+#ifdef ROOM_SENSE
+#include "RoomSense.h"
+#include "HumidityCtl.h"
+#endif
+#ifdef VALVE_MONITOR
+#include "ValveMonitor.h"
+#endif
+#ifdef MODBUS_RTU
+#include "ModbusRtu.h"
+#endif
+#ifdef APP_BOOTLOADER
+#include "BootCtl.h"
+#endif
+#ifdef APP_RTOS2
+#include "AppTasks.h"
+#endif
+#ifdef APP_SST
+#include "AppSst.h"
+#endif
+#ifdef APP_SCHEDULE
+#include "AppSchedule.h"
+#endif
+#ifdef APP_CONSOLE
+#include "AppConsole.h"
+#endif
+#ifdef APP_BENCH
+#include "AppBench.h"
+#endif
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -36,7 +74,7 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-
+#define BUTTON_EVENT_QUEUE  (8u)   /// Событий кнопки между SysTick и суперциклом
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -46,7 +84,8 @@
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
-/*volatile*/ Seg7_Handle_t seg7_handle = {0};
+/** Индикатор: сеттеры публикуют вид под seqlock, TIM3 берёт целый снимок (7_seg_driver.c) */
+Seg7_Handle_t seg7_handle = {0};
 
 GPIO_TypeDef* digit_ports[NUMBER_OF_DIG] = {
   [0] = Q1_GPIO_Port,
@@ -71,19 +110,59 @@ MachineState_Context_t Machine_State = {
   .machine_state = STATE_READY,
   .valve_state   = CLOSED,
   .cfg_sec       = DEFAULT_TIME,
-  .cur_sec       = 0
+  .cur_sec       = 0,
+  .fault_code    = FAULT_NONE,
+  .over_temp     = 0,
+  .rh_dpct       = 0,
+  .valve_opens   = 0
 };
 
+/**
+ * События кнопки: пишет SysTick (HAL_SYSTICK_Callback), забирает суперцикл.
+ * Слово - (мкс << 8) | MachineEvent_t: младшие 24 бита App_Time_Us32() в момент события
+ * (16.7 с - с запасом больше любой задержки суперцикла).
+ */
+APP_SPSC_DEFINE(button_events, BUTTON_EVENT_QUEUE);
+static volatile uint32_t button_armed;   /// Button_Init() выполнен - SysTick может опрашивать
+
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 /* USER CODE BEGIN PFP */
+static void Machine_Dispatch(MachineEvent_t event);
+static void App_Late_Init(void);
+#ifdef APP_SCHEDULE
+static void App_Sleep(void);
+#endif
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
+/**
+ * @brief Передача события автомату с записью в трассу.
+ * @details Трасса пишется во всех сборках (снимок попадает в дамп отказа, FaultCapture.h).
+ *          Проверка свойств действует только в отладочной сборке (DEBUG): нарушение,
+ *          например клапан открыт дольше cfg_sec + 1 с, - авария E02. В выпуске
+ *          свойства проверяет хост-тест test/test_machine_trace.c, а не устройство в парной.
+ */
+static void Machine_Dispatch(const MachineEvent_t event)
+{
+  Machine_Process(&Machine_State, event);
+
+  const MachineTrace_Violation_t violation =
+    Machine_Trace_Record(App_Time_Us(), event, &Machine_State, &seg7_handle);
+#ifdef DEBUG
+  if (violation != TRACE_OK && Machine_State.machine_state != STATE_FAULT)
+  {
+    Machine_Raise_Fault(&Machine_State, FAULT_LOGIC);
+  }
+#else
+  (void)violation;
+#endif
+}
+
 /* USER CODE END 0 */
 
 /**
@@ -94,7 +173,9 @@ int main(void)
 {
 
   /* USER CODE BEGIN 1 */
-
+#ifdef APP_RAMFUNC
+  App_RamFunc_Init();   /// Векторы в ОЗУ: мультиплекс и кнопка работают и во время стирания Flash
+#endif
   /* USER CODE END 1 */
 
   /* MCU Configuration--------------------------------------------------------*/
@@ -109,6 +190,9 @@ int main(void)
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
+#ifdef APP_BENCH
+  App_Bench_Run();   /// До настройки выводов: замеряемый код не трогает сегменты и клапан
+#endif
   /* USER CODE END SysInit */
 
   /* Initialize all configured peripherals */
@@ -116,6 +200,10 @@ int main(void)
   MX_TIM3_Init();
   /* USER CODE BEGIN 2 */
 
+  /// --- Ранний этап: клапан закрыт стартовым кодом, до первой картинки только нужное ей ---
+  App_Time_Init();
+  App_Profile_Init();
+  APP_CRC_Init();
   APP_Load_CFG_Flash();
   Machine_State.cfg_sec = GlobalAppConfig.cfg_sec;
 
@@ -123,12 +211,38 @@ int main(void)
   Seg7_SetNumber(&seg7_handle, Machine_State.cfg_sec);
   Seg7_UpdateIndicator(&seg7_handle);
 
-  Button_Init(K1_GPIO_Port, K1_Pin, HIGH);
-
-  HAL_TIM_Base_Start_IT(&htim3);
+  /// Предыдущий запуск закончился отказом ядра - безопасный режим до следующего сброса
+  if (Fault_Capture_Init())
+  {
+    Machine_Raise_Fault(&Machine_State, (MachineFault_t)Fault_Capture_Code());
+  }
 
-  uint32_t last_ms =     HAL_GetTick();  /// Для 1мс - сканера
-  uint32_t last_tick1s = HAL_GetTick();  /// Для 1с - тика автомата
+  App_Tim3_Start();
+#ifdef APP_BENCH
+  App_Bench_Boot_Display();   /// Такты от сброса до первой картинки
+#endif
+
+  /// --- Отложенный этап: UART, кнопка и необязательные модули - индикатор уже светится ---
+  App_Late_Init();
+
+#ifdef APP_RTOS2
+  /// Дальше работают потоки AppTasks.c; суперцикл ниже в этой сборке не выполняется
+  App_Tasks_Start(&Machine_State, Machine_Dispatch);
+#endif
+
+#ifdef APP_SST
+  /// Дальше работают активные объекты AppSst.c (прерывания), суперцикл ниже не выполняется
+  App_Sst_Start(&Machine_State, Machine_Dispatch);
+#endif
+
+  uint32_t last_ms =     HAL_GetTick();  /// Тик прошлого прохода (признак свободного прохода)
+  uint64_t last_tick1s = App_Time_Us();  /// Для 1с - тика автомата, мкс (64 бита: без переполнения)
+#ifdef APP_BOOTLOADER
+  uint8_t  boot_confirmed = 0;            /// Образ подтверждён загрузчику (см. Boot/)
+#endif
+#ifdef APP_SCHEDULE
+  uint32_t last_active = HAL_GetTick();   /// Последнее нажатие или работа вне READY (отсчёт до сна)
+#endif
 
   /* USER CODE END 2 */
 
@@ -137,26 +251,115 @@ int main(void)
   while (1)
   {
     const uint32_t now = HAL_GetTick();
+    const uint8_t  idle = (last_ms == now);  /// В этом проходе не наступила новая миллисекунда
+    last_ms = now;
+    const uint64_t now_us  = App_Time_Us();
+    const uint32_t pass_us = (uint32_t)now_us;   /// Начало прохода - готовность телеметрии и проверки образа
+
+    /// --- Кнопка: шаги 1 мс идут в SysTick и не зависят от длины прохода, здесь - её события ---
+    uint32_t packed;
+    while (App_Spsc_Pop(&button_events, &packed))
+    {
+      const uint32_t at      = App_Time_Us32();
+      const uint32_t release = at - (((at << 8) - (packed & ~0xFFu)) >> 8);   /// Момент возникновения, мкс (24 бита)
+
+      App_Profile_Begin(APP_PROFILE_CONTROL);
+      Machine_Dispatch((MachineEvent_t)(packed & 0xFFu));
+      App_Profile_End_Us(APP_PROFILE_CONTROL, release);
+#ifdef APP_SCHEDULE
+      last_active = now;
+#endif
+    }
 
-    /// --- Кнопка:  строгие 1 мс шаги; "догоняем', если главный цикл задержался ---///
-    while (last_ms != now)
+    /// --- Секундный тик автомата ---
+    if ((now_us - last_tick1s) >= APP_TIME_HZ)
     {
-      last_ms++;
-      const MachineEvent_t current_event = Button_Poll_1ms();
+      last_tick1s += APP_TIME_HZ;  /// Не приравнять к NOW, а прибавить секунду
+      App_Profile_Begin(APP_PROFILE_CONTROL);
+      Machine_Dispatch(EVENT_TICK_1S);
+      App_Profile_End_Us(APP_PROFILE_CONTROL, (uint32_t)last_tick1s);
+    }
 
-      if (current_event != EVENT_NONE)
-      {
-        Machine_Process(&Machine_State, current_event);
-      }
+#ifdef APP_SCHEDULE
+    /// --- Расписание: сработавший будильник RTC - запуск, долгий простой в READY - сон STOP ---
+    if (Schedule_Take_Alarm())
+    {
+      Machine_Dispatch(EVENT_SCHEDULE);
     }
+    if (Machine_State.machine_state != STATE_READY)
+    {
+      last_active = now;
+    }
+    else if (SCHEDULE_STOP_ENABLED && (now - last_active) >= SCHEDULE_IDLE_MS)
+    {
+      App_Sleep();                       /// Тик HAL во сне стоит: отсчёты продолжаются с места
+      last_active = HAL_GetTick();
+    }
+#endif
 
-    /// --- Секундный тик автомата ---
-    if ((now - last_tick1s) >= 1000)
+#ifdef ROOM_SENSE
+    /// --- Датчики парной: готовый блок АЦП обрабатывается здесь, события - автомату ---
+    const MachineEvent_t sense_event = Room_Sense_Poll();
+    if (sense_event != EVENT_NONE)
+    {
+      Machine_Dispatch(sense_event);
+    }
+
+    /// --- Тики регулятора влажности (TIM4): все накопленные, с последним измерением ---
+    Machine_State.rh_dpct = Room_Sense_Get()->rh_dpct;
+    while (Humidity_Ctl_Take_Tick())
+    {
+      Machine_Dispatch(EVENT_CONTROL_TICK);
+    }
+#endif
+
+#ifdef VALVE_MONITOR
+    /// --- Отказ катушки клапана: клапан уже закрыт прерыванием, автомат - в аварию ---
+    const MachineFault_t coil_fault = Valve_Monitor_Poll();
+    if (coil_fault != FAULT_NONE)
+    {
+      Machine_Raise_Fault(&Machine_State, coil_fault);
+    }
+#endif
+
+    /// --- Телеметрия: Modbus RTU (кадры, отмеченные прерыванием IDLE), консоль и дамп отказа в USART1 ---
+    App_Profile_Begin(APP_PROFILE_TELEMETRY);
+#ifdef MODBUS_RTU
+    Modbus_Poll();
+#endif
+#ifdef APP_CONSOLE
+    if (App_Console_Poll())
+    {
+#ifdef APP_SCHEDULE
+      last_active = now;                 /// Оператор за консолью - не засыпать
+#endif
+    }
+#endif
+    Fault_Capture_Poll();
+    App_Profile_End_Us(APP_PROFILE_TELEMETRY, pass_us);
+
+    /// --- Фоновая проверка образа прошивки: порция 1 КБ только в свободном проходе ---
+    FwCheck_Result_t fw_check = FW_CHECK_BUSY;
+    if (idle)
     {
-      last_tick1s += 1000;  /// Не приравнять к NOW, а прибавить 1000
-      Machine_Process(&Machine_State, EVENT_TICK_1S);
+      App_Profile_Begin(APP_PROFILE_PERSIST);
+      fw_check = FW_Check_Step();
+      App_Profile_End_Us(APP_PROFILE_PERSIST, pass_us);
+    }
+    if (fw_check == FW_CHECK_FAILED)
+    {
+      Machine_Raise_Fault(&Machine_State, FAULT_FW_CRC);
     }
 
+#ifdef APP_BOOTLOADER
+    /// --- Первый полный проход проверки образа успешен: новый образ больше не откатывается ---
+    /// Образ без печати (FW_CHECK_UNSEALED) не подтверждается: проверять не с чем
+    if (!boot_confirmed && fw_check == FW_CHECK_PASSED)
+    {
+      boot_confirmed = (BootCtl_Confirm() == HAL_OK) ? 1u : 0u;
+    }
+#endif
+
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -211,11 +414,89 @@ void SystemClock_Config(void)
 }
 
 /* USER CODE BEGIN 4 */
-void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+APP_RAMCODE void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
 {
   if (htim->Instance == TIM3)
     Seg7_UpdateIndicator(&seg7_handle);
 }
+
+/**
+ * @brief Периферия и модули, не нужные до первой картинки на индикаторе.
+ * @details Выполняется после App_Tim3_Start(): USART1 (в .ioc вызов MX_USART1_UART_Init()
+ *          из main() не генерируется), отчёт замеров, фоновая проверка образа, кнопка
+ *          и необязательные модули. Разрешение кнопки - после Button_Init(): до этого
+ *          SysTick её не опрашивает.
+ */
+static void App_Late_Init(void)
+{
+  MX_USART1_UART_Init();
+#ifdef APP_BENCH
+  App_Bench_Report();
+#endif
+  FW_Check_Init();
+
+  Button_Init(K1_GPIO_Port, K1_Pin, HIGH);
+  App_Atomic_Publish(&button_armed, 1u);
+
+#ifdef VALVE_MONITOR
+  Valve_Monitor_Init();
+#endif
+
+#ifdef ROOM_SENSE
+  Room_Sense_Init();
+  Humidity_Ctl_Timer_Init();
+#endif
+
+#ifdef MODBUS_RTU
+  Modbus_Init(&Machine_State);
+#endif
+
+#ifdef APP_SCHEDULE
+  Schedule_Init(GlobalAppConfig.sched);
+#endif
+
+#ifdef APP_CONSOLE
+  App_Console_Init(&Machine_State);
+#endif
+}
+
+#ifdef APP_SCHEDULE
+/**
+ * @brief Сон STOP из READY: индикатор погашен, будят будильник расписания и кнопка.
+ */
+static void App_Sleep(void)
+{
+  App_Tim3_Stop();
+  Seg7_Off(&seg7_handle);
+  Schedule_Stop();
+  App_Tim3_Start();
+}
+#endif
+
+#if !defined(APP_RTOS2) && !defined(APP_SST)
+/**
+ * @brief Шаг кнопки в SysTick (после HAL_IncTick): строго раз в миллисекунду,
+ *        событие - в кольцо button_events для суперцикла.
+ */
+APP_RAMCODE void HAL_SYSTICK_Callback(void)
+{
+  if (!App_Atomic_Load(&button_armed))
+  {
+    return;
+  }
+
+  const uint32_t now = HAL_GetTick();
+
+  App_Profile_Begin(APP_PROFILE_INPUT);
+  const MachineEvent_t event = Button_Poll_1ms();
+  App_Profile_End(APP_PROFILE_INPUT, now);
+
+  if (event != EVENT_NONE)
+  {
+    (void)App_Spsc_Push(&button_events, (App_Time_Us32() << 8) | (uint32_t)event);
+  }
+}
+#endif
 /* USER CODE END 4 */
 
 /**
@@ -22,6 +22,31 @@
 #include "stm32f4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "AppLl.h"
+#include "AppRamFunc.h"
+#include "AppTime.h"
+#ifdef ROOM_SENSE
+#include "RoomSense.h"
+#include "HumidityCtl.h"
+#endif
+#ifdef VALVE_MONITOR
+#include "ValveMonitor.h"
+#endif
+#ifdef MODBUS_RTU
+#include "ModbusRtu.h"
+#endif
+#ifdef APP_RTOS2
+#include "AppTasks.h"
+#endif
+#ifdef APP_SST
+#include "AppSst.h"
+#endif
+#ifdef APP_SCHEDULE
+#include "AppSchedule.h"
+#endif
+#ifdef APP_BENCH
+#include "AppBench.h"
+#endif
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -46,7 +71,9 @@
 
 /* Private function prototypes -----------------------------------------------*/
 /* USER CODE BEGIN PFP */
-
+/** Мультиплекс и тик с кнопкой выполняются из ОЗУ (APP_RAMFUNC): работают во время стирания Flash */
+APP_RAMCODE void TIM3_IRQHandler(void);
+APP_RAMCODE void SysTick_Handler(void);
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
@@ -78,66 +105,7 @@ void NMI_Handler(void)
   /* USER CODE END NonMaskableInt_IRQn 1 */
 }
 
-/**
-  * @brief This function handles Hard fault interrupt.
-  */
-void HardFault_Handler(void)
-{
-  /* USER CODE BEGIN HardFault_IRQn 0 */
-
-  /* USER CODE END HardFault_IRQn 0 */
-  while (1)
-  {
-    /* USER CODE BEGIN W1_HardFault_IRQn 0 */
-    /* USER CODE END W1_HardFault_IRQn 0 */
-  }
-}
-
-/**
-  * @brief This function handles Memory management fault.
-  */
-void MemManage_Handler(void)
-{
-  /* USER CODE BEGIN MemoryManagement_IRQn 0 */
-
-  /* USER CODE END MemoryManagement_IRQn 0 */
-  while (1)
-  {
-    /* USER CODE BEGIN W1_MemoryManagement_IRQn 0 */
-    /* USER CODE END W1_MemoryManagement_IRQn 0 */
-  }
-}
-
-/**
-  * @brief This function handles Pre-fetch fault, memory access fault.
-  */
-void BusFault_Handler(void)
-{
-  /* USER CODE BEGIN BusFault_IRQn 0 */
-
-  /* USER CODE END BusFault_IRQn 0 */
-  while (1)
-  {
-    /* USER CODE BEGIN W1_BusFault_IRQn 0 */
-    /* USER CODE END W1_BusFault_IRQn 0 */
-  }
-}
-
-/**
-  * @brief This function handles Undefined instruction or illegal state.
-  */
-void UsageFault_Handler(void)
-{
-  /* USER CODE BEGIN UsageFault_IRQn 0 */
-
-  /* USER CODE END UsageFault_IRQn 0 */
-  while (1)
-  {
-    /* USER CODE BEGIN W1_UsageFault_IRQn 0 */
-    /* USER CODE END W1_UsageFault_IRQn 0 */
-  }
-}
-
+#ifndef APP_RTOS2   /* SVC, PendSV и SysTick в сборке с RTOS2 - у ядра RTX5 (irq_armv7m.S) */
 /**
   * @brief This function handles System service call via SWI instruction.
   */
@@ -150,6 +118,7 @@ void SVC_Handler(void)
 
   /* USER CODE END SVCall_IRQn 1 */
 }
+#endif /* APP_RTOS2 */
 
 /**
   * @brief This function handles Debug monitor.
@@ -164,6 +133,7 @@ void DebugMon_Handler(void)
   /* USER CODE END DebugMonitor_IRQn 1 */
 }
 
+#ifndef APP_RTOS2
 /**
   * @brief This function handles Pendable request for system service.
   */
@@ -187,9 +157,17 @@ void SysTick_Handler(void)
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
+#ifdef APP_SST
+  App_Sst_Tick_IRQHandler();
+#elif defined(APP_RAMFUNC)
+  HAL_SYSTICK_Callback();     /// То же, что HAL_SYSTICK_IRQHandler(), без вызова кода во Flash
+#else
+  HAL_SYSTICK_IRQHandler();   /// HAL_SYSTICK_Callback() в main.c: шаг кнопки
+#endif
 
   /* USER CODE END SysTick_IRQn 1 */
 }
+#endif /* APP_RTOS2 */
 
 /******************************************************************************/
 /* STM32F4xx Peripheral Interrupt Handlers                                    */
@@ -204,7 +182,14 @@ void SysTick_Handler(void)
 void TIM3_IRQHandler(void)
 {
   /* USER CODE BEGIN TIM3_IRQn 0 */
-
+#ifdef APP_LL_TIM
+  /// Только событие обновления: разбор всех флагов в HAL_TIM_IRQHandler() не нужен
+  if (App_Tim3_Take_Update())
+  {
+    HAL_TIM_PeriodElapsedCallback(&htim3);
+  }
+  return;
+#endif
   /* USER CODE END TIM3_IRQn 0 */
   HAL_TIM_IRQHandler(&htim3);
   /* USER CODE BEGIN TIM3_IRQn 1 */
@@ -213,5 +198,123 @@ void TIM3_IRQHandler(void)
 }
 
 /* USER CODE BEGIN 1 */
+/**
+  * @brief This function handles TIM5 global interrupt (microsecond timebase overflow, AppTime.h).
+  */
+void TIM5_IRQHandler(void)
+{
+  App_Time_IRQHandler();
+}
+
+#if defined(ROOM_SENSE) || defined(VALVE_MONITOR)
+/**
+  * @brief This function handles DMA2 stream4 global interrupt (ADC1: RoomSense.h, ValveMonitor.h).
+  */
+void DMA2_Stream4_IRQHandler(void)
+{
+#ifdef VALVE_MONITOR
+  if (Valve_Monitor_DMA_IRQHandler())
+  {
+    return;   /// Поток был занят пачкой тока катушки
+  }
+#endif
+#ifdef ROOM_SENSE
+  Room_Sense_DMA_IRQHandler();
+#endif
+}
+#endif
+
+#ifdef ROOM_SENSE
+
+/**
+  * @brief This function handles TIM4 global interrupt (humidity controller tick, HumidityCtl.h).
+  */
+void TIM4_IRQHandler(void)
+{
+  Humidity_Ctl_Timer_IRQHandler();
+}
+#endif
+
+#ifdef MODBUS_RTU
+/**
+  * @brief This function handles USART6 global interrupt (Modbus RTU: IDLE and TC, ModbusRtu.h).
+  */
+void USART6_IRQHandler(void)
+{
+  Modbus_IRQHandler();
+}
+#endif
+
+#ifdef APP_RTOS2
+/**
+  * @brief This function handles TIM1 update and TIM10 global interrupt (tickless idle wake-up, AppTasks.h).
+  */
+void TIM1_UP_TIM10_IRQHandler(void)
+{
+  App_Tasks_Idle_IRQHandler();
+}
+
+/**
+  * @brief This function handles EXTI line[15:10] interrupts (K1 edge wakes the input thread, AppTasks.h).
+  */
+void EXTI15_10_IRQHandler(void)
+{
+  App_Tasks_Button_IRQHandler();
+}
+#endif
+
+#ifdef APP_SST
+/**
+  * @brief This function handles I2C1 event interrupt (SST task "button", AppSst.h).
+  */
+void I2C1_EV_IRQHandler(void)
+{
+  App_Sst_Button_IRQHandler();
+}
+
+/**
+  * @brief This function handles I2C1 error interrupt (SST task "machine", AppSst.h).
+  */
+void I2C1_ER_IRQHandler(void)
+{
+  App_Sst_Machine_IRQHandler();
+}
+
+/**
+  * @brief This function handles I2C2 event interrupt (SST task "flash", AppSst.h).
+  */
+void I2C2_EV_IRQHandler(void)
+{
+  App_Sst_Flash_IRQHandler();
+}
+#endif
+
+#ifdef APP_SCHEDULE
+/**
+  * @brief This function handles RTC alarms A and B interrupt through EXTI line 17 (AppSchedule.h).
+  */
+void RTC_Alarm_IRQHandler(void)
+{
+  Schedule_Rtc_IRQHandler();
+}
+
+/**
+  * @brief This function handles EXTI line[15:10] interrupts (K1 wake-up from STOP, AppSchedule.h).
+  */
+void EXTI15_10_IRQHandler(void)
+{
+  Schedule_Button_IRQHandler();
+}
+#endif
+
+#ifdef APP_BENCH
+/**
+  * @brief This function handles I2C2 error interrupt (software-triggered: interrupt entry benchmark, AppBench.h).
+  */
+void I2C2_ER_IRQHandler(void)
+{
+  App_Bench_IRQHandler();
+}
+#endif
 
 /* USER CODE END 1 */
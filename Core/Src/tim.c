@@ -21,7 +21,12 @@
 #include "tim.h"
 
 /* USER CODE BEGIN 0 */
+#ifdef APP_LL_TIM
+#include "stm32f4xx_ll_bus.h"
+#include "stm32f4xx_ll_tim.h"
 
+static void MX_TIM3_Ll_Init(void);
+#endif
 /* USER CODE END 0 */
 
 TIM_HandleTypeDef htim3;
@@ -31,7 +36,10 @@ void MX_TIM3_Init(void)
 {
 
   /* USER CODE BEGIN TIM3_Init 0 */
-
+#ifdef APP_LL_TIM
+  MX_TIM3_Ll_Init();   /// Те же настройки регистрами, HAL_TIM в образ не попадает
+  return;
+#endif
   /* USER CODE END TIM3_Init 0 */
 
   TIM_ClockConfigTypeDef sClockSourceConfig = {0};
@@ -107,5 +115,27 @@ void HAL_TIM_Base_MspDeInit(TIM_HandleTypeDef* tim_baseHandle)
 }
 
 /* USER CODE BEGIN 1 */
+#ifdef APP_LL_TIM
+/**
+ * @brief TIM3 без HAL: PSC = 8399, ARR = 9, счёт вверх, без предзагрузки ARR (как в .ioc).
+ * @details Прерывание разрешает App_Tim3_Start() (AppLl.h), обработчик - TIM3_IRQHandler.
+ */
+static void MX_TIM3_Ll_Init(void)
+{
+  LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_TIM3);
 
+  LL_TIM_SetCounterMode(TIM3, LL_TIM_COUNTERMODE_UP);
+  LL_TIM_SetClockDivision(TIM3, LL_TIM_CLOCKDIVISION_DIV1);
+  LL_TIM_DisableARRPreload(TIM3);
+  LL_TIM_SetPrescaler(TIM3, 8399);
+  LL_TIM_SetAutoReload(TIM3, 9);
+  LL_TIM_GenerateEvent_UPDATE(TIM3);   /// PSC вступает в силу только по событию обновления
+  LL_TIM_ClearFlag_UPDATE(TIM3);
+
+  htim3.Instance = TIM3;               /// HAL_TIM_PeriodElapsedCallback() различает таймер по Instance
+
+  NVIC_SetPriority(TIM3_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 0, 0));
+  NVIC_EnableIRQ(TIM3_IRQn);
+}
+#endif
 /* USER CODE END 1 */
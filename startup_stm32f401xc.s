@@ -39,6 +39,11 @@ defined in linker script */
 .word  _sdata
 /* end address for the .data section. defined in linker script */
 .word  _edata
+/* start address of the RAM code (.ramfunc) and of its initializers. defined in linker script */
+.word  _siramfunc
+.word  _sramfunc
+/* end address of the RAM code. defined in linker script */
+.word  _eramfunc
 /* start address for the .bss section. defined in linker script */
 .word  _sbss
 /* end address for the .bss section. defined in linker script */
@@ -59,40 +64,64 @@ defined in linker script */
   .type  Reset_Handler, %function
 Reset_Handler:  
   ldr   sp, =_estack      /* set stack pointer */
-  
+
+/* Start the cycle counter (DWT->CYCCNT): reset-to-valve-safe and reset-to-first-display
+   are measured from here. Behind the bootloader the count continues from its reset. */
+  ldr   r0, =0xE000EDFC   /* CoreDebug->DEMCR */
+  ldr   r1, [r0]
+  orr   r1, r1, #0x01000000  /* TRCENA */
+  str   r1, [r0]
+  ldr   r0, =0xE0001000   /* DWT->CTRL */
+#ifndef APP_BOOTLOADER
+  movs  r1, #0
+  str   r1, [r0, #4]      /* DWT->CYCCNT */
+#endif
+  ldr   r1, [r0]
+  orr   r1, r1, #1        /* CYCCNTENA */
+  str   r1, [r0]
+
+/* Valve safe first: the valve (PB12) is active LOW, ODR is set to 1 before the pin
+   becomes an output, so it never drives 0. MX_GPIO_Init() configures it the same way. */
+  ldr   r2, =0x40023830   /* RCC->AHB1ENR */
+  ldr   r1, [r2]
+  orr   r1, r1, #0x2      /* GPIOBEN */
+  str   r1, [r2]
+  dsb
+  ldr   r2, =0x40020400   /* GPIOB */
+  mov   r1, #0x1000       /* BS12 */
+  str   r1, [r2, #0x18]   /* GPIOB->BSRR */
+  ldr   r1, [r2]          /* GPIOB->MODER: MODER12 = 01, output */
+  bic   r1, r1, #0x03000000
+  orr   r1, r1, #0x01000000
+  str   r1, [r2]
+  ldr   r8, [r0, #4]      /* valve safe, cycles: stored into App_Boot_Valve_Cycles after .bss */
+
+/* Prefetch, instruction and data caches of the flash (ART) before the copy loops */
+  ldr   r2, =0x40023C00   /* FLASH->ACR */
+  ldr   r1, [r2]
+  orr   r1, r1, #0x700    /* PRFTEN | ICEN | DCEN */
+  str   r1, [r2]
+
 /* Call the clock system initialization function.*/
   bl  SystemInit  
 
-/* Copy the data segment initializers from flash to SRAM */  
+/* Copy the RAM code (.ramfunc) and the data segment initializers from flash to SRAM */
+  ldr r0, =_sramfunc
+  ldr r1, =_eramfunc
+  ldr r2, =_siramfunc
+  bl  CopyWords
   ldr r0, =_sdata
   ldr r1, =_edata
   ldr r2, =_sidata
-  movs r3, #0
-  b LoopCopyDataInit
+  bl  CopyWords
 
-CopyDataInit:
-  ldr r4, [r2, r3]
-  str r4, [r0, r3]
-  adds r3, r3, #4
-
-LoopCopyDataInit:
-  adds r4, r0, r3
-  cmp r4, r1
-  bcc CopyDataInit
-  
 /* Zero fill the bss segment. */
-  ldr r2, =_sbss
-  ldr r4, =_ebss
-  movs r3, #0
-  b LoopFillZerobss
-
-FillZerobss:
-  str  r3, [r2]
-  adds r2, r2, #4
+  ldr r0, =_sbss
+  ldr r1, =_ebss
+  bl  ZeroWords
 
-LoopFillZerobss:
-  cmp r2, r4
-  bcc FillZerobss
+  ldr r0, =App_Boot_Valve_Cycles
+  str r8, [r0]
 
 /* Call static constructors */
     bl __libc_init_array
@@ -101,6 +130,72 @@ LoopFillZerobss:
   bx  lr    
 .size  Reset_Handler, .-Reset_Handler
 
+/**
+ * @brief  Copy words from r2 to [r0, r1): four words per ldm/stm, then word by word.
+ *         The linker script aligns both ends of every section to 4 bytes.
+ * @param  r0 destination, r1 destination end, r2 source
+ * @retval None; r3-r6 are clobbered, r8 is preserved
+*/
+  .thumb_func
+  .type  CopyWords, %function
+CopyWords:
+  adds  r3, r0, #16
+  cmp   r3, r1
+  bhi   CopyWordsTail
+  ldmia r2!, {r3, r4, r5, r6}
+  stmia r0!, {r3, r4, r5, r6}
+  b     CopyWords
+
+CopyWordsTail:
+  cmp   r0, r1
+  bhs   CopyWordsDone
+  ldr   r3, [r2], #4
+  str   r3, [r0], #4
+  b     CopyWordsTail
+
+CopyWordsDone:
+  bx    lr
+.size  CopyWords, .-CopyWords
+
+/**
+ * @brief  Zero [r0, r1): four words per stm, then word by word.
+ * @param  r0 start, r1 end
+ * @retval None; r2-r6 are clobbered, r8 is preserved
+*/
+  .thumb_func
+  .type  ZeroWords, %function
+ZeroWords:
+  movs  r3, #0
+  movs  r4, #0
+  movs  r5, #0
+  movs  r6, #0
+
+ZeroWordsBlock:
+  adds  r2, r0, #16
+  cmp   r2, r1
+  bhi   ZeroWordsTail
+  stmia r0!, {r3, r4, r5, r6}
+  b     ZeroWordsBlock
+
+ZeroWordsTail:
+  cmp   r0, r1
+  bhs   ZeroWordsDone
+  str   r3, [r0], #4
+  b     ZeroWordsTail
+
+ZeroWordsDone:
+  bx    lr
+.size  ZeroWords, .-ZeroWords
+
+/* Cycles from reset to the valve being safe (DWT->CYCCNT), read by AppBench.c */
+  .section  .bss.App_Boot_Valve_Cycles,"aw",%nobits
+  .align 2
+  .global  App_Boot_Valve_Cycles
+  .type  App_Boot_Valve_Cycles, %object
+App_Boot_Valve_Cycles:
+  .space 4
+.size  App_Boot_Valve_Cycles, .-App_Boot_Valve_Cycles
+
 /**
  * @brief  This is the code that gets called when the processor receives an 
  *         unexpected interrupt.  This simply enters an infinite loop, preserving
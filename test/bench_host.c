@@ -0,0 +1,157 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * Замер горячих путей на ПК: AppBench.c (APP_BENCH_PORT_HOST) с модулями прошивки без
+ * изменений - 7_seg_driver.c, Button.c, State_Machine.c, AppFlashConfig.c, AppCrc.c.
+ * Вместо DWT->CYCCNT - счётчик тактов процессора ПК (TSC на x86-64, иначе наносекунды),
+ * вместо программного прерывания - SIGUSR1. Запись конфигурации кладётся во Flash-модель
+ * заранее: cfg_load и cfg_save замеряются, как на плате с сохранённой конфигурацией.
+ *
+ * Отчёт - те же строки JSON, что APP_BENCH печатает в USART1: в stdout или в файл. Цель
+ * bench запускает программу BENCH_HOST_RUNS раз и сравнивает медиану с базой
+ * test/bench-host.json в шагах калибровочного цикла (tools/bench_check.py --calibrated).
+ * Код возврата проверяет только полноту отчёта: такты ПК зависят от машины и нагрузки.
+ *
+ *   bench_host [файл отчёта]
+ */
+
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include "host_periph.h"
+#include "host_test.h"
+#include "AppBench.h"
+#include "AppCrc.h"
+#include "AppFlashConfig.h"
+#include "7_seg_driver.h"
+
+Seg7_Handle_t      seg7_handle;
+uint32_t           App_Boot_Valve_Cycles;
+UART_HandleTypeDef huart1;   /// HAL_UART_Transmit() хоста пишет в host_uart_tx
+TIM_HandleTypeDef  htim3;
+
+uint32_t App_Bench_Host_Cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return (uint32_t)__builtin_ia32_rdtsc();
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+  return (uint32_t)((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec);
+#endif
+}
+
+static void bench_signal(int sig)
+{
+  (void)sig;
+  App_Bench_IRQHandler();
+}
+
+void App_Bench_Host_Raise(void)
+{
+  raise(SIGUSR1);
+}
+
+/** -- Flash HAL и TIM3: конфигурация не меняется, записи нет -- */
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim)
+{
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim)
+{
+  CHECK(0);
+  return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+  CHECK(0);
+  return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+  CHECK(0);
+  return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError)
+{
+  CHECK(0);
+  return HAL_ERROR;
+}
+
+/**
+ * @brief Сохранённая конфигурация во Flash-модели (как APP_Save_CFG_Flash()).
+ */
+static void bench_store_config(void)
+{
+  AppFlashConfig_t config;
+
+  memset(&config, 0, sizeof(config));
+  config.magic       = APP_CFG_MAGIC;
+  config.version     = APP_CFG_VERSION;
+  config.cfg_sec     = APP_CFG_SEC_DEFAULT;
+  config.cfg_sec_inv = ~config.cfg_sec;
+  config.crc32       = APP_CRC_Calc((const uint32_t *)&config, APP_CFG_CRC_WORDS);
+  memcpy((void *)(uintptr_t)FLASH_CFG_ADDR, &config, sizeof(config));
+}
+
+int main(int argc, char **argv)
+{
+  static const char *const names[] = {
+    "\"seg7_update\"", "\"seg7_set_number\"", "\"button_poll\"", "\"cfg_load\"", "\"cfg_save\"",
+    "\"isr_entry\"", "\"machine/READY/BTN_SHRT_PRESS\"", "\"machine/FAULT/SCHEDULE\""
+  };
+
+  signal(SIGUSR1, bench_signal);
+  APP_CRC_Init();
+  bench_store_config();
+
+  App_Bench_Run();
+  App_Bench_Report();
+
+  /// Отчёт целиком: начало, конец, все замеры
+  CHECK(host_uart_tx_len < HOST_UART_CAPTURE);
+  host_uart_tx[host_uart_tx_len < HOST_UART_CAPTURE ? host_uart_tx_len : HOST_UART_CAPTURE - 1u] = '\0';
+  const char *report = (const char *)host_uart_tx;
+  CHECK(strncmp(report, "BENCH BEGIN\r\n", 13u) == 0);
+  CHECK(strstr(report, "BENCH END\r\n") != NULL);
+  CHECK(strstr(report, "\"calib\":") != NULL);
+  for (uint32_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+  {
+    if (strstr(report, names[i]) == NULL)
+    {
+      fprintf(stderr, "bench_host: no %s in the report\n", names[i]);
+      CHECK(0);
+    }
+  }
+  uint32_t machine = 0;
+  for (const char *p = strstr(report, "\"machine/"); p != NULL; p = strstr(p + 1, "\"machine/"))
+  {
+    machine++;
+  }
+  CHECK_EQ(machine, 4u * 9u);
+  CHECK_EQ(GlobalAppConfig.cfg_sec, APP_CFG_SEC_DEFAULT);   /// Загружена сохранённая запись
+
+  FILE *out = (argc > 1) ? fopen(argv[1], "w") : stdout;
+  CHECK(out != NULL);
+  if (out != NULL)
+  {
+    fputs(report, out);
+    if (out != stdout)
+    {
+      fclose(out);
+    }
+  }
+  return HOST_TEST_RESULT("bench_host");
+}
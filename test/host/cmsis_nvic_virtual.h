@@ -0,0 +1,45 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef TEST_HOST_CMSIS_NVIC_VIRTUAL_H
+#define TEST_HOST_CMSIS_NVIC_VIRTUAL_H
+
+/**
+ * Хост-сборка: NVIC через точку расширения CMSIS (CMSIS_NVIC_VIRTUAL, core_cm4.h).
+ * ISER/ICER на плате - регистры установки и сброса: запись единицы меняет один бит.
+ * В отображённой памяти запись ISER[n] затёрла бы остальные разрешения слова, поэтому
+ * NVIC_EnableIRQ()/NVIC_DisableIRQ() здесь ставят и снимают бит в ISER (его и читает
+ * NVIC_GetEnableIRQ()). Остальные функции - те же, что без виртуализации.
+ */
+
+#define NVIC_SetPriorityGrouping    __NVIC_SetPriorityGrouping
+#define NVIC_GetPriorityGrouping    __NVIC_GetPriorityGrouping
+#define NVIC_EnableIRQ              host_nvic_enable_irq
+#define NVIC_GetEnableIRQ           __NVIC_GetEnableIRQ
+#define NVIC_DisableIRQ             host_nvic_disable_irq
+#define NVIC_GetPendingIRQ          __NVIC_GetPendingIRQ
+#define NVIC_SetPendingIRQ          __NVIC_SetPendingIRQ
+#define NVIC_ClearPendingIRQ        __NVIC_ClearPendingIRQ
+#define NVIC_GetActive              __NVIC_GetActive
+#define NVIC_SetPriority            __NVIC_SetPriority
+#define NVIC_GetPriority            __NVIC_GetPriority
+#define NVIC_SystemReset            __NVIC_SystemReset
+
+__STATIC_INLINE void host_nvic_enable_irq(IRQn_Type IRQn)
+{
+  if ((int32_t)(IRQn) >= 0)
+  {
+    NVIC->ISER[((uint32_t)IRQn) >> 5UL] |= (uint32_t)(1UL << (((uint32_t)IRQn) & 0x1FUL));
+  }
+}
+
+__STATIC_INLINE void host_nvic_disable_irq(IRQn_Type IRQn)
+{
+  if ((int32_t)(IRQn) >= 0)
+  {
+    NVIC->ISER[((uint32_t)IRQn) >> 5UL] &= ~(uint32_t)(1UL << (((uint32_t)IRQn) & 0x1FUL));
+  }
+}
+
+#endif //TEST_HOST_CMSIS_NVIC_VIRTUAL_H
@@ -0,0 +1,116 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef TEST_HOST_CMSIS_H
+#define TEST_HOST_CMSIS_H
+
+/**
+ *  ---------------------------------------------------------
+ *  - Хост-сборка модулей прошивки: замена cmsis_gcc.h       -
+ *  ---------------------------------------------------------
+ *
+ * Подключается ко всем файлам хост-тестов (-include), вместе с -D__CMSIS_GCC_H:
+ * настоящий cmsis_gcc.h пропускается, а заголовки CMSIS и HAL берутся без изменений.
+ * Встроенные функции ядра здесь на C: барьеры - барьеры компилятора, LDREX/STREX -
+ * обычные чтение/запись (тест однопоточный либо сам моделирует вытеснение),
+ * PRIMASK/BASEPRI - переменные, по которым тест видит запреты прерываний.
+ *
+ * Регистры периферии остаются по своим адресам: host_periph.c отображает туда ОЗУ
+ * (mmap), поэтому модули работают с GPIOx, TIMx, FLASH, SCB и т.д. как на плате.
+ */
+
+#include <stdint.h>
+
+/** Определения компилятора из cmsis_gcc.h */
+#define __ASM                                  __asm
+#define __INLINE                               inline
+#define __STATIC_INLINE                        static inline
+#define __STATIC_FORCEINLINE                   __attribute__((always_inline)) static inline
+#define __NO_RETURN                            __attribute__((__noreturn__))
+#define __USED                                 __attribute__((used))
+#define __WEAK                                 __attribute__((weak))
+#define __PACKED                               __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT                        struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION                         union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)                           __attribute__((aligned(x)))
+#define __RESTRICT                             __restrict
+#define __COMPILER_BARRIER()                   __asm volatile("" ::: "memory")
+#define __UNALIGNED_UINT16_READ(addr)          (*(const uint16_t *)(const void *)(addr))
+#define __UNALIGNED_UINT16_WRITE(addr, val)    (void)(*(uint16_t *)(void *)(addr) = (val))
+#define __UNALIGNED_UINT32_READ(addr)          (*(const uint32_t *)(const void *)(addr))
+#define __UNALIGNED_UINT32_WRITE(addr, val)    (void)(*(uint32_t *)(void *)(addr) = (val))
+
+/** Состояние "ядра", которое видят тесты */
+extern volatile uint32_t host_primask;    /// 1 - __disable_irq()
+extern volatile uint32_t host_basepri;
+extern volatile uint32_t host_ipsr;       /// Номер исключения (0 - основной код)
+extern volatile uint32_t host_wfi_count;  /// Выполнено __WFI()/__WFE()
+
+void host_wfi(void);                      /// __WFI(): счёт, в host_sim.c - ещё и сон в модельном времени
+
+/** Барьеры и подсказки */
+#define __NOP()      __COMPILER_BARRIER()
+#define __SEV()      __COMPILER_BARRIER()
+#define __WFI()      host_wfi()
+#define __WFE()      ((void)(host_wfi_count++))
+#define __BKPT(v)    __builtin_trap()
+
+__STATIC_FORCEINLINE void __ISB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+__STATIC_FORCEINLINE void __DSB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+__STATIC_FORCEINLINE void __DMB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+
+/** Прерывания */
+__STATIC_FORCEINLINE void     __enable_irq(void)            { host_primask = 0u; __DMB(); }
+__STATIC_FORCEINLINE void     __disable_irq(void)           { __DMB(); host_primask = 1u; }
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void)           { return host_primask; }
+__STATIC_FORCEINLINE void     __set_PRIMASK(uint32_t value) { host_primask = value; }
+__STATIC_FORCEINLINE uint32_t __get_BASEPRI(void)           { return host_basepri; }
+__STATIC_FORCEINLINE void     __set_BASEPRI(uint32_t value) { host_basepri = value; }
+__STATIC_FORCEINLINE uint32_t __get_IPSR(void)              { return host_ipsr; }
+__STATIC_FORCEINLINE void     __set_MSP(uint32_t value)     { (void)value; }
+
+/** Эксклюзивный доступ: монитор не нужен, хост-тесты без настоящего вытеснения */
+__STATIC_FORCEINLINE uint32_t __LDREXW(volatile uint32_t *addr) { return __atomic_load_n(addr, __ATOMIC_SEQ_CST); }
+__STATIC_FORCEINLINE uint32_t __STREXW(uint32_t value, volatile uint32_t *addr)
+{
+  __atomic_store_n(addr, value, __ATOMIC_SEQ_CST);
+  return 0u;
+}
+__STATIC_FORCEINLINE void __CLREX(void) { }
+
+/** Битовые операции */
+__STATIC_FORCEINLINE uint32_t __REV(uint32_t value)   { return __builtin_bswap32(value); }
+__STATIC_FORCEINLINE uint32_t __REV16(uint32_t value)
+{
+  return ((value & 0x00FF00FFu) << 8) | ((value >> 8) & 0x00FF00FFu);
+}
+__STATIC_FORCEINLINE uint32_t __RBIT(uint32_t value)
+{
+  uint32_t result = 0;
+  for (uint32_t i = 0; i < 32u; i++)
+  {
+    result = (result << 1) | ((value >> i) & 1u);
+  }
+  return result;
+}
+__STATIC_FORCEINLINE uint8_t __CLZ(uint32_t value) { return value ? (uint8_t)__builtin_clz(value) : 32u; }
+__STATIC_FORCEINLINE uint32_t __ROR(uint32_t op1, uint32_t op2)
+{
+  op2 %= 32u;
+  return op2 ? (op1 >> op2) | (op1 << (32u - op2)) : op1;
+}
+
+__STATIC_FORCEINLINE int32_t __SSAT(int32_t val, uint32_t sat)
+{
+  const int32_t max = (int32_t)((1u << (sat - 1u)) - 1u);
+  const int32_t min = -1 - max;
+  return val > max ? max : (val < min ? min : val);
+}
+__STATIC_FORCEINLINE uint32_t __USAT(int32_t val, uint32_t sat)
+{
+  const uint32_t max = (1u << sat) - 1u;
+  return val < 0 ? 0u : ((uint32_t)val > max ? max : (uint32_t)val);
+}
+
+#endif //TEST_HOST_CMSIS_H
@@ -0,0 +1,157 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_periph.h"
+#include "main.h"
+
+/** Тик HAL: тест двигает время сам (host_tick_advance), HAL_Delay() - тоже.
+ *  HAL_GetTick() слабая: в сборке APP_RTOS2 тик - счётчик ядра (AppTasks.c) */
+volatile uint32_t uwTick;
+uint32_t SystemCoreClock = 20000000u;   /// HCLK платы (SystemClock_Config)
+
+uint8_t  host_uart_tx[HOST_UART_CAPTURE];
+uint32_t host_uart_tx_len;
+uint32_t host_error_count;
+uint8_t  host_error_allowed;
+
+__attribute__((weak)) uint32_t HAL_GetTick(void)
+{
+  return uwTick;
+}
+
+void HAL_IncTick(void)
+{
+  uwTick++;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+  uwTick += Delay;
+}
+
+void host_tick_advance(const uint32_t ms)
+{
+  uwTick += ms;
+}
+
+HAL_StatusTypeDef HAL_Init(void)
+{
+  return HAL_OK;
+}
+
+/** -- Такты (SystemClock_Config: HCLK 20 МГц, APB1 / 2, APB2 / 1) -- */
+
+uint32_t HAL_RCC_GetHCLKFreq(void)
+{
+  return SystemCoreClock;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+  return SystemCoreClock / 2u;
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void)
+{
+  return SystemCoreClock;
+}
+
+/** -- GPIO: те же регистры, что и у HAL (ODR/BSRR/IDR в отображённой памяти) -- */
+
+/**
+ * @brief Режим, подтяжка, тип выхода, скорость и альтернативная функция - в регистры порта.
+ * @details Прерывания EXTI не моделируются: тест сам вызывает обработчик.
+ */
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+  for (uint32_t pin = 0; pin < 16u; pin++)
+  {
+    if ((GPIO_Init->Pin & (1u << pin)) == 0u)
+    {
+      continue;
+    }
+    const uint32_t shift2 = pin * 2u;
+    GPIOx->MODER   = (GPIOx->MODER   & ~(3u << shift2)) | ((GPIO_Init->Mode & GPIO_MODE) << shift2);
+    GPIOx->PUPDR   = (GPIOx->PUPDR   & ~(3u << shift2)) | (GPIO_Init->Pull << shift2);
+    GPIOx->OSPEEDR = (GPIOx->OSPEEDR & ~(3u << shift2)) | (GPIO_Init->Speed << shift2);
+    GPIOx->OTYPER  = (GPIOx->OTYPER  & ~(1u << pin)) |
+                     (((GPIO_Init->Mode & OUTPUT_TYPE) >> OUTPUT_TYPE_Pos) << pin);
+    if ((GPIO_Init->Mode & GPIO_MODE) == MODE_AF)
+    {
+      const uint32_t shift4 = (pin & 7u) * 4u;
+      GPIOx->AFR[pin >> 3] = (GPIOx->AFR[pin >> 3] & ~(0xFu << shift4)) | (GPIO_Init->Alternate << shift4);
+    }
+  }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+  return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+  /// BSRR в памяти не самосбрасывается: результат записи сразу переносится в ODR
+  if (PinState != GPIO_PIN_RESET)
+  {
+    GPIOx->ODR |= GPIO_Pin;
+  }
+  else
+  {
+    GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+  }
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+  GPIOx->ODR ^= GPIO_Pin;
+}
+
+/** -- NVIC: запись в регистры NVIC отображённого SCS -- */
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+  (void)SubPriority;
+  NVIC_SetPriority(IRQn, PreemptPriority);
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+  NVIC_EnableIRQ(IRQn);
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+  NVIC_DisableIRQ(IRQn);
+}
+
+/** -- USART1: передача сохраняется в host_uart_tx -- */
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size,
+                                    uint32_t Timeout)
+{
+  (void)huart;
+  (void)Timeout;
+  for (uint16_t i = 0; i < Size && host_uart_tx_len < HOST_UART_CAPTURE; i++)
+  {
+    host_uart_tx[host_uart_tx_len++] = pData[i];
+  }
+  return HAL_OK;
+}
+
+/**
+ * @brief Error_Handler() на плате не возвращается; в тесте - ошибка, если не ожидалась.
+ */
+void Error_Handler(void)
+{
+  host_error_count++;
+  if (!host_error_allowed)
+  {
+    fprintf(stderr, "Error_Handler() called\n");
+    exit(3);
+  }
+}
@@ -0,0 +1,67 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "host_periph.h"
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE MAP_FIXED
+#endif
+
+/** Окна адресов STM32F401, на которые отображается ОЗУ процесса */
+static const struct {
+  uintptr_t base;
+  size_t    size;
+  uint8_t   fill;   /// Значение после host_periph_reset()
+} host_windows[] = {
+  { FLASH_BASE,  FLASH_END + 1u - FLASH_BASE, 0xFFu },   /// Flash: стёрта
+  { PERIPH_BASE, 0x00080000u,                 0x00u },   /// APB1, APB2, AHB1
+  { 0xE0000000u, 0x00100000u,                 0x00u },   /// PPB: SCS, DWT, CoreDebug, DBGMCU
+};
+
+volatile uint32_t host_primask;
+volatile uint32_t host_basepri;
+volatile uint32_t host_ipsr;
+volatile uint32_t host_wfi_count;
+
+/**
+ * @brief __WFI() хост-тестов: только счёт (модель времени host_sim.c заменяет её своей).
+ */
+__attribute__((weak)) void host_wfi(void)
+{
+  host_wfi_count++;
+}
+
+/**
+ * @brief Отображение окон до main() теста: заголовки CMSIS обращаются по адресам платы.
+ */
+__attribute__((constructor(101))) static void host_periph_map(void)
+{
+  for (size_t i = 0; i < sizeof(host_windows) / sizeof(host_windows[0]); i++)
+  {
+    void *at = mmap((void *)host_windows[i].base, host_windows[i].size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (at != (void *)host_windows[i].base)
+    {
+      fprintf(stderr, "host_periph: cannot map 0x%08lX\n", (unsigned long)host_windows[i].base);
+      exit(2);
+    }
+  }
+  host_periph_reset();
+}
+
+void host_periph_reset(void)
+{
+  for (size_t i = 0; i < sizeof(host_windows) / sizeof(host_windows[0]); i++)
+  {
+    memset((void *)host_windows[i].base, host_windows[i].fill, host_windows[i].size);
+  }
+  host_primask   = 0;
+  host_basepri   = 0;
+  host_ipsr      = 0;
+  host_wfi_count = 0;
+}
@@ -0,0 +1,36 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef TEST_HOST_PERIPH_H
+#define TEST_HOST_PERIPH_H
+
+/**
+ *  ---------------------------------------------------------
+ *  - Хост-сборка: периферия и HAL для тестов                -
+ *  ---------------------------------------------------------
+ *
+ * host_periph.c до main() отображает ОЗУ на адреса Flash, периферии и PPB (SCS, DWT):
+ * регистры - обычная память, тест сам ставит флаги и читает записанное модулем.
+ * host_hal.c - функции HAL, которые вызывают модули: тик, GPIO, NVIC, частоты,
+ * передача UART в буфер, Error_Handler() - выход с ошибкой.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+
+/** Частные макроопределения */
+#define HOST_UART_CAPTURE  (4096u)   /// Байт HAL_UART_Transmit(), которые сохраняет host_hal.c
+
+/** Внешние переменные */
+extern uint8_t  host_uart_tx[HOST_UART_CAPTURE];
+extern uint32_t host_uart_tx_len;
+extern uint32_t host_error_count;   /// Вызовов Error_Handler() (если тест разрешил их через host_error_allowed)
+extern uint8_t  host_error_allowed;
+
+/** Прототипы функций **/
+void host_periph_reset (void);
+void host_tick_advance (uint32_t ms);
+
+#endif //TEST_HOST_PERIPH_H
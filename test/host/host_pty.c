@@ -0,0 +1,87 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include "host_pty.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+/**
+ * @brief Открыть pty.
+ * @param device_fd Ведущая сторона (для прошивки), O_NONBLOCK.
+ * @retval Ведомая сторона (для теста), O_NONBLOCK; -1 - pty недоступен.
+ */
+int host_pty_open(int *device_fd)
+{
+  const int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+  {
+    return -1;
+  }
+  const int term = open(ptsname(master), O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (term < 0)
+  {
+    return -1;
+  }
+
+  struct termios raw;
+  tcgetattr(term, &raw);
+  cfmakeraw(&raw);
+  tcsetattr(term, TCSANOW, &raw);
+
+  fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+  *device_fd = master;
+  return term;
+}
+
+/**
+ * @brief Запись с терминала; возврат - когда все байты дошли до прошивки (приходят "разом").
+ * @retval Сколько байт ждёт на стороне прошивки (не меньше length - успех).
+ */
+uint32_t host_pty_send(const int term_fd, const int device_fd, const void *data, const uint32_t length)
+{
+  if (write(term_fd, data, length) != (ssize_t)length)
+  {
+    return 0u;
+  }
+
+  int queued = 0;
+  for (uint32_t wait = 0; wait < 1000u && queued < (int)length; wait++)
+  {
+    host_pty_wait(device_fd, 1);
+    (void)ioctl(device_fd, FIONREAD, &queued);
+  }
+  return (uint32_t)queued;
+}
+
+/**
+ * @brief Всё, что уже пришло на терминал (не ждёт).
+ */
+uint32_t host_pty_receive(const int term_fd, void *data, const uint32_t size)
+{
+  uint32_t total = 0;
+
+  while (total < size)
+  {
+    const ssize_t got = read(term_fd, (uint8_t *)data + total, size - total);
+    if (got <= 0)
+    {
+      break;
+    }
+    total += (uint32_t)got;
+  }
+  return total;
+}
+
+/**
+ * @brief Ждать входных байт на fd не дольше timeout_ms: pty передаёт их не мгновенно.
+ */
+void host_pty_wait(const int fd, const int timeout_ms)
+{
+  struct pollfd ready = { .fd = fd, .events = POLLIN };
+  (void)poll(&ready, 1, timeout_ms);
+}
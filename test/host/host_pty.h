@@ -0,0 +1,24 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef TEST_HOST_PTY_H
+#define TEST_HOST_PTY_H
+
+/**
+ * pty для хост-портов с дескриптором вместо USART (Console_Host_Attach(), Modbus):
+ * ведущая сторона - прошивке, без блокировки, как регистр DMA; ведомая - тесту,
+ * в сыром режиме (без эха и замены CR/LF), как провод USART.
+ *
+ * Отдельный файл: <termios.h> определяет CR1, CR2, CR3 - имена регистров CMSIS.
+ */
+
+#include <stdint.h>
+
+/** Прототипы функций **/
+int      host_pty_open    (int *device_fd);
+uint32_t host_pty_send    (int term_fd, int device_fd, const void *data, uint32_t length);
+uint32_t host_pty_receive (int term_fd, void *data, uint32_t size);
+void     host_pty_wait    (int fd, int timeout_ms);
+
+#endif //TEST_HOST_PTY_H
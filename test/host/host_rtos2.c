@@ -0,0 +1,545 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * Модель ядра CMSIS-RTOS2 для хост-прогона AppTasks.c (host_sim.h): ровно те функции, что
+ * вызывает прошивка, с поведением RTX5 там, где от него зависит отклик:
+ *   - вытеснение по приоритету; равные - по порядку готовности, вытесненный - первым;
+ *   - тик - SysTick_Handler() (1 кГц, OS_TICK_FREQ), таймауты и osDelayUntil() - в тиках;
+ *   - osKernelSuspend() - тиков до ближайшего таймаута (osWaitForever - нет ни одного),
+ *     SysTick выключен; пока ядро приостановлено, потоки не переключаются; osKernelResume()
+ *     засчитывает проспанные тики и включает SysTick;
+ *   - мьютекс с наследованием приоритета, очередь сообщений (запись без ожидания),
+ *     флаги потока; из прерывания - только готовность, переключение - после него.
+ * Цена самого ядра не моделируется (0 тактов): в таблице отклика - только работа потоков.
+ * Поток простоя - osRtxIdleThread() прошивки (tickless-сон AppTasks.c).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "host_sim.h"
+
+#define RTOS_THREADS  (8u)
+#define RTOS_QUEUES   (4u)
+#define RTOS_MUTEXES  (4u)
+#define RTOS_MSG_MAX  (64u)   /// Байт сообщения
+#define RTOS_MSG_CNT  (16u)
+
+typedef enum {
+  WAIT_NONE = 0,
+  WAIT_DELAY,
+  WAIT_FLAGS,
+  WAIT_QUEUE,
+  WAIT_MUTEX,
+} Rtos_Wait_t;
+
+typedef struct {
+  uint8_t  used;
+  uint32_t size;
+  uint32_t count;
+  uint32_t head;
+  uint32_t len;
+  uint8_t  buf[RTOS_MSG_CNT][RTOS_MSG_MAX];
+} Rtos_Queue_t;
+
+typedef struct Rtos_Thread Rtos_Thread_t;
+
+typedef struct {
+  uint8_t        used;
+  uint8_t        inherit;
+  Rtos_Thread_t *owner;
+  uint32_t       count;
+} Rtos_Mutex_t;
+
+struct Rtos_Thread {
+  HostSim_Ctx_t  ctx;
+  const char    *name;
+  osThreadFunc_t func;
+  void          *argument;
+  osPriority_t   priority;
+  osPriority_t   base_priority;
+  uint8_t        ready;
+  uint32_t       seq;          /// Порядок готовности среди равных
+  Rtos_Wait_t    wait;
+  uint8_t        timed;
+  uint32_t       wake;         /// Тик таймаута
+  uint32_t       flags;
+  uint32_t       wait_flags;
+  uint32_t       wait_options;
+  Rtos_Queue_t  *queue;
+  void          *msg;
+  Rtos_Mutex_t  *mutex;
+  uint32_t       result;       /// osStatus_t или флаги
+};
+
+__NO_RETURN void osRtxIdleThread(void *argument);
+
+static Rtos_Thread_t   rtos_threads[RTOS_THREADS];
+static Rtos_Queue_t    rtos_queues[RTOS_QUEUES];
+static Rtos_Mutex_t    rtos_mutexes[RTOS_MUTEXES];
+static Rtos_Thread_t  *rtos_current;
+static osKernelState_t rtos_state = osKernelInactive;
+static uint32_t        rtos_tick;
+static uint32_t        rtos_seq;
+
+static const osThreadAttr_t rtos_idle_attr = { .name = "idle", .priority = osPriorityIdle };
+
+/** -- Планировщик -- */
+
+static void rtos_make_ready(Rtos_Thread_t *thread, const uint32_t result)
+{
+  thread->wait   = WAIT_NONE;
+  thread->timed  = 0;
+  thread->result = result;
+  thread->ready  = 1;
+  thread->seq    = ++rtos_seq;
+}
+
+static Rtos_Thread_t *rtos_pick(void)
+{
+  Rtos_Thread_t *best = NULL;
+
+  for (uint32_t i = 0; i < RTOS_THREADS; i++)
+  {
+    Rtos_Thread_t *thread = &rtos_threads[i];
+    if (thread->func == NULL || !thread->ready)
+    {
+      continue;
+    }
+    if (best == NULL || thread->priority > best->priority ||
+        (thread->priority == best->priority && thread->seq < best->seq))
+    {
+      best = thread;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Процессор - старшему готовому потоку. Не из прерывания и не при приостановленном ядре.
+ */
+static void rtos_schedule(void)
+{
+  if (rtos_state != osKernelRunning || host_ipsr != 0u)
+  {
+    return;
+  }
+  Rtos_Thread_t *next = rtos_pick();
+  if (next != NULL && next != rtos_current)
+  {
+    rtos_current = next;
+    host_sim_switch(&next->ctx);
+  }
+}
+
+/**
+ * @brief Текущий поток ждёт; возвращает результат, с которым его разбудили.
+ */
+static uint32_t rtos_block(const Rtos_Wait_t wait, const uint32_t timeout)
+{
+  Rtos_Thread_t *self = rtos_current;
+
+  self->ready = 0;
+  self->wait  = wait;
+  self->timed = (timeout != osWaitForever) ? 1u : 0u;
+  self->wake  = rtos_tick + timeout;
+  rtos_schedule();
+  return self->result;
+}
+
+/**
+ * @brief Таймауты, наступившие к текущему тику.
+ */
+static void rtos_timeouts(void)
+{
+  for (uint32_t i = 0; i < RTOS_THREADS; i++)
+  {
+    Rtos_Thread_t *thread = &rtos_threads[i];
+    if (thread->func == NULL || thread->ready || !thread->timed || (int32_t)(thread->wake - rtos_tick) > 0)
+    {
+      continue;
+    }
+    const Rtos_Wait_t wait = thread->wait;
+    if (wait == WAIT_MUTEX && thread->mutex->inherit && thread->mutex->owner != NULL)
+    {
+      thread->mutex->owner->priority = thread->mutex->owner->base_priority;
+    }
+    rtos_make_ready(thread, (wait == WAIT_DELAY) ? (uint32_t)osOK :
+                            (wait == WAIT_FLAGS) ? (uint32_t)osFlagsErrorTimeout : (uint32_t)osErrorTimeout);
+  }
+}
+
+/**
+ * @brief Вход потока (контекст - первое поле Rtos_Thread_t): функция потока не возвращается.
+ */
+static void rtos_entry(void)
+{
+  Rtos_Thread_t *self = (Rtos_Thread_t *)host_sim_ctx;
+  self->func(self->argument);
+  fprintf(stderr, "host_rtos2: thread %s returned\n", self->name);
+  exit(2);
+}
+
+/**
+ * @brief После прерывания (host_sim.c): разбуженный старший поток вытесняет текущий.
+ */
+void host_sim_after_irq(void)
+{
+  rtos_schedule();
+}
+
+/**
+ * @brief Тик ядра (os_systick.c RTX).
+ */
+void SysTick_Handler(void)
+{
+  if (rtos_state != osKernelRunning)
+  {
+    return;
+  }
+  rtos_tick++;
+  rtos_timeouts();
+}
+
+/** -- Ядро -- */
+
+osStatus_t osKernelInitialize(void)
+{
+  memset(rtos_threads, 0, sizeof(rtos_threads));
+  memset(rtos_queues, 0, sizeof(rtos_queues));
+  memset(rtos_mutexes, 0, sizeof(rtos_mutexes));
+  rtos_current = NULL;
+  rtos_tick    = 0;
+  rtos_seq     = 0;
+  rtos_state   = osKernelReady;
+  return osOK;
+}
+
+osKernelState_t osKernelGetState(void)
+{
+  return rtos_state;
+}
+
+/**
+ * @brief SysTick 1 кГц (os_systick.c), поток простоя и первый переключатель; не возвращается.
+ */
+osStatus_t osKernelStart(void)
+{
+  if (rtos_state != osKernelReady || osThreadNew(osRtxIdleThread, NULL, &rtos_idle_attr) == NULL)
+  {
+    return osError;
+  }
+  SysTick->LOAD = SystemCoreClock / 1000u - 1u;
+  SysTick->VAL  = 0;
+  NVIC_SetPriority(SysTick_IRQn, 15u);
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+
+  rtos_state = osKernelRunning;
+  rtos_schedule();
+  return osError;
+}
+
+uint32_t osKernelGetTickCount(void)
+{
+  return rtos_tick;
+}
+
+uint32_t osKernelGetTickFreq(void)
+{
+  return 1000u;
+}
+
+/**
+ * @brief Тиков до ближайшего таймаута; SysTick выключен до osKernelResume().
+ */
+uint32_t osKernelSuspend(void)
+{
+  uint32_t ticks = osWaitForever;
+
+  for (uint32_t i = 0; i < RTOS_THREADS; i++)
+  {
+    const Rtos_Thread_t *thread = &rtos_threads[i];
+    if (thread->func != NULL && thread->ready && thread != rtos_current)
+    {
+      return 0u;   /// Есть готовый поток - сна нет
+    }
+    if (thread->func != NULL && !thread->ready && thread->timed)
+    {
+      const int32_t left = (int32_t)(thread->wake - rtos_tick);
+      const uint32_t due = (left > 0) ? (uint32_t)left : 0u;
+      ticks = (due < ticks) ? due : ticks;
+    }
+  }
+  if (ticks == 0u)
+  {
+    return 0u;
+  }
+  SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+  rtos_state = osKernelSuspended;
+  return ticks;
+}
+
+void osKernelResume(const uint32_t sleep_ticks)
+{
+  if (rtos_state != osKernelSuspended)
+  {
+    return;
+  }
+  rtos_tick += sleep_ticks;
+  rtos_timeouts();
+  SysTick->VAL   = 0;
+  SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+  rtos_state = osKernelRunning;
+  rtos_schedule();
+}
+
+/** -- Потоки -- */
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr)
+{
+  for (uint32_t i = 0; i < RTOS_THREADS; i++)
+  {
+    Rtos_Thread_t *thread = &rtos_threads[i];
+    if (thread->func != NULL)
+    {
+      continue;
+    }
+    thread->func          = func;
+    thread->argument      = argument;
+    thread->name          = (attr != NULL && attr->name != NULL) ? attr->name : "thread";
+    thread->priority      = (attr != NULL && attr->priority != osPriorityNone) ? attr->priority : osPriorityNormal;
+    thread->base_priority = thread->priority;
+    host_sim_ctx_init(&thread->ctx, rtos_entry);
+    rtos_make_ready(thread, osOK);
+    rtos_schedule();
+    return thread;
+  }
+  return NULL;
+}
+
+osThreadId_t osThreadGetId(void)
+{
+  return rtos_current;
+}
+
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, const uint32_t flags)
+{
+  Rtos_Thread_t *thread = (Rtos_Thread_t *)thread_id;
+
+  if (thread == NULL)
+  {
+    return (uint32_t)osFlagsErrorParameter;
+  }
+  thread->flags |= flags;
+  const uint32_t now = thread->flags;
+
+  if (thread->wait == WAIT_FLAGS)
+  {
+    const uint32_t match = thread->flags & thread->wait_flags;
+    const uint8_t  done  = (thread->wait_options & osFlagsWaitAll) ? (match == thread->wait_flags) : (match != 0u);
+    if (done)
+    {
+      if (!(thread->wait_options & osFlagsNoClear))
+      {
+        thread->flags &= ~thread->wait_flags;
+      }
+      rtos_make_ready(thread, now);
+      rtos_schedule();
+    }
+  }
+  return now;
+}
+
+uint32_t osThreadFlagsClear(const uint32_t flags)
+{
+  const uint32_t was = rtos_current->flags;
+  rtos_current->flags &= ~flags;
+  return was;
+}
+
+uint32_t osThreadFlagsWait(const uint32_t flags, const uint32_t options, const uint32_t timeout)
+{
+  Rtos_Thread_t *self  = rtos_current;
+  const uint32_t match = self->flags & flags;
+
+  if ((options & osFlagsWaitAll) ? (match == flags) : (match != 0u))
+  {
+    const uint32_t was = self->flags;
+    if (!(options & osFlagsNoClear))
+    {
+      self->flags &= ~flags;
+    }
+    return was;
+  }
+  if (timeout == 0u)
+  {
+    return (uint32_t)osFlagsErrorResource;
+  }
+  self->wait_flags   = flags;
+  self->wait_options = options;
+  return rtos_block(WAIT_FLAGS, timeout);
+}
+
+osStatus_t osDelayUntil(const uint32_t ticks)
+{
+  const uint32_t delay = ticks - rtos_tick;
+
+  if (delay == 0u || delay > 0x7FFFFFFEu)
+  {
+    return osErrorParameter;   /// Момент уже прошёл
+  }
+  return (osStatus_t)rtos_block(WAIT_DELAY, delay);
+}
+
+/** -- Очереди -- */
+
+osMessageQueueId_t osMessageQueueNew(const uint32_t msg_count, const uint32_t msg_size, const osMessageQueueAttr_t *attr)
+{
+  (void)attr;
+  for (uint32_t i = 0; i < RTOS_QUEUES; i++)
+  {
+    Rtos_Queue_t *queue = &rtos_queues[i];
+    if (!queue->used && msg_count <= RTOS_MSG_CNT && msg_size <= RTOS_MSG_MAX)
+    {
+      queue->used  = 1;
+      queue->size  = msg_size;
+      queue->count = msg_count;
+      return queue;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Запись без ожидания (прошивка пишет только так): ждущему получателю - сразу.
+ */
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void *msg_ptr, const uint8_t msg_prio, const uint32_t timeout)
+{
+  Rtos_Queue_t *queue = (Rtos_Queue_t *)mq_id;
+  (void)msg_prio;
+  (void)timeout;
+
+  Rtos_Thread_t *receiver = NULL;
+  for (uint32_t i = 0; i < RTOS_THREADS; i++)
+  {
+    Rtos_Thread_t *thread = &rtos_threads[i];
+    if (thread->func != NULL && thread->wait == WAIT_QUEUE && thread->queue == queue &&
+        (receiver == NULL || thread->priority > receiver->priority))
+    {
+      receiver = thread;
+    }
+  }
+  if (receiver != NULL)
+  {
+    memcpy(receiver->msg, msg_ptr, queue->size);
+    rtos_make_ready(receiver, osOK);
+    rtos_schedule();
+    return osOK;
+  }
+  if (queue->len == queue->count)
+  {
+    return osErrorResource;
+  }
+  memcpy(queue->buf[(queue->head + queue->len) % queue->count], msg_ptr, queue->size);
+  queue->len++;
+  return osOK;
+}
+
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void *msg_ptr, uint8_t *msg_prio, const uint32_t timeout)
+{
+  Rtos_Queue_t *queue = (Rtos_Queue_t *)mq_id;
+
+  if (msg_prio != NULL)
+  {
+    *msg_prio = 0;
+  }
+  if (queue->len != 0u)
+  {
+    memcpy(msg_ptr, queue->buf[queue->head], queue->size);
+    queue->head = (queue->head + 1u) % queue->count;
+    queue->len--;
+    return osOK;
+  }
+  if (timeout == 0u)
+  {
+    return osErrorResource;
+  }
+  rtos_current->queue = queue;
+  rtos_current->msg   = msg_ptr;
+  return (osStatus_t)rtos_block(WAIT_QUEUE, timeout);
+}
+
+/** -- Мьютексы -- */
+
+osMutexId_t osMutexNew(const osMutexAttr_t *attr)
+{
+  for (uint32_t i = 0; i < RTOS_MUTEXES; i++)
+  {
+    Rtos_Mutex_t *mutex = &rtos_mutexes[i];
+    if (!mutex->used)
+    {
+      mutex->used    = 1;
+      mutex->inherit = (attr != NULL && (attr->attr_bits & osMutexPrioInherit)) ? 1u : 0u;
+      return mutex;
+    }
+  }
+  return NULL;
+}
+
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, const uint32_t timeout)
+{
+  Rtos_Mutex_t  *mutex = (Rtos_Mutex_t *)mutex_id;
+  Rtos_Thread_t *self  = rtos_current;
+
+  if (mutex->owner == NULL)
+  {
+    mutex->owner = self;
+    mutex->count = 1;
+    return osOK;
+  }
+  if (mutex->owner == self || timeout == 0u)
+  {
+    return osErrorResource;
+  }
+  if (mutex->inherit && mutex->owner->priority < self->priority)
+  {
+    mutex->owner->priority = self->priority;
+  }
+  self->mutex = mutex;
+  return (osStatus_t)rtos_block(WAIT_MUTEX, timeout);
+}
+
+osStatus_t osMutexRelease(osMutexId_t mutex_id)
+{
+  Rtos_Mutex_t  *mutex = (Rtos_Mutex_t *)mutex_id;
+  Rtos_Thread_t *self  = rtos_current;
+
+  if (mutex->owner != self)
+  {
+    return osErrorResource;
+  }
+  self->priority = self->base_priority;
+  mutex->owner   = NULL;
+
+  Rtos_Thread_t *next = NULL;
+  for (uint32_t i = 0; i < RTOS_THREADS; i++)
+  {
+    Rtos_Thread_t *thread = &rtos_threads[i];
+    if (thread->func != NULL && thread->wait == WAIT_MUTEX && thread->mutex == mutex &&
+        (next == NULL || thread->priority > next->priority))
+    {
+      next = thread;
+    }
+  }
+  if (next != NULL)
+  {
+    mutex->owner = next;
+    mutex->count = 1;
+    rtos_make_ready(next, osOK);
+  }
+  rtos_schedule();
+  return osOK;
+}
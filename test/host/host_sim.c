@@ -0,0 +1,480 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "host_sim.h"
+#include "main.h"
+
+/**
+ * @brief Таймер платы в модели: счёт от момента, когда модель увидела CEN
+ */
+typedef struct {
+  TIM_TypeDef *tim;
+  IRQn_Type    irq;
+  uint8_t      running;
+  uint64_t     start;   /// Такт, с которого считает CNT
+  uint32_t     cnt0;    /// CNT в момент start
+  uint32_t     cnt;     /// CNT, записанный моделью: другое значение в регистре - запись прошивки
+} HostSim_Timer_t;
+
+/**
+ * @brief Уровень K1 в заданный момент (сценарий теста)
+ */
+typedef struct {
+  uint64_t at;
+  uint32_t level;
+} HostSim_Button_t;
+
+#define HOST_SIM_BUTTONS  (512u)
+#define HOST_SIM_EXC      (16u + 96u)
+#define HOST_SIM_K1_EXTI  (K1_Pin)   /// Линия EXTI = номер вывода PB10
+
+uint64_t       host_sim_now;
+HostSim_Ctx_t *host_sim_ctx;
+uint64_t       host_sim_costs[HOST_SIM_COST_KEYS];
+uint32_t       host_sim_irqs[HOST_SIM_EXC];
+
+static HostSim_Timer_t sim_timers[] = {
+  { TIM3,  TIM3_IRQn,          0, 0, 0, 0 },   /// Мультиплекс индикатора
+  { TIM5,  TIM5_IRQn,          0, 0, 0, 0 },   /// AppTime, 1 МГц
+  { TIM10, TIM1_UP_TIM10_IRQn, 0, 0, 0, 0 },   /// Пробуждение из tickless-сна (AppTasks.c)
+};
+
+static HostSim_Button_t sim_buttons[HOST_SIM_BUTTONS];
+static uint32_t         sim_button_count;
+static uint32_t         sim_button_next;
+
+static HostSim_Ctx_t  sim_test;             /// Контекст теста (main() программы)
+static HostSim_Ctx_t *sim_resume;           /// Контекст прошивки, остановленный на host_sim_until
+static uint64_t       sim_until;
+static uint8_t        sim_systick_on;
+static uint64_t       sim_systick_next;
+static uint8_t        sim_pending[HOST_SIM_EXC];
+static uint32_t       sim_pending_count;    /// Ожидающих запросов: без них sim_deliverable() не ищет
+static uint64_t       sim_tsc_overhead;     /// Цена самого замера HOST_SIM_COST, такты ПК
+
+/**
+ * @brief Такты ПК. LFENCE с обеих сторон: RDTSC не обгоняет замеряемый вызов и не отстаёт от него.
+ */
+uint64_t host_sim_tsc(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_lfence();
+  const uint64_t tsc = __builtin_ia32_rdtsc();
+  __builtin_ia32_lfence();
+  return tsc;
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+  return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Сброс модели; цена замера - минимум пустого HOST_SIM_COST.
+ * @param costs Начальные цены по ключам (host_sim_costs прошлого прогона), NULL - ещё нет.
+ */
+void host_sim_init(const uint64_t *costs)
+{
+  host_sim_now     = 0;
+  host_sim_ctx     = &sim_test;
+  sim_resume       = NULL;
+  sim_button_count = 0;
+  sim_button_next  = 0;
+  sim_systick_on   = 0;
+  for (uint32_t i = 0; i < HOST_SIM_COST_KEYS; i++)
+  {
+    host_sim_costs[i] = (costs != NULL) ? costs[i] : UINT64_MAX;
+  }
+
+  sim_tsc_overhead = UINT64_MAX;
+  for (uint32_t i = 0; i < 10000u; i++)
+  {
+    const uint64_t t0 = host_sim_tsc();
+    const uint64_t t1 = host_sim_tsc();
+    if (t1 - t0 < sim_tsc_overhead)
+    {
+      sim_tsc_overhead = t1 - t0;
+    }
+  }
+}
+
+/** -- Регистры -- */
+
+static uint64_t sim_timer_period(const HostSim_Timer_t *timer)
+{
+  return (uint64_t)timer->tim->PSC + 1u;
+}
+
+/**
+ * @brief Такт следующего события обновления (UINT64_MAX - таймер стоит).
+ */
+static uint64_t sim_timer_update_at(const HostSim_Timer_t *timer)
+{
+  if (!timer->running)
+  {
+    return UINT64_MAX;
+  }
+  const uint64_t arr = (uint64_t)timer->tim->ARR;
+  const uint64_t to  = (timer->cnt0 <= arr) ? arr + 1u - timer->cnt0 : 1u;
+  return timer->start + to * sim_timer_period(timer);
+}
+
+static void sim_raise(const IRQn_Type irq)
+{
+  if (!sim_pending[(int32_t)irq + 16])
+  {
+    sim_pending[(int32_t)irq + 16] = 1u;
+    sim_pending_count++;
+  }
+}
+
+/**
+ * @brief Время -> регистры: CYCCNT, SysTick, CNT таймеров; пуск и останов таймеров по CEN.
+ * @details Запись CNT прошивкой (значение не то, что оставила модель) - счёт с записанного
+ *          значения, как у кристалла: останов, CNT = 0 и пуск между двумя шагами модели
+ *          начинают новый отсчёт.
+ */
+static void sim_sync(void)
+{
+  DWT->CYCCNT = (uint32_t)host_sim_now;
+
+  if (SysTick->CTRL & SysTick_CTRL_ENABLE_Msk)
+  {
+    if (!sim_systick_on)
+    {
+      sim_systick_on   = 1;
+      sim_systick_next = host_sim_now + SysTick->LOAD + 1u;
+    }
+    const uint64_t period = (uint64_t)SysTick->LOAD + 1u;
+    const uint64_t late   = (host_sim_now >= sim_systick_next) ? host_sim_now - sim_systick_next + 1u : 0u;
+    /// Перезагрузка внутри обработчика (события ещё не выполнены): счёт идёт с LOAD дальше
+    SysTick->VAL = (late == 0u) ? (uint32_t)(sim_systick_next - host_sim_now - 1u)
+                                : (uint32_t)(period - 1u - (late - 1u) % period);
+  }
+  else
+  {
+    sim_systick_on = 0;
+  }
+
+  for (uint32_t i = 0; i < sizeof(sim_timers) / sizeof(sim_timers[0]); i++)
+  {
+    HostSim_Timer_t *timer = &sim_timers[i];
+    if ((timer->tim->CR1 & TIM_CR1_CEN) && (!timer->running || timer->tim->CNT != timer->cnt))
+    {
+      timer->running = 1;
+      timer->start   = host_sim_now;
+      timer->cnt0    = timer->tim->CNT;
+    }
+    else if (timer->running && !(timer->tim->CR1 & TIM_CR1_CEN))
+    {
+      timer->running = 0;
+    }
+    if (timer->running)
+    {
+      timer->tim->CNT = timer->cnt0 + (uint32_t)((host_sim_now - timer->start) / sim_timer_period(timer));
+    }
+    timer->cnt = timer->tim->CNT;
+  }
+}
+
+/**
+ * @brief Ближайшее событие модели: SysTick, обновление таймера, фронт K1, конец прогона.
+ */
+static uint64_t sim_next_event(void)
+{
+  uint64_t next = sim_until;
+
+  if (sim_systick_on && sim_systick_next < next)
+  {
+    next = sim_systick_next;
+  }
+  for (uint32_t i = 0; i < sizeof(sim_timers) / sizeof(sim_timers[0]); i++)
+  {
+    const uint64_t at = sim_timer_update_at(&sim_timers[i]);
+    next = (at < next) ? at : next;
+  }
+  if (sim_button_next < sim_button_count && sim_buttons[sim_button_next].at < next)
+  {
+    next = sim_buttons[sim_button_next].at;
+  }
+  return next;
+}
+
+/**
+ * @brief Все события, наступившие к host_sim_now: флаги и запросы прерываний.
+ */
+static void sim_fire(void)
+{
+  while (sim_systick_on && sim_systick_next <= host_sim_now)
+  {
+    sim_systick_next += SysTick->LOAD + 1u;
+    if (SysTick->CTRL & SysTick_CTRL_TICKINT_Msk)
+    {
+      sim_raise(SysTick_IRQn);
+    }
+  }
+
+  for (uint32_t i = 0; i < sizeof(sim_timers) / sizeof(sim_timers[0]); i++)
+  {
+    HostSim_Timer_t *timer = &sim_timers[i];
+    for (uint64_t at = sim_timer_update_at(timer); at <= host_sim_now; at = sim_timer_update_at(timer))
+    {
+      timer->tim->SR |= TIM_SR_UIF;
+      if (timer->tim->CR1 & TIM_CR1_OPM)
+      {
+        timer->tim->CR1 &= ~TIM_CR1_CEN;
+        timer->tim->CNT  = 0;
+        timer->cnt       = 0;
+        timer->running   = 0;
+      }
+      else
+      {
+        timer->start = at;
+        timer->cnt0  = 0;
+      }
+      if (timer->tim->DIER & TIM_DIER_UIE)
+      {
+        sim_raise(timer->irq);
+      }
+    }
+  }
+
+  while (sim_button_next < sim_button_count && sim_buttons[sim_button_next].at <= host_sim_now)
+  {
+    const uint32_t was = (K1_GPIO_Port->IDR & K1_Pin) ? 1u : 0u;
+    const uint32_t now = sim_buttons[sim_button_next++].level;
+
+    K1_GPIO_Port->IDR = now ? (K1_GPIO_Port->IDR | K1_Pin) : (K1_GPIO_Port->IDR & ~(uint32_t)K1_Pin);
+    const uint32_t edge = (now && !was) ? EXTI->RTSR : (!now && was) ? EXTI->FTSR : 0u;
+    if ((edge & EXTI->IMR & HOST_SIM_K1_EXTI) != 0u)
+    {
+      EXTI->PR |= HOST_SIM_K1_EXTI;
+      sim_raise(EXTI15_10_IRQn);
+    }
+  }
+
+  if (host_sim_now >= sim_until)
+  {
+    sim_resume = host_sim_ctx;              /// Прогон закончен: тест продолжит отсюда
+    host_sim_switch(&sim_test);
+  }
+  sim_sync();
+}
+
+/**
+ * @brief Запрос, который можно выполнить: разрешён в NVIC (SysTick - TICKINT), старший по приоритету.
+ * @retval Номер исключения, 0 - нет.
+ */
+static uint32_t sim_deliverable(void)
+{
+  uint32_t best      = 0;
+  uint32_t best_prio = UINT32_MAX;
+
+  if (sim_pending_count == 0u)
+  {
+    return 0;
+  }
+
+  for (uint32_t exc = 15u; exc < HOST_SIM_EXC; exc++)
+  {
+    if (!sim_pending[exc])
+    {
+      continue;
+    }
+    const IRQn_Type irq = (IRQn_Type)((int32_t)exc - 16);
+    if (exc >= 16u && !NVIC_GetEnableIRQ(irq))
+    {
+      continue;
+    }
+    const uint32_t prio = NVIC_GetPriority(irq);
+    if (prio < best_prio)
+    {
+      best      = exc;
+      best_prio = prio;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Выполнить ожидающие прерывания (если не __disable_irq()), затем - переключение потоков.
+ * @retval 1 - было хотя бы одно прерывание.
+ */
+static uint32_t sim_deliver(void)
+{
+  uint32_t ran = 0;
+
+  for (uint32_t exc = sim_deliverable(); exc != 0u && !host_primask; exc = sim_deliverable())
+  {
+    sim_pending[exc] = 0;
+    sim_pending_count--;
+    host_sim_irqs[exc]++;
+    host_ipsr = exc;
+    host_sim_irq((IRQn_Type)((int32_t)exc - 16));
+    host_ipsr = 0;
+    sim_sync();
+    ran = 1;
+  }
+  if (ran)
+  {
+    host_sim_after_irq();
+  }
+  return ran;
+}
+
+__attribute__((weak)) void host_sim_after_irq(void)
+{
+}
+
+/** -- Время -- */
+
+/**
+ * @brief Процессор занят cycles тактов: события в это время выполняются по ходу.
+ * @details В обработчике прерывания время только прибавляется (и видно в регистрах):
+ *          наступившие события выполнятся после выхода из него.
+ */
+void host_sim_advance(const uint64_t cycles)
+{
+  if (host_ipsr != 0u)
+  {
+    host_sim_now += cycles;
+    sim_sync();
+    return;
+  }
+
+  uint64_t left = cycles;
+  for (;;)
+  {
+    sim_sync();
+    (void)sim_deliver();
+    const uint64_t next = sim_next_event();
+    if (next > host_sim_now + left)
+    {
+      host_sim_now += left;
+      sim_sync();
+      return;
+    }
+    if (next > host_sim_now)
+    {
+      left        -= next - host_sim_now;
+      host_sim_now = next;
+    }
+    sim_fire();
+  }
+}
+
+/**
+ * @brief Цена вызова: минимум по ключу за вычетом цены замера, не меньше такта.
+ * @details Замеренные такты вызова уходят в skipped контекста: объемлющий HOST_SIM_COST
+ *          вычитает их и платит только за свой код.
+ */
+void host_sim_charge(const uint32_t key, const uint64_t host_cycles)
+{
+  const uint64_t cost = (host_cycles > sim_tsc_overhead) ? host_cycles - sim_tsc_overhead : 0u;
+
+  if (cost < host_sim_costs[key])
+  {
+    host_sim_costs[key] = cost;
+  }
+
+  HostSim_Ctx_t *const ctx = host_sim_ctx;
+  const uint64_t       s0  = ctx->skipped;
+  const uint64_t       t0  = host_sim_tsc();
+  host_sim_advance((host_sim_costs[key] != 0u) ? host_sim_costs[key] : 1u);
+  ctx->skipped = s0 + (host_sim_tsc() - t0) + host_cycles;
+}
+
+/**
+ * @brief __WFI(): сон до прерывания. С __disable_irq() будит и запрос без выполнения обработчика.
+ */
+void host_sim_wfi(void)
+{
+  HostSim_Ctx_t *const ctx = host_sim_ctx;
+  const uint64_t       s0  = ctx->skipped;
+  const uint64_t       t0  = host_sim_tsc();
+
+  for (;;)
+  {
+    sim_sync();
+    if (sim_deliver() || (host_primask && sim_deliverable() != 0u))
+    {
+      break;
+    }
+    const uint64_t next = sim_next_event();
+    host_sim_now = (next > host_sim_now) ? next : host_sim_now;
+    sim_fire();
+  }
+  ctx->skipped = s0 + (host_sim_tsc() - t0);
+}
+
+/**
+ * @brief Замена слабой из host_periph.c: __WFI() прошивки спит в модельном времени.
+ */
+void host_wfi(void)
+{
+  host_wfi_count++;
+  host_sim_wfi();
+}
+
+/**
+ * @brief Уровень K1 с такта at (события - по возрастанию времени).
+ */
+void host_sim_button(const uint64_t at, const uint32_t level)
+{
+  if (sim_button_count >= HOST_SIM_BUTTONS ||
+      (sim_button_count != 0u && at < sim_buttons[sim_button_count - 1u].at))
+  {
+    fprintf(stderr, "host_sim: button events out of order or too many\n");
+    exit(2);
+  }
+  sim_buttons[sim_button_count].at    = at;
+  sim_buttons[sim_button_count].level = level;
+  sim_button_count++;
+}
+
+/** -- Контексты -- */
+
+void host_sim_ctx_init(HostSim_Ctx_t *ctx, void (*entry)(void))
+{
+  void *stack = malloc(HOST_SIM_STACK);
+  if (stack == NULL || getcontext(&ctx->uc) != 0)
+  {
+    fprintf(stderr, "host_sim: no context\n");
+    exit(2);
+  }
+  ctx->uc.uc_stack.ss_sp   = stack;
+  ctx->uc.uc_stack.ss_size = HOST_SIM_STACK;
+  ctx->uc.uc_link          = NULL;
+  ctx->skipped             = 0;
+  makecontext(&ctx->uc, entry, 0);
+}
+
+/**
+ * @brief Передать процессор контексту to. Время, пока текущий стоит, - не его цена.
+ */
+void host_sim_switch(HostSim_Ctx_t *to)
+{
+  HostSim_Ctx_t *const from = host_sim_ctx;
+
+  if (from == to)
+  {
+    return;
+  }
+  host_sim_ctx = to;
+  const uint64_t t0 = host_sim_tsc();
+  (void)swapcontext(&from->uc, &to->uc);
+  from->skipped += host_sim_tsc() - t0;
+}
+
+/**
+ * @brief Из теста: прошивка выполняется до такта until (первый вызов - с начала firmware).
+ */
+void host_sim_run(HostSim_Ctx_t *firmware, const uint64_t until)
+{
+  sim_until = until;
+  host_sim_switch((sim_resume != NULL) ? sim_resume : firmware);
+}
@@ -0,0 +1,91 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef TEST_HOST_SIM_H
+#define TEST_HOST_SIM_H
+
+/**
+ *  ---------------------------------------------------------
+ *  - Хост-сборка: виртуальное время и прерывания платы      -
+ *  ---------------------------------------------------------
+ *
+ * Прошивка целиком (main.c, обработчики stm32f4xx_it.c) выполняется на ПК, а время - модельное,
+ * в тактах HCLK. Время идёт только в двух местах:
+ *   host_sim_charge() - цена вызова функции прошивки (HOST_SIM_COST в обёртках -Wl,--wrap);
+ *   host_sim_wfi()    - __WFI(): сон до ближайшего прерывания.
+ * На каждом шаге host_sim.c переносит время в регистры: DWT->CYCCNT, SysTick->VAL, CNT таймеров
+ * TIM3, TIM5, TIM10 (PSC, ARR, OPM как у кристалла, такт таймера = HCLK). Выходы (BSRR) не
+ * моделируются: состояние клапана тест читает из контекста автомата.
+ * Наступившие события - перезагрузка SysTick, обновление таймера, фронт K1 (PB10, EXTI 10
+ * по RTSR/FTSR/IMR) - вызывают host_sim_irq() программы, если прерывание разрешено (NVIC, TICKINT)
+ * и не запрещено __disable_irq(); иначе ждут разрешения. Вложенных прерываний нет: время
+ * обработчика просто сдвигает часы.
+ *
+ * Цена вызова - такты ПК, замеренные вокруг настоящего вызова (без времени модели и других
+ * контекстов), минимум по ключу: шум ПК не попадает в модель, разные пути кода (состояние и
+ * событие автомата) - разные ключи. Начальные минимумы можно передать из прошлого прогона
+ * (host_sim_costs), тогда модель одинакова с первого вызова.
+ *
+ * Контексты (main прошивки, потоки host_rtos2.c) - ucontext: host_sim_switch() передаёт
+ * процессор, host_sim_run() - из теста до заданного момента модельного времени.
+ */
+
+/** Подключение заголовочных файлов */
+#include <stdint.h>
+#include <stddef.h>
+#include <ucontext.h>
+#include "stm32f4xx_hal.h"
+
+/** Частные макроопределения */
+#define HOST_SIM_COST_KEYS  (64u)         /// Ключей цены вызова
+#define HOST_SIM_STACK      (256u * 1024u) /// Стек контекста на ПК, байт
+
+/**
+ * @brief Цена вызова call по ключу key: такты ПК самого вызова (вложенные цены и время
+ *        других контекстов вычитаются) -> host_sim_charge().
+ */
+#define HOST_SIM_COST(key, call)                                                           \
+  do                                                                                       \
+  {                                                                                        \
+    HostSim_Ctx_t *const cost_ctx  = host_sim_ctx;                                         \
+    const uint64_t       cost_skip = cost_ctx->skipped;                                    \
+    const uint64_t       cost_t0   = host_sim_tsc();                                       \
+    call;                                                                                  \
+    const uint64_t cost_t1 = host_sim_tsc();                                               \
+    host_sim_charge((key), cost_t1 - cost_t0 - (cost_ctx->skipped - cost_skip));           \
+  } while (0)
+
+/** Структуры */
+
+/**
+ * @brief Контекст выполнения на ПК (main прошивки, поток RTOS, сам тест)
+ */
+typedef struct {
+  ucontext_t uc;
+  uint64_t   skipped;   /// Такты ПК, проведённые в модели и в других контекстах (не в цене вызовов)
+} HostSim_Ctx_t;
+
+/** Внешние переменные */
+extern uint64_t       host_sim_now;                        /// Модельное время, такты HCLK
+extern HostSim_Ctx_t *host_sim_ctx;                        /// Текущий контекст
+extern uint64_t       host_sim_costs[HOST_SIM_COST_KEYS];  /// Цена по ключам, такты (UINT64_MAX - ещё не было)
+extern uint32_t       host_sim_irqs[16u + 96u];            /// Выполнено прерываний по номеру исключения
+
+/** Прототипы функций **/
+void     host_sim_init    (const uint64_t *costs);
+uint64_t host_sim_tsc     (void);
+void     host_sim_charge  (uint32_t key, uint64_t host_cycles);
+void     host_sim_advance (uint64_t cycles);
+void     host_sim_wfi     (void);
+void     host_sim_button  (uint64_t at, uint32_t level);
+void     host_sim_ctx_init(HostSim_Ctx_t *ctx, void (*entry)(void));
+void     host_sim_switch  (HostSim_Ctx_t *to);
+void     host_sim_run     (HostSim_Ctx_t *firmware, uint64_t until);
+
+/// Реализует программа: вызов обработчика прерывания (номер IRQn, SysTick_IRQn = -1)
+void     host_sim_irq     (IRQn_Type irq);
+/// Слабая, переопределяет host_rtos2.c: переключение потоков после прерывания
+void     host_sim_after_irq(void);
+
+#endif //TEST_HOST_SIM_H
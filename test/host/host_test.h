@@ -0,0 +1,47 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+#ifndef TEST_HOST_TEST_H
+#define TEST_HOST_TEST_H
+
+/**
+ * Проверки хост-тестов: CHECK() печатает место и значение и продолжает, код возврата
+ * HOST_TEST_RESULT() - число неудачных проверок (0 - тест пройден, так его видит CTest).
+ */
+
+#include <stdio.h>
+
+static unsigned host_test_failed;
+static unsigned host_test_checks;
+
+#define CHECK(cond)                                                              \
+  do                                                                             \
+  {                                                                              \
+    host_test_checks++;                                                          \
+    if (!(cond))                                                                 \
+    {                                                                            \
+      host_test_failed++;                                                        \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);  \
+    }                                                                            \
+  } while (0)
+
+#define CHECK_EQ(actual, expected)                                               \
+  do                                                                             \
+  {                                                                              \
+    const unsigned long long check_a = (unsigned long long)(actual);             \
+    const unsigned long long check_e = (unsigned long long)(expected);           \
+    host_test_checks++;                                                          \
+    if (check_a != check_e)                                                      \
+    {                                                                            \
+      host_test_failed++;                                                        \
+      fprintf(stderr, "%s:%d: %s = 0x%llX, expected 0x%llX\n",                   \
+              __FILE__, __LINE__, #actual, check_a, check_e);                    \
+    }                                                                            \
+  } while (0)
+
+#define HOST_TEST_RESULT(name)                                                   \
+  (printf("%s: %u checks, %u failed\n", (name), host_test_checks, host_test_failed), \
+   host_test_failed != 0u)
+
+#endif //TEST_HOST_TEST_H
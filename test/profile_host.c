@@ -0,0 +1,532 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * Худший отклик задач на ПК: прошивка целиком (main.c, tim.c, gpio.c, usart.c, stm32f4xx_it.c и
+ * модули) в модельном времени host_sim.h, та же сборка, что Release (APP_LL_GPIO, APP_LL_TIM).
+ * С APP_RTOS2 - потоки AppTasks.c на модели ядра host_rtos2.c, без неё - суперцикл.
+ *
+ * Цена горячих функций прошивки - такты ПК их настоящего вызова (обёртки -Wl,--wrap ниже),
+ * минимум по ключу. Сценарий проходится PROFILE_LEARN_RUNS раз в дочерних процессах (fork),
+ * минимумы переходят из прогона в прогон; отчётный прогон считает с ними с самого начала -
+ * холодный кэш первого вызова частых путей не попадает в таблицу. Редкие пути (запись
+ * конфигурации - раз за сценарий) на ПК всегда с холодным кэшем: их цена - с запасом.
+ * Код между обёрнутыми вызовами, вход в прерывание и ядро RTOS (переключение потоков,
+ * osKernelSuspend/Resume) в модели бесплатны: таблица - нижняя граница, сравнимая между сборками.
+ * Запись во Flash - модель без времени стирания (оно одинаково останавливает обе сборки),
+ * образ прошивки - 32 КБ с печатью (FW_Check_Step() проверяет его как на плате).
+ *
+ * Сценарий на K1 (с дребезгом): покой, короткое нажатие и отсчёт, долгое - настройка,
+ * два шага, долгое - запись, покой. Проверки: клапан открыт на время отсчёта, cfg_sec
+ * записан во Flash; в сборке APP_RTOS2 - в покое ядро не тикает: osKernelSuspend() отдаёт
+ * больше тика (App_Tasks_Idle), прерываний SysTick единицы за секунды покоя.
+ *
+ * Отчёт - строки JSON таблицы App_Profile (такты модели = такты ПК) между "PROFILE BEGIN" и
+ * "PROFILE END" с заголовком калибровки, как у AppBench.c, в stdout или в файл; сводит отчёты
+ * обеих сборок и сравнивает с базой tools/profile_table.py (цель profile):
+ *   profile_host [файл отчёта]
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "host_periph.h"
+#include "host_sim.h"
+#include "host_test.h"
+#include "main.h"
+#include "stm32f4xx_it.h"
+#include "State_Machine.h"
+#include "Button.h"
+#include "7_seg_driver.h"
+#include "MachineTrace.h"
+#include "AppFlashConfig.h"
+#include "AppProfile.h"
+#include "AppCrc.h"
+#include "FwImageCheck.h"
+#include "FaultCapture.h"
+#ifdef APP_RTOS2
+#include "AppTasks.h"
+#endif
+
+#define MS               (20000u)                  /// Тактов HCLK в миллисекунде
+#define IMAGE_BYTES      (32u * 1024u)             /// Образ для FW_Check_Step() (_fw_image_start.._fw_footer)
+#define MACHINE_EVENTS   (EVENT_SCHEDULE + 1u)
+#define PROFILE_LEARN_RUNS  (2u)                   /// Прогонов, набирающих минимумы цен до отчётного
+#define PROFILE_CALIB_LOOPS (1000u)                /// Шагов калибровочного цикла (как BENCH_CALIB_LOOPS)
+
+#ifdef APP_RTOS2
+#define BUILD_NAME       "rtos2"
+#else
+#define BUILD_NAME       "superloop"
+#endif
+
+/**
+ * @brief Ключи цены вызова (host_sim_charge)
+ */
+enum {
+  COST_BUTTON_POLL = 0,
+  COST_SEG7_UPDATE,
+  COST_CFG_SAVE,
+  COST_FW_CHECK,
+  COST_GET_TICK,
+  COST_PROFILE_END,
+  COST_TRACE,
+  COST_FAULT_POLL,
+  COST_MACHINE,                                          /// + состояние * MACHINE_EVENTS + событие
+  COST_KEYS = COST_MACHINE + 5u * MACHINE_EVENTS
+};
+_Static_assert(COST_KEYS <= HOST_SIM_COST_KEYS, "profile_host.c: more cost keys than host_sim.h keeps");
+
+extern MachineState_Context_t Machine_State;                       /// main.c
+extern const volatile FwFooter_t fw_footer;                         /// FwImageCheck.c
+int Firmware_Main(void);                                            /// main() прошивки (main=Firmware_Main)
+void TIM5_IRQHandler(void);                                         /// stm32f4xx_it.c, секция USER CODE 1
+#ifdef APP_RTOS2
+void TIM1_UP_TIM10_IRQHandler(void);
+void EXTI15_10_IRQHandler(void);
+#endif
+
+static HostSim_Ctx_t     firmware;
+static volatile uint32_t calib_sink;   /// Результат калибровочного цикла, чтобы его не выбросил компилятор
+
+/** -- Цена вызовов: обёртки -Wl,--wrap -- */
+
+MachineEvent_t           __real_Button_Poll_1ms(void);
+void                     __real_Seg7_UpdateIndicator(Seg7_Handle_t *seg7_handle);
+void                     __real_Machine_Process(MachineState_Context_t *ctx, MachineEvent_t event);
+HAL_StatusTypeDef        __real_APP_Save_CFG_Flash(void);
+FwCheck_Result_t         __real_FW_Check_Step(void);
+uint32_t                 __real_HAL_GetTick(void);
+void                     __real_App_Profile_End(AppProfile_Task_t task, uint32_t release_tick);
+void                     __real_App_Profile_End_Us(AppProfile_Task_t task, uint32_t release_us);
+MachineTrace_Violation_t __real_Machine_Trace_Record(uint64_t t_us, MachineEvent_t event,
+                                                     const MachineState_Context_t *ctx,
+                                                     const Seg7_Handle_t *seg7_handle);
+
+MachineEvent_t __wrap_Button_Poll_1ms(void)
+{
+  MachineEvent_t event;
+  HOST_SIM_COST(COST_BUTTON_POLL, event = __real_Button_Poll_1ms());
+  return event;
+}
+
+void __wrap_Seg7_UpdateIndicator(Seg7_Handle_t *seg7_handle)
+{
+  HOST_SIM_COST(COST_SEG7_UPDATE, __real_Seg7_UpdateIndicator(seg7_handle));
+}
+
+void __wrap_Machine_Process(MachineState_Context_t *ctx, const MachineEvent_t event)
+{
+  const uint32_t key = COST_MACHINE + (uint32_t)ctx->machine_state * MACHINE_EVENTS + (uint32_t)event;
+  HOST_SIM_COST(key, __real_Machine_Process(ctx, event));
+}
+
+HAL_StatusTypeDef __wrap_APP_Save_CFG_Flash(void)
+{
+  HAL_StatusTypeDef status;
+  HOST_SIM_COST(COST_CFG_SAVE, status = __real_APP_Save_CFG_Flash());
+  return status;
+}
+
+FwCheck_Result_t __wrap_FW_Check_Step(void)
+{
+  FwCheck_Result_t result;
+  HOST_SIM_COST(COST_FW_CHECK, result = __real_FW_Check_Step());
+  return result;
+}
+
+uint32_t __wrap_HAL_GetTick(void)
+{
+  uint32_t tick;
+  HOST_SIM_COST(COST_GET_TICK, tick = __real_HAL_GetTick());
+  return tick;
+}
+
+void __wrap_App_Profile_End(const AppProfile_Task_t task, const uint32_t release_tick)
+{
+  HOST_SIM_COST(COST_PROFILE_END, __real_App_Profile_End(task, release_tick));
+}
+
+void __wrap_App_Profile_End_Us(const AppProfile_Task_t task, const uint32_t release_us)
+{
+  HOST_SIM_COST(COST_PROFILE_END, __real_App_Profile_End_Us(task, release_us));
+}
+
+MachineTrace_Violation_t __wrap_Machine_Trace_Record(const uint64_t t_us, const MachineEvent_t event,
+                                                     const MachineState_Context_t *ctx,
+                                                     const Seg7_Handle_t *seg7_handle)
+{
+  MachineTrace_Violation_t violation;
+  HOST_SIM_COST(COST_TRACE, violation = __real_Machine_Trace_Record(t_us, event, ctx, seg7_handle));
+  return violation;
+}
+
+/** -- HAL, которого нет в host_hal.c: такты, UART, HAL_TIM (с APP_LL_TIM не вызываются) -- */
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(const RCC_OscInitTypeDef *RCC_OscInitStruct)
+{
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(const RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency)
+{
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart)
+{
+  return HAL_OK;
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin)
+{
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim)
+{
+  CHECK(0);
+  return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_TIM_ConfigClockSource(TIM_HandleTypeDef *htim, const TIM_ClockConfigTypeDef *sClockSourceConfig)
+{
+  CHECK(0);
+  return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim, const TIM_MasterConfigTypeDef *sMasterConfig)
+{
+  CHECK(0);
+  return HAL_ERROR;
+}
+
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
+{
+  CHECK(0);
+}
+
+#ifndef APP_RTOS2
+/**
+ * @brief SysTick_Handler() суперцикла: HAL_IncTick() и шаг кнопки в HAL_SYSTICK_Callback().
+ */
+void HAL_SYSTICK_IRQHandler(void)
+{
+  HAL_SYSTICK_Callback();
+}
+#endif
+
+/** -- Flash: запись в отображённую память, стирание - без времени -- */
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError)
+{
+  CHECK_EQ(pEraseInit->Sector, FLASH_CFG_SECTOR);
+  memset((void *)(uintptr_t)FLASH_CFG_ADDR, 0xFF, sizeof(AppFlashConfig_t));
+  *SectorError = 0xFFFFFFFFu;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+  CHECK_EQ(TypeProgram, FLASH_TYPEPROGRAM_WORD);
+  *(volatile uint32_t *)(uintptr_t)Address &= (uint32_t)Data;   /// Программирование только сбрасывает биты
+  return HAL_OK;
+}
+
+/** -- Захват отказов: на ПК отказа ядра нет -- */
+
+uint8_t Fault_Capture_Init(void)
+{
+  return 0;
+}
+
+uint8_t Fault_Capture_Code(void)
+{
+  return 0;
+}
+
+static void fault_poll(void)
+{
+}
+
+void Fault_Capture_Poll(void)
+{
+  HOST_SIM_COST(COST_FAULT_POLL, fault_poll());
+}
+
+/** -- Прерывания модели -- */
+
+void host_sim_irq(const IRQn_Type irq)
+{
+  switch (irq)
+  {
+    case SysTick_IRQn:       SysTick_Handler();          break;
+    case TIM3_IRQn:          TIM3_IRQHandler();          break;
+    case TIM5_IRQn:          TIM5_IRQHandler();          break;
+#ifdef APP_RTOS2
+    case TIM1_UP_TIM10_IRQn: TIM1_UP_TIM10_IRQHandler(); break;
+    case EXTI15_10_IRQn:     EXTI15_10_IRQHandler();     break;
+#endif
+    default:
+      fprintf(stderr, "profile_host: unexpected IRQ %d\n", (int)irq);
+      CHECK(0);
+      break;
+  }
+}
+
+/** -- Плата до main() прошивки -- */
+
+/**
+ * @brief Образ во Flash-модели и печать футера, как после tools/fw_image_crc.py.
+ */
+static void board_seal_image(void)
+{
+  uint32_t *image = (uint32_t *)(uintptr_t)FLASH_BASE;
+  uint32_t  state = 0x7E57u;
+
+  for (uint32_t i = 0; i < IMAGE_BYTES / sizeof(uint32_t); i++)
+  {
+    state   ^= state << 13;
+    state   ^= state >> 17;
+    state   ^= state << 5;
+    image[i] = state;
+  }
+
+  AppCrc_Ctx_t crc;
+  APP_CRC_Init();
+  APP_CRC_Ctx_Init(&crc);
+  APP_CRC_Accumulate(&crc, image, IMAGE_BYTES / sizeof(uint32_t));
+
+  const long      page  = sysconf(_SC_PAGESIZE);
+  const uintptr_t start = (uintptr_t)&fw_footer & ~(uintptr_t)(page - 1);
+  if (mprotect((void *)start, (size_t)page * 2u, PROT_READ | PROT_WRITE) != 0)
+  {
+    perror("profile_host: footer");
+    exit(2);
+  }
+  FwFooter_t *footer = (FwFooter_t *)(uintptr_t)&fw_footer;
+  footer->magic     = FW_FOOTER_MAGIC;
+  footer->length    = IMAGE_BYTES;
+  footer->crc32     = crc.crc;
+  footer->crc32_inv = ~crc.crc;
+}
+
+static void firmware_entry(void)
+{
+  (void)Firmware_Main();
+  fprintf(stderr, "profile_host: firmware main() returned\n");
+  exit(2);
+}
+
+/** -- Сценарий -- */
+
+static uint64_t at_ms(const uint32_t ms)
+{
+  return (uint64_t)ms * MS;
+}
+
+/**
+ * @brief Нажатие K1 в момент ms на hold_ms, дребезг на обоих фронтах.
+ */
+static void press(const uint32_t ms, const uint32_t hold_ms)
+{
+  static const uint8_t bounce_ms[] = { 0, 2, 3, 6, 8 };   /// Смены уровня: 1, 0, 1, 0, 1
+
+  for (uint32_t i = 0; i < sizeof(bounce_ms); i++)
+  {
+    host_sim_button(at_ms(ms + bounce_ms[i]), (i & 1u) ? 0u : 1u);
+  }
+  for (uint32_t i = 0; i < sizeof(bounce_ms); i++)
+  {
+    host_sim_button(at_ms(ms + hold_ms + bounce_ms[i]), (i & 1u) ? 1u : 0u);
+  }
+}
+
+static void scenario(void)
+{
+  press(2000u,  150u);                     /// Отсчёт DEFAULT_TIME с
+  press(7000u,  BTN_LONG_MS + 300u);       /// Настройка
+  press(9000u,  100u);                     /// 3 -> 4
+  press(9600u,  100u);                     /// 4 -> 5
+  press(10200u, BTN_LONG_MS + 300u);       /// Запись
+}
+
+/**
+ * @brief Окно покоя: сколько раз тикнул SysTick и как спало ядро.
+ */
+static void check_idle_window(const uint32_t from_ms, const uint32_t to_ms)
+{
+  host_sim_run(&firmware, at_ms(from_ms));
+  const uint32_t ticks_before = host_sim_irqs[16 + (int32_t)SysTick_IRQn];
+#ifdef APP_RTOS2
+  memset(&App_Tasks_Idle, 0, sizeof(App_Tasks_Idle));
+#endif
+  host_sim_run(&firmware, at_ms(to_ms));
+  const uint32_t ticks = host_sim_irqs[16 + (int32_t)SysTick_IRQn] - ticks_before;
+
+#ifdef APP_RTOS2
+  const uint32_t window = to_ms - from_ms;
+  printf("idle %u..%u ms: SysTick %u, sleeps %u, longest %u ticks (%u slept in one WFI), slept %u ticks\n",
+         from_ms, to_ms, ticks, App_Tasks_Idle.sleeps, App_Tasks_Idle.max_ticks, App_Tasks_Idle.max_slept,
+         App_Tasks_Idle.slept_ticks);
+  CHECK(App_Tasks_Idle.max_ticks >= APP_TASKS_TELEMETRY_MS / 2u);   /// Ядро отпускает больше тика
+  CHECK(App_Tasks_Idle.max_slept > 1u);
+  CHECK(App_Tasks_Idle.slept_ticks >= window - window / 50u);       /// Почти всё окно - без тика ядра
+  CHECK(ticks <= window / 100u);
+#else
+  printf("idle %u..%u ms: SysTick %u\n", from_ms, to_ms, ticks);
+#endif
+}
+
+/**
+ * @brief Прогон сценария от сброса.
+ * @param costs Начальные цены вызовов (host_sim_init()).
+ */
+static void run(const uint64_t *costs)
+{
+  host_periph_reset();
+  host_sim_init(costs);
+  board_seal_image();
+#ifndef APP_RTOS2
+  SysTick->LOAD = SystemCoreClock / 1000u - 1u;   /// HAL_Init() -> HAL_InitTick(): 1 мс
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+#endif
+  host_sim_ctx_init(&firmware, firmware_entry);
+  scenario();
+
+  check_idle_window(500u, 2000u);
+
+  host_sim_run(&firmware, at_ms(2400u));
+  CHECK_EQ(Machine_State.valve_state, OPEN);
+  host_sim_run(&firmware, at_ms(6500u));
+  CHECK_EQ(Machine_State.valve_state, CLOSED);
+  CHECK_EQ(Machine_State.machine_state, STATE_READY);
+
+  host_sim_run(&firmware, at_ms(8600u));
+  CHECK_EQ(Machine_State.machine_state, STATE_CONFIG);
+  host_sim_run(&firmware, at_ms(12500u));
+  CHECK_EQ(Machine_State.machine_state, STATE_READY);
+  CHECK_EQ(Machine_State.cfg_sec, DEFAULT_TIME + 2u);
+  CHECK_EQ(((const AppFlashConfig_t *)(uintptr_t)FLASH_CFG_ADDR)->cfg_sec, DEFAULT_TIME + 2u);
+  CHECK_EQ(Machine_State.valve_opens, 1u);
+
+  check_idle_window(12500u, 15000u);
+}
+
+/**
+ * @brief Калибровочный цикл - тот же, что в AppBench.c: PROFILE_CALIB_LOOPS зависимых шагов.
+ */
+static __attribute__((noinline)) uint32_t calib_loop(uint32_t x)
+{
+  for (uint32_t i = 0; i < PROFILE_CALIB_LOOPS; i++)
+  {
+    x = x * 1664525u + 1013904223u;
+    __asm volatile ("" : "+r" (x));
+  }
+  return x;
+}
+
+/**
+ * @brief Минимум тактов ПК калибровочного цикла: цены вызовов - такты этого же ПК.
+ */
+static uint64_t calibrate(void)
+{
+  uint64_t best = UINT64_MAX;
+
+  for (uint32_t run = 0; run < 256u; run++)
+  {
+    const uint64_t t0 = host_sim_tsc();
+    calib_sink = calib_loop(run);
+    const uint64_t t1 = host_sim_tsc();
+    best = (t1 - t0 < best) ? t1 - t0 : best;
+  }
+  return best;
+}
+
+/**
+ * @brief Таблица App_Profile строками JSON; заголовок - как у отчёта AppBench.c.
+ */
+static void report(FILE *out, const uint64_t calib)
+{
+  static const char *const tasks[APP_PROFILE_COUNT] = { "input", "control", "telemetry", "persist" };
+
+  fprintf(out, "PROFILE BEGIN\n");
+  fprintf(out, "{\"hclk\":%u,\"calib\":%llu,\"calib_loops\":%u}\n",
+          (unsigned)SystemCoreClock, (unsigned long long)calib, PROFILE_CALIB_LOOPS);
+  for (uint32_t i = 0; i < APP_PROFILE_COUNT; i++)
+  {
+    fprintf(out, "{\"build\":\"%s\",\"task\":\"%s\",\"runs\":%u,\"worst_response\":%u,\"worst_exec\":%u}\n",
+            BUILD_NAME, tasks[i], App_Profile[i].runs, App_Profile[i].worst_response, App_Profile[i].worst_exec);
+  }
+  fprintf(out, "PROFILE END\n");
+}
+
+/**
+ * @brief Прогон в дочернем процессе: минимумы цен вызовов.
+ * @param costs Цены прошлого прогона, сюда же - новые минимумы.
+ * @param first 1 - прошлого прогона не было, costs не заполнен.
+ */
+static void learn(uint64_t *costs, const uint8_t first)
+{
+  int pipe_fd[2];
+  if (pipe(pipe_fd) != 0)
+  {
+    perror("profile_host: pipe");
+    exit(2);
+  }
+  const pid_t child = fork();
+  if (child == 0)
+  {
+    (void)freopen("/dev/null", "w", stdout);
+    run(first ? NULL : costs);
+    const ssize_t sent = write(pipe_fd[1], host_sim_costs, sizeof(host_sim_costs));
+    _exit((sent == (ssize_t)sizeof(host_sim_costs) && host_test_failed == 0u) ? 0 : 1);
+  }
+
+  int           status = 0;
+  const ssize_t got    = read(pipe_fd[0], costs, sizeof(host_sim_costs));
+  (void)waitpid(child, &status, 0);
+  close(pipe_fd[0]);
+  close(pipe_fd[1]);
+  CHECK_EQ(got, sizeof(host_sim_costs));
+  CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+int main(int argc, char **argv)
+{
+  /// Прогоны 1..PROFILE_LEARN_RUNS: минимумы цен вызовов, каждый начинает с минимумов прошлого
+  uint64_t learned[HOST_SIM_COST_KEYS];
+  for (uint32_t i = 0; i < PROFILE_LEARN_RUNS; i++)
+  {
+    learn(learned, (i == 0u) ? 1u : 0u);
+  }
+
+  /// Отчётный прогон: с первого вызова - набранные цены
+  run(learned);
+
+  FILE *out = (argc > 1) ? fopen(argv[1], "w") : stdout;
+  if (out == NULL)
+  {
+    perror(argv[1]);
+    return 2;
+  }
+  report(out, calibrate());
+  if (out != stdout)
+  {
+    fclose(out);
+  }
+
+  return HOST_TEST_RESULT("profile_host_" BUILD_NAME);
+}
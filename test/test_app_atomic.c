@@ -0,0 +1,339 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * Нагрузочная проверка AppAtomic.h (хост-порт APP_ATOMIC_PORT_HOST) двумя способами:
+ *
+ *   - вытеснение, как на одном ядре: интервальный таймер шлёт процессу SIGALRM,
+ *     обработчик сигнала - "прерывание": выполняется до конца в любой точке основного кода;
+ *   - два потока: на многоядерном ПК - строже, чем нужно МК (порядок памяти виден целиком),
+ *     на одном ядре - вытеснение планировщиком в любой точке.
+ *
+ * Кольцо SPSC: ни одно слово не потеряно, не повторено и не переставлено.
+ * Seqlock: любое чтение, признанное целым, - одна версия блока.
+ * Add/Take/Exchange: сколько событий добавлено, столько и забрано.
+ *
+ *   test_app_atomic [итераций]
+ */
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <sys/time.h>
+#include "host_test.h"
+#include "AppAtomic.h"
+
+#define SEQ_WORDS     (8u)    /// Размер блока под seqlock (как Seg7_View_t - несколько слов)
+#define IRQ_PERIOD_US (20)    /// Период "прерываний"; чаще - обработчик не успевает (одно ядро)
+
+APP_SPSC_DEFINE(ring, 64u);
+
+static volatile uint32_t irq_count;
+static void            (*irq_body)(void);
+
+/** -- "Прерывание": SIGALRM интервального таймера -- */
+
+static void irq_handler(int signo)
+{
+  (void)signo;
+  irq_body();
+  irq_count++;
+}
+
+/**
+ * @brief Запуск "прерываний": SIGALRM каждые IRQ_PERIOD_US, в любой точке основного кода.
+ */
+static void irq_start(void (*body)(void))
+{
+  irq_body  = body;
+  irq_count = 0;
+  signal(SIGALRM, irq_handler);
+  const struct itimerval period = { { 0, IRQ_PERIOD_US }, { 0, IRQ_PERIOD_US } };
+  setitimer(ITIMER_REAL, &period, NULL);
+}
+
+static void irq_end(void)
+{
+  const struct itimerval off = { { 0, 0 }, { 0, 0 } };
+  setitimer(ITIMER_REAL, &off, NULL);
+  signal(SIGALRM, SIG_IGN);
+}
+
+/** -- Кольцо SPSC -- */
+
+static volatile uint32_t ring_next_push;
+static volatile uint32_t ring_dropped;
+
+/** Писатель - прерывание (как приём UART), читатель - основной код */
+static void ring_irq_push(void)
+{
+  if (App_Spsc_Push(&ring, ring_next_push))
+  {
+    ring_next_push = ring_next_push + 1u;
+  }
+  else
+  {
+    ring_dropped = ring_dropped + 1u;   /// Полное кольцо: слово не записано, следующее - то же
+  }
+}
+
+static void test_spsc_preempt(const uint32_t iterations)
+{
+  ring.head = ring.tail = 0;
+  ring_next_push = 0;
+  ring_dropped   = 0;
+
+  irq_start(ring_irq_push);
+  uint32_t expected = 0;
+  uint32_t errors   = 0;
+  while (expected < iterations)
+  {
+    uint32_t value;
+    if (App_Spsc_Pop(&ring, &value))
+    {
+      errors += (value != expected);
+      expected = value + 1u;
+    }
+  }
+  irq_end();
+
+  CHECK_EQ(errors, 0u);
+  printf("spsc/preempt: %u words, %u interrupts, %u full\n", expected, irq_count, ring_dropped);
+}
+
+static void *ring_producer(void *arg)
+{
+  const uint32_t iterations = *(const uint32_t *)arg;
+  for (uint32_t value = 0; value < iterations;)
+  {
+    if (App_Spsc_Push(&ring, value))
+    {
+      value++;
+    }
+    else
+    {
+      sched_yield();   /// Полно: на одном ядре читателю нужен квант
+    }
+  }
+  return NULL;
+}
+
+static void test_spsc_threads(uint32_t iterations)
+{
+  ring.head = ring.tail = 0;
+
+  pthread_t producer;
+  pthread_create(&producer, NULL, ring_producer, &iterations);
+  uint32_t errors = 0;
+  for (uint32_t expected = 0; expected < iterations;)
+  {
+    uint32_t value;
+    if (App_Spsc_Pop(&ring, &value))
+    {
+      errors += (value != expected);
+      expected++;
+    }
+    else
+    {
+      sched_yield();
+    }
+  }
+  pthread_join(producer, NULL);
+
+  CHECK_EQ(errors, 0u);
+  CHECK_EQ(ring.head, ring.tail);
+}
+
+/** -- Seqlock -- */
+
+static AppSeqlock_t      seq_lock;
+static volatile uint32_t seq_block[SEQ_WORDS];
+static volatile uint32_t seq_valid;
+static volatile uint32_t seq_torn;     /// Признанные целыми, но разные слова - ошибка
+static volatile uint32_t seq_retry;
+
+/**
+ * @brief Читатель, как Seg7_Snapshot(): одна попытка, при неудаче - прошлый снимок.
+ */
+static void seq_read_once(void)
+{
+  uint32_t copy[SEQ_WORDS];
+  const uint32_t seq = App_Seq_Read_Begin(&seq_lock);
+  for (uint32_t i = 0; i < SEQ_WORDS; i++)
+  {
+    copy[i] = seq_block[i];
+  }
+  if (!App_Seq_Read_Valid(&seq_lock, seq))
+  {
+    seq_retry = seq_retry + 1u;
+    return;
+  }
+  for (uint32_t i = 1; i < SEQ_WORDS; i++)
+  {
+    if (copy[i] != copy[0])
+    {
+      seq_torn = seq_torn + 1u;
+      return;
+    }
+  }
+  seq_valid = seq_valid + 1u;
+}
+
+static void seq_write(const uint32_t version)
+{
+  App_Seq_Write_Begin(&seq_lock);
+  for (uint32_t i = 0; i < SEQ_WORDS; i++)
+  {
+    seq_block[i] = version;
+  }
+  App_Seq_Write_End(&seq_lock);
+}
+
+/** Писатель - основной код (сеттеры индикатора), читатель - прерывание (мультиплекс) */
+static void test_seqlock_preempt(const uint32_t iterations)
+{
+  seq_valid = seq_torn = seq_retry = 0;
+
+  irq_start(seq_read_once);
+  for (uint32_t version = 0; version < iterations; version++)
+  {
+    seq_write(version);
+  }
+  irq_end();
+
+  CHECK_EQ(seq_torn, 0u);
+  CHECK(seq_valid > 0u);
+  CHECK(seq_retry > 0u);   /// Прерывание действительно попадало внутрь записи
+  printf("seqlock/preempt: %u whole, %u retried, %u torn\n", seq_valid, seq_retry, seq_torn);
+}
+
+static volatile uint32_t seq_writer_done;
+
+static void *seq_writer(void *arg)
+{
+  const uint32_t iterations = *(const uint32_t *)arg;
+  for (uint32_t version = 0; version < iterations; version++)
+  {
+    seq_write(version);
+  }
+  __atomic_store_n(&seq_writer_done, 1u, __ATOMIC_SEQ_CST);
+  return NULL;
+}
+
+static void test_seqlock_threads(uint32_t iterations)
+{
+  seq_valid = seq_torn = seq_retry = 0;
+  seq_writer_done = 0;
+
+  pthread_t writer;
+  pthread_create(&writer, NULL, seq_writer, &iterations);
+  while (!__atomic_load_n(&seq_writer_done, __ATOMIC_SEQ_CST))
+  {
+    seq_read_once();
+  }
+  pthread_join(writer, NULL);
+
+  CHECK_EQ(seq_torn, 0u);
+  CHECK(seq_valid > 0u);
+}
+
+/** -- Add / Take / Exchange -- */
+
+static volatile uint32_t events_pending;
+static volatile uint32_t events_added;
+static volatile uint32_t code_word;
+static volatile uint32_t code_published;
+
+/** Прерывание копит события (кнопка) и выставляет коды (биты аварий) */
+static void events_irq(void)
+{
+  App_Atomic_Add(&events_pending, 1u);
+  events_added = events_added + 1u;
+
+  const uint32_t bit = 1u << (events_added % 32u);
+  uint32_t old = code_word;
+  while (!__atomic_compare_exchange_n(&code_word, &old, old | bit, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+  {
+  }
+  code_published = code_published | bit;
+}
+
+static void test_counters_preempt(const uint32_t iterations)
+{
+  events_pending = events_added = 0;
+  code_word = code_published = 0;
+
+  uint32_t taken     = 0;
+  uint32_t codes_got = 0;
+  irq_start(events_irq);
+  while (irq_count < iterations)
+  {
+    taken     += App_Atomic_Take(&events_pending);
+    codes_got |= App_Atomic_Exchange(&code_word, 0u);
+  }
+  irq_end();
+
+  while (App_Atomic_Take(&events_pending))
+  {
+    taken++;
+  }
+  codes_got |= App_Atomic_Exchange(&code_word, 0u);
+
+  CHECK_EQ(taken, events_added);
+  CHECK_EQ(codes_got, code_published);
+  printf("add/take/exchange/preempt: %u events, %u taken\n", events_added, taken);
+}
+
+static void *events_producer(void *arg)
+{
+  const uint32_t iterations = *(const uint32_t *)arg;
+  for (uint32_t i = 0; i < iterations; i++)
+  {
+    App_Atomic_Add(&events_pending, 1u);
+  }
+  return NULL;
+}
+
+static void test_counters_threads(uint32_t iterations)
+{
+  events_pending = 0;
+
+  pthread_t producer[2];
+  pthread_create(&producer[0], NULL, events_producer, &iterations);
+  pthread_create(&producer[1], NULL, events_producer, &iterations);
+
+  uint32_t taken = 0;
+  while (taken < 2u * iterations)
+  {
+    if (App_Atomic_Take(&events_pending))
+    {
+      taken++;
+    }
+    else
+    {
+      sched_yield();
+    }
+  }
+  pthread_join(producer[0], NULL);
+  pthread_join(producer[1], NULL);
+
+  CHECK_EQ(taken, 2u * iterations);
+  CHECK_EQ(events_pending, 0u);
+}
+
+int main(int argc, char **argv)
+{
+  const uint32_t iterations = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 20000u;
+
+  test_spsc_preempt(iterations);
+  test_spsc_threads(iterations * 100u);
+  test_seqlock_preempt(iterations * 100u);
+  test_seqlock_threads(iterations * 100u);
+  test_counters_preempt(iterations);
+  test_counters_threads(iterations * 100u);
+
+  return HOST_TEST_RESULT("test_app_atomic");
+}
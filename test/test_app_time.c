@@ -0,0 +1,207 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * AppTime на ПК (APP_TIME_PORT_HOST): 64-битное время через переполнения TIM5.
+ *
+ *   - сценарии: переполнение с отложенным прерыванием (читатель в прерывании или при
+ *     запрещённых прерываниях), перенос старшего слова, интервал App_Time_Us32();
+ *   - гонка: SIGALRM каждые 20 мкс - "железо" TIM5 (CNT прыгает вперёд, при переходе
+ *     через 0 ставится UIF) и прерывание переполнения, сразу или отложенное (не дольше
+ *     половины периода CNT, как требует AppTime.h). Основной код читает App_Time_Us()
+ *     без остановки: каждое значение не меньше предыдущего и лежит между истинным
+ *     временем до и после чтения.
+ *
+ *   test_app_time [прерываний]
+ */
+
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include "host_test.h"
+#include "AppTime.h"
+
+#define IRQ_PERIOD_US (20)
+
+/** Истинное время модели: сколько микросекунд "насчитал" TIM5 */
+static volatile uint64_t true_us;
+static volatile uint32_t irq_pending;
+static volatile uint32_t signals;
+static volatile uint32_t wraps;
+static uint32_t          rng_state = 0x5EEDu;
+
+static uint32_t rng(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+/**
+ * @brief Счёт TIM5 до cnt (вперёд); переход через 0 ставит UIF, как аппаратный счётчик.
+ */
+static void tick_to(const uint32_t cnt)
+{
+  if (cnt < App_Time_Host_Tim.CNT)
+  {
+    App_Time_Host_Tim.SR |= APP_TIME_UIF;
+  }
+  App_Time_Host_Tim.CNT = cnt;
+}
+
+static uint64_t last;
+
+static void check_now(const uint64_t expected, const int line)
+{
+  const uint64_t now = App_Time_Us();
+  if (now != expected)
+  {
+    fprintf(stderr, "line %d: App_Time_Us() = 0x%llX, expected 0x%llX\n", line,
+            (unsigned long long)now, (unsigned long long)expected);
+  }
+  CHECK_EQ(now, expected);
+  CHECK(now >= last);
+  last = now;
+}
+
+static void test_scenarios(void)
+{
+  App_Time_Init();
+  last = 0;
+  check_now(0, __LINE__);
+
+  tick_to(0xFFFFFFF0u);
+  check_now(0xFFFFFFF0ull, __LINE__);
+
+  tick_to(5u);                        /// Переполнение, прерывание ещё не выполнено
+  check_now(0x100000005ull, __LINE__);
+  tick_to(0x7FFFFFFFu);               /// Всё ещё ожидает, CNT в младшей половине
+  check_now(0x17FFFFFFFull, __LINE__);
+  App_Time_IRQHandler();              /// Прерывание выполнилось: время то же
+  check_now(0x17FFFFFFFull, __LINE__);
+  CHECK_EQ(App_Time_Host_Tim.SR & APP_TIME_UIF, 0u);
+  CHECK_EQ(App_Time_Overflows, 1u);
+
+  tick_to(0xFFFFFFFFu);               /// Старшая половина без UIF: слово не прибавляется
+  check_now(0x1FFFFFFFFull, __LINE__);
+
+  /// Перенос в старшем слове
+  App_Time_Overflows    = 0xFFFFFFFEu;
+  App_Time_Host_Tim.CNT = 0xFFFFFFFFu;
+  last = 0;
+  check_now(0xFFFFFFFEFFFFFFFFull, __LINE__);
+  tick_to(1u);
+  check_now(0xFFFFFFFF00000001ull, __LINE__);
+  App_Time_IRQHandler();
+  check_now(0xFFFFFFFF00000001ull, __LINE__);
+
+  /// Интервал по 32 битам через переполнение
+  App_Time_Host_Tim.CNT = 0xFFFFFF00u;
+  const uint32_t start = App_Time_Us32();
+  App_Time_Host_Tim.CNT = 0x100u;
+  CHECK_EQ(App_Time_Us32() - start, 0x200u);
+
+  /// Секунды
+  App_Time_Init();
+  App_Time_Overflows    = 1;
+  App_Time_Host_Tim.CNT = 0;
+  CHECK_EQ(App_Time_Seconds(), (uint32_t)(0x100000000ull / APP_TIME_HZ));
+}
+
+/**
+ * @brief "Железо" TIM5 и NVIC: шаг счётчика, прерывание сразу или отложенное.
+ * @details Отложенное прерывание выполняется до того, как CNT пройдёт половину периода.
+ */
+static void tim5_model(int signo)
+{
+  (void)signo;
+
+  if (irq_pending && (rng() & 1u))
+  {
+    irq_pending = 0;
+    App_Time_IRQHandler();   /// Отложенное: читатель был "в прерывании" или с запретом
+  }
+
+  const uint32_t step = (rng() & ((1u << 27) - 1u)) + 1u;   /// В среднем переполнение раз в 64 шага
+  const uint32_t cnt  = App_Time_Host_Tim.CNT + step;
+
+  if (irq_pending && (cnt < App_Time_Host_Tim.CNT || cnt >= APP_TIME_HALF))
+  {
+    irq_pending = 0;
+    App_Time_IRQHandler();   /// Дольше половины периода откладывать нельзя
+  }
+
+  tick_to(cnt);
+  true_us = true_us + step;
+
+  if (App_Time_Host_Tim.SR & APP_TIME_UIF)
+  {
+    wraps = wraps + 1u;
+    if (rng() & 1u)
+    {
+      App_Time_IRQHandler();   /// Сразу
+    }
+    else
+    {
+      irq_pending = 1;
+    }
+  }
+  signals = signals + 1u;
+}
+
+static void test_race(const uint32_t interrupts)
+{
+  App_Time_Init();
+  true_us     = 0;
+  irq_pending = 0;
+  signals     = 0;
+  wraps       = 0;
+
+  uint64_t previous = 0;
+  uint64_t reads    = 0;
+  uint32_t backward = 0;
+  uint32_t outside  = 0;
+
+  signal(SIGALRM, tim5_model);
+  const struct itimerval period = { { 0, IRQ_PERIOD_US }, { 0, IRQ_PERIOD_US } };
+  setitimer(ITIMER_REAL, &period, NULL);
+
+  while (signals < interrupts)
+  {
+    const uint64_t before = true_us;
+    const uint64_t now    = App_Time_Us();
+    const uint64_t after  = true_us;
+
+    backward += (now < previous);
+    outside  += (now < before || now > after);
+    if ((now < previous || now < before || now > after) && backward + outside < 5u)
+    {
+      fprintf(stderr, "read %llu: 0x%llX, previous 0x%llX, true 0x%llX..0x%llX\n",
+              (unsigned long long)reads, (unsigned long long)now, (unsigned long long)previous,
+              (unsigned long long)before, (unsigned long long)after);
+    }
+    previous = now;
+    reads++;
+  }
+
+  const struct itimerval off = { { 0, 0 }, { 0, 0 } };
+  setitimer(ITIMER_REAL, &off, NULL);
+  signal(SIGALRM, SIG_IGN);
+
+  CHECK_EQ(backward, 0u);
+  CHECK_EQ(outside, 0u);
+  CHECK(wraps > 100u);
+  printf("race: %llu reads, %u interrupts, %u overflows\n", (unsigned long long)reads, signals, wraps);
+}
+
+int main(int argc, char **argv)
+{
+  const uint32_t interrupts = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 40000u;
+
+  test_scenarios();
+  test_race(interrupts);
+
+  return HOST_TEST_RESULT("test_app_time");
+}
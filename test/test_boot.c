@@ -0,0 +1,901 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * Загрузчик целиком на ПК: Boot.c (main() собран как Boot_Main()), BootCtl.c,
+ * BootFlash.c (BOOT_FLASH_PORT_HOST) и AppCrc.c (табличный расчёт) без изменений.
+ *
+ *   - Flash - общая для процессов память по адресу 0x08000000. Стирание и запись слова
+ *     проходят через модель (запись - битовое И), которая "выключает питание" перед
+ *     операцией или посреди неё: при стирании часть битов уже в 1, при записи часть нулей
+ *     ещё не записана;
+ *   - каждый запуск загрузчика - отдельный процесс (fork): статические переменные - как
+ *     после сброса, Flash сохраняется. SysTick - SIGALRM; NVIC_SystemReset() и переход в
+ *     приложение (Boot_Uart_DeInit()) завершают процесс;
+ *   - USART1 заменён хостом, который делает то же, что tools/fw_update.py: HELLO, BEGIN,
+ *     DATA с next_offset из ответа, END; ответы проверяются по CRC.
+ *
+ * Сценарии: обновление и подтверждение; возобновление приёма после обрыва питания;
+ * CRC образа не совпала на END; откат после BOOT_MAX_TRIALS запусков без подтверждения и
+ * BEGIN во время испытания; откат без резерва; переход журнала в другую половину и обрыв
+ * при стирании. Затем обрыв питания в каждой операции стирания и записи журнала и в
+ * выборке записей данных на всём пути обновления: после восстановления в слоте A всегда
+ * старый или новый образ целиком, и обновление доходит до конца.
+ *
+ *   test_boot [шаг выборки записей данных]
+ */
+
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "host_test.h"
+#include "main.h"
+#include "AppCrc.h"
+#include "BootCtl.h"
+#include "BootFlash.h"
+#include "BootProto.h"
+#include "BootUart.h"
+
+#define FLASH_BYTES    (FLASH_END + 1u - FLASH_BASE)
+#define CUT_NEVER      (0xFFFFFFFFu)
+#define OP_LOG         (40000u)
+#define TICK_US        (20)         /// Период SysTick загрузчика в тесте
+#define IDLE_TICKS     (2000u)      /// Хост молчит, загрузчик ждёт - запуск окончен
+#define HANG_TICKS     (200000u)    /// Запуск не закончился - зависание
+
+#define OLD_LEN        (3u * 1024u)          /// Образ, прошитый через ST-LINK
+#define NEW_LEN        (6u * 1024u + 64u)    /// Последний кадр DATA неполный
+
+int  Boot_Main(void);   /// Boot.c
+void SysTick_Handler(void);
+
+/** Чем закончился процесс запуска */
+enum {
+  EXIT_JUMP = 10,   /// Переход в приложение
+  EXIT_RESET,       /// NVIC_SystemReset()
+  EXIT_CUT,         /// Пропало питание
+  EXIT_IDLE,        /// Загрузчик ждёт образ, хост больше ничего не шлёт
+  EXIT_HANG,
+  EXIT_APP          /// "Приложение" отработало
+};
+
+/** Вид операции Flash */
+enum {
+  OP_ERASE,
+  OP_JOURNAL,       /// Запись слова журнала
+  OP_DATA           /// Запись слова образа (слот B, резерв, слот A)
+};
+
+typedef struct {
+  uint8_t  kind;
+  uint32_t address;
+} Op_t;
+
+/**
+ * @brief Хост на USART1 (NULL image - хоста нет)
+ */
+typedef struct {
+  const uint32_t *image;
+  uint32_t        len;
+  uint32_t        crc;            /// CRC в BEGIN
+  uint32_t        corrupt_word;   /// Не 0 - в DATA искажено слово corrupt_word - 1 (кадр с верной CRC)
+} Host_t;
+
+/**
+ * @brief Общая память теста и процессов запуска
+ */
+typedef struct {
+  uint32_t ops;            /// Операций Flash с начала прогона
+  uint32_t cut_at;         /// На какой операции пропадает питание
+  uint8_t  cut_torn;       /// 1 - операция выполнена частично, 0 - не начата
+  uint8_t  logging;
+  uint32_t log_len;
+  Op_t     log[OP_LOG];
+  uint32_t hello_state;    /// Ответы загрузчика хосту в последнем запуске
+  uint32_t begin_status;
+  uint32_t begin_offset;
+  uint32_t end_status;
+  uint32_t data_bytes;     /// Байт образа отправлено в DATA
+  uint32_t child_errors;   /// Проверки, не прошедшие в процессах запуска
+} Shared_t;
+
+static Shared_t *shared;
+static uint32_t  old_slot[BOOT_SLOT_SIZE / 4u];   /// Слот A после прошивки через ST-LINK
+static uint32_t  new_image[NEW_LEN / 4u];
+static uint32_t  bad_image[NEW_LEN / 4u];         /// Запускается, но не подтверждается
+static uint32_t  new_crc;
+static uint32_t  bad_crc;
+static uint8_t   snapshot[FLASH_BYTES];
+static uint32_t  rng_state = 0xB007u;
+
+static const uint32_t sector_addr[] = { 0x08000000u, 0x08004000u, 0x08008000u, 0x0800C000u,
+                                        0x08010000u, 0x08020000u, 0x08040000u };
+
+static uint32_t rng(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static void child_fail(const char *what)
+{
+  fprintf(stderr, "boot process: %s\n", what);
+  shared->child_errors++;
+}
+
+/** -- Модель Flash -- */
+
+/**
+ * @brief Учёт операции; 1 - на ней пропадает питание.
+ */
+static uint8_t flash_op(const uint8_t kind, const uint32_t address)
+{
+  const uint32_t n = shared->ops++;
+  if (shared->logging && shared->log_len < OP_LOG)
+  {
+    shared->log[shared->log_len++] = (Op_t){ kind, address };
+  }
+  return n == shared->cut_at;
+}
+
+void Boot_Flash_Host_Erase(const uint32_t sector)
+{
+  uint32_t      *word  = (uint32_t *)(uintptr_t)sector_addr[sector];
+  const uint32_t words = (sector_addr[sector + 1u] - sector_addr[sector]) / sizeof(uint32_t);
+
+  if (flash_op(OP_ERASE, sector_addr[sector]))
+  {
+    if (shared->cut_torn)
+    {
+      const uint32_t done = rng() % words;
+      for (uint32_t i = 0; i < words; i++)
+      {
+        word[i] = (i < done) ? 0xFFFFFFFFu : (word[i] | rng());
+      }
+    }
+    _exit(EXIT_CUT);
+  }
+  memset(word, 0xFF, words * sizeof(uint32_t));
+  FLASH->SR = 0;   /// Операция прошла: флаги, записанные Boot_Flash_Unlock() (сброс единицей), сняты
+}
+
+void Boot_Flash_Host_Program(const uint32_t address, const uint32_t value)
+{
+  volatile uint32_t *word    = (volatile uint32_t *)(uintptr_t)address;
+  const uint8_t      journal = (address >= BOOT_CTL_ADDR && address < BOOT_CTL_ADDR + BOOT_CTL_SIZE) ||
+                               (address >= BOOT_CTL_ALT_ADDR && address < BOOT_CTL_ALT_ADDR + BOOT_CTL_SIZE);
+
+  if (flash_op(journal ? OP_JOURNAL : OP_DATA, address))
+  {
+    if (shared->cut_torn)
+    {
+      *word &= value | rng();
+    }
+    _exit(EXIT_CUT);
+  }
+  *word &= value;   /// Запись только сбрасывает биты
+  FLASH->SR = 0;
+}
+
+/** -- USART1: хост по шагам tools/fw_update.py -- */
+
+static Host_t            host;
+static uint8_t           rx[1024];
+static uint32_t          rx_head;
+static uint32_t          rx_tail;
+static uint8_t           tx[64];
+static uint32_t          tx_len;
+static volatile uint32_t ticks;
+static uint32_t          quiet_since;
+
+static void host_send(const uint8_t cmd, const uint32_t *payload, const uint32_t words)
+{
+  uint32_t frame[2u + BOOT_PROTO_MAX_PAYLOAD / 4u];
+
+  frame[0] = BOOT_PROTO_SYNC | ((uint32_t)cmd << 8u) | ((words * 4u) << 16u);
+  memcpy(&frame[1], payload, words * sizeof(uint32_t));
+  frame[1u + words] = APP_CRC_Calc(frame, 1u + words);
+  if (rx_head == rx_tail)
+  {
+    rx_head = rx_tail = 0;
+  }
+  memcpy(&rx[rx_head], frame, (2u + words) * sizeof(uint32_t));
+  rx_head    += (2u + words) * sizeof(uint32_t);
+  quiet_since = ticks;
+}
+
+/**
+ * @brief Следующий кадр с offset: DATA или, когда всё отправлено, END.
+ */
+static void host_next(const uint32_t offset)
+{
+  if (offset >= host.len)
+  {
+    host_send(BOOT_CMD_END, NULL, 0u);
+    return;
+  }
+
+  uint32_t       payload[1u + BOOT_PROTO_CHUNK / 4u];
+  const uint32_t chunk = (host.len - offset < BOOT_PROTO_CHUNK) ? host.len - offset : BOOT_PROTO_CHUNK;
+  payload[0] = offset;
+  memcpy(&payload[1], &host.image[offset / 4u], chunk);
+  if (host.corrupt_word != 0u && host.corrupt_word - 1u >= offset / 4u &&
+      host.corrupt_word - 1u < (offset + chunk) / 4u)
+  {
+    payload[1u + host.corrupt_word - 1u - offset / 4u] ^= 0x00010000u;
+  }
+  shared->data_bytes += chunk;
+  host_send(BOOT_CMD_DATA, payload, 1u + chunk / 4u);
+}
+
+static void host_reply(const uint8_t cmd, const uint32_t *payload, const uint32_t words)
+{
+  switch (cmd)
+  {
+    case BOOT_CMD_HELLO | BOOT_PROTO_REPLY:
+      shared->hello_state = payload[2];
+      if (words == 5u && host.image != NULL)
+      {
+        const uint32_t begin[2] = { host.len, host.crc };
+        host_send(BOOT_CMD_BEGIN, begin, 2u);
+      }
+      break;
+
+    case BOOT_CMD_BEGIN | BOOT_PROTO_REPLY:
+      shared->begin_status = payload[0];
+      shared->begin_offset = payload[1];
+      if (payload[0] == BOOT_ST_OK)
+      {
+        host_next(payload[1]);
+      }
+      break;
+
+    case BOOT_CMD_DATA | BOOT_PROTO_REPLY:
+      if (payload[0] == BOOT_ST_OK || payload[0] == BOOT_ST_ERR_STATE)
+      {
+        host_next(payload[1]);
+      }
+      else
+      {
+        child_fail("DATA refused");
+      }
+      break;
+
+    case BOOT_CMD_END | BOOT_PROTO_REPLY:
+      shared->end_status = payload[0];
+      break;
+
+    default:
+      child_fail("unexpected reply");
+      break;
+  }
+}
+
+void Boot_Uart_Init(void)
+{
+  rx_head = rx_tail = 0;
+  tx_len  = 0;
+  if (host.image != NULL)
+  {
+    host_send(BOOT_CMD_HELLO, NULL, 0u);
+  }
+}
+
+/** Переход в приложение: загрузчик отпускает USART1 последним делом перед прыжком */
+void Boot_Uart_DeInit(void)
+{
+  _exit(EXIT_JUMP);
+}
+
+uint32_t Boot_Uart_Available(void)
+{
+  if (rx_head == rx_tail && ticks - quiet_since > IDLE_TICKS)
+  {
+    _exit(EXIT_IDLE);
+  }
+  return rx_head - rx_tail;
+}
+
+uint8_t Boot_Uart_Peek(const uint32_t offset)
+{
+  return rx[rx_tail + offset];
+}
+
+void Boot_Uart_Read(uint8_t *dst, uint32_t len)
+{
+  if (dst != NULL)
+  {
+    memcpy(dst, &rx[rx_tail], len);
+  }
+  rx_tail += len;
+}
+
+/**
+ * @brief Ответы загрузчика: кадры [SYNC][cmd|0x80][len] payload crc32.
+ */
+void Boot_Uart_Write(const uint8_t *src, const uint32_t len)
+{
+  if (tx_len + len > sizeof(tx))
+  {
+    child_fail("reply too long");
+    return;
+  }
+  memcpy(&tx[tx_len], src, len);
+  tx_len += len;
+
+  uint32_t frame[sizeof(tx) / 4u];
+  memcpy(frame, tx, tx_len & ~3u);
+  const uint32_t payload = frame[0] >> 16u;
+  if (tx_len < 8u || tx_len < payload + 8u)
+  {
+    return;
+  }
+  if ((frame[0] & 0xFFu) != BOOT_PROTO_SYNC || APP_CRC_Calc(frame, 1u + payload / 4u) != frame[1u + payload / 4u])
+  {
+    child_fail("reply CRC");
+  }
+  tx_len = 0;
+  host_reply((uint8_t)(frame[0] >> 8u), &frame[1], payload / 4u);
+}
+
+/** -- Процессы запуска -- */
+
+static void tick(int sig)
+{
+  (void)sig;
+  ticks++;
+  SysTick_Handler();
+  if (SCB->AIRCR & SCB_AIRCR_SYSRESETREQ_Msk)
+  {
+    _exit(EXIT_RESET);
+  }
+  if (ticks > HANG_TICKS)
+  {
+    _exit(EXIT_HANG);
+  }
+}
+
+static int wait_child(const pid_t pid)
+{
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+/**
+ * @brief Запуск загрузчика с хостом (или без) до перехода в приложение, сброса, обрыва питания.
+ */
+static int boot(const Host_t *with_host)
+{
+  shared->hello_state  = 0xFFu;
+  shared->begin_status = 0xFFu;
+  shared->begin_offset = 0xFFFFFFFFu;
+  shared->end_status   = 0xFFu;
+  shared->data_bytes   = 0;
+
+  fflush(stdout);
+  fflush(stderr);
+  const pid_t pid = fork();
+  if (pid == 0)
+  {
+    static const Host_t none = { NULL, 0u, 0u, 0u };
+    host      = (with_host != NULL) ? *with_host : none;
+    rng_state = 0x9E3779B9u ^ shared->ops;
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = tick;
+    sigaction(SIGALRM, &action, NULL);
+    const struct itimerval period = { { 0, TICK_US }, { 0, TICK_US } };
+    setitimer(ITIMER_REAL, &period, NULL);
+
+    Boot_Main();
+    _exit(EXIT_HANG);
+  }
+  return wait_child(pid);
+}
+
+/**
+ * @brief Приложение после перехода: подтверждает образ (BootCtl_Confirm) или просто работает.
+ */
+static int app(const uint8_t confirm)
+{
+  fflush(stdout);
+  fflush(stderr);
+  const pid_t pid = fork();
+  if (pid == 0)
+  {
+    rng_state = 0x7F4A7C15u ^ shared->ops;
+    if (confirm && BootCtl_Confirm() != HAL_OK)
+    {
+      child_fail("BootCtl_Confirm");
+    }
+    _exit(EXIT_APP);
+  }
+  return wait_child(pid);
+}
+
+/** -- Проверки состояния Flash -- */
+
+static BootCtl_Record_t journal(void)
+{
+  BootCtl_Record_t record;
+  BootCtl_Load(&record);
+  return record;
+}
+
+static uint8_t slot_a_is(const uint32_t *image, const uint32_t len)
+{
+  return memcmp((const void *)(uintptr_t)BOOT_SLOT_A_ADDR, image, len) == 0;
+}
+
+static uint8_t slot_a_old(void)
+{
+  return slot_a_is(old_slot, BOOT_SLOT_SIZE);
+}
+
+static uint8_t backup_old(void)
+{
+  return memcmp((const void *)(uintptr_t)BOOT_BACKUP_ADDR, old_slot, BOOT_SLOT_SIZE) == 0;
+}
+
+/**
+ * @brief Образ: таблица векторов (SP в ОЗУ, Reset_Handler в слоте A), дальше - случайные слова.
+ */
+static void image_make(uint32_t *image, const uint32_t len)
+{
+  image[0] = 0x20010000u;
+  image[1] = BOOT_SLOT_A_ADDR + 0x1C1u;
+  for (uint32_t i = 2; i < len / 4u; i++)
+  {
+    image[i] = rng();
+  }
+}
+
+/** Чистая Flash и образ old_slot в слоте A (ST-LINK), журнал пуст */
+static void flash_reset(void)
+{
+  memset((void *)(uintptr_t)FLASH_BASE, 0xFF, FLASH_BYTES);
+  memcpy((void *)(uintptr_t)BOOT_SLOT_A_ADDR, old_slot, BOOT_SLOT_SIZE);
+  shared->ops     = 0;
+  shared->cut_at  = CUT_NEVER;
+  shared->logging = 0;
+}
+
+/** Запись журнала без изменения состояния (заполнение половины) */
+static void journal_fill(const uint32_t records)
+{
+  BootCtl_Record_t record = journal();
+  for (uint32_t i = 0; i < records; i++)
+  {
+    CHECK_EQ(BootCtl_Write(&record), HAL_OK);
+  }
+}
+
+static uint8_t half_blank(const uint32_t address)
+{
+  const uint32_t *word = (const uint32_t *)(uintptr_t)address;
+  for (uint32_t i = 0; i < BOOT_CTL_SIZE / 4u; i++)
+  {
+    if (word[i] != 0xFFFFFFFFu)
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/** -- Сценарии -- */
+
+static const Host_t host_new = { new_image, NEW_LEN, 0u, 0u };
+
+static Host_t host_with(const uint32_t *image, const uint32_t crc)
+{
+  Host_t with = host_new;
+  with.image  = image;
+  with.crc    = crc;
+  return with;
+}
+
+/** Обновление, испытание, подтверждение; K1 при сбросе - режим приёма без HELLO */
+static void test_update(void)
+{
+  const Host_t with = host_with(new_image, new_crc);
+
+  flash_reset();
+  CHECK_EQ(boot(NULL), EXIT_JUMP);
+  CHECK(slot_a_old());
+  CHECK_EQ(journal().seq, 0u);   /// Журнал пуст: подтверждённый образ неизвестной длины
+
+  CHECK_EQ(boot(&with), EXIT_JUMP);
+  CHECK_EQ(shared->hello_state, BOOT_STATE_CONFIRMED);
+  CHECK_EQ(shared->begin_status, BOOT_ST_OK);
+  CHECK_EQ(shared->begin_offset, 0u);
+  CHECK_EQ(shared->data_bytes, NEW_LEN);
+  CHECK_EQ(shared->end_status, BOOT_ST_OK);
+  CHECK(slot_a_is(new_image, NEW_LEN));
+  CHECK(backup_old());
+  CHECK_EQ(journal().state, BOOT_STATE_TRIAL);
+  CHECK_EQ(journal().trials, 1u);
+
+  CHECK_EQ(app(1), EXIT_APP);
+  CHECK_EQ(journal().state, BOOT_STATE_CONFIRMED);
+  CHECK_EQ(journal().image_len, NEW_LEN);
+  CHECK_EQ(journal().image_crc, new_crc);
+  CHECK_EQ(boot(NULL), EXIT_JUMP);
+  CHECK(slot_a_is(new_image, NEW_LEN));
+
+  /// K1 удерживается: режим приёма, без хоста - ожидание, слот A не тронут
+  GPIOB->IDR |= K1_Pin;
+  CHECK_EQ(boot(NULL), EXIT_IDLE);
+  GPIOB->IDR &= ~(uint32_t)K1_Pin;
+  CHECK(slot_a_is(new_image, NEW_LEN));
+  CHECK_EQ(journal().state, BOOT_STATE_CONFIRMED);
+}
+
+/** Обрыв питания посреди приёма: BEGIN с тем же образом продолжает с записанного */
+static void test_resume(void)
+{
+  const Host_t with = host_with(new_image, new_crc);
+
+  flash_reset();
+  shared->logging = 1;
+  shared->log_len = 0;
+  CHECK_EQ(boot(&with), EXIT_JUMP);
+  shared->logging = 0;
+
+  /// Половина слов образа в слоте B
+  uint32_t cut = CUT_NEVER;
+  for (uint32_t i = 0, seen = 0; i < shared->log_len; i++)
+  {
+    if (shared->log[i].kind == OP_DATA && shared->log[i].address >= BOOT_SLOT_B_ADDR &&
+        shared->log[i].address < BOOT_BACKUP_ADDR && ++seen == NEW_LEN / 8u)
+    {
+      cut = i;
+      break;
+    }
+  }
+  CHECK(cut != CUT_NEVER);
+
+  flash_reset();
+  shared->cut_at   = cut;
+  shared->cut_torn = 0;
+  CHECK_EQ(boot(&with), EXIT_CUT);
+  shared->cut_at = CUT_NEVER;
+  CHECK_EQ(journal().state, BOOT_STATE_RECEIVING);
+
+  CHECK_EQ(boot(&with), EXIT_JUMP);
+  CHECK_EQ(shared->hello_state, BOOT_STATE_RECEIVING);
+  CHECK_EQ(shared->begin_status, BOOT_ST_OK);
+  CHECK_EQ(shared->begin_offset, (NEW_LEN / 8u - 1u) * 4u);   /// Слова до обрыва
+  CHECK_EQ(shared->data_bytes, NEW_LEN - shared->begin_offset);
+  CHECK_EQ(shared->end_status, BOOT_ST_OK);
+  CHECK(slot_a_is(new_image, NEW_LEN));
+}
+
+/** CRC принятого образа не совпала: ERR_IMAGE, слот A не тронут, следующий BEGIN - с нуля */
+static void test_crc_mismatch(void)
+{
+  Host_t corrupt      = host_with(new_image, new_crc);
+  corrupt.corrupt_word = 700u;
+  const Host_t wrong  = host_with(new_image, new_crc ^ 1u);
+  const Host_t with   = host_with(new_image, new_crc);
+
+  flash_reset();
+  CHECK_EQ(boot(&corrupt), EXIT_IDLE);
+  CHECK_EQ(shared->end_status, BOOT_ST_ERR_IMAGE);
+  CHECK(slot_a_old());
+  CHECK_EQ(journal().state, BOOT_STATE_RECEIVING);
+  CHECK_EQ(journal().image_crc, ~new_crc);   /// Сессия не возобновляется
+
+  CHECK_EQ(boot(NULL), EXIT_IDLE);           /// Приём не закончен - ждём образ
+  CHECK(slot_a_old());
+
+  CHECK_EQ(boot(&wrong), EXIT_IDLE);
+  CHECK_EQ(shared->begin_offset, 0u);
+  CHECK_EQ(shared->end_status, BOOT_ST_ERR_IMAGE);
+
+  CHECK_EQ(boot(&with), EXIT_JUMP);
+  CHECK_EQ(shared->begin_offset, 0u);
+  CHECK_EQ(shared->data_bytes, NEW_LEN);
+  CHECK_EQ(shared->end_status, BOOT_ST_OK);
+  CHECK(slot_a_is(new_image, NEW_LEN));
+}
+
+/** Образ не подтверждается: BOOT_MAX_TRIALS запусков, затем резерв; BEGIN при испытании отвергается */
+static void test_rollback(void)
+{
+  const Host_t bad  = host_with(bad_image, bad_crc);
+  const Host_t with = host_with(new_image, new_crc);
+  uint32_t     trial_jumps = 0;
+
+  flash_reset();
+  CHECK_EQ(boot(&bad), EXIT_JUMP);
+  CHECK(slot_a_is(bad_image, NEW_LEN));
+  trial_jumps++;
+
+  /// Хост пробует обновить во время испытания: резерв и образ не стираются
+  CHECK_EQ(boot(&with), EXIT_IDLE);
+  CHECK_EQ(shared->hello_state, BOOT_STATE_TRIAL);
+  CHECK_EQ(shared->begin_status, BOOT_ST_ERR_STATE);
+  CHECK_EQ(shared->data_bytes, 0u);
+  CHECK(backup_old());
+  CHECK(slot_a_is(bad_image, NEW_LEN));
+
+  for (uint32_t i = 0; i < 2u * BOOT_MAX_TRIALS; i++)
+  {
+    CHECK_EQ(boot(NULL), EXIT_JUMP);
+    CHECK_EQ(app(0), EXIT_APP);
+    if (!slot_a_is(bad_image, NEW_LEN))
+    {
+      break;
+    }
+    trial_jumps++;
+  }
+  CHECK_EQ(trial_jumps, BOOT_MAX_TRIALS - 1u);   /// Один запуск испытания ушёл на попытку хоста
+  CHECK(slot_a_old());
+  CHECK_EQ(journal().state, BOOT_STATE_CONFIRMED);
+  CHECK_EQ(journal().image_len, BOOT_SLOT_SIZE);
+  CHECK_EQ(journal().image_crc, APP_CRC_Calc(old_slot, BOOT_SLOT_SIZE / 4u));
+
+  /// После отката обновление снова принимается
+  CHECK_EQ(boot(&with), EXIT_JUMP);
+  CHECK_EQ(shared->begin_status, BOOT_ST_OK);
+  CHECK(slot_a_is(new_image, NEW_LEN));
+  CHECK(backup_old());
+}
+
+/** Откатываться некуда (слот A был пуст): UPDATE_REQ, новый образ принимается */
+static void test_no_backup(void)
+{
+  const Host_t bad  = host_with(bad_image, bad_crc);
+  const Host_t with = host_with(new_image, new_crc);
+
+  flash_reset();
+  memset((void *)(uintptr_t)BOOT_SLOT_A_ADDR, 0xFF, BOOT_SLOT_SIZE);
+  CHECK_EQ(boot(NULL), EXIT_IDLE);   /// Запускать нечего
+  CHECK_EQ(boot(&bad), EXIT_JUMP);
+  CHECK_EQ(journal().backup_crc, 0u);
+
+  uint32_t boots = 0;
+  while (boot(NULL) == EXIT_JUMP && boots < 2u * BOOT_MAX_TRIALS)
+  {
+    boots++;
+  }
+  CHECK_EQ(boots, BOOT_MAX_TRIALS - 1u);
+  CHECK_EQ(journal().state, BOOT_STATE_UPDATE_REQ);
+
+  CHECK_EQ(boot(&with), EXIT_JUMP);
+  CHECK_EQ(shared->hello_state, BOOT_STATE_UPDATE_REQ);
+  CHECK_EQ(shared->begin_status, BOOT_ST_OK);
+  CHECK(slot_a_is(new_image, NEW_LEN));
+  CHECK_EQ(app(1), EXIT_APP);
+  CHECK_EQ(journal().state, BOOT_STATE_CONFIRMED);
+}
+
+/** Журнал: переход в другую половину, обрыв при стирании старой и при стирании испорченной новой */
+static void test_journal_switch(void)
+{
+  const Host_t     with     = host_with(new_image, new_crc);
+  const uint32_t   per_half = BOOT_CTL_SIZE / sizeof(BootCtl_Record_t);
+
+  /// Половина 0 заполнена: первая запись обновления (RECEIVING) - в половину 1, затем стирание 0
+  flash_reset();
+  journal_fill(per_half);
+  CHECK(half_blank(BOOT_CTL_ALT_ADDR));
+  shared->logging = 1;
+  shared->log_len = 0;
+  const uint32_t base = shared->ops;
+  CHECK_EQ(boot(&with), EXIT_JUMP);
+  shared->logging = 0;
+  CHECK(half_blank(BOOT_CTL_ADDR) || journal().seq <= per_half);   /// Половина 0 стёрта или снова в работе
+
+  uint32_t erase_old = CUT_NEVER;
+  for (uint32_t i = 0; i < shared->log_len; i++)
+  {
+    if (shared->log[i].kind == OP_ERASE && shared->log[i].address == BOOT_CTL_ADDR)
+    {
+      erase_old = base + i;
+      break;
+    }
+  }
+  CHECK(erase_old != CUT_NEVER);
+
+  for (uint8_t torn = 0; torn < 2u; torn++)
+  {
+    flash_reset();
+    journal_fill(per_half);
+    shared->ops      = base;
+    shared->cut_at   = erase_old;
+    shared->cut_torn = torn;
+    CHECK_EQ(boot(&with), EXIT_CUT);
+    shared->cut_at = CUT_NEVER;
+    CHECK_EQ(journal().state, BOOT_STATE_RECEIVING);   /// Запись уже в половине 1
+    CHECK_EQ(journal().seq, per_half + 1u);
+
+    CHECK_EQ(boot(&with), EXIT_JUMP);
+    CHECK_EQ(shared->begin_status, BOOT_ST_OK);
+    CHECK(slot_a_is(new_image, NEW_LEN));
+  }
+
+  /// Половина 1 заполняется, обратный переход: испорченная половина 0 сначала стирается
+  BootCtl_Record_t record = journal();
+  for (uint32_t i = 0; i < per_half + 10u; i++)
+  {
+    record.trials = i;
+    CHECK_EQ(BootCtl_Write(&record), HAL_OK);
+    CHECK_EQ(journal().trials, i);
+  }
+  CHECK(half_blank(BOOT_CTL_ALT_ADDR));
+
+  /// Обрыв при стирании испорченной новой половины: действующая запись - в старой
+  flash_reset();
+  journal_fill(per_half);
+  *(volatile uint32_t *)(uintptr_t)(BOOT_CTL_ALT_ADDR + 0x100u) = 0x12345678u;
+  shared->cut_at   = shared->ops;   /// Первая операция - стирание половины 1
+  shared->cut_torn = 1;
+  BootCtl_Record_t trial = journal();
+  trial.state = BOOT_STATE_UPDATE_REQ;
+  const pid_t pid = fork();
+  if (pid == 0)
+  {
+    (void)BootCtl_Write(&trial);
+    _exit(EXIT_APP);
+  }
+  CHECK_EQ(wait_child(pid), EXIT_CUT);
+  shared->cut_at = CUT_NEVER;
+  CHECK_EQ(journal().state, BOOT_STATE_CONFIRMED);
+  CHECK_EQ(journal().seq, per_half);
+  CHECK_EQ(boot(NULL), EXIT_JUMP);
+  CHECK(slot_a_old());
+  CHECK_EQ(boot(&with), EXIT_JUMP);
+  CHECK(slot_a_is(new_image, NEW_LEN));
+}
+
+/**
+ * @brief Обрыв питания в операции cut пути "обновление + подтверждение", затем восстановление.
+ * @retval Запусков до подтверждённого нового образа.
+ */
+static uint32_t sweep_one(const uint32_t cut, const uint8_t torn)
+{
+  const Host_t with = host_with(new_image, new_crc);
+
+  memcpy((void *)(uintptr_t)FLASH_BASE, snapshot, FLASH_BYTES);
+  shared->ops      = 0;
+  shared->cut_at   = cut;
+  shared->cut_torn = torn;
+  int rc = boot(&with);
+  if (rc == EXIT_JUMP)
+  {
+    rc = app(1);
+  }
+  CHECK_EQ(rc, EXIT_CUT);
+  shared->cut_at = CUT_NEVER;
+
+  /// Питание вернулось: запуск без хоста; ждёт образ или в слоте старый - хост повторяет обновление
+  for (uint32_t boots = 1; boots <= 8u; boots++)
+  {
+    const uint8_t use_host = (boots % 2u) == 0u;
+    rc = boot(use_host ? &with : NULL);
+    if (rc == EXIT_JUMP)
+    {
+      const uint8_t is_new = slot_a_is(new_image, NEW_LEN);
+      if (!is_new && !slot_a_old())
+      {
+        fprintf(stderr, "cut %u%s: jump into a broken slot A\n", cut, torn ? " torn" : "");
+        CHECK(0);
+        return boots;
+      }
+      if (is_new)
+      {
+        CHECK_EQ(app(1), EXIT_APP);
+        if (journal().state == BOOT_STATE_CONFIRMED && journal().image_crc == new_crc)
+        {
+          return boots;
+        }
+      }
+      else if (!use_host)
+      {
+        boots++;   /// Старый образ работает: сразу запуск с хостом
+        rc = boot(&with);
+        if (rc == EXIT_JUMP && slot_a_is(new_image, NEW_LEN))
+        {
+          CHECK_EQ(app(1), EXIT_APP);
+          return boots;
+        }
+      }
+    }
+    else if (rc != EXIT_IDLE)
+    {
+      fprintf(stderr, "cut %u%s: boot ended with %d\n", cut, torn ? " torn" : "", rc);
+      CHECK(0);
+      return boots;
+    }
+  }
+  fprintf(stderr, "cut %u%s: update not finished, state %u\n", cut, torn ? " torn" : "", journal().state);
+  CHECK(0);
+  return 0;
+}
+
+static void test_power_cuts(const uint32_t data_stride)
+{
+  const Host_t   with     = host_with(new_image, new_crc);
+  const uint32_t per_half = BOOT_CTL_SIZE / sizeof(BootCtl_Record_t);
+
+  /// Журнал почти полон: переход в другую половину - посреди обновления
+  flash_reset();
+  journal_fill(per_half - 3u);
+  memcpy(snapshot, (const void *)(uintptr_t)FLASH_BASE, FLASH_BYTES);
+
+  shared->ops     = 0;
+  shared->logging = 1;
+  shared->log_len = 0;
+  CHECK_EQ(boot(&with), EXIT_JUMP);
+  CHECK_EQ(app(1), EXIT_APP);
+  shared->logging = 0;
+  CHECK_EQ(journal().state, BOOT_STATE_CONFIRMED);
+  const uint32_t total = shared->ops;
+  CHECK_EQ(shared->log_len, total);
+
+  uint32_t points    = 0;
+  uint32_t max_boots = 0;
+  uint32_t data_seen = 0;
+  for (uint32_t i = 0; i < total; i++)
+  {
+    const Op_t op = shared->log[i];
+    if (op.kind == OP_DATA && (data_seen++ % data_stride) != 0u)
+    {
+      continue;
+    }
+    for (uint8_t torn = 0; torn < 2u; torn++)
+    {
+      const uint32_t boots = sweep_one(i, torn);
+      max_boots = (boots > max_boots) ? boots : max_boots;
+      points++;
+    }
+  }
+  printf("power cuts: %u flash operations, %u cuts, up to %u boots to finish the update\n", total,
+         points, max_boots);
+}
+
+int main(int argc, char **argv)
+{
+  const uint32_t data_stride = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 397u;
+
+  /// Flash - общая с процессами запусков память
+  void *flash = mmap((void *)(uintptr_t)FLASH_BASE, FLASH_BYTES, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+  shared      = mmap(NULL, sizeof(Shared_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (flash != (void *)(uintptr_t)FLASH_BASE || shared == MAP_FAILED)
+  {
+    fprintf(stderr, "test_boot: cannot map shared memory\n");
+    return 2;
+  }
+  memset(shared, 0, sizeof(*shared));
+
+  APP_CRC_Init();
+  memset(old_slot, 0xFF, sizeof(old_slot));
+  image_make(old_slot, OLD_LEN);
+  image_make(new_image, NEW_LEN);
+  image_make(bad_image, NEW_LEN);
+  new_crc = APP_CRC_Calc(new_image, NEW_LEN / 4u);
+  bad_crc = APP_CRC_Calc(bad_image, NEW_LEN / 4u);
+
+  test_update();
+  test_resume();
+  test_crc_mismatch();
+  test_rollback();
+  test_no_backup();
+  test_journal_switch();
+  test_power_cuts(data_stride);
+
+  CHECK_EQ(shared->child_errors, 0u);
+  return HOST_TEST_RESULT("test_boot");
+}
@@ -0,0 +1,348 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * Консоль на ПК (CONSOLE_PORT_HOST) через pty: консоль читает и пишет ведущую сторону,
+ * тест - терминал на ведомой (сырой режим, как USART).
+ *
+ *   - ядро (Console.c) со своей таблицей: вставка 64 байт разом - ответы на все команды,
+ *     по порядку, и не больше одной строки за Console_Poll(); вставки по кругу кольца
+ *     приёма, слова через его конец, CR LF, длинная строка, лишние слова, неизвестная
+ *     команда; неотсортированная таблица отвергается;
+ *   - таблица AppConsole.c: тест собирается в каждом варианте опций (APP_SCHEDULE,
+ *     APP_LL_FLASH, APP_BOOTLOADER) - Console_Init() принимает таблицу, help перечисляет команды по
+ *     возрастанию, каждая команда находится. В C имена не сравнить в _Static_assert,
+ *     поэтому порядок таблицы проверяется здесь, при сборке тестов, а не в прошивке.
+ */
+
+#include <string.h>
+#include "host_pty.h"
+#include "host_test.h"
+#include "Console.h"
+#include "AppConsole.h"
+#include "AppFlashConfig.h"
+#include "AppTime.h"
+#include "AppCrc.h"
+#if defined(APP_LL_FLASH) || defined(APP_BOOTLOADER)
+#include "BootFlash.h"
+#endif
+#ifdef APP_BOOTLOADER
+#include "BootCtl.h"
+#endif
+
+#define OUT_MAX (4096u)
+
+static int  term_fd;          /// Ведомая сторона pty: "терминал техника"
+static int  console_fd;       /// Ведущая - у консоли (host_pty.h)
+static char out[OUT_MAX];     /// Принятые терминалом ответы
+static int  out_len;
+
+static void term_send(const char *text)
+{
+  CHECK(host_pty_send(term_fd, console_fd, text, (uint32_t)strlen(text)) >= strlen(text));
+}
+
+static void term_collect(void)
+{
+  out_len += (int)host_pty_receive(term_fd, &out[out_len], OUT_MAX - 1u - (uint32_t)out_len);
+  out[out_len] = '\0';
+}
+
+/**
+ * @brief Суперцикл до ответа длины expected_len (0 - пока ответы идут): сколько строк выполнено.
+ * @details Каждый проход выполняет не больше одной строки (счётчик lines консоли).
+ */
+static uint32_t run_until(const uint32_t expected_len, uint8_t (*poll_fn)(void))
+{
+  uint32_t lines = 0;
+  uint32_t quiet = 0;
+
+  out_len = 0;
+  out[0]  = '\0';
+  for (uint32_t spin = 0; spin < 1000u && quiet < 20u; spin++)
+  {
+    const uint16_t before = Console_Get_Stats()->lines;
+    const int      was    = out_len;
+
+    lines += poll_fn();
+    CHECK((uint16_t)(Console_Get_Stats()->lines - before) <= 1u);
+    term_collect();
+    if (expected_len != 0u && (uint32_t)out_len >= expected_len)
+    {
+      break;
+    }
+    if (out_len == was)
+    {
+      host_pty_wait(term_fd, 1);
+      quiet++;
+    }
+    else
+    {
+      quiet = 0;
+    }
+  }
+  return lines;
+}
+
+static void check_out(const char *expected, const int line)
+{
+  if (strcmp(out, expected) != 0)
+  {
+    fprintf(stderr, "line %d:\n  got      \"%s\"\n  expected \"%s\"\n", line, out, expected);
+  }
+  CHECK(strcmp(out, expected) == 0);
+}
+
+/** -- Ядро: своя таблица -- */
+
+static void cmd_add(const Console_Args_t *args)
+{
+  uint32_t a;
+  uint32_t b;
+  if (args->count != 3u || !Console_Span_Uint(&args->arg[1], &a) || !Console_Span_Uint(&args->arg[2], &b))
+  {
+    Console_Puts("ERR usage\r\n");
+    return;
+  }
+  Console_Put_Uint(a + b);
+  Console_Puts("\r\n");
+}
+
+/** Слова через запятую, по символу из кольца - проверка отрезков */
+static void cmd_echo(const Console_Args_t *args)
+{
+  for (uint32_t i = 1; i < args->count; i++)
+  {
+    for (uint32_t c = 0; c < args->arg[i].len; c++)
+    {
+      const char ch = Console_Span_Char(&args->arg[i], c);
+      Console_Write(&ch, 1u);
+    }
+    Console_Puts((i + 1u < args->count) ? "," : "");
+  }
+  Console_Puts("\r\n");
+}
+
+static void cmd_ping(const Console_Args_t *args)
+{
+  (void)args;
+  Console_Puts("pong\r\n");
+}
+
+static const Console_Cmd_t core_commands[] = {
+  { "add",  cmd_add,  "A B" },
+  { "echo", cmd_echo, "words" },
+  { "ping", cmd_ping, "" },
+};
+
+static void test_core(void)
+{
+  CHECK_EQ(Console_Init(core_commands, 3u), HAL_OK);
+
+  /// 64 байта вставкой: 8 строк за один write(), ответы по порядку, по строке за проход
+  static const char paste[] = "add 1 2\rping\recho ab cd\radd 40 2\rx\r\nping\recho 123456789\radd 7 8\r";
+  static const char reply[] = "3\r\npong\r\nab,cd\r\n42\r\nERR unknown command, see help\r\n"
+                              "pong\r\n123456789\r\n15\r\n";
+  CHECK_EQ(strlen(paste), 64u);
+
+  for (uint32_t round = 0; round < 40u; round++)   /// 2560 байт: кольцо 256 - слова через его конец
+  {
+    term_send(paste);
+    CHECK_EQ(run_until(strlen(reply), Console_Poll), 8u);
+    check_out(reply, __LINE__);
+  }
+  CHECK_EQ(Console_Get_Stats()->lines, 320u);
+  CHECK_EQ(Console_Get_Stats()->unknown, 40u);
+
+  /// Строка длиннее CONSOLE_LINE_MAX отбрасывается целиком, следующая - как обычно
+  char longline[CONSOLE_LINE_MAX + 32u];
+  memset(longline, 'z', sizeof(longline));
+  strcpy(&longline[sizeof(longline) - 2u], "\r");
+  term_send(longline);
+  term_send("ping\r");
+  run_until(strlen("ERR line too long\r\npong\r\n"), Console_Poll);
+  check_out("ERR line too long\r\npong\r\n", __LINE__);
+  CHECK_EQ(Console_Get_Stats()->too_long, 1u);
+
+  term_send("echo 1 2 3 4 5 6\r  \t \r\r\n");
+  run_until(strlen("ERR too many arguments\r\n"), Console_Poll);
+  check_out("ERR too many arguments\r\n", __LINE__);
+
+  /// Двоичный поиск требует порядок: повтор и обратный порядок отвергаются
+  static const Console_Cmd_t unsorted[] = { { "ping", cmd_ping, "" }, { "echo", cmd_echo, "" } };
+  static const Console_Cmd_t repeated[] = { { "echo", cmd_echo, "" }, { "echo", cmd_echo, "" } };
+  CHECK_EQ(Console_Init(unsorted, 2u), HAL_ERROR);
+  CHECK_EQ(Console_Init(repeated, 2u), HAL_ERROR);
+}
+
+/** -- Таблица AppConsole.c в этом варианте сборки -- */
+
+AppFlashConfig_t GlobalAppConfig;
+static uint32_t  saves;
+
+HAL_StatusTypeDef APP_Save_CFG_Flash(void)
+{
+  saves++;
+  return HAL_OK;
+}
+
+#if defined(APP_LL_FLASH) || defined(APP_BOOTLOADER)
+const BootFlash_Stats_t *Boot_Flash_Get_Stats(void)
+{
+  static const BootFlash_Stats_t stats = {0};
+  return &stats;
+}
+
+const AppFlashConfig_Stats_t *APP_Get_CFG_Stats(void)
+{
+  static const AppFlashConfig_Stats_t stats = {0};
+  return &stats;
+}
+#endif
+
+#ifdef APP_BOOTLOADER
+static uint32_t update_requests;
+
+/** Журнал "не пишется": при успехе консоль сбросила бы МК (NVIC_SystemReset) */
+HAL_StatusTypeDef BootCtl_Request_Update(void)
+{
+  update_requests++;
+  return HAL_ERROR;
+}
+#endif
+
+static uint32_t crc_words;
+
+/** Замер CRC: такты - по числу слов, сравнение результатов - в тесте AppCrc не нужно */
+void APP_CRC_Benchmark(const uint32_t *data, const uint32_t words, AppCrc_Bench_t *result)
+{
+  (void)data;
+  crc_words          = words;
+  result->words      = words;
+  result->cycles_hw  = words;
+  result->cycles_dma = 2u * words;
+  result->cycles_sw  = 3u * words;
+  result->match      = (words != 7u) ? 1u : 0u;
+}
+
+static const char *const app_names[] = {
+  "crc",
+#if defined(APP_LL_FLASH) || defined(APP_BOOTLOADER)
+  "flash",
+#endif
+  "help",
+#ifdef APP_SCHEDULE
+  "sched",
+#endif
+  "sec",
+  "status",
+#ifdef APP_SCHEDULE
+  "time",
+#endif
+#ifdef APP_BOOTLOADER
+  "update",
+#endif
+};
+
+static void test_app_table(void)
+{
+  static MachineState_Context_t ctx = { .machine_state = STATE_READY, .cfg_sec = 3u };
+  const uint32_t                count = sizeof(app_names) / sizeof(app_names[0]);
+
+  App_Time_Init();
+#ifdef APP_SCHEDULE
+  Schedule_Init(GlobalAppConfig.sched);
+#endif
+  App_Console_Init(&ctx);   /// Неотсортированная таблица - Error_Handler(): тест завершится с ошибкой
+  run_until(0u, App_Console_Poll);
+
+  /// help: все команды варианта, строго по возрастанию
+  term_send("help\r");
+  run_until(0u, App_Console_Poll);
+  const char *line = out;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    const size_t len = strlen(app_names[i]);
+    CHECK(strncmp(line, app_names[i], len) == 0 && strncmp(&line[len], " - ", 3u) == 0);
+    CHECK(i == 0u || strcmp(app_names[i - 1u], app_names[i]) < 0);
+    line = strchr(line, '\n');
+    if (line == NULL)
+    {
+      break;
+    }
+    line++;
+  }
+  CHECK(line != NULL && *line == '\0');
+
+  /// Каждая команда находится двоичным поиском
+  for (uint32_t i = 0; i < count; i++)
+  {
+    const uint16_t unknown = Console_Get_Stats()->unknown;
+    term_send(app_names[i]);
+    term_send("\r");
+    run_until(0u, App_Console_Poll);
+    CHECK_EQ(Console_Get_Stats()->unknown, unknown);
+  }
+  term_send("statu\rstatuss\r");
+  run_until(0u, App_Console_Poll);
+  check_out("ERR unknown command, see help\r\nERR unknown command, see help\r\n", __LINE__);
+
+  /// Запись настройки - во Flash после ответа; не в READY - отказ
+  term_send("sec 5\rsec 9\r");
+  run_until(strlen("sec 5\r\nERR range\r\n"), App_Console_Poll);
+  check_out("sec 5\r\nERR range\r\n", __LINE__);
+  CHECK_EQ(GlobalAppConfig.cfg_sec, 5u);
+  CHECK_EQ(saves, 1u);
+  ctx.machine_state = STATE_COUNTDOWN;
+  term_send("sec 4\r");
+  run_until(strlen("ERR busy, only in READY\r\n"), App_Console_Poll);
+  check_out("ERR busy, only in READY\r\n", __LINE__);
+  ctx.machine_state = STATE_READY;
+
+  /// Замер CRC: блок по умолчанию и заданный, несовпадение, неверный размер
+  term_send("crc\rcrc 7\r");
+  run_until(strlen("crc words 1024 hw 1024 dma 2048 sw 3072 match\r\ncrc words 7 hw 7 dma 14 sw 21 MISMATCH\r\n"),
+            App_Console_Poll);
+  check_out("crc words 1024 hw 1024 dma 2048 sw 3072 match\r\ncrc words 7 hw 7 dma 14 sw 21 MISMATCH\r\n", __LINE__);
+  CHECK_EQ(crc_words, 7u);
+  term_send("crc 0\rcrc 16385\r");
+  run_until(2u * strlen("ERR usage: crc [1..16384]\r\n"), App_Console_Poll);
+  check_out("ERR usage: crc [1..16384]\r\nERR usage: crc [1..16384]\r\n", __LINE__);
+
+#ifdef APP_BOOTLOADER
+  /// Запрос обновления: не в READY - отказ без записи в журнал
+  const uint32_t requests = update_requests;
+  ctx.machine_state = STATE_COUNTDOWN;
+  term_send("update\r");
+  run_until(strlen("ERR busy, only in READY\r\n"), App_Console_Poll);
+  check_out("ERR busy, only in READY\r\n", __LINE__);
+  CHECK_EQ(update_requests, requests);
+  ctx.machine_state = STATE_READY;
+  term_send("update\r");
+  run_until(strlen("ERR flash\r\n"), App_Console_Poll);
+  check_out("ERR flash\r\n", __LINE__);
+  CHECK_EQ(update_requests, requests + 1u);
+#endif
+
+#ifdef APP_SCHEDULE
+  term_send("time 3 06:29:30\rsched 0 135 06:30\r");
+  run_until(strlen("3 06:29:30\r\n0: 135 06:30\r\n"), App_Console_Poll);
+  check_out("3 06:29:30\r\n0: 135 06:30\r\n", __LINE__);
+  CHECK_EQ(GlobalAppConfig.sched[0], SCHEDULE_ENTRY(0x15u, 6, 30));
+  CHECK_EQ(Schedule_Host_Sleep(3600u), 30u);   /// Будильник перевзведён на новую запись
+#endif
+
+  printf("app table: %u commands\n", count);
+}
+
+int main(void)
+{
+  term_fd = host_pty_open(&console_fd);
+  CHECK(term_fd >= 0);
+  Console_Host_Attach(console_fd);
+  test_core();
+  test_app_table();
+
+  return HOST_TEST_RESULT("test_console");
+}
@@ -0,0 +1,297 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * Сценарий на уровне выводов: кнопка K1 (PB10) нажимается через IDR, результат читается
+ * только с выводов - клапан PB12, сегменты PA0..PA7, разряды PB0..PB2. Связка как в main.c:
+ * SysTick - Button_Poll_1ms() и Machine_Process(), TIM3 (~238 Гц, здесь каждые 4 мс) -
+ * Seg7_UpdateIndicator(). Модель порта применяет записанный драйвером BSRR к ODR, как
+ * это делает GPIO кристалла; цифры расшифровываются своей таблицей, не таблицей драйвера.
+ *
+ * Проверки: после старта "  3" и клапан закрыт; короткое нажатие - PB12 низкий, справа
+ * 3, 2, 1, слева бегущий сегмент, закрытие на нуле и снова "  3"; долгое нажатие - точка
+ * и мигание последнего разряда, шаг 3 -> 4 -> 5, долгое - одна запись и "  5", клапан всё
+ * это время закрыт; повторное нажатие посреди отсчёта закрывает клапан. В каждом шаге
+ * мультиплекса горит ровно один разряд.
+ *
+ * Тот же сценарий для прошивки в Renode - renode/7_seg.robot (если найден renode-test).
+ */
+
+#include <string.h>
+#include "host_periph.h"
+#include "host_test.h"
+#include "7_seg_driver.h"
+#include "Button.h"
+#include "AppFlashConfig.h"
+
+#define MUX_PERIOD_MS  (4u)
+#define DIGIT_MASK     (Q1_Pin | Q2_Pin | Q3_Pin)
+#define SEGMENT_MASK   (0xFFu)
+#define SEGMENT_DP     (0x80u)
+
+Seg7_Handle_t    seg7_handle;
+AppFlashConfig_t GlobalAppConfig = { .cfg_sec = DEFAULT_TIME };
+
+static GPIO_TypeDef *digit_ports[NUMBER_OF_DIG] = { Q1_GPIO_Port, Q2_GPIO_Port, Q3_GPIO_Port };
+static uint16_t      digit_pins [NUMBER_OF_DIG] = { Q1_Pin, Q2_Pin, Q3_Pin };
+
+static MachineState_Context_t machine;
+static uint32_t now_ms;
+static uint32_t next_tick_ms;
+static uint32_t saves;
+static uint32_t valve_open_ms;              /// Сколько мс PB12 был низким
+static uint8_t  lit[NUMBER_OF_DIG];          /// Последний шаблон на выводах для каждого разряда
+static uint8_t  lit_seen[NUMBER_OF_DIG];     /// Все шаблоны разряда за окно (ИЛИ)
+static uint8_t  lit_blank[NUMBER_OF_DIG];    /// Разряд был погашен за окно
+
+HAL_StatusTypeDef APP_Save_CFG_Flash(void)
+{
+  saves++;
+  return HAL_OK;
+}
+
+/**
+ * @brief Цифра по сегментам a..g (без точки), -1 - не цифра, 10 - пусто.
+ */
+static int decode(const uint8_t pattern)
+{
+  static const uint8_t font[10] = { 0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F };
+
+  if ((pattern & 0x7Fu) == 0u)
+  {
+    return 10;
+  }
+  for (int i = 0; i < 10; i++)
+  {
+    if ((pattern & 0x7Fu) == font[i])
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief BSRR -> ODR, как в GPIO: старшая половина сбрасывает, младшая устанавливает.
+ */
+static void port_apply(GPIO_TypeDef *port)
+{
+  const uint32_t bsrr = port->BSRR;
+
+  port->ODR  = (port->ODR & ~(bsrr >> 16)) | (bsrr & 0xFFFFu);
+  port->BSRR = 0;
+}
+
+/**
+ * @brief Шаг мультиплекса TIM3 и чтение выводов: какой разряд горит и что на сегментах.
+ */
+static void mux_step(void)
+{
+  Seg7_UpdateIndicator(&seg7_handle);
+  port_apply(GPIOA);
+  port_apply(GPIOB);
+
+  const uint32_t digits = GPIOB->ODR & DIGIT_MASK;
+  const uint8_t  shown  = (uint8_t)(GPIOA->ODR & SEGMENT_MASK);
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < NUMBER_OF_DIG; i++)
+  {
+    if (digits & digit_pins[i])
+    {
+      count++;
+      lit[i]       = shown;
+      lit_seen[i] |= shown;
+      lit_blank[i] |= (shown == 0u) ? 1u : 0u;
+    }
+  }
+  CHECK_EQ(count, 1u);   /// Ровно один ключ открыт - без засветки соседнего разряда
+}
+
+static void step_1ms(void)
+{
+  now_ms++;
+  const MachineEvent_t event = Button_Poll_1ms();
+  if (event != EVENT_NONE)
+  {
+    Machine_Process(&machine, event);
+  }
+  if ((int32_t)(now_ms - next_tick_ms) >= 0)
+  {
+    next_tick_ms += 1000u;
+    Machine_Process(&machine, EVENT_TICK_1S);
+  }
+  if (now_ms % MUX_PERIOD_MS == 0u)
+  {
+    mux_step();
+  }
+  valve_open_ms += (VALVE_GPIO_Port->ODR & VALVE_Pin) ? 0u : 1u;
+}
+
+static void run_ms(const uint32_t ms)
+{
+  for (uint32_t i = 0; i < ms; i++)
+  {
+    step_1ms();
+  }
+}
+
+static void window_reset(void)
+{
+  memset(lit_seen, 0, sizeof(lit_seen));
+  memset(lit_blank, 0, sizeof(lit_blank));
+}
+
+static uint32_t valve_pin(void)
+{
+  return (VALVE_GPIO_Port->ODR & VALVE_Pin) ? 1u : 0u;
+}
+
+static void hold(const uint32_t pressed, const uint32_t ms)
+{
+  if (pressed)
+  {
+    K1_GPIO_Port->IDR |= K1_Pin;
+  }
+  else
+  {
+    K1_GPIO_Port->IDR &= ~(uint32_t)K1_Pin;
+  }
+  run_ms(ms);
+}
+
+/**
+ * @brief Нажатие K1 с дребезгом контакта на обоих фронтах.
+ */
+static void press(const uint32_t hold_ms)
+{
+  hold(1, 2); hold(0, 1); hold(1, 3); hold(0, 2);
+  hold(1, hold_ms);
+  hold(0, 2); hold(1, 1); hold(0, 3); hold(1, 1);
+  hold(0, BTN_DEBOUNCE_MS + 2u);
+}
+
+/**
+ * @brief На индикаторе число справа без точки, левее - пусто (как Seg7_SetNumber() для 0..9).
+ */
+static void check_display(const int number)
+{
+  CHECK_EQ(decode(lit[0]), 10);
+  CHECK_EQ(decode(lit[1]), 10);
+  CHECK_EQ(decode(lit[NUMBER_OF_DIG - 1u]), number);
+  CHECK_EQ(lit[NUMBER_OF_DIG - 1u] & SEGMENT_DP, 0u);
+}
+
+/** -- Старт как в main.c -- */
+
+static void boot(void)
+{
+  memset(&machine, 0, sizeof(machine));
+  machine.machine_state = STATE_READY;
+  machine.cfg_sec       = DEFAULT_TIME;
+  VALVE_GPIO_Port->ODR |= VALVE_Pin;   /// MX_GPIO_Init: клапан закрыт
+  Button_Init(K1_GPIO_Port, K1_Pin, HIGH);
+  Seg7_Init(&seg7_handle, digit_ports, digit_pins, GPIOA, 0xFF);
+  Seg7_SetNumber(&seg7_handle, machine.cfg_sec);
+
+  run_ms(200);
+  check_display(DEFAULT_TIME);
+  CHECK_EQ(valve_pin(), 1u);
+  CHECK_EQ(valve_open_ms, 0u);
+}
+
+/** -- Короткое нажатие: отсчёт с открытым клапаном -- */
+
+static void test_countdown(void)
+{
+  int      shown[8];
+  uint32_t shown_count = 0;
+  int      previous    = -2;
+
+  press(150);
+  CHECK_EQ(valve_pin(), 0u);
+  window_reset();
+  valve_open_ms = 0;
+  for (uint32_t ms = 0; ms < 5000u && valve_pin() == 0u; ms++)
+  {
+    step_1ms();
+    const int digit = decode(lit[NUMBER_OF_DIG - 1u]);
+    if (valve_pin() == 0u && digit != previous && shown_count < sizeof(shown) / sizeof(shown[0]))
+    {
+      shown[shown_count++] = digit;
+      previous = digit;
+    }
+    /// Слева - один сегмент из a..f, средний разряд пуст
+    const uint8_t left = lit[0];
+    CHECK(left == 0x01u || left == 0x02u || left == 0x04u || left == 0x08u || left == 0x10u || left == 0x20u);
+    CHECK_EQ(lit[1], 0u);
+  }
+  CHECK_EQ(valve_pin(), 1u);
+  CHECK(valve_open_ms >= (DEFAULT_TIME - 1u) * 1000u && valve_open_ms <= DEFAULT_TIME * 1000u);
+  CHECK_EQ(lit_seen[0], 0x3Fu);   /// Бегущий сегмент прошёл все a..f
+
+  /// Индикатор показывал 3, 2, 1 пока клапан открыт (0 - уже при закрытом)
+  CHECK_EQ(shown_count, DEFAULT_TIME);
+  for (uint32_t i = 0; i < shown_count; i++)
+  {
+    CHECK_EQ(shown[i], (int)(DEFAULT_TIME - i));
+  }
+
+  run_ms(1500);
+  check_display(DEFAULT_TIME);
+  CHECK_EQ(valve_pin(), 1u);
+}
+
+/** -- Долгое нажатие: настройка, шаг значения, сохранение -- */
+
+static void test_config(void)
+{
+  valve_open_ms = 0;
+  press(BTN_LONG_MS + 300u);
+  window_reset();
+  run_ms(800);
+  CHECK(lit_seen[NUMBER_OF_DIG - 1u] & SEGMENT_DP);   /// Точка - режим настройки
+  CHECK_EQ(lit_blank[NUMBER_OF_DIG - 1u], 1u);        /// Редактируемый разряд мигает
+  CHECK_EQ(decode(lit_seen[NUMBER_OF_DIG - 1u]), DEFAULT_TIME);
+
+  for (uint32_t step = 1; step <= 2u; step++)
+  {
+    press(100);
+    window_reset();
+    run_ms(800);
+    CHECK_EQ(decode(lit_seen[NUMBER_OF_DIG - 1u]), DEFAULT_TIME + step);
+  }
+
+  const uint32_t saves_before = saves;
+  press(BTN_LONG_MS + 300u);
+  CHECK_EQ(saves, saves_before + 1u);
+  window_reset();
+  run_ms(800);
+  check_display(DEFAULT_TIME + 2);
+  CHECK_EQ(lit_blank[NUMBER_OF_DIG - 1u], 0u);   /// Мигание снято
+  CHECK_EQ(valve_open_ms, 0u);                   /// В настройке клапан не открывался
+}
+
+/** -- Остановка кнопкой посреди отсчёта -- */
+
+static void test_stop(void)
+{
+  press(150);
+  run_ms(1500);
+  CHECK_EQ(valve_pin(), 0u);
+  press(150);
+  CHECK_EQ(valve_pin(), 1u);
+  run_ms(200);
+  check_display(DEFAULT_TIME + 2);
+  CHECK_EQ(lit[0], 0u);   /// Бегущий сегмент погас вместе с клапаном
+}
+
+int main(void)
+{
+  boot();
+  test_countdown();
+  test_config();
+  test_stop();
+
+  return HOST_TEST_RESULT("test_gpio_scenario");
+}
@@ -0,0 +1,172 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * Регулятор влажности (HumidityCtl.c и arm_pid_f32 из CMSIS-DSP, как в прошивке) в
+ * замкнутом контуре с моделью парной на ПК. Числа настройки - время установления,
+ * перерегулирование, переключения клапана - считает код прошивки, модель - только
+ * помещение:
+ *
+ *   dRH/dt = gain * steam(t - delay) * (100 - RH) / 100 - (RH - RH_ambient) / tau,
+ *
+ * датчик - инерционное звено sensor_tau (RoomSense.c усредняет блоки 64 мс, инерция -
+ * сам зонд), в регулятор идёт 0.1 %, как Room_Sense_Get()->rh_dpct.
+ *
+ * Проверки для каждого помещения: установление в полосу +/- BAND_PCT не дольше
+ * SETTLE_MAX_S и без выхода из неё до конца, перерегулирование не больше OVERSHOOT_MAX,
+ * не больше двух переключений за окно, открытие не короче HUM_CTL_MIN_ON_TICKS и не
+ * дольше HUM_CTL_MAX_OPEN_MS, закрытие не короче HUM_CTL_MIN_OFF_TICKS. Сценарий
+ * "door open" - 20 минут открытой двери (уставка недостижима, выход в упоре), затем
+ * дверь закрыта: без анти-виндапа интеграл дал бы выброс.
+ *
+ *   test_humidity [минут]
+ */
+
+#include <stdlib.h>
+#include "host_test.h"
+#include "HumidityCtl.h"
+
+#define DT_S           (1.0f / (float)HUM_CTL_TICK_HZ)
+#define SETPOINT_PCT   ((float)HUM_CTL_SETPOINT / 10.0f)
+#define BAND_PCT       (2.0f)
+#define SETTLE_MAX_S   (600.0f)
+#define OVERSHOOT_MAX  (3.0f)       /// %RH выше уставки
+#define DELAY_MAX      (100u)       /// Тиков задержки пара в трубе
+
+/**
+ * @brief Помещение
+ */
+typedef struct {
+  const char *name;
+  float       gain;          /// %RH/с при открытом клапане и сухом воздухе
+  float       tau_s;         /// Утечка к окружающей влажности
+  float       ambient;       /// %RH
+  uint32_t    delay_ticks;   /// Задержка пара
+  float       sensor_tau_s;
+  float       door_tau_s;    /// Утечка при открытой двери (0 - двери нет)
+  float       door_open_s;   /// Сколько дверь открыта с начала
+} Room_t;
+
+static const Room_t rooms[] = {
+  { "nominal",    4.0f, 600.0f, 40.0f, 50u, 20.0f,  0.0f,    0.0f },
+  { "small room", 6.0f, 400.0f, 40.0f, 30u, 15.0f,  0.0f,    0.0f },
+  { "large room", 3.0f, 900.0f, 30.0f, 80u, 30.0f,  0.0f,    0.0f },
+  { "leaky door", 6.0f, 300.0f, 40.0f, 50u, 20.0f,  0.0f,    0.0f },
+  { "door open",  4.0f, 600.0f, 40.0f, 50u, 20.0f, 30.0f, 1200.0f },
+};
+
+/**
+ * @brief Итог прогона
+ */
+typedef struct {
+  float    settle_s;       /// < 0 - не установилась
+  float    overshoot;      /// Максимум RH над уставкой после установления двери
+  float    final;
+  uint32_t switches;
+  uint32_t max_window_switches;
+  uint32_t min_on_ticks;
+  uint32_t max_on_ticks;
+  uint32_t min_off_ticks;
+} Result_t;
+
+static Result_t run(const Room_t *room, const uint32_t minutes)
+{
+  HumidityCtl_t ctl;
+  uint8_t       pipe[DELAY_MAX] = {0};
+  float         rh              = room->ambient;
+  float         measured        = room->ambient;
+  uint32_t      run_ticks       = 0;   /// Длина текущего открытия/закрытия
+  uint32_t      window_switches = 0;
+  uint32_t      previous        = 0;
+  Result_t      result          = { .settle_s = -1.0f, .min_on_ticks = UINT32_MAX, .min_off_ticks = UINT32_MAX };
+  const float   start_s         = room->door_open_s;   /// Установление считается с закрытия двери
+
+  Humidity_Ctl_Init(&ctl);
+  const uint32_t steps = minutes * 60u * HUM_CTL_TICK_HZ;
+  for (uint32_t n = 0; n < steps; n++)
+  {
+    const float   t_s   = (float)n * DT_S;
+    const int16_t rh_dp = (int16_t)(measured * 10.0f + 0.5f);
+    const uint8_t valve = Humidity_Ctl_Step(&ctl, rh_dp);
+
+    /// Длины открытий и закрытий; закрытие до первого открытия не в счёт
+    if (valve != previous)
+    {
+      if (previous)
+      {
+        result.min_on_ticks = (run_ticks < result.min_on_ticks) ? run_ticks : result.min_on_ticks;
+        result.max_on_ticks = (run_ticks > result.max_on_ticks) ? run_ticks : result.max_on_ticks;
+      }
+      else if (result.switches != 0u)
+      {
+        result.min_off_ticks = (run_ticks < result.min_off_ticks) ? run_ticks : result.min_off_ticks;
+      }
+      result.switches++;
+      window_switches++;
+      run_ticks = 0;
+    }
+    run_ticks++;
+    previous = valve;
+    if (n % HUM_CTL_WINDOW_TICKS == HUM_CTL_WINDOW_TICKS - 1u)
+    {
+      result.max_window_switches = (window_switches > result.max_window_switches) ? window_switches
+                                                                                  : result.max_window_switches;
+      window_switches = 0;
+    }
+
+    /// Помещение
+    const uint8_t steam = (room->delay_ticks != 0u) ? pipe[n % room->delay_ticks] : valve;
+    if (room->delay_ticks != 0u)
+    {
+      pipe[n % room->delay_ticks] = valve;
+    }
+    const float tau = (t_s < room->door_open_s) ? room->door_tau_s : room->tau_s;
+    rh       += DT_S * (room->gain * (float)steam * (100.0f - rh) / 100.0f - (rh - room->ambient) / tau);
+    measured += DT_S * (rh - measured) / room->sensor_tau_s;
+
+    if (t_s >= start_s)
+    {
+      if (rh - SETPOINT_PCT > result.overshoot)
+      {
+        result.overshoot = rh - SETPOINT_PCT;
+      }
+      if (rh > SETPOINT_PCT - BAND_PCT && rh < SETPOINT_PCT + BAND_PCT)
+      {
+        result.settle_s = (result.settle_s < 0.0f) ? t_s - start_s : result.settle_s;
+      }
+      else
+      {
+        result.settle_s = -1.0f;
+      }
+    }
+  }
+  CHECK_EQ(ctl.switches, result.switches);   /// Счётчик регулятора = переключения на выходе
+  result.final = rh;
+  return result;
+}
+
+int main(int argc, char **argv)
+{
+  const uint32_t minutes = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 60u;
+
+  printf("%-12s %10s %10s %9s %6s %7s %8s %8s\n", "scenario", "settle, s", "overshoot", "switches",
+         "sw/h", "final", "on, s", "off, s");
+  for (uint32_t i = 0; i < sizeof(rooms) / sizeof(rooms[0]); i++)
+  {
+    const Result_t r = run(&rooms[i], minutes);
+
+    printf("%-12s %10.0f %+9.1f%% %9u %6.0f %6.1f%% %3.1f-%-4.1f %6.1f\n", rooms[i].name, r.settle_s,
+           r.overshoot, r.switches, (float)r.switches * 60.0f / (float)minutes, r.final,
+           (float)r.min_on_ticks * DT_S, (float)r.max_on_ticks * DT_S, (float)r.min_off_ticks * DT_S);
+
+    CHECK(r.settle_s >= 0.0f && r.settle_s <= SETTLE_MAX_S);
+    CHECK(r.overshoot <= OVERSHOOT_MAX);
+    CHECK(r.max_window_switches <= 2u);
+    CHECK(r.min_on_ticks >= HUM_CTL_MIN_ON_TICKS);
+    CHECK(r.max_on_ticks * (1000u / HUM_CTL_TICK_HZ) <= HUM_CTL_MAX_OPEN_MS);
+    CHECK(r.min_off_ticks >= HUM_CTL_MIN_OFF_TICKS);
+  }
+
+  return HOST_TEST_RESULT("test_humidity");
+}
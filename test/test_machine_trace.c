@@ -0,0 +1,348 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * Машина состояний, кнопка и трасса на ПК: случайные последовательности нажатий
+ * (с дребезгом, короткие и долгие) и событий (тик, перегрев, расписание) проходят
+ * через Button_Poll_1ms() и Machine_Process() так же, как в main.c, каждая запись
+ * трассы проверяется на лету, снимки кольцевого буфера - Machine_Trace_Check().
+ * Испорченные копии записанных трасс проверка обязана отвергнуть.
+ *
+ *   test_machine_trace [событий] [seed]
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "host_periph.h"
+#include "host_test.h"
+#include "Button.h"
+#include "MachineTrace.h"
+#include "AppFlashConfig.h"
+
+Seg7_Handle_t    seg7_handle;
+AppFlashConfig_t GlobalAppConfig = { .cfg_sec = DEFAULT_TIME };
+
+static MachineState_Context_t machine;
+/** Часы трассы (App_Time_Us) начинаются у перехода через 2^32 мкс: 64-битная метка не переполняется */
+#define TRACE_T0_US (0x100000000ull - 3600000000ull)
+
+static uint32_t now_ms;
+static uint32_t next_tick_ms;
+static uint32_t saves;
+static uint64_t dispatched;
+static uint64_t violations;
+static uint32_t rng_state;
+
+HAL_StatusTypeDef APP_Save_CFG_Flash(void)
+{
+  saves++;
+  return HAL_OK;
+}
+
+static uint32_t rng(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static uint32_t rng_range(const uint32_t lo, const uint32_t hi)
+{
+  return lo + rng() % (hi - lo + 1u);
+}
+
+/**
+ * @brief Machine_Dispatch() из main.c: обработка, запись в трассу и проверка выхода клапана.
+ */
+static void dispatch(const MachineEvent_t event)
+{
+  Machine_Process(&machine, event);
+
+  const MachineTrace_Violation_t result = Machine_Trace_Record(TRACE_T0_US + (uint64_t)now_ms * 1000u, event,
+                                                                &machine, &seg7_handle);
+  if (result != TRACE_OK)
+  {
+    violations++;
+    fprintf(stderr, "t=%u ms event %d: violation %d (state %d, valve %d)\n",
+            now_ms, (int)event, (int)result, (int)machine.machine_state, (int)machine.valve_state);
+  }
+
+  /// Клапан открыт низким уровнем PB12
+  const uint32_t pin_high = (VALVE_GPIO_Port->ODR & VALVE_Pin) ? 1u : 0u;
+  CHECK_EQ(pin_high, (machine.valve_state == OPEN) ? 0u : 1u);
+  dispatched++;
+}
+
+/**
+ * @brief Одна миллисекунда: опрос кнопки (SysTick) и секундный тик (основной цикл).
+ */
+static void step_1ms(void)
+{
+  now_ms++;
+  const MachineEvent_t button_event = Button_Poll_1ms();
+  if (button_event != EVENT_NONE)
+  {
+    dispatch(button_event);
+  }
+  if ((int32_t)(now_ms - next_tick_ms) >= 0)
+  {
+    next_tick_ms += 1000u;
+    dispatch(EVENT_TICK_1S);
+  }
+}
+
+static void button_level(const uint32_t pressed)
+{
+  if (pressed)
+  {
+    K1_GPIO_Port->IDR |= K1_Pin;
+  }
+  else
+  {
+    K1_GPIO_Port->IDR &= ~(uint32_t)K1_Pin;
+  }
+}
+
+static void hold(const uint32_t pressed, const uint32_t ms)
+{
+  button_level(pressed);
+  for (uint32_t i = 0; i < ms; i++)
+  {
+    step_1ms();
+  }
+}
+
+/**
+ * @brief Нажатие с дребезгом на обоих фронтах.
+ */
+static void press(const uint32_t hold_ms)
+{
+  for (uint32_t i = rng_range(0, 4); i > 0; i--)
+  {
+    hold(1, rng_range(1, 3));
+    hold(0, rng_range(1, 3));
+  }
+  hold(1, hold_ms);
+  for (uint32_t i = rng_range(0, 4); i > 0; i--)
+  {
+    hold(0, rng_range(1, 3));
+    hold(1, rng_range(1, 3));
+  }
+  hold(0, BTN_DEBOUNCE_MS + 2u);
+}
+
+static void machine_reset(void)
+{
+  memset(&machine, 0, sizeof(machine));
+  machine.machine_state = STATE_READY;
+  machine.cfg_sec       = DEFAULT_TIME;
+  VALVE_GPIO_Port->ODR |= VALVE_Pin;   /// MX_GPIO_Init: клапан закрыт
+  Button_Init(K1_GPIO_Port, K1_Pin, HIGH);
+}
+
+/**
+ * @brief Снимок кольцевого буфера должен пройти ту же проверку вне автомата.
+ */
+static MachineTrace_Record_t snapshot[MACHINE_TRACE_DEPTH];
+
+static void check_snapshot(void)
+{
+  const uint32_t count = Machine_Trace_Snapshot(snapshot, MACHINE_TRACE_DEPTH);
+  uint32_t bad = 0;
+  CHECK_EQ(Machine_Trace_Check(snapshot, count, &bad), TRACE_OK);
+}
+
+/** -- Записанные сценарии: ожидаемые состояния после известных нажатий -- */
+
+static void test_recorded(void)
+{
+  /// Короткое нажатие: отсчёт cfg_sec, клапан закрывается сам
+  press(200);
+  CHECK_EQ(machine.machine_state, STATE_COUNTDOWN);
+  CHECK_EQ(machine.valve_state, OPEN);
+  for (uint32_t i = 0; i < DEFAULT_TIME * 1000u + 1000u; i++)
+  {
+    step_1ms();
+  }
+  CHECK_EQ(machine.valve_state, CLOSED);
+  CHECK_EQ(machine.machine_state, STATE_READY);
+
+  /// Долгое нажатие - CONFIG, шаг значения, долгое - сохранение
+  press(1300);
+  CHECK_EQ(machine.machine_state, STATE_CONFIG);
+  press(100);
+  CHECK_EQ(machine.cur_sec, DEFAULT_TIME + 1u);
+  const uint32_t saves_before = saves;
+  press(1300);
+  CHECK_EQ(machine.machine_state, STATE_READY);
+  CHECK_EQ(machine.cfg_sec, DEFAULT_TIME + 1u);
+  CHECK_EQ(saves, saves_before + 1u);
+
+  /// Остановка кнопкой посреди отсчёта
+  press(150);
+  hold(0, 1500);
+  CHECK_EQ(machine.valve_state, OPEN);
+  press(150);
+  CHECK_EQ(machine.valve_state, CLOSED);
+  CHECK_EQ(machine.machine_state, STATE_READY);
+
+  /// Перегрев: запуск запрещён, на индикаторе "Hot"
+  dispatch(EVENT_OVER_TEMP);
+  press(150);
+  CHECK_EQ(machine.machine_state, STATE_READY);
+  CHECK_EQ(machine.valve_state, CLOSED);
+  dispatch(EVENT_TEMP_OK);
+
+  check_snapshot();
+}
+
+/** -- Случайные нажатия на уровне GPIO -- */
+
+static void test_random_buttons(const uint32_t sequences)
+{
+  for (uint32_t s = 0; s < sequences; s++)
+  {
+    switch (rng() % 8u)
+    {
+      case 0:
+      case 1:
+      case 2:
+        press(rng_range(30, 900));     /// Короткое
+        break;
+      case 3:
+        press(rng_range(1000, 2500));  /// Долгое
+        break;
+      case 4:
+        hold(0, rng_range(1, 5000));   /// Пауза
+        break;
+      case 5:
+        hold(1, rng_range(1, BTN_DEBOUNCE_MS - 1u));   /// Помеха короче антидребезга
+        hold(0, BTN_DEBOUNCE_MS + 1u);
+        break;
+      case 6:
+        dispatch((rng() & 1u) ? EVENT_OVER_TEMP : EVENT_TEMP_OK);
+        break;
+      default:
+        dispatch(EVENT_SCHEDULE);
+        break;
+    }
+    if ((s & 63u) == 0u)
+    {
+      check_snapshot();
+    }
+  }
+}
+
+/**
+ * @brief Случайные события без кнопки: время идёт шагами до секунды, тик - каждую секунду.
+ */
+static void test_random_events(const uint64_t events)
+{
+  static const MachineEvent_t pool[] = {
+    EVENT_BTN_SHRT_PRESS, EVENT_BTN_SHRT_PRESS, EVENT_BTN_LONG_PRESS, EVENT_OVER_TEMP,
+    EVENT_TEMP_OK, EVENT_TEMP_OK, EVENT_RH_REACHED, EVENT_SCHEDULE, EVENT_NONE
+  };
+  const uint64_t target = dispatched + events;
+
+  while (dispatched < target)
+  {
+    now_ms += rng_range(0, 400);
+    if ((int32_t)(now_ms - next_tick_ms) >= 0)
+    {
+      next_tick_ms += 1000u;
+      dispatch(EVENT_TICK_1S);
+    }
+    dispatch(pool[rng() % (sizeof(pool) / sizeof(pool[0]))]);
+    if ((dispatched & 0xFFFFu) == 0u)
+    {
+      check_snapshot();
+    }
+  }
+}
+
+/** -- Проверка не пустая: испорченные трассы отвергаются -- */
+
+static void test_checker_rejects(void)
+{
+  /// В READY - событиями, а не сбросом: трасса продолжается
+  dispatch(EVENT_TEMP_OK);
+  while (machine.machine_state != STATE_READY)
+  {
+    dispatch((machine.machine_state == STATE_CONFIG) ? EVENT_BTN_LONG_PRESS : EVENT_BTN_SHRT_PRESS);
+  }
+  press(100);                                   /// Отсчёт: клапан открыт
+  for (uint32_t i = 0; i < 1500u; i++)
+  {
+    step_1ms();
+  }
+
+  const uint32_t count = Machine_Trace_Snapshot(snapshot, MACHINE_TRACE_DEPTH);
+  uint32_t open_index = count;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    if (snapshot[i].valve == OPEN)
+    {
+      open_index = i;
+      break;
+    }
+  }
+  CHECK(open_index + 1u < count);
+  if (open_index + 1u >= count)
+  {
+    return;
+  }
+
+  MachineTrace_Record_t bad[MACHINE_TRACE_DEPTH];
+  uint32_t bad_index = 0;
+
+  memcpy(bad, snapshot, sizeof(bad));
+  bad[open_index].state = STATE_READY;           /// Клапан открыт в READY
+  CHECK_EQ(Machine_Trace_Check(bad, count, &bad_index), TRACE_VALVE_STATE);
+  CHECK_EQ(bad_index, open_index);
+
+  memcpy(bad, snapshot, sizeof(bad));
+  bad[open_index + 1u].valve = OPEN;             /// Клапан не закрылся через cfg_sec + 1 с
+  bad[open_index + 1u].state = STATE_COUNTDOWN;
+  bad[open_index + 1u].t_us  = bad[open_index].t_us + bad[open_index].cfg_sec * 1000000u +
+                               MACHINE_TRACE_OPEN_SLACK + 1u;
+  for (uint32_t i = open_index + 2u; i < count; i++)
+  {
+    bad[i].t_us = bad[open_index + 1u].t_us;
+  }
+  CHECK_EQ(Machine_Trace_Check(bad, count, &bad_index), TRACE_VALVE_TIMEOUT);
+
+  memcpy(bad, snapshot, sizeof(bad));
+  bad[open_index + 1u].t_us = bad[open_index].t_us - 1u;   /// Время назад
+  CHECK_EQ(Machine_Trace_Check(bad, count, &bad_index), TRACE_TIME_ORDER);
+
+  memcpy(bad, snapshot, sizeof(bad));
+  bad[open_index].state     = STATE_CONFIG;     /// Из CONFIG прямо в COUNTDOWN
+  bad[open_index].valve     = CLOSED;
+  bad[open_index + 1u].state = STATE_COUNTDOWN;
+  CHECK_EQ(Machine_Trace_Check(bad, count, &bad_index), TRACE_CONFIG_EXIT);
+}
+
+int main(int argc, char **argv)
+{
+  const uint64_t events = (argc > 1) ? strtoull(argv[1], NULL, 0) : 2000000u;
+  rng_state = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 0x7A55u;
+
+  GPIO_TypeDef *digit_ports[NUMBER_OF_DIG] = { Q1_GPIO_Port, Q2_GPIO_Port, Q3_GPIO_Port };
+  const uint16_t digit_pins[NUMBER_OF_DIG] = { Q1_Pin, Q2_Pin, Q3_Pin };
+  Seg7_Init(&seg7_handle, digit_ports, digit_pins, A_GPIO_Port, 0x00FFu);
+
+  next_tick_ms = 1000u;
+  machine_reset();
+
+  test_recorded();
+  test_random_buttons(20000u);
+  test_random_events(events);
+  CHECK_EQ(violations, 0u);
+  printf("dispatched %llu events, %u saves\n", (unsigned long long)dispatched, saves);
+
+  test_checker_rejects();
+
+  return HOST_TEST_RESULT("test_machine_trace");
+}
@@ -0,0 +1,423 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * Modbus RTU slave на ПК за pty: ModbusRtu.c собран как для МК, без изменений, а
+ * тест моделирует USART6 и DMA2 на отображённых регистрах (host_periph.h):
+ *
+ *   - приём: байты с ведущей стороны pty пишутся в кольцо по M0AR Stream1, NDTR
+ *     убывает, как у DMA; конец пачки байт - флаг IDLE и Modbus_IRQHandler();
+ *   - передача: включённый Stream6 - NDTR байт с M0AR уходят в pty, затем TC и
+ *     Modbus_IRQHandler(); DE (PA8) поднят на время ответа.
+ *
+ * Ведомая сторона pty - клиент шины: функции 03/04/06/10, ответы-исключения,
+ * отброс кадров с неверным CRC, чужого адреса и склеенных кадров, широковещательная
+ * запись без ответа, кадры через конец кольца DMA, потеря кадра при полной очереди.
+ */
+
+#include <string.h>
+#include "host_periph.h"
+#include "host_pty.h"
+#include "host_test.h"
+#include "ModbusRtu.h"
+#include "AppFlashConfig.h"
+
+#define RESP_MAX (MODBUS_ADU_MAX)
+
+static int                    term_fd;      /// Клиент шины
+static int                    device_fd;    /// USART6 (модель)
+static MachineState_Context_t ctx;
+static uint32_t               saves;        /// Вызовов записи конфигурации
+static uint32_t               de_errors;    /// DE не поднят на время ответа или не снят после
+
+AppFlashConfig_t GlobalAppConfig;
+
+HAL_StatusTypeDef APP_Save_CFG_Flash(void)
+{
+  CHECK(!(DMA2_Stream6->CR & DMA_SxCR_EN));   /// Только после ухода ответа
+  saves++;
+  return HAL_OK;
+}
+
+/** -- Модель USART6 + DMA2 Stream1/Stream6 -- */
+
+/**
+ * @brief Принятые байты - в кольцо DMA; конец пачки - IDLE.
+ * @retval Сколько байт принято.
+ */
+static uint32_t bus_receive(void)
+{
+  uint8_t        bytes[MODBUS_RX_RING];
+  const uint32_t got = host_pty_receive(device_fd, bytes, sizeof(bytes));
+
+  for (uint32_t i = 0; i < got; i++)
+  {
+    uint8_t *ring = (uint8_t *)(uintptr_t)DMA2_Stream1->M0AR;
+    ring[MODBUS_RX_RING - DMA2_Stream1->NDTR] = bytes[i];
+    DMA2_Stream1->NDTR = (DMA2_Stream1->NDTR == 1u) ? MODBUS_RX_RING : DMA2_Stream1->NDTR - 1u;
+  }
+  if (got != 0u)
+  {
+    USART6->SR |= USART_SR_IDLE;
+    Modbus_IRQHandler();
+    USART6->SR &= ~USART_SR_IDLE;
+  }
+  return got;
+}
+
+/**
+ * @brief Отдать ответ из включённого Stream6, затем прерывание TC.
+ */
+static void bus_transmit(void)
+{
+  if (!(DMA2_Stream6->CR & DMA_SxCR_EN))
+  {
+    return;
+  }
+  de_errors += (GPIOA->BSRR != MODBUS_DE_PIN);
+  const uint8_t *frame = (const uint8_t *)(uintptr_t)DMA2_Stream6->M0AR;
+  CHECK_EQ(host_pty_send(device_fd, term_fd, frame, DMA2_Stream6->NDTR), DMA2_Stream6->NDTR);
+  DMA2_Stream6->NDTR = 0;
+  DMA2_Stream6->CR  &= ~DMA_SxCR_EN;
+
+  USART6->SR |= USART_SR_TC;
+  Modbus_IRQHandler();
+  de_errors += (GPIOA->BSRR != (uint32_t)MODBUS_DE_PIN << 16);
+  CHECK(!(USART6->CR1 & USART_CR1_TCIE));
+}
+
+/** Проход суперцикла с шиной */
+static void bus_step(void)
+{
+  bus_receive();
+  Modbus_Poll();
+  bus_transmit();
+  Modbus_Poll();   /// Запись во Flash - после ответа
+}
+
+/** -- Клиент -- */
+
+/**
+ * @brief Запрос с CRC и ответ: до кадра с верным CRC или 20 мс тишины.
+ * @retval Длина ответа; 0 - ответа нет.
+ */
+static uint32_t transact_raw(const uint8_t *request, const uint32_t length, uint8_t *response)
+{
+  uint32_t total = 0;
+  uint32_t quiet = 0;
+
+  CHECK(host_pty_send(term_fd, device_fd, request, length) >= length);
+  while (quiet < 20u && total < RESP_MAX)
+  {
+    bus_step();
+    const uint32_t got = host_pty_receive(term_fd, &response[total], RESP_MAX - total);
+    total += got;
+    if (got == 0u)
+    {
+      host_pty_wait(term_fd, 1);
+      quiet++;
+    }
+    else if (total >= 5u &&
+             Modbus_Crc16(response, total - 2u) == (uint16_t)(response[total - 2u] | (response[total - 1u] << 8)))
+    {
+      break;   /// Кадр ответа целиком
+    }
+    else
+    {
+      quiet = 0;
+    }
+  }
+  if (total != 0u)
+  {
+    CHECK(total >= 4u);
+    CHECK_EQ(Modbus_Crc16(response, total - 2u), (uint16_t)(response[total - 2u] | (response[total - 1u] << 8)));
+  }
+  return total;
+}
+
+static uint32_t transact(const uint8_t *pdu, const uint32_t pdu_length, uint8_t *response)
+{
+  uint8_t frame[MODBUS_ADU_MAX];
+
+  memcpy(frame, pdu, pdu_length);
+  const uint16_t crc = Modbus_Crc16(frame, pdu_length);
+  frame[pdu_length]      = (uint8_t)crc;
+  frame[pdu_length + 1u] = (uint8_t)(crc >> 8);
+  return transact_raw(frame, pdu_length + 2u, response);
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+  return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+/**
+ * @brief Ответ-исключение: function | 0x80 и код.
+ */
+static void check_exception(const uint8_t *pdu, const uint32_t length, const uint8_t code, const int line)
+{
+  uint8_t        response[RESP_MAX];
+  const uint32_t got = transact(pdu, length, response);
+
+  if (got != 5u || response[1] != (pdu[1] | 0x80u) || response[2] != code)
+  {
+    fprintf(stderr, "line %d: function 0x%02X: %u bytes, 0x%02X 0x%02X\n", line, pdu[1], got,
+            response[1], response[2]);
+  }
+  CHECK_EQ(got, 5u);
+  CHECK_EQ(response[0], MODBUS_SLAVE_ADDR);
+  CHECK_EQ(response[1], pdu[1] | 0x80u);
+  CHECK_EQ(response[2], code);
+}
+
+static uint16_t read_input(const uint16_t reg)
+{
+  uint8_t       response[RESP_MAX];
+  const uint8_t pdu[] = { MODBUS_SLAVE_ADDR, 0x04, 0, (uint8_t)reg, 0, 1 };
+  CHECK_EQ(transact(pdu, sizeof(pdu), response), 7u);
+  return get16(&response[3]);
+}
+
+/** -- Функции -- */
+
+static void test_read(void)
+{
+  uint8_t response[RESP_MAX];
+
+  /// 0x03: cfg_sec
+  const uint8_t fc03[] = { MODBUS_SLAVE_ADDR, 0x03, 0, 0, 0, 1 };
+  CHECK_EQ(transact(fc03, sizeof(fc03), response), 7u);
+  CHECK_EQ(response[1], 0x03u);
+  CHECK_EQ(response[2], 2u);
+  CHECK_EQ(get16(&response[3]), ctx.cfg_sec);
+
+  /// 0x04: все input-регистры - поля контекста и счётчики шины
+  const ModbusRtu_Stats_t before = *Modbus_Get_Stats();
+  const uint8_t fc04[] = { MODBUS_SLAVE_ADDR, 0x04, 0, 0, 0, 11 };
+  CHECK_EQ(transact(fc04, sizeof(fc04), response), 3u + 22u + 2u);
+  CHECK_EQ(response[2], 22u);
+  CHECK_EQ(get16(&response[3]),  STATE_COUNTDOWN);
+  CHECK_EQ(get16(&response[5]),  OPEN);
+  CHECK_EQ(get16(&response[7]),  2u);
+  CHECK_EQ(get16(&response[9]),  0u);
+  CHECK_EQ(get16(&response[11]), 1u);
+  CHECK_EQ(get16(&response[13]), (uint16_t)(int16_t)-15);   /// Знаковое - в дополнительном коде
+  CHECK_EQ(get16(&response[15]), 1234u);
+  CHECK_EQ(get16(&response[17]), before.frames + 1u);      /// Сам этот запрос уже посчитан
+  CHECK_EQ(get16(&response[19]), before.crc_errors);
+  CHECK_EQ(get16(&response[21]), before.exceptions);
+  CHECK_EQ(get16(&response[23]), before.overruns);
+}
+
+static void test_write(void)
+{
+  uint8_t response[RESP_MAX];
+
+  /// 0x06: эхо, поле контекста и копия в конфигурации, запись во Flash после ответа
+  const uint8_t fc06[] = { MODBUS_SLAVE_ADDR, 0x06, 0, 0, 0, 5 };
+  CHECK_EQ(transact(fc06, sizeof(fc06), response), 8u);
+  CHECK(memcmp(response, fc06, sizeof(fc06)) == 0);
+  CHECK_EQ(ctx.cfg_sec, 5u);
+  CHECK_EQ(GlobalAppConfig.cfg_sec, 5u);
+  CHECK_EQ(saves, 1u);
+
+  /// То же значение - записи во Flash нет
+  CHECK_EQ(transact(fc06, sizeof(fc06), response), 8u);
+  CHECK_EQ(saves, 1u);
+
+  /// 0x10: адрес и количество в ответе
+  const uint8_t fc10[] = { MODBUS_SLAVE_ADDR, 0x10, 0, 0, 0, 1, 2, 0, 4 };
+  CHECK_EQ(transact(fc10, sizeof(fc10), response), 8u);
+  CHECK(memcmp(response, fc10, 6u) == 0);
+  CHECK_EQ(ctx.cfg_sec, 4u);
+  CHECK_EQ(saves, 2u);
+
+  /// Широковещательная запись: выполняется, ответа нет
+  const uint8_t broadcast[] = { 0, 0x06, 0, 0, 0, 6 };
+  CHECK_EQ(transact(broadcast, sizeof(broadcast), response), 0u);
+  CHECK_EQ(ctx.cfg_sec, 6u);
+  CHECK_EQ(saves, 3u);
+}
+
+static void test_exceptions(void)
+{
+  const uint16_t exceptions = Modbus_Get_Stats()->exceptions;
+
+  const uint8_t bad_function[] = { MODBUS_SLAVE_ADDR, 0x05, 0, 0, 0xFF, 0 };
+  check_exception(bad_function, sizeof(bad_function), MODBUS_EX_ILLEGAL_FUNCTION, __LINE__);
+
+  const uint8_t bad_holding[] = { MODBUS_SLAVE_ADDR, 0x03, 0, 1, 0, 1 };
+  check_exception(bad_holding, sizeof(bad_holding), MODBUS_EX_ILLEGAL_ADDRESS, __LINE__);
+
+  const uint8_t past_input[] = { MODBUS_SLAVE_ADDR, 0x04, 0, 10, 0, 2 };
+  check_exception(past_input, sizeof(past_input), MODBUS_EX_ILLEGAL_ADDRESS, __LINE__);
+
+  const uint8_t zero_count[] = { MODBUS_SLAVE_ADDR, 0x04, 0, 0, 0, 0 };
+  check_exception(zero_count, sizeof(zero_count), MODBUS_EX_ILLEGAL_VALUE, __LINE__);
+
+  const uint8_t big_count[] = { MODBUS_SLAVE_ADDR, 0x03, 0, 0, 0, MODBUS_READ_MAX + 1u };
+  check_exception(big_count, sizeof(big_count), MODBUS_EX_ILLEGAL_VALUE, __LINE__);
+
+  const uint8_t out_of_range[] = { MODBUS_SLAVE_ADDR, 0x06, 0, 0, 0, APP_CFG_SEC_MAX + 1u };
+  check_exception(out_of_range, sizeof(out_of_range), MODBUS_EX_ILLEGAL_VALUE, __LINE__);
+
+  const uint8_t bad_holding_06[] = { MODBUS_SLAVE_ADDR, 0x06, 0, 1, 0, 4 };
+  check_exception(bad_holding_06, sizeof(bad_holding_06), MODBUS_EX_ILLEGAL_ADDRESS, __LINE__);
+
+  const uint8_t byte_count[] = { MODBUS_SLAVE_ADDR, 0x10, 0, 0, 0, 1, 4, 0, 4, 0, 4 };
+  check_exception(byte_count, sizeof(byte_count), MODBUS_EX_ILLEGAL_VALUE, __LINE__);
+
+  const uint8_t short_06[] = { MODBUS_SLAVE_ADDR, 0x06, 0, 0, 4 };
+  check_exception(short_06, sizeof(short_06), MODBUS_EX_ILLEGAL_VALUE, __LINE__);
+
+  /// Не в READY - занято, значение не меняется
+  const uint8_t value = ctx.cfg_sec;
+  ctx.machine_state = STATE_CONFIG;
+  const uint8_t busy[] = { MODBUS_SLAVE_ADDR, 0x06, 0, 0, 0, 3 };
+  check_exception(busy, sizeof(busy), MODBUS_EX_DEVICE_BUSY, __LINE__);
+  CHECK_EQ(ctx.cfg_sec, value);
+  ctx.machine_state = STATE_READY;
+
+  CHECK_EQ(Modbus_Get_Stats()->exceptions, exceptions + 10u);
+  CHECK_EQ(read_input(9), exceptions + 10u);
+}
+
+/**
+ * @brief Кадры без ответа: неверный CRC, короткий, чужой адрес, два кадра без паузы.
+ */
+static void test_rejected(void)
+{
+  uint8_t        response[RESP_MAX];
+  const uint16_t crc_errors = Modbus_Get_Stats()->crc_errors;
+  const uint16_t frames     = Modbus_Get_Stats()->frames;
+
+  uint8_t frame[8] = { MODBUS_SLAVE_ADDR, 0x06, 0, 0, 0, 3 };
+  const uint16_t crc = Modbus_Crc16(frame, 6u);
+  frame[6] = (uint8_t)crc;
+  frame[7] = (uint8_t)(crc >> 8);
+
+  for (uint32_t bit = 0; bit < 64u; bit++)   /// Любой искажённый бит кадра
+  {
+    uint8_t corrupt[8];
+    memcpy(corrupt, frame, sizeof(corrupt));
+    corrupt[bit / 8u] ^= (uint8_t)(1u << (bit % 8u));
+    CHECK_EQ(transact_raw(corrupt, sizeof(corrupt), response), 0u);
+  }
+  CHECK_EQ(transact_raw(frame, 3u, response), 0u);
+  CHECK(ctx.cfg_sec != 3u);
+
+  const uint8_t other[] = { MODBUS_SLAVE_ADDR + 1u, 0x03, 0, 0, 0, 1 };
+  CHECK_EQ(transact(other, sizeof(other), response), 0u);
+
+  uint8_t glued[16];
+  memcpy(glued, frame, 8u);
+  memcpy(&glued[8], frame, 8u);
+  CHECK_EQ(transact_raw(glued, sizeof(glued), response), 0u);
+
+  CHECK_EQ(Modbus_Get_Stats()->crc_errors, crc_errors + 64u + 1u + 1u);
+  CHECK_EQ(Modbus_Get_Stats()->frames, frames);
+  CHECK(ctx.cfg_sec != 3u);
+  CHECK_EQ(read_input(8), crc_errors + 66u);
+
+  /// Целый кадр после всего этого - как обычно
+  CHECK_EQ(transact_raw(frame, sizeof(frame), response), 8u);
+  CHECK_EQ(ctx.cfg_sec, 3u);
+}
+
+/**
+ * @brief Кадры разной длины через конец кольца DMA (512 байт) много раз.
+ */
+static void test_ring_wrap(void)
+{
+  uint8_t response[RESP_MAX];
+  uint8_t pdu[7u + 2u * 4u] = { MODBUS_SLAVE_ADDR, 0x10, 0, 0, 0, 1, 2, 0, 0 };
+
+  for (uint32_t i = 0; i < 300u; i++)
+  {
+    if (i % 2u)
+    {
+      pdu[8] = (uint8_t)(APP_CFG_SEC_MIN + i % (APP_CFG_SEC_MAX - APP_CFG_SEC_MIN + 1u));
+      CHECK_EQ(transact(pdu, 9u, response), 8u);
+      CHECK_EQ(ctx.cfg_sec, pdu[8]);
+    }
+    else
+    {
+      const uint8_t fc03[] = { MODBUS_SLAVE_ADDR, 0x03, 0, 0, 0, 1 };
+      CHECK_EQ(transact(fc03, sizeof(fc03), response), 7u);
+      CHECK_EQ(get16(&response[3]), ctx.cfg_sec);
+    }
+  }
+  CHECK(DMA2_Stream1->NDTR != MODBUS_RX_RING);
+}
+
+/**
+ * @brief Суперцикл занят: очередь концов кадров MODBUS_FRAME_QUEUE, лишний кадр - overruns.
+ */
+static void test_overrun(void)
+{
+  const uint8_t  fc03[]   = { MODBUS_SLAVE_ADDR, 0x03, 0, 0, 0, 1 };
+  const uint16_t overruns = Modbus_Get_Stats()->overruns;
+  uint8_t        frame[8];
+
+  memcpy(frame, fc03, sizeof(fc03));
+  const uint16_t crc = Modbus_Crc16(frame, 6u);
+  frame[6] = (uint8_t)crc;
+  frame[7] = (uint8_t)(crc >> 8);
+
+  for (uint32_t i = 0; i < MODBUS_FRAME_QUEUE + 1u; i++)
+  {
+    CHECK(host_pty_send(term_fd, device_fd, frame, sizeof(frame)) >= sizeof(frame));
+    CHECK_EQ(bus_receive(), sizeof(frame));   /// Только приём: Modbus_Poll() не вызывается
+  }
+  CHECK_EQ(Modbus_Get_Stats()->overruns, overruns + 1u);
+
+  /// Очередь разбирается по одному ответу: следующий кадр - после TC
+  uint8_t  response[RESP_MAX];
+  uint32_t answered = 0;
+  for (uint32_t spin = 0; spin < 100u; spin++)
+  {
+    bus_step();
+    answered += host_pty_receive(term_fd, response, sizeof(response));
+    host_pty_wait(term_fd, 1);
+  }
+  CHECK_EQ(answered, MODBUS_FRAME_QUEUE * 7u);
+
+  /// Байты потерянного кадра остались в кольце: следующий кадр склеивается с ними и
+  /// отбрасывается по CRC (мастер повторит запрос), дальше - как обычно
+  const uint16_t crc_errors = Modbus_Get_Stats()->crc_errors;
+  CHECK_EQ(transact_raw(frame, sizeof(frame), response), 0u);
+  CHECK_EQ(Modbus_Get_Stats()->crc_errors, crc_errors + 1u);
+  CHECK_EQ(transact_raw(frame, sizeof(frame), response), 7u);
+}
+
+int main(void)
+{
+  term_fd = host_pty_open(&device_fd);
+  CHECK(term_fd >= 0);
+
+  ctx.machine_state = STATE_COUNTDOWN;
+  ctx.valve_state   = OPEN;
+  ctx.cfg_sec       = 3u;
+  ctx.cur_sec       = 2u;
+  ctx.over_temp     = 1u;
+  ctx.rh_dpct       = -15;
+  ctx.valve_opens   = 1234u;
+  Modbus_Init(&ctx);
+
+  CHECK_EQ(USART6->BRR, (HAL_RCC_GetPCLK2Freq() + MODBUS_BAUD / 2u) / MODBUS_BAUD);
+  CHECK(USART6->CR1 & USART_CR1_IDLEIE);
+  CHECK_EQ(DMA2_Stream1->NDTR, MODBUS_RX_RING);
+
+  test_read();
+  ctx.machine_state = STATE_READY;
+  ctx.valve_state   = CLOSED;
+  test_write();
+  test_exceptions();
+  test_rejected();
+  test_ring_wrap();
+  test_overrun();
+
+  CHECK_EQ(de_errors, 0u);
+  return HOST_TEST_RESULT("test_modbus");
+}
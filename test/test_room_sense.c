@@ -0,0 +1,336 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * Сбор температуры и влажности (RoomSense.c и CMSIS-DSP: arm_fir_decimate_q15,
+ * arm_mean_q15, как в прошивке) на синтетических сигналах. Тест - это ADC1 и
+ * DMA2 Stream4: кадры {T, RH} пишутся в буфер, который указывает CT (M0AR/M1AR),
+ * затем CT переключается, ставится TCIF4 и вызывается Room_Sense_DMA_IRQHandler();
+ * суперцикл - Room_Sense_Poll() раз в блок.
+ *
+ * Отсчёты считаются по физике датчиков, а не по таблицам прошивки: делитель с NTC
+ * B3950 и HIH-5030 (0.1515 + 0.00636 * RH), плюс шум и помеха 150 Гц.
+ *   - калибровка: от -10 до +120 °C и от 0 до 100 % - ошибка LUT и фильтра в пределах
+ *     TEMP_TOL / RH_TOL, за краями таблицы - крайние значения; Room_Sense_Lut() на
+ *     своей таблице - узлы, середины отрезков, края;
+ *   - события: разогрев через ROOM_SENSE_TEMP_LIMIT - один EVENT_OVER_TEMP, остывание
+ *     на гистерезис - EVENT_TEMP_OK; влажность до цели - один EVENT_RH_REACHED, провал
+ *     меньше гистерезиса не взводит его снова, больше - взводит;
+ *   - буферы: обработан тот, что DMA только что заполнил; суперцикл опоздал на блок -
+ *     последним обработан новый; нет блоков дольше 500 мс - EVENT_OVER_TEMP;
+ *     Room_Sense_Pause()/Room_Sense_Resume() - запись снова с буфера 0.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "host_test.h"
+#include "host_periph.h"
+#include "RoomSense.h"
+
+#define TEMP_TOL      (1.0)    /// °C: ошибка кусочно-линейной таблицы NTC + шум
+#define RH_TOL        (0.5)    /// %
+#define NOISE_CODES   (12u)    /// Размах шума АЦП, отсчётов
+#define HUM_CODES     (20.0)   /// Амплитуда помехи 150 Гц, отсчётов
+#define BLOCK_MS      (ROOM_SENSE_BLOCK * 1000u / ROOM_SENSE_RATE_HZ)
+
+static uint32_t rng_state = 0xADC1u;
+static uint32_t sample_n;      /// Номер отсчёта с начала - фаза помехи
+
+static uint32_t rng(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+/** NTC 10 кОм B3950 к +3.3 В, 10 кОм к земле: отсчёт 12 бит */
+static double ntc_code(const double temp_c)
+{
+  const double r_ntc = 10000.0 * exp(3950.0 * (1.0 / (temp_c + 273.15) - 1.0 / 298.15));
+  return 4095.0 * 10000.0 / (r_ntc + 10000.0);
+}
+
+/** HIH-5030 от того же питания: отсчёт 12 бит */
+static double rh_code(const double rh_pct)
+{
+  return 4095.0 * (0.1515 + 0.00636 * rh_pct);
+}
+
+static uint16_t adc(const double code)
+{
+  const double hum   = HUM_CODES * sin(2.0 * M_PI * 150.0 * (double)sample_n / (double)ROOM_SENSE_RATE_HZ);
+  const double noisy = code + hum + (double)(rng() % (NOISE_CODES + 1u)) - (double)NOISE_CODES / 2.0;
+  return (uint16_t)((noisy < 0.0) ? 0.0 : ((noisy > 4095.0) ? 4095.0 : noisy + 0.5));
+}
+
+/**
+ * @brief Один блок DMA: температура и влажность линейно от (t0, rh0) до (t1, rh1), затем TC.
+ */
+static void dma_block(const double t0, const double t1, const double rh0, const double rh1)
+{
+  const uint8_t ct     = (DMA2_Stream4->CR & DMA_SxCR_CT) ? 1u : 0u;
+  uint16_t     *buffer = (uint16_t *)(uintptr_t)(ct ? DMA2_Stream4->M1AR : DMA2_Stream4->M0AR);
+
+  CHECK(DMA2_Stream4->CR & DMA_SxCR_EN);
+  CHECK_EQ(DMA2_Stream4->NDTR, ROOM_SENSE_BLOCK * ROOM_SENSE_CHANNELS);
+  for (uint32_t i = 0; i < ROOM_SENSE_BLOCK; i++, sample_n++)
+  {
+    const double k = (double)i / (double)ROOM_SENSE_BLOCK;
+    buffer[i * ROOM_SENSE_CHANNELS + 0u] = adc(ntc_code(t0 + (t1 - t0) * k));
+    buffer[i * ROOM_SENSE_CHANNELS + 1u] = adc(rh_code(rh0 + (rh1 - rh0) * k));
+  }
+
+  /// Конец буфера: DMA переходит на другой (CT) и ставит TCIF4
+  DMA2_Stream4->CR ^= DMA_SxCR_CT;
+  DMA2->HISR       |= DMA_HISR_TCIF4;
+  Room_Sense_DMA_IRQHandler();
+  DMA2->HISR        = 0;   /// В памяти запись HIFCR флаги не снимает
+  host_tick_advance(BLOCK_MS);
+}
+
+/** Блок постоянного уровня и суперцикл */
+static MachineEvent_t step(const double temp_c, const double rh_pct)
+{
+  dma_block(temp_c, temp_c, rh_pct, rh_pct);
+  return Room_Sense_Poll();
+}
+
+static double temp_read(void)
+{
+  return (double)Room_Sense_Get()->temp_dc / 10.0;
+}
+
+static double rh_read(void)
+{
+  return (double)Room_Sense_Get()->rh_dpct / 10.0;
+}
+
+static void start(void)
+{
+  host_periph_reset();
+  Room_Sense_Init();
+  CHECK_EQ(DMA2_Stream4->M0AR != DMA2_Stream4->M1AR, 1u);
+  CHECK_EQ(DMA2_Stream4->PAR, (uint32_t)(uintptr_t)&ADC1->DR);
+  CHECK_EQ(DMA2_Stream4->CR & (DMA_SxCR_DBM | DMA_SxCR_CT), DMA_SxCR_DBM);
+  CHECK_EQ(ADC1->SQR3, (0u << ADC_SQR3_SQ1_Pos) | (1u << ADC_SQR3_SQ2_Pos));   /// Кадр {T, RH}
+  CHECK_EQ(TIM2->CR1 & TIM_CR1_CEN, TIM_CR1_CEN);
+  CHECK_EQ((TIM2->PSC + 1u) * (TIM2->ARR + 1u), HAL_RCC_GetPCLK1Freq() * 2u / ROOM_SENSE_RATE_HZ);
+  CHECK_EQ(Room_Sense_Poll(), EVENT_NONE);   /// Блоков ещё не было: событий нет
+}
+
+/** -- Калибровка -- */
+
+static void test_lut(void)
+{
+  static const q15_t   x[] = { 1000, 2000, 6000 };
+  static const int16_t y[] = {  -50,  150,  110 };   /// Участок роста и участок спада
+  const RoomSense_Lut_t lut = { x, y, 3u };
+
+  CHECK_EQ(Room_Sense_Lut(&lut, -32768), -50);
+  CHECK_EQ(Room_Sense_Lut(&lut, 1000), -50);
+  CHECK_EQ(Room_Sense_Lut(&lut, 1500), 50u);
+  CHECK_EQ(Room_Sense_Lut(&lut, 2000), 150u);
+  CHECK_EQ(Room_Sense_Lut(&lut, 4000), 130u);
+  CHECK_EQ(Room_Sense_Lut(&lut, 5000), 120u);
+  CHECK_EQ(Room_Sense_Lut(&lut, 5999), 111u);      /// Деление с отбрасыванием дробной части
+  CHECK_EQ(Room_Sense_Lut(&lut, 32767), 110u);
+
+  const RoomSense_Lut_t pair = { &x[1], &y[1], 2u };
+  CHECK_EQ(Room_Sense_Lut(&pair, 3000), 140u);
+}
+
+static void test_calibration(void)
+{
+  double worst_t  = 0.0;
+  double worst_rh = 0.0;
+
+  start();
+  for (int temp = -10; temp <= 120; temp += 5)
+  {
+    const double rh = (double)(temp + 10) * 100.0 / 130.0;
+    for (uint32_t i = 0; i < 3u; i++)   /// Линия задержки ФНЧ - 16 отсчётов, блок - 64
+    {
+      step((double)temp, rh);
+    }
+    const double err_t  = fabs(temp_read() - (double)temp);
+    const double err_rh = fabs(rh_read() - rh);
+    worst_t  = (err_t  > worst_t)  ? err_t  : worst_t;
+    worst_rh = (err_rh > worst_rh) ? err_rh : worst_rh;
+    if (err_t > TEMP_TOL || err_rh > RH_TOL)
+    {
+      fprintf(stderr, "%d C / %.1f %%: read %.1f C / %.1f %%\n", temp, rh, temp_read(), rh_read());
+    }
+    CHECK(err_t <= TEMP_TOL);
+    CHECK(err_rh <= RH_TOL);
+  }
+  printf("calibration: worst %.2f C, %.2f %%RH\n", worst_t, worst_rh);
+
+  /// За краями таблиц: обрыв и замыкание NTC, датчик влажности в насыщении
+  for (uint32_t i = 0; i < 3u; i++)
+  {
+    step(-40.0, -20.0);
+  }
+  CHECK_EQ(Room_Sense_Get()->temp_dc, -100);
+  CHECK_EQ(Room_Sense_Get()->rh_dpct, 0u);
+  for (uint32_t i = 0; i < 3u; i++)
+  {
+    step(200.0, 120.0);
+  }
+  CHECK_EQ(Room_Sense_Get()->temp_dc, 1200u);
+  CHECK_EQ(Room_Sense_Get()->rh_dpct, 1000u);
+}
+
+/** -- События -- */
+
+/**
+ * @brief Линейный переход за seconds секунд, события - в журнал вместе с истинными значениями.
+ */
+typedef struct {
+  MachineEvent_t event;
+  double         temp_c;
+  double         rh_pct;
+} Seen_t;
+
+static Seen_t   seen[16];
+static uint32_t seen_count;
+
+static void ramp(const double t0, const double t1, const double rh0, const double rh1, const double seconds)
+{
+  const uint32_t blocks = (uint32_t)(seconds * 1000.0 / BLOCK_MS);
+  for (uint32_t b = 0; b < blocks; b++)
+  {
+    const double k0 = (double)b / (double)blocks;
+    const double k1 = (double)(b + 1u) / (double)blocks;
+    dma_block(t0 + (t1 - t0) * k0, t0 + (t1 - t0) * k1, rh0 + (rh1 - rh0) * k0, rh0 + (rh1 - rh0) * k1);
+    const MachineEvent_t event = Room_Sense_Poll();
+    if (event != EVENT_NONE && seen_count < 16u)
+    {
+      seen[seen_count++] = (Seen_t){ event, t0 + (t1 - t0) * k1, rh0 + (rh1 - rh0) * k1 };
+    }
+  }
+}
+
+static void test_events(void)
+{
+  const double limit  = ROOM_SENSE_TEMP_LIMIT / 10.0;
+  const double temp_ok = (ROOM_SENSE_TEMP_LIMIT - ROOM_SENSE_TEMP_HYST) / 10.0;
+  const double target = ROOM_SENSE_RH_TARGET / 10.0;
+  const double rearm  = (ROOM_SENSE_RH_TARGET - ROOM_SENSE_RH_HYST) / 10.0;
+
+  start();
+  seen_count = 0;
+  ramp(40.0, 40.0, 60.0, 60.0, 1.0);
+  CHECK_EQ(seen_count, 0u);
+
+  /// Разогрев до 60 °C за 40 с, выдержка, остывание до 50 °C
+  ramp(40.0, 60.0, 60.0, 60.0, 40.0);
+  ramp(60.0, 60.0, 60.0, 60.0, 10.0);
+  CHECK_EQ(seen_count, 1u);
+  CHECK_EQ(seen[0].event, EVENT_OVER_TEMP);
+  CHECK(fabs(seen[0].temp_c - limit) <= TEMP_TOL);
+  ramp(60.0, 50.0, 60.0, 60.0, 40.0);
+  CHECK_EQ(seen_count, 2u);
+  CHECK_EQ(seen[1].event, EVENT_TEMP_OK);
+  CHECK(fabs(seen[1].temp_c - temp_ok) <= TEMP_TOL);
+
+  /// Дребезг у порога: колебания +/- 0.5 °C вокруг 55 °C - одно событие
+  seen_count = 0;
+  for (uint32_t i = 0; i < 20u; i++)
+  {
+    ramp(limit - 0.5, limit + 0.5, 60.0, 60.0, 1.0);
+    ramp(limit + 0.5, limit - 0.5, 60.0, 60.0, 1.0);
+  }
+  CHECK_EQ(seen_count, 1u);
+  CHECK_EQ(seen[0].event, EVENT_OVER_TEMP);
+  ramp(limit, 45.0, 60.0, 60.0, 10.0);
+  CHECK_EQ(seen_count, 2u);
+  CHECK_EQ(seen[1].event, EVENT_TEMP_OK);
+
+  /// Влажность до цели; провал на 3 % - без повтора, на 6 % - цель снова взведена
+  seen_count = 0;
+  ramp(45.0, 45.0, 60.0, 98.0, 60.0);
+  CHECK_EQ(seen_count, 1u);
+  CHECK_EQ(seen[0].event, EVENT_RH_REACHED);
+  CHECK(fabs(seen[0].rh_pct - target) <= RH_TOL);
+  ramp(45.0, 45.0, 98.0, target - 3.0, 10.0);
+  ramp(45.0, 45.0, target - 3.0, 98.0, 10.0);
+  CHECK_EQ(seen_count, 1u);
+  ramp(45.0, 45.0, 98.0, rearm - 1.0, 10.0);
+  ramp(45.0, 45.0, rearm - 1.0, 98.0, 10.0);
+  CHECK_EQ(seen_count, 2u);
+  CHECK_EQ(seen[1].event, EVENT_RH_REACHED);
+  CHECK(fabs(seen[1].rh_pct - target) <= RH_TOL);
+
+  /// Перегрев при достигнутой влажности: события по одному за вызов, перегрев первым
+  seen_count = 0;
+  ramp(45.0, 45.0, 98.0, 80.0, 5.0);
+  dma_block(70.0, 70.0, 98.0, 98.0);
+  dma_block(70.0, 70.0, 98.0, 98.0);
+  CHECK_EQ(Room_Sense_Poll(), EVENT_OVER_TEMP);
+  CHECK_EQ(Room_Sense_Poll(), EVENT_RH_REACHED);
+  CHECK_EQ(Room_Sense_Poll(), EVENT_NONE);
+}
+
+/** -- Буферы DMA -- */
+
+static void test_buffers(void)
+{
+  start();
+  step(30.0, 50.0);
+  step(30.0, 50.0);
+
+  /// Скачок: блок, который DMA только что заполнил, обработан в этом же проходе
+  CHECK_EQ(step(80.0, 90.0), EVENT_OVER_TEMP);
+  CHECK(temp_read() > ROOM_SENSE_TEMP_LIMIT / 10.0);
+
+  /// Суперцикл опоздал на блок: готовы оба буфера, последним обработан новый
+  for (uint32_t late = 0; late < 8u; late++)
+  {
+    const double older = (late & 1u) ? 30.0 : 40.0;
+    const double newer = (late & 1u) ? 40.0 : 30.0;
+    dma_block(older, older, 50.0, 50.0);
+    dma_block(newer, newer, 50.0, 50.0);
+    Room_Sense_Poll();
+    CHECK(fabs(temp_read() - newer) < fabs(temp_read() - older));   /// ФНЧ ещё помнит старый блок
+    CHECK_EQ(Room_Sense_Get()->valid, 1u);
+  }
+
+  /// Без новых блоков значения не меняются: отсчёты читает только обработка блока
+  const int16_t kept = Room_Sense_Get()->temp_dc;
+  for (uint32_t i = 0; i < 5u; i++)
+  {
+    host_tick_advance(BLOCK_MS);
+    CHECK_EQ(Room_Sense_Poll(), EVENT_NONE);
+  }
+  CHECK_EQ(Room_Sense_Get()->temp_dc, kept);
+
+  /// Поток DMA встал: через 500 мс - перегрев (без датчиков пар не подаётся), один раз
+  host_tick_advance(500u);
+  CHECK_EQ(Room_Sense_Poll(), EVENT_OVER_TEMP);
+  CHECK_EQ(Room_Sense_Get()->valid, 0u);
+  CHECK_EQ(Room_Sense_Poll(), EVENT_NONE);
+
+  /// Сбор на паузе (ValveMonitor) и снова: запись с буфера 0, перегрев снимается
+  Room_Sense_Pause();
+  CHECK_EQ(DMA2_Stream4->CR & DMA_SxCR_EN, 0u);
+  CHECK_EQ(TIM2->CR1 & TIM_CR1_CEN, 0u);
+  DMA2_Stream4->CR |= DMA_SxCR_CT;
+  Room_Sense_Resume();
+  CHECK_EQ(DMA2_Stream4->CR & DMA_SxCR_CT, 0u);
+  CHECK_EQ(step(30.0, 50.0), EVENT_TEMP_OK);
+  CHECK(fabs(temp_read() - 30.0) <= 2.0 * TEMP_TOL);   /// Линия задержки ФНЧ помнит 40 °C
+  step(30.0, 50.0);
+  CHECK(fabs(temp_read() - 30.0) <= TEMP_TOL);
+}
+
+int main(void)
+{
+  test_lut();
+  test_calibration();
+  test_events();
+  test_buffers();
+
+  return HOST_TEST_RESULT("test_room_sense");
+}
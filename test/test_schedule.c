@@ -0,0 +1,179 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * Недельное расписание на ПК (SCHEDULE_PORT_HOST): год сна до будильника через
+ * Schedule_Host_Sleep(), как суперцикл - сон, Schedule_Take_Alarm(), снова сон.
+ * За каждую из 52 недель каждая минута запуска из расписания наступает ровно один
+ * раз, в секунду 0, и других срабатываний нет. Прогон дважды: сон всегда до
+ * будильника и сон, прерываемый "кнопкой" через случайное время.
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "AppSchedule.h"
+
+#define WEEK_S   (SCHEDULE_WEEK_MINUTES * 60u)
+#define WEEKS    (52u)
+#define START_S  (WEEK_S - 120u)   /// Воскресенье 23:58 недели 0: Пн 00:00 - уже неделя 1
+
+/** Расписание: пересечения, края суток и недели, недопустимые и пустые записи */
+static uint32_t entries[SCHEDULE_ENTRIES] = {
+  SCHEDULE_ENTRY(SCHEDULE_WORKDAYS, 6, 30),
+  SCHEDULE_ENTRY(SCHEDULE_EVERY_DAY, 6, 30),   /// Та же минута в будни - один запуск
+  SCHEDULE_ENTRY(SCHEDULE_WEEKEND, 8, 0),
+  SCHEDULE_ENTRY(SCHEDULE_MONDAY, 0, 0),       /// Первая минута недели
+  SCHEDULE_ENTRY(0x40u, 23, 59),               /// Последняя минута недели (воскресенье)
+  SCHEDULE_ENTRY(0x04u, 12, 0) | (1u << 20),   /// Лишний бит: запись недопустима
+  SCHEDULE_ENTRY(0x10u, 24, 1),                /// Минута 1441: недопустима
+  0u
+};
+
+/** Сколько раз сработала каждая минута недели в каждой неделе */
+static uint8_t fired[WEEKS + 1u][SCHEDULE_WEEK_MINUTES];
+static uint8_t expected_minute[SCHEDULE_WEEK_MINUTES];
+static uint32_t rng_state = 0x5EEDu;
+
+static uint32_t rng(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+/**
+ * @brief Ожидаемые минуты запуска - прямо из записей, без Schedule_Next().
+ */
+static uint32_t expected_build(void)
+{
+  uint32_t count = 0;
+
+  memset(expected_minute, 0, sizeof(expected_minute));
+  for (uint32_t i = 0; i < SCHEDULE_ENTRIES; i++)
+  {
+    const uint32_t days   = (entries[i] >> SCHEDULE_DAYS_POS) & SCHEDULE_DAYS_MASK;
+    const uint32_t minute = entries[i] & SCHEDULE_MINUTE_MASK;
+    if ((entries[i] >> (SCHEDULE_DAYS_POS + 7u)) != 0u || minute >= SCHEDULE_DAY_MINUTES)
+    {
+      continue;
+    }
+    for (uint32_t day = 0; day < 7u; day++)
+    {
+      if ((days & (1u << day)) != 0u && !expected_minute[day * SCHEDULE_DAY_MINUTES + minute])
+      {
+        expected_minute[day * SCHEDULE_DAY_MINUTES + minute] = 1u;
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+/**
+ * @brief Год работы суперцикла.
+ * @param button_wake 0 - сон до будильника; 1 - сон ещё и прерывается кнопкой.
+ */
+static void run_year(const uint8_t button_wake)
+{
+  const Schedule_Time_t start = { .weekday = 7u, .hour = 23u, .minute = 58u, .second = 0u };
+  const uint32_t        per_week = expected_build();
+  uint32_t              now_s    = START_S;   /// Секунды от понедельника недели 0
+  uint32_t              wakes    = 0;
+  uint32_t              alarms   = 0;
+  uint32_t              wrong    = 0;
+
+  memset(fired, 0, sizeof(fired));
+  Schedule_Init(entries);
+  Schedule_Set_Time(&start);
+
+  while (now_s < (WEEKS + 1u) * WEEK_S)
+  {
+    const uint32_t max_s = button_wake ? (rng() % (3u * 86400u) + 1u) : WEEK_S;
+    now_s += Schedule_Host_Sleep(max_s);
+    wakes++;
+
+    Schedule_Time_t time;
+    Schedule_Get_Time(&time);
+    CHECK_EQ(Schedule_Minute_Of_Week(&time) * 60u + time.second, now_s % WEEK_S);
+
+    if (!Schedule_Take_Alarm())
+    {
+      continue;
+    }
+    const uint32_t minute = Schedule_Minute_Of_Week(&time);
+    if (time.second != 0u || !expected_minute[minute])
+    {
+      wrong++;
+      fprintf(stderr, "week %u: alarm at day %u %02u:%02u:%02u\n", now_s / WEEK_S, time.weekday,
+              time.hour, time.minute, time.second);
+    }
+    if (now_s / WEEK_S <= WEEKS)   /// Последний сон заканчивается уже в неделе 53
+    {
+      fired[now_s / WEEK_S][minute]++;
+      alarms++;
+    }
+  }
+
+  CHECK_EQ(wrong, 0u);
+  for (uint32_t week = 1; week <= WEEKS; week++)
+  {
+    uint32_t missed   = 0;
+    uint32_t repeated = 0;
+    for (uint32_t minute = 0; minute < SCHEDULE_WEEK_MINUTES; minute++)
+    {
+      missed   += (expected_minute[minute] && fired[week][minute] == 0u);
+      repeated += (fired[week][minute] > expected_minute[minute]);
+    }
+    if (missed != 0u || repeated != 0u)
+    {
+      fprintf(stderr, "week %u: %u missed, %u repeated\n", week, missed, repeated);
+    }
+    CHECK_EQ(missed, 0u);
+    CHECK_EQ(repeated, 0u);
+  }
+  CHECK_EQ(fired[0][SCHEDULE_WEEK_MINUTES - 1u], 1u);   /// Вс 23:59 недели 0
+  CHECK_EQ(alarms, WEEKS * per_week + 1u);
+  if (!button_wake)
+  {
+    CHECK_EQ(wakes, alarms + 1u);                        /// Только будильники (+1 - в неделе 53)
+  }
+  printf("%s: %u launches a week, %u wakes, %u alarms\n", button_wake ? "button" : "alarm only",
+         per_week, wakes, alarms);
+}
+
+/**
+ * @brief Правка расписания между срабатываниями: следующий запуск - по новому.
+ */
+static void test_edit(void)
+{
+  const Schedule_Time_t monday = { .weekday = 1u, .hour = 7u };
+  const uint32_t        saved  = entries[0];
+
+  Schedule_Init(entries);
+  Schedule_Set_Time(&monday);
+  entries[0] = SCHEDULE_ENTRY(SCHEDULE_MONDAY, 7, 5);
+  Schedule_Rearm();
+
+  CHECK_EQ(Schedule_Host_Sleep(WEEK_S), 5u * 60u);
+  CHECK_EQ(Schedule_Take_Alarm(), 1u);
+  CHECK_EQ(Schedule_Take_Alarm(), 0u);                  /// Одно срабатывание - один запуск
+  entries[0] = saved;
+  Schedule_Rearm();
+
+  /// Пустое расписание: будильник выключен, сон до max_s
+  uint32_t none[SCHEDULE_ENTRIES] = {0};
+  Schedule_Init(none);
+  CHECK_EQ(Schedule_Host_Sleep(WEEK_S), WEEK_S);
+  CHECK_EQ(Schedule_Take_Alarm(), 0u);
+}
+
+int main(void)
+{
+  run_year(0);
+  run_year(1);
+  test_edit();
+
+  return HOST_TEST_RESULT("test_schedule");
+}
@@ -0,0 +1,121 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * Сеттеры индикатора на ПК: содержимое digit_buf и опубликованного вида после
+ * Seg7_SetNumber/SetError/SetText/SetDP при текущем NUMBER_OF_DIG. Собирается дважды:
+ * 3 разряда (прямое подключение) и 6 разрядов (SEG7_BACKEND_SPI) - на 6 разрядах
+ * видно всё, что сеттер не перезаписал.
+ */
+
+#include <string.h>
+#include "host_periph.h"
+#include "host_test.h"
+#include "7_seg_driver.h"
+#include "main.h"
+
+/** Коды сегментов (7_seg_driver.c) */
+#define CODE_BLANK (0x00u)
+#define CODE_E     (0x79u)
+static const uint8_t code_digit[10] = { 0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F };
+
+static Seg7_Handle_t seg7;
+
+static void check_view(const uint8_t expected[NUMBER_OF_DIG], const int line)
+{
+  for (uint32_t i = 0; i < NUMBER_OF_DIG; i++)
+  {
+    if (seg7.digit_buf[i] != expected[i] || seg7.view.digit[i] != expected[i])
+    {
+      fprintf(stderr, "line %d: digit %u = 0x%02X (view 0x%02X), expected 0x%02X\n",
+              line, i, seg7.digit_buf[i], seg7.view.digit[i], expected[i]);
+    }
+    CHECK_EQ(seg7.digit_buf[i], expected[i]);
+    CHECK_EQ(seg7.view.digit[i], expected[i]);
+  }
+}
+
+/**
+ * @brief Код аварии: "E" слева, две цифры справа, между ними пусто - что бы ни было до этого.
+ */
+static void test_set_error(void)
+{
+  uint8_t expected[NUMBER_OF_DIG];
+
+  for (uint32_t code = 0; code <= 100u; code++)
+  {
+    Seg7_SetNumber(&seg7, 888u);
+    Seg7_SetText(&seg7, "88888888");
+    Seg7_SetDP(&seg7, NUMBER_OF_DIG - 2u, 1);
+    Seg7_SetError(&seg7, (uint8_t)code);
+
+    const uint32_t shown = (code > 99u) ? 99u : code;
+    memset(expected, CODE_BLANK, sizeof(expected));
+    expected[0]                 = CODE_E;
+    expected[NUMBER_OF_DIG - 2] = code_digit[shown / 10u];
+    expected[NUMBER_OF_DIG - 1] = code_digit[shown % 10u];
+    check_view(expected, __LINE__);
+    CHECK_EQ(seg7.view.blink_mask, 0u);
+    CHECK(seg7.view.anim == NULL);
+  }
+}
+
+/**
+ * @brief Число - по правому краю, старшие разряды пустые.
+ */
+static void test_set_number(void)
+{
+  static const uint16_t numbers[] = { 0u, 7u, 42u, 305u, 999u, 4096u, 65535u };
+  uint8_t expected[NUMBER_OF_DIG];
+
+  for (uint32_t n = 0; n < sizeof(numbers) / sizeof(numbers[0]); n++)
+  {
+    Seg7_SetText(&seg7, "88888888");
+    Seg7_SetNumber(&seg7, numbers[n]);
+
+    memset(expected, CODE_BLANK, sizeof(expected));
+    uint32_t value = numbers[n];
+    int32_t  i     = NUMBER_OF_DIG - 1;
+    do
+    {
+      expected[i--] = code_digit[value % 10u];
+      value /= 10u;
+    } while (value != 0u && i >= 0);
+    check_view(expected, __LINE__);
+  }
+}
+
+/**
+ * @brief Текст - по левому краю, '.' - точка предыдущего символа, остальное пусто.
+ */
+static void test_set_text(void)
+{
+  uint8_t expected[NUMBER_OF_DIG];
+
+  Seg7_SetNumber(&seg7, 888u);
+  Seg7_SetText(&seg7, "E.r");
+  memset(expected, CODE_BLANK, sizeof(expected));
+  expected[0] = CODE_E | SEG7_DP_BIT;
+  expected[1] = 0x50u;
+  check_view(expected, __LINE__);
+}
+
+int main(void)
+{
+  GPIO_TypeDef  *digit_ports[NUMBER_OF_DIG];
+  uint16_t       digit_pins[NUMBER_OF_DIG];
+  for (uint32_t i = 0; i < NUMBER_OF_DIG; i++)
+  {
+    digit_ports[i] = GPIOB;
+    digit_pins[i]  = (uint16_t)(1u << i);
+  }
+  Seg7_Init(&seg7, digit_ports, digit_pins, GPIOA, 0x00FFu);
+
+  test_set_error();
+  test_set_number();
+  test_set_text();
+
+  printf("NUMBER_OF_DIG = %d\n", NUMBER_OF_DIG);
+  return HOST_TEST_RESULT("test_seg7_driver");
+}
@@ -0,0 +1,223 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * SPI back-end индикатора на ПК: после каждого шага мультиплекса (Seg7_UpdateIndicator)
+ * берётся кадр, который DMA2 Stream3 передаст в SPI1 (M0AR, NDTR), и прогоняется через
+ * модель цепочки 74HC595: 24 бита старшим вперёд, затем защёлка. Выходы регистров
+ * сегментов, разрядов и светодиодов сверяются бит в бит с ожидаемыми.
+ * Собирается для 3 и 6 разрядов.
+ */
+
+#include <string.h>
+#include "host_periph.h"
+#include "host_test.h"
+#include "7_seg_driver.h"
+#include "Seg7_Spi.h"
+
+/** Коды сегментов (7_seg_driver.c): бит 0 - A ... бит 6 - G, бит 7 - точка */
+static const uint8_t code_digit[10] = { 0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F };
+
+static Seg7_Handle_t seg7;
+
+/**
+ * @brief Выходы цепочки после защёлки: Q0..Q7 каждого регистра.
+ */
+typedef struct {
+  uint8_t segments;   /// Первый регистр от MOSI
+  uint8_t digits;
+  uint8_t leds;       /// Последний
+} Chain_t;
+
+/**
+ * @brief Модель 74HC595 x3: сдвиг по каждому биту (MSB первым), выход QH' в следующий регистр.
+ */
+static Chain_t chain_shift(const uint8_t *frame, const uint32_t length)
+{
+  uint8_t shift[3] = { 0, 0, 0 };   /// Сегменты, разряды, светодиоды
+
+  for (uint32_t byte = 0; byte < length; byte++)
+  {
+    for (int32_t bit = 7; bit >= 0; bit--)
+    {
+      const uint8_t in = (uint8_t)((frame[byte] >> bit) & 1u);
+      shift[2] = (uint8_t)((shift[2] << 1) | (shift[1] >> 7));
+      shift[1] = (uint8_t)((shift[1] << 1) | (shift[0] >> 7));
+      shift[0] = (uint8_t)((shift[0] << 1) | in);
+    }
+  }
+  return (Chain_t){ .segments = shift[0], .digits = shift[1], .leds = shift[2] };
+}
+
+/**
+ * @brief Один шаг мультиплекса: прерывание TIM3, затем "передача" кадра из DMA.
+ */
+static Chain_t mux_step(void)
+{
+  DMA2_Stream3->CR &= ~DMA_SxCR_EN;
+  Seg7_UpdateIndicator(&seg7);
+
+  CHECK(DMA2_Stream3->CR & DMA_SxCR_EN);
+  CHECK_EQ(DMA2_Stream3->NDTR, SEG7_SPI_FRAME_BYTES);
+  CHECK_EQ(DMA2_Stream3->PAR, (uint32_t)(uintptr_t)&SPI1->DR);
+
+  const uint8_t *frame = (const uint8_t *)(uintptr_t)DMA2_Stream3->M0AR;
+  return chain_shift(frame, DMA2_Stream3->NDTR);
+}
+
+/**
+ * @brief Полный цикл: на шаге i горит только разряд i с ожидаемым шаблоном.
+ */
+static void check_cycle(const uint8_t expected[NUMBER_OF_DIG], const uint8_t leds, const int line)
+{
+  for (uint32_t i = 0; i < NUMBER_OF_DIG; i++)
+  {
+    const Chain_t out = mux_step();
+    if (out.digits != (uint8_t)(1u << i) || out.segments != expected[i] || out.leds != leds)
+    {
+      fprintf(stderr, "line %d step %u: digits 0x%02X segments 0x%02X leds 0x%02X\n",
+              line, i, out.digits, out.segments, out.leds);
+    }
+    CHECK_EQ(out.digits, 1u << i);
+    CHECK_EQ(out.segments, expected[i]);
+    CHECK_EQ(out.leds, leds);
+  }
+}
+
+/**
+ * @brief Настройка периферии: SPI1 ведущий, режим 0, MSB первым; DMA канал 3, память -> SPI; защёлка CCR1.
+ */
+static void test_init_registers(void)
+{
+  CHECK(SPI1->CR1 & SPI_CR1_MSTR);
+  CHECK(SPI1->CR1 & SPI_CR1_SPE);
+  CHECK_EQ(SPI1->CR1 & (SPI_CR1_LSBFIRST | SPI_CR1_CPOL | SPI_CR1_CPHA | SPI_CR1_DFF), 0u);
+  CHECK_EQ(SPI1->CR1 & SPI_CR1_BR, SEG7_SPI_BAUD_DIV);
+  CHECK(SPI1->CR2 & SPI_CR2_TXDMAEN);
+
+  CHECK_EQ((DMA2_Stream3->CR & DMA_SxCR_CHSEL) >> DMA_SxCR_CHSEL_Pos, 3u);
+  CHECK_EQ(DMA2_Stream3->CR & DMA_SxCR_DIR, DMA_SxCR_DIR_0);
+  CHECK(DMA2_Stream3->CR & DMA_SxCR_MINC);
+  CHECK_EQ(DMA2_Stream3->CR & (DMA_SxCR_PSIZE | DMA_SxCR_MSIZE | DMA_SxCR_PINC), 0u);
+
+  CHECK_EQ(TIM3->CCR1, SEG7_SPI_LATCH_CCR);
+  CHECK_EQ(TIM3->CCMR1 & TIM_CCMR1_OC1M, TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1M_0);
+  CHECK(TIM3->CCER & TIM_CCER_CC1E);
+
+  /// PB3 - SCK, PB5 - MOSI (AF5), PB4 - RCLK (AF2)
+  CHECK_EQ((GPIOB->MODER >> 6) & 0x3Fu, 0x2Au);
+  CHECK_EQ((GPIOB->AFR[0] >> 12) & 0xFFFu, 0x525u);
+}
+
+static void test_number(void)
+{
+  uint8_t expected[NUMBER_OF_DIG];
+
+  Seg7_SetNumber(&seg7, 305u);
+  memset(expected, 0, sizeof(expected));
+  expected[NUMBER_OF_DIG - 3] = code_digit[3];
+  expected[NUMBER_OF_DIG - 2] = code_digit[0];
+  expected[NUMBER_OF_DIG - 1] = code_digit[5];
+  check_cycle(expected, 0u, __LINE__);
+  check_cycle(expected, 0u, __LINE__);   /// Кадры повторяются без изменения вида
+
+  Seg7_SetDP(&seg7, NUMBER_OF_DIG - 1u, 1);
+  expected[NUMBER_OF_DIG - 1] |= SEG7_DP_BIT;
+  check_cycle(expected, 0u, __LINE__);
+  Seg7_SetDP(&seg7, NUMBER_OF_DIG - 1u, 0);
+}
+
+static void test_error_and_leds(void)
+{
+  uint8_t expected[NUMBER_OF_DIG];
+
+  Seg7_SetLeds(&seg7, 0xA5u);
+  Seg7_SetError(&seg7, 13u);
+  memset(expected, 0, sizeof(expected));
+  expected[0]                 = 0x79u;
+  expected[NUMBER_OF_DIG - 2] = code_digit[1];
+  expected[NUMBER_OF_DIG - 1] = code_digit[3];
+  check_cycle(expected, 0xA5u, __LINE__);
+  Seg7_SetLeds(&seg7, 0u);
+}
+
+/**
+ * @brief Мигание: SEG7_BLINK_CYCLES циклов разряд виден, столько же - пуст.
+ */
+static void test_blink(void)
+{
+  uint8_t expected[NUMBER_OF_DIG];
+
+  Seg7_SetNumber(&seg7, 7u);
+  Seg7_SetBlink(&seg7, 1u << (NUMBER_OF_DIG - 1));
+  memset(expected, 0, sizeof(expected));
+
+  for (uint32_t cycle = 0; cycle < 4u * SEG7_BLINK_CYCLES; cycle++)
+  {
+    const uint32_t visible = ((cycle / SEG7_BLINK_CYCLES) % 2u) == 0u;
+    expected[NUMBER_OF_DIG - 1] = visible ? code_digit[7] : 0u;
+    check_cycle(expected, 0u, __LINE__);
+  }
+  Seg7_SetBlink(&seg7, 0);
+}
+
+/**
+ * @brief Анимация занимает левый разряд, кадр меняется раз в frame_ticks циклов.
+ */
+static void test_animation(void)
+{
+  uint8_t expected[NUMBER_OF_DIG];
+
+  Seg7_SetNumber(&seg7, 42u);
+  Seg7_SetAnimation(&seg7, &seg7_anim_spinner);
+  memset(expected, 0, sizeof(expected));
+  expected[NUMBER_OF_DIG - 2] = code_digit[4];
+  expected[NUMBER_OF_DIG - 1] = code_digit[2];
+
+  const uint32_t frames = seg7_anim_spinner.frame_count;
+  for (uint32_t cycle = 0; cycle < 2u * frames * seg7_anim_spinner.frame_ticks; cycle++)
+  {
+    expected[0] = (uint8_t)(1u << ((cycle / seg7_anim_spinner.frame_ticks) % frames));   /// A, B, ... F
+    check_cycle(expected, 0u, __LINE__);
+  }
+  Seg7_SetAnimation(&seg7, NULL);
+}
+
+/**
+ * @brief Seg7_Off(): пустой кадр и защёлка вручную через принудительный уровень OC1.
+ */
+static void test_off(void)
+{
+  DMA2->LISR = DMA_LISR_TCIF3;   /// Передача "закончилась"
+  SPI1->SR   = SPI_SR_TXE;
+  Seg7_Off(&seg7);
+
+  const Chain_t out = chain_shift((const uint8_t *)(uintptr_t)DMA2_Stream3->M0AR, DMA2_Stream3->NDTR);
+  CHECK_EQ(out.segments, 0u);
+  CHECK_EQ(out.digits, 0u);
+  CHECK_EQ(out.leds, 0u);
+  CHECK_EQ(TIM3->CCMR1 & TIM_CCMR1_OC1M, TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1M_0);
+}
+
+int main(void)
+{
+  GPIO_TypeDef *digit_ports[NUMBER_OF_DIG];
+  uint16_t      digit_pins[NUMBER_OF_DIG];
+  for (uint32_t i = 0; i < NUMBER_OF_DIG; i++)
+  {
+    digit_ports[i] = GPIOB;
+    digit_pins[i]  = (uint16_t)(1u << i);
+  }
+  Seg7_Init(&seg7, digit_ports, digit_pins, GPIOA, 0x00FFu);
+
+  test_init_registers();
+  test_number();
+  test_error_and_leds();
+  test_blink();
+  test_animation();
+  test_off();
+
+  printf("NUMBER_OF_DIG = %d\n", NUMBER_OF_DIG);
+  return HOST_TEST_RESULT("test_seg7_spi");
+}
@@ -0,0 +1,233 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * Ядро SST на ПК (SST_PORT_HOST): порядок запуска по приоритетам, вытеснение при
+ * отправке более важной задаче, отложенный запуск задач не важнее текущего кода,
+ * переполнение очереди и её повторное использование по кругу.
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "Sst.h"
+
+#define PRIO_ISR   (0u)   /// Прерывание важнее всех задач
+#define PRIO_HIGH  (1u)
+#define PRIO_MID   (2u)
+#define PRIO_LOW   (3u)
+
+#define LOG_DEPTH  (64u)
+
+/** Журнал: задача, сигнал, фаза (B - начало обработчика, E - конец) и приоритет в этот момент */
+typedef struct {
+  char     task;
+  uint16_t sig;
+  char     phase;
+  uint8_t  current;
+} Log_Entry_t;
+
+static Log_Entry_t log_buf[LOG_DEPTH];
+static uint32_t    log_len;
+
+static Sst_Task_t task_high;
+static Sst_Task_t task_mid;
+static Sst_Task_t task_low;
+static Sst_Slot_t ring_high[4];
+static Sst_Slot_t ring_mid[4];
+static Sst_Slot_t ring_low[4];
+
+/** Что делает обработчик по сигналу */
+enum {
+  SIG_PLAIN     = 1,   /// Только запись в журнал
+  SIG_POST_HIGH = 2,   /// Отправить задаче high (вытеснение)
+  SIG_POST_LOW  = 3,   /// Отправить задаче low (отложенный запуск)
+  SIG_POST_SELF = 4    /// Отправить себе же (после текущего события)
+};
+
+static void log_add(const char task, const uint16_t sig, const char phase)
+{
+  if (log_len < LOG_DEPTH)
+  {
+    log_buf[log_len++] = (Log_Entry_t){ task, sig, phase, Sst_Host_Current() };
+  }
+}
+
+static char task_name(const Sst_Task_t *task)
+{
+  return (task == &task_high) ? 'H' : ((task == &task_mid) ? 'M' : 'L');
+}
+
+static void handler(Sst_Task_t *task, const Sst_Evt_t *evt)
+{
+  const char name = task_name(task);
+  log_add(name, evt->sig, 'B');
+  switch (evt->sig)
+  {
+    case SIG_POST_HIGH:
+      Sst_Post(&task_high, SIG_PLAIN, 0, 0);
+      break;
+    case SIG_POST_LOW:
+      Sst_Post(&task_low, SIG_PLAIN, 0, 0);
+      break;
+    case SIG_POST_SELF:
+      Sst_Post(task, SIG_PLAIN, 0, 0);
+      break;
+    default:
+      break;
+  }
+  log_add(name, evt->sig, 'E');
+}
+
+/**
+ * @brief Журнал в строку "HB1 HE1 ..." для сравнения с ожидаемым порядком.
+ */
+static void check_log(const char *expected, const int line)
+{
+  char text[LOG_DEPTH * 5u] = "";
+  for (uint32_t i = 0; i < log_len; i++)
+  {
+    char item[8];
+    snprintf(item, sizeof(item), "%s%c%c%u", (i > 0u) ? " " : "", log_buf[i].task, log_buf[i].phase,
+             (unsigned)log_buf[i].sig);
+    strcat(text, item);
+  }
+  if (strcmp(text, expected) != 0)
+  {
+    fprintf(stderr, "line %d:\n  got      %s\n  expected %s\n", line, text, expected);
+  }
+  CHECK(strcmp(text, expected) == 0);
+  log_len = 0;
+}
+
+static void setup(void)
+{
+  Sst_Host_Reset();
+  log_len = 0;
+  CHECK_EQ(Sst_Task_Init(&task_high, handler, ring_high, 4, 0, PRIO_HIGH), HAL_OK);
+  CHECK_EQ(Sst_Task_Init(&task_mid,  handler, ring_mid,  4, 0, PRIO_MID),  HAL_OK);
+  CHECK_EQ(Sst_Task_Init(&task_low,  handler, ring_low,  4, 0, PRIO_LOW),  HAL_OK);
+}
+
+/** -- Приоритеты -- */
+
+static void isr_post_all(void)
+{
+  Sst_Post(&task_low,  SIG_PLAIN, 0, 0);
+  Sst_Post(&task_mid,  SIG_PLAIN, 0, 0);
+  Sst_Post(&task_high, SIG_PLAIN, 0, 0);
+  Sst_Post(&task_low,  SIG_PLAIN, 0, 0);
+  log_add('I', 0, 'E');   /// Задачи не запускались внутри прерывания
+}
+
+static void test_priority_order(void)
+{
+  setup();
+  Sst_Host_Isr(PRIO_ISR, isr_post_all);
+  check_log("IE0 HB1 HE1 MB1 ME1 LB1 LE1 LB1 LE1", __LINE__);
+  CHECK_EQ(Sst_Host_Current(), SST_HOST_THREAD_PRIO);
+
+  /// Из основного цикла задача важнее - запуск сразу, внутри Sst_Post()
+  Sst_Post(&task_mid, SIG_PLAIN, 0, 0);
+  check_log("MB1 ME1", __LINE__);
+
+  /// Обработчик выполняется с приоритетом своей задачи
+  setup();
+  Sst_Host_Isr(PRIO_ISR, isr_post_all);
+  CHECK_EQ(log_buf[1].current, PRIO_HIGH);
+  CHECK_EQ(log_buf[3].current, PRIO_MID);
+  CHECK_EQ(log_buf[5].current, PRIO_LOW);
+  log_len = 0;
+}
+
+/** -- Вытеснение -- */
+
+static void test_preemption(void)
+{
+  setup();
+
+  /// low отправляет high: high вытесняет low посреди обработчика
+  Sst_Post(&task_low, SIG_POST_HIGH, 0, 0);
+  check_log("LB2 HB1 HE1 LE2", __LINE__);
+
+  /// high отправляет low: low ждёт конца high
+  Sst_Post(&task_high, SIG_POST_LOW, 0, 0);
+  check_log("HB3 HE3 LB1 LE1", __LINE__);
+
+  /// Событие себе же - после текущего, без вложенности
+  Sst_Post(&task_mid, SIG_POST_SELF, 0, 0);
+  check_log("MB4 ME4 MB1 ME1", __LINE__);
+}
+
+static void isr_mid_prio(void)
+{
+  log_add('I', 0, 'B');
+  Sst_Post(&task_high, SIG_PLAIN, 0, 0);   /// Важнее прерывания: вытесняет его сразу
+  Sst_Post(&task_low,  SIG_PLAIN, 0, 0);   /// Не важнее прерванной задачи: после неё
+  log_add('I', 0, 'E');
+}
+
+static void low_with_interrupt(Sst_Task_t *task, const Sst_Evt_t *evt)
+{
+  log_add('L', evt->sig, 'B');
+  if (evt->sig == SIG_PLAIN + 10u)
+  {
+    Sst_Host_Isr(PRIO_MID, isr_mid_prio);   /// Прерывание посреди задачи low
+  }
+  log_add('L', evt->sig, 'E');
+}
+
+static void test_interrupt_in_task(void)
+{
+  setup();
+  task_low.handler = low_with_interrupt;
+  Sst_Post(&task_low, SIG_PLAIN + 10u, 0, 0);
+  check_log("LB11 IB0 HB1 HE1 IE0 LE11 LB1 LE1", __LINE__);
+}
+
+/** -- Переполнение очереди -- */
+
+static HAL_StatusTypeDef overflow_results[6];
+
+static void isr_flood(void)
+{
+  for (uint32_t i = 0; i < 6u; i++)
+  {
+    overflow_results[i] = Sst_Post(&task_low, (uint16_t)(100u + i), 0, 0);
+  }
+}
+
+static void test_overflow(void)
+{
+  setup();
+
+  for (uint32_t round = 0; round < 1000u; round++)   /// Номера ячеек идут по кругу много раз
+  {
+    Sst_Host_Isr(PRIO_ISR, isr_flood);
+
+    CHECK_EQ(overflow_results[3], HAL_OK);
+    CHECK_EQ(overflow_results[4], HAL_BUSY);
+    CHECK_EQ(overflow_results[5], HAL_BUSY);
+    if (round == 0u)
+    {
+      check_log("LB100 LE100 LB101 LE101 LB102 LE102 LB103 LE103", __LINE__);
+    }
+    log_len = 0;
+  }
+  CHECK_EQ(atomic_load(&task_low.lost), 2000u);
+  CHECK_EQ(task_low.head, 4000u);
+
+  Sst_Slot_t ring_bad[3];
+  Sst_Task_t task_bad;
+  CHECK_EQ(Sst_Task_Init(&task_bad, handler, ring_bad, 3, 0, PRIO_LOW), HAL_ERROR);
+}
+
+int main(void)
+{
+  test_priority_order();
+  test_preemption();
+  test_interrupt_in_task();
+  test_overflow();
+
+  return HOST_TEST_RESULT("test_sst");
+}
@@ -0,0 +1,157 @@
+//
+// Created by Dmitry on 18.10.2026.
+//
+
+/**
+ * Контроль тока катушки (ValveMonitor.c и CMSIS-DSP arm_max_q15, arm_mean_q15, как в
+ * прошивке) на модели катушки. Тест - это ADC1 и DMA2 Stream4: после
+ * Valve_Monitor_Start() отсчёты пишутся в буфер M0AR (NDTR штук), ставится TCIF4 и
+ * вызывается Valve_Monitor_DMA_IRQHandler(), код отказа - Valve_Monitor_Poll().
+ *
+ * Ток считается по цепи, а не по порогам прошивки: L di/dt = V - R i - ЭДС якоря,
+ * шаг 1 мкс, АЦП - 12 бит с шумом на каждые VALVE_MON_SAMPLE_NS. Якорь трогается,
+ * когда ток доходит до PULL_MA, и MOVE_US наводит встречную ЭДС (провал тока).
+ * Исправная катушка - L/R 0.6 мс, как в расчёте окна ValveMonitor.h. Проверки: открытие
+ * и закрытие исправного клапана - без отказа; обрыв, замыкание, витковое замыкание,
+ * заклинивший якорь, ключ не выключился - свой код и клапан закрыт в прерывании.
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "host_periph.h"
+#include "ValveMonitor.h"
+
+#define SUPPLY_V       (24.0)
+#define DIODE_V        (0.7)      /// Обратный диод катушки при закрытии
+#define PULL_MA        (200.0)    /// Ток, при котором трогается якорь
+#define MOVE_US        (400u)     /// Ход якоря
+#define MOVE_EMF_V     (20.0)     /// Пик встречной ЭДС на ходу якоря
+#define NOISE_CODES    (4u)       /// Размах шума АЦП, отсчётов
+
+/**
+ * @brief Катушка и ключ
+ */
+typedef struct {
+  const char    *name;
+  double         r_ohm;        /// 0 - обрыв
+  double         l_mh;
+  uint8_t        moves;        /// Якорь сдвигается
+  uint8_t        opening;      /// Фронт: 1 - открытие, 0 - закрытие
+  uint8_t        driver_stuck; /// Закрытие, но ключ остался включён
+  MachineFault_t expected;
+} Coil_t;
+
+static const Coil_t coils[] = {
+  { "opening",       80.0, 48.0, 1, 1, 0, FAULT_NONE           },
+  { "closing",       80.0, 48.0, 0, 0, 0, FAULT_NONE           },
+  { "open coil",      0.0, 48.0, 0, 1, 0, FAULT_COIL_OPEN      },
+  { "shorted coil",  20.0, 12.0, 1, 1, 0, FAULT_COIL_SHORT     },
+  { "shorted turns", 45.0, 27.0, 1, 1, 0, FAULT_COIL_SHORT     },
+  { "stuck plunger", 80.0, 48.0, 0, 1, 0, FAULT_COIL_NO_INRUSH },
+  { "driver stuck",  80.0, 48.0, 0, 0, 1, FAULT_VALVE_DRIVER   },
+};
+
+static uint32_t rng_state = 0xC011u;
+
+static uint32_t rng(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+/**
+ * @brief Отсчёт АЦП для тока: шунт и усилитель - VALVE_MON_FULL_SCALE_MA на полную шкалу.
+ */
+static uint16_t adc_code(const double current_ma)
+{
+  double code = current_ma * 4095.0 / (double)VALVE_MON_FULL_SCALE_MA;
+  code += (double)(rng() % (2u * NOISE_CODES + 1u)) - (double)NOISE_CODES;
+  code  = (code < 0.0) ? 0.0 : (code > 4095.0) ? 4095.0 : code;
+  return (uint16_t)(code + 0.5);
+}
+
+/**
+ * @brief Пачка после фронта PB12: интегрирование цепи и выборка АЦП.
+ */
+static void coil_burst(const Coil_t *coil, uint16_t *burst, const uint32_t samples)
+{
+  const double hold_ma  = (coil->r_ohm > 0.0) ? 1000.0 * SUPPLY_V / coil->r_ohm : 0.0;
+  const double drive_v  = (coil->opening || coil->driver_stuck) ? SUPPLY_V : -DIODE_V;
+  double       i_ma     = coil->opening ? 0.0 : hold_ma;   /// До закрытия - ток удержания
+  uint32_t     move_at  = 0;
+  uint32_t     next_ns  = VALVE_MON_SAMPLE_NS;
+  uint32_t     n        = 0;
+
+  for (uint32_t t_us = 1; n < samples; t_us++)
+  {
+    if (coil->r_ohm > 0.0)
+    {
+      double emf = 0.0;
+      if (coil->moves && move_at == 0u && i_ma >= PULL_MA)
+      {
+        move_at = t_us;
+      }
+      if (move_at != 0u && t_us - move_at < MOVE_US)
+      {
+        const double x = (double)(t_us - move_at) / (double)MOVE_US;
+        emf = MOVE_EMF_V * 4.0 * x * (1.0 - x);   /// Скорость якоря - полуволна
+      }
+      i_ma += (drive_v - coil->r_ohm * i_ma / 1000.0 - emf) / coil->l_mh;   /// мА за 1 мкс
+      i_ma  = (i_ma < 0.0) ? 0.0 : i_ma;
+    }
+    while (n < samples && t_us * 1000u >= next_ns)
+    {
+      burst[n++] = adc_code(i_ma);
+      next_ns += VALVE_MON_SAMPLE_NS;
+    }
+  }
+}
+
+static MachineFault_t run(const Coil_t *coil)
+{
+  VALVE_GPIO_Port->BSRR = 0;
+  DMA2->HISR            = 0;
+  Valve_Monitor_Start(coil->opening);
+
+  CHECK_EQ(DMA2_Stream4->NDTR, VALVE_MON_SAMPLES);
+  CHECK(DMA2_Stream4->CR & DMA_SxCR_EN);
+  CHECK(ADC1->CR2 & ADC_CR2_CONT);
+  uint16_t *burst = (uint16_t *)(uintptr_t)DMA2_Stream4->M0AR;
+  coil_burst(coil, burst, VALVE_MON_SAMPLES);
+
+  DMA2->HISR = DMA_HISR_TCIF4;
+  CHECK_EQ(Valve_Monitor_DMA_IRQHandler(), 1u);
+  CHECK_EQ(ADC1->CR2, 0u);   /// АЦП остановлен до следующего фронта
+
+  const MachineFault_t fault = Valve_Monitor_Poll();
+  CHECK_EQ(Valve_Monitor_Poll(), FAULT_NONE);   /// Код выдаётся один раз
+  CHECK_EQ(VALVE_GPIO_Port->BSRR, (fault != FAULT_NONE) ? VALVE_Pin : 0u);
+  return fault;
+}
+
+int main(void)
+{
+  Valve_Monitor_Init();
+
+  printf("burst %u samples, %u us + analysis %u us <= %u us\n", VALVE_MON_SAMPLES, VALVE_MON_BURST_US,
+         VALVE_MON_ANALYSE_US, VALVE_MON_DETECT_MAX_US);
+  for (uint32_t repeat = 0; repeat < 20u; repeat++)   /// Разный шум АЦП
+  {
+    for (uint32_t i = 0; i < sizeof(coils) / sizeof(coils[0]); i++)
+    {
+      const MachineFault_t fault = run(&coils[i]);
+      if (fault != coils[i].expected)
+      {
+        fprintf(stderr, "%s: fault %d, expected %d\n", coils[i].name, (int)fault, (int)coils[i].expected);
+      }
+      CHECK_EQ(fault, coils[i].expected);
+    }
+  }
+
+  /// Прерывание без пачки - не её (его обрабатывает RoomSense)
+  CHECK_EQ(Valve_Monitor_DMA_IRQHandler(), 0u);
+
+  return HOST_TEST_RESULT("test_valve_monitor");
+}
@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""Hot-path benchmark results of an APP_BENCH build, checked against a baseline.
+
+The firmware (Core/Src/AppBench.c) prints one JSON object per line between
+"BENCH BEGIN" and "BENCH END" on USART1: a header with the core clock and
+the measurement overhead, then {"name", "runs", "min", "max"} in core
+cycles. The log comes from a serial terminal on the board or from the
+USART1 file backend of renode/7_seg_bench.resc (target bench).
+
+A benchmark regresses when its min or max grows by more than --threshold
+percent and more than --slack cycles over the baseline. Boards and Renode
+count cycles differently: keep a separate baseline for each. The host build
+(test/bench_host.c, target bench of the host tree) counts PC cycles, where
+the max only reflects scheduler noise: compare it with --min-only.
+
+With --calibrated the gate compares steps of the calibration loop instead of
+cycles: every figure is divided by the header "calib" (cycles of a loop of
+"calib_loops" dependent steps, measured in the same run) and multiplied by
+"calib_loops", for the report and the baseline alike. A baseline from another
+CPU or clock then still gates; raw cycles are only printed. --slack is in
+steps then.
+
+Several logs (repeated runs of the same build) are merged before the check:
+the median of the per-run minima and calibration loops, the largest max.
+One lucky or disturbed run then neither sets the baseline nor trips the gate.
+Benchmarks named with --info are printed but never fail the check (on the
+host isr_entry is a kernel signal delivery, not code of this tree).
+
+    python3 tools/bench_check.py bench.log --save bench.json
+    python3 tools/bench_check.py bench.log --baseline bench.json --threshold 10
+    python3 tools/bench_check.py host-*.log --baseline test/bench-host.json --min-only --calibrated
+"""
+
+import argparse
+import json
+import statistics
+import sys
+
+
+def parse_log(path):
+    """Header and {name: {runs, min, max}} of the last complete report in the log."""
+    header = None
+    results = None
+    current = None
+
+    with open(path, encoding="ascii", errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if line == "BENCH BEGIN":
+                current = {"header": None, "results": {}}
+            elif line == "BENCH END" and current is not None:
+                header, results = current["header"], current["results"]
+                current = None
+            elif current is not None and line.startswith("{"):
+                record = json.loads(line)
+                if "name" in record:
+                    name = record.pop("name")
+                    current["results"][name] = record
+                else:
+                    current["header"] = record
+
+    if results is None:
+        sys.exit(f"{path}: no complete BENCH BEGIN .. BENCH END report")
+    return {"header": header or {}, "results": results}
+
+
+def merge(reports):
+    """One report from repeated runs: median of min and of the header figures, largest max."""
+    if len(reports) == 1:
+        return reports[0]
+    header = dict(reports[0]["header"])
+    for key in ("overhead", "calib"):
+        values = [r["header"][key] for r in reports if key in r["header"]]
+        if values:
+            header[key] = round(statistics.median(values))
+    results = {}
+    for name in sorted({name for r in reports for name in r["results"]}):
+        runs = [r["results"][name] for r in reports if name in r["results"]]
+        results[name] = {"runs": sum(r["runs"] for r in runs),
+                         "min": round(statistics.median(r["min"] for r in runs)),
+                         "max": max(r["max"] for r in runs)}
+    return {"header": header, "results": results}
+
+
+def regressed(old, new, threshold, slack):
+    return new > old + slack and new > old * (1.0 + threshold / 100.0)
+
+
+def calibrated(report, path):
+    """Results in calibration-loop steps: {name: {runs, min, max}} scaled by calib_loops / calib."""
+    header = report["header"]
+    if not header.get("calib") or not header.get("calib_loops"):
+        sys.exit(f"{path}: no calibration loop in the header (report from an older build?)")
+    scale = header["calib_loops"] / header["calib"]
+    return {name: {"runs": r["runs"], "min": round(r["min"] * scale), "max": round(r["max"] * scale)}
+            for name, r in report["results"].items()}
+
+
+def compare(report, baseline, threshold, slack, min_only=False, calib=False, info=()):
+    """Print the comparison table and return the names that regressed."""
+    old_hclk = baseline["header"].get("hclk")
+    new_hclk = report["header"].get("hclk")
+    if old_hclk != new_hclk and not calib:
+        print(f"warning: core clock {old_hclk} in the baseline, {new_hclk} now")
+
+    new_results = report["results"]
+    old_results = baseline["results"]
+    if calib:
+        print(f"calibration loop: {report['header']['calib']} cycles now, "
+              f"{baseline['header'].get('calib')} in the baseline; figures in loop steps, raw = cycles now")
+        new_results = calibrated(report, "report")
+        old_results = calibrated(baseline, "baseline")
+
+    failed = []
+    print(f"{'benchmark':<36}{'min':>8}{'was':>8}{'max':>10}{'was':>8}{'delta':>9}"
+          + (f"{'raw min':>10}" if calib else ""))
+    for name in sorted(set(new_results) | set(old_results)):
+        new = new_results.get(name)
+        old = old_results.get(name)
+        if new is None:
+            print(f"{name:<36}{'':>8}{old['min']:>8}{'':>10}{old['max']:>8}  missing")
+            continue
+        if old is None:
+            print(f"{name:<36}{new['min']:>8}{'':>8}{new['max']:>10}{'':>8}  new")
+            continue
+
+        key = "min" if min_only else "max"
+        delta = 100.0 * (new[key] - old[key]) / old[key] if old[key] else 0.0
+        mark = "  info" if name in info else ""
+        if name not in info and (regressed(old["min"], new["min"], threshold, slack) or
+                                 (not min_only and regressed(old["max"], new["max"], threshold, slack))):
+            failed.append(name)
+            mark = "  REGRESSION"
+        raw = f"{report['results'][name]['min']:>10}" if calib else ""
+        print(f"{name:<36}{new['min']:>8}{old['min']:>8}{new['max']:>10}{old['max']:>8}"
+              f"{delta:>+8.1f}%{raw}{mark}")
+    return failed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log", nargs="+", help="USART1 output of the APP_BENCH build (several: repeated runs)")
+    parser.add_argument("--save", help="write the results as JSON (baseline for later runs)")
+    parser.add_argument("--baseline", help="JSON written by --save of an earlier run")
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed growth, percent")
+    parser.add_argument("--slack", type=int, default=4, help="growth ignored below this many cycles")
+    parser.add_argument("--min-only", action="store_true",
+                        help="check only the best case (host runs: the worst case is scheduler noise)")
+    parser.add_argument("--calibrated", action="store_true",
+                        help="compare in calibration-loop steps, not cycles (baseline from another machine)")
+    parser.add_argument("--info", action="append", default=[], metavar="NAME",
+                        help="print this benchmark, but do not gate on it (repeatable)")
+    args = parser.parse_args()
+
+    report = merge([parse_log(path) for path in args.log])
+
+    baseline = None
+    if args.baseline:
+        with open(args.baseline, encoding="utf-8") as f:
+            baseline = json.load(f)
+
+    if args.save:
+        with open(args.save, "w", encoding="utf-8") as f:
+            json.dump(report, f, indent=1, sort_keys=True)
+
+    if baseline is None:
+        print(f"{'benchmark':<36}{'runs':>8}{'min':>8}{'max':>10}")
+        for name, result in sorted(report["results"].items()):
+            print(f"{name:<36}{result['runs']:>8}{result['min']:>8}{result['max']:>10}")
+        return
+
+    failed = compare(report, baseline, args.threshold, args.slack, args.min_only, args.calibrated, args.info)
+    if failed:
+        sys.exit(f"{len(failed)} benchmark(s) over {args.threshold:g}% of the baseline: " + ", ".join(failed))
+
+
+if __name__ == "__main__":
+    main()
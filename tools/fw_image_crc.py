@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""Seal a firmware ELF: write image length and CRC32 into the .fw_footer section.
+
+The CRC matches the STM32F4 hardware CRC unit (and Core/Src/AppCrc.c):
+polynomial 0x04C11DB7, init 0xFFFFFFFF, 32-bit little-endian words fed
+MSB first, no reflection, no final XOR.
+
+The image is everything loaded into FLASH from its origin up to .fw_footer,
+with gaps filled with 0xFF exactly as they read back from erased flash.
+"""
+
+import argparse
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+
+FW_FOOTER_MAGIC = 0x46574352  # "FWCR", see Core/Inc/FwImageCheck.h
+CRC_POLY = 0x04C11DB7
+
+
+def _make_table():
+    table = []
+    for i in range(256):
+        c = i << 24
+        for _ in range(8):
+            c = ((c << 1) ^ CRC_POLY) if c & 0x80000000 else (c << 1)
+            c &= 0xFFFFFFFF
+        table.append(c)
+    return table
+
+
+_TABLE = _make_table()
+
+
+def stm32_crc32(data, crc=0xFFFFFFFF):
+    """CRC32 of data (length multiple of 4) as computed by the STM32 CRC unit."""
+    if len(data) % 4:
+        raise ValueError("data length must be a multiple of 4")
+    for (word,) in struct.iter_unpack("<I", data):
+        crc ^= word
+        for _ in range(4):
+            crc = ((crc << 8) & 0xFFFFFFFF) ^ _TABLE[crc >> 24]
+    return crc
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="linked firmware ELF, patched in place")
+    parser.add_argument("--objcopy", default="arm-none-eabi-objcopy")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp:
+        image_path = os.path.join(tmp, "image.bin")
+        footer_path = os.path.join(tmp, "footer.bin")
+
+        subprocess.check_call([args.objcopy, "-O", "binary", "--gap-fill", "0xFF",
+                               "-R", ".fw_footer", args.elf, image_path])
+        with open(image_path, "rb") as f:
+            image = f.read()
+
+        # .fw_footer is 4-byte aligned; pad the tail the same way the flash reads back
+        image += b"\xFF" * (-len(image) % 4)
+        crc = stm32_crc32(image)
+
+        with open(footer_path, "wb") as f:
+            f.write(struct.pack("<4I", FW_FOOTER_MAGIC, len(image), crc, crc ^ 0xFFFFFFFF))
+
+        subprocess.check_call([args.objcopy, "--update-section",
+                               ".fw_footer=" + footer_path, args.elf])
+
+    print("fw_image_crc: %s length=%d crc32=0x%08X" % (os.path.basename(args.elf), len(image), crc))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
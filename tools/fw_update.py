@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""Upload a firmware image to the 7_Seg_Boot bootloader over USART1.
+
+The image is the raw binary of the application linked for slot A
+(APP_BOOTLOADER=ON), e.g.:
+
+    arm-none-eabi-objcopy -O binary --gap-fill 0xFF 7_Seg.elf 7_Seg.bin
+    tools/fw_update.py --port /dev/ttyUSB0 7_Seg.bin
+
+Reset the board (or hold K1 during reset) right before running the tool:
+the bootloader listens for HELLO only for a short window after reset.
+Protocol: Boot/Inc/BootProto.h. An interrupted upload is resumed by simply
+running the tool again with the same image.
+
+Requires pyserial.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+import serial
+
+from fw_image_crc import stm32_crc32
+
+SYNC = 0xA5
+REPLY = 0x80
+CMD_HELLO, CMD_BEGIN, CMD_DATA, CMD_END, CMD_RESET = 1, 2, 3, 4, 5
+CHUNK = 256
+WINDOW = 4
+STATUS = {0: "OK", 1: "ERR_FRAME", 2: "ERR_STATE", 3: "ERR_ARGS", 4: "ERR_FLASH", 5: "ERR_IMAGE"}
+ST_OK, ST_ERR_STATE = 0, 2
+
+
+class BootError(Exception):
+    pass
+
+
+class Boot:
+    def __init__(self, port, timeout):
+        self.ser = serial.Serial(port, 115200, timeout=timeout)
+
+    def send(self, cmd, payload=b""):
+        head = struct.pack("<BBH", SYNC, cmd, len(payload))
+        self.ser.write(head + payload + struct.pack("<I", stm32_crc32(head + payload)))
+
+    def receive(self, cmd):
+        """Wait for the reply to cmd; returns its payload words or None on timeout."""
+        while True:
+            b = self.ser.read(1)
+            if not b:
+                return None
+            if b[0] != SYNC:
+                continue
+            rest = self.ser.read(3)
+            if len(rest) < 3:
+                return None
+            rcmd, length = rest[0], rest[1] | (rest[2] << 8)
+            body = self.ser.read(length + 4)
+            if len(body) < length + 4:
+                return None
+            head = bytes([SYNC]) + rest
+            (crc,) = struct.unpack_from("<I", body, length)
+            if crc != stm32_crc32(head + body[:length]) or rcmd != (cmd | REPLY):
+                continue
+            return struct.unpack("<%dI" % (length // 4), body[:length])
+
+    def call(self, cmd, payload=b"", retries=5):
+        for _ in range(retries):
+            self.send(cmd, payload)
+            reply = self.receive(cmd)
+            if reply is not None:
+                return reply
+        raise BootError("no reply to command %d" % cmd)
+
+
+def upload(boot, image):
+    status, version, state, slot_size, _ = boot.call(CMD_HELLO, retries=50)
+    print("bootloader v%d, state %d, slot %d bytes" % (version, state, slot_size))
+    if len(image) > slot_size:
+        raise BootError("image (%d bytes) does not fit the slot (%d bytes)" % (len(image), slot_size))
+
+    crc = stm32_crc32(image)
+    boot.ser.timeout = 5.0   # BEGIN erases a 128 KB sector
+    status, offset = boot.call(CMD_BEGIN, struct.pack("<II", len(image), crc), retries=1)
+    boot.ser.timeout = 1.0
+    if status == ST_ERR_STATE:
+        raise BootError("BEGIN: an install or trial is in progress (state %d), "
+                        "let the application confirm or roll back first" % state)
+    if status != ST_OK:
+        raise BootError("BEGIN: %s" % STATUS.get(status, status))
+    if offset:
+        print("resuming at %d" % offset)
+
+    # Sliding window: up to WINDOW frames in flight, the bootloader programs
+    # one chunk while the next ones are being received by DMA.
+    acked = offset
+    while acked < len(image):
+        in_flight = []
+        pos = acked
+        while len(in_flight) < WINDOW and pos < len(image):
+            chunk = image[pos:pos + CHUNK]
+            boot.send(CMD_DATA, struct.pack("<I", pos) + chunk)
+            in_flight.append(pos)
+            pos += len(chunk)
+        for _ in in_flight:
+            reply = boot.receive(CMD_DATA)
+            if reply is None:
+                break                         # lost frame or reply: resend from acked
+            status, next_offset = reply
+            if status not in (ST_OK, ST_ERR_STATE):
+                raise BootError("DATA: %s" % STATUS.get(status, status))
+            acked = max(acked, next_offset)
+            if status == ST_ERR_STATE:
+                break                         # a frame was skipped: resend from acked
+        boot.ser.reset_input_buffer()
+        print("\r%6d / %d" % (acked, len(image)), end="", flush=True)
+    print()
+
+    boot.ser.timeout = 2.0
+    (status,) = boot.call(CMD_END, retries=1)
+    if status != ST_OK:
+        raise BootError("END: %s" % STATUS.get(status, status))
+    print("image accepted (crc32=0x%08X), bootloader is installing it" % crc)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("image", help="raw binary linked for slot A")
+    parser.add_argument("--port", required=True)
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as f:
+        image = f.read()
+    image += b"\xFF" * (-len(image) % 4)
+
+    boot = Boot(args.port, timeout=0.1)
+    start = time.time()
+    try:
+        upload(boot, image)
+    except BootError as e:
+        print("fw_update: %s" % e, file=sys.stderr)
+        return 1
+    print("done in %.1f s" % (time.time() - start))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""Minimal Modbus RTU master for the controller's slave (Core/Src/ModbusRtu.c).
+
+Talks to a serial device (USB RS-485 adapter, or a pseudo-terminal when the
+frame handler runs on the host) with plain termios, no pyserial needed.
+
+  python3 tools/modbus_master.py /dev/ttyUSB0 status
+  python3 tools/modbus_master.py /dev/ttyUSB0 set-time 5
+  python3 tools/modbus_master.py /dev/ttyUSB0 raw 01 04 00 00 00 02
+
+Register map must match Core/Inc/ModbusRtu.h.
+"""
+
+import argparse
+import os
+import select
+import struct
+import sys
+import termios
+import time
+
+INPUT_REGS = [
+    "state", "valve", "cur_sec", "fault", "over_temp", "rh_dpct", "valve_opens",
+    "frames", "crc_errors", "exceptions", "overruns", "temp_dc",
+]
+HOLDING_REGS = ["cfg_sec"]
+STATES = {0: "READY", 1: "COUNTDOWN", 2: "CONFIG", 3: "FAULT", 4: "AUTO"}
+EXCEPTIONS = {1: "illegal function", 2: "illegal address", 3: "illegal value", 6: "device busy"}
+SIGNED = {"rh_dpct", "temp_dc"}
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+def frame(pdu):
+    return pdu + struct.pack("<H", crc16(pdu))
+
+
+class ModbusError(Exception):
+    pass
+
+
+class Port:
+    BAUDS = {9600: termios.B9600, 19200: termios.B19200, 38400: termios.B38400,
+             57600: termios.B57600, 115200: termios.B115200}
+
+    def __init__(self, path, baud, timeout):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        self.timeout = timeout
+        attrs = termios.tcgetattr(self.fd)
+        attrs[0] = 0                                        # iflag: raw
+        attrs[1] = 0                                        # oflag: raw
+        attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+        attrs[3] = 0                                        # lflag: no echo, no canonical mode
+        attrs[4] = attrs[5] = self.BAUDS[baud]
+        termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+        termios.tcflush(self.fd, termios.TCIOFLUSH)
+        # t3.5 is fixed at 1.75 ms above 19200 baud; the slave answers on IDLE (1 char)
+        self.gap = 0.00175 if baud > 19200 else 3.5 * 11 / baud
+
+    def transact(self, request):
+        os.write(self.fd, request)
+        reply = b""
+        deadline = time.monotonic() + self.timeout
+        while True:
+            wait = deadline - time.monotonic() if not reply else self.gap * 4
+            if wait <= 0 or not select.select([self.fd], [], [], wait)[0]:
+                break
+            reply += os.read(self.fd, 256)
+        return reply
+
+
+def request(port, address, pdu):
+    reply = port.transact(frame(bytes([address]) + pdu))
+    if address == 0:
+        return b""
+    if len(reply) < 5:
+        raise ModbusError(f"timeout ({len(reply)} bytes)")
+    if crc16(reply[:-2]) != struct.unpack("<H", reply[-2:])[0]:
+        raise ModbusError("bad CRC in reply")
+    if reply[0] != address:
+        raise ModbusError(f"reply from address {reply[0]}")
+    if reply[1] & 0x80:
+        raise ModbusError(f"exception {reply[2]}: {EXCEPTIONS.get(reply[2], '?')}")
+    return reply[1:-2]
+
+
+def read(port, address, function, first, count):
+    pdu = request(port, address, struct.pack(">BHH", function, first, count))
+    return list(struct.unpack(f">{count}H", pdu[2:2 + 2 * count]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port", help="serial device or pty")
+    parser.add_argument("--address", type=int, default=1, help="slave address (MODBUS_SLAVE_ADDR)")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=0.5, help="reply timeout, s")
+    sub = parser.add_subparsers(dest="command", required=True)
+    sub.add_parser("status", help="read all input and holding registers")
+    set_time = sub.add_parser("set-time", help="write cfg_sec (holding 0)")
+    set_time.add_argument("seconds", type=int)
+    raw = sub.add_parser("raw", help="send address + PDU bytes (hex), print the reply")
+    raw.add_argument("bytes", nargs="+")
+    args = parser.parse_args()
+
+    port = Port(args.port, args.baud, args.timeout)
+    try:
+        if args.command == "status":
+            count = len(INPUT_REGS)
+            try:
+                values = read(port, args.address, 0x04, 0, count)
+            except ModbusError:
+                count -= 1                                  # no temp_dc without ROOM_SENSE
+                values = read(port, args.address, 0x04, 0, count)
+            for name, value in zip(INPUT_REGS, values):
+                if name in SIGNED and value >= 0x8000:
+                    value -= 0x10000
+                note = f"  ({STATES.get(value, '?')})" if name == "state" else ""
+                print(f"input   {name:<11} {value}{note}")
+            for name, value in zip(HOLDING_REGS, read(port, args.address, 0x03, 0, len(HOLDING_REGS))):
+                print(f"holding {name:<11} {value}")
+        elif args.command == "set-time":
+            request(port, args.address, struct.pack(">BHH", 0x06, 0, args.seconds))
+            print(f"cfg_sec = {args.seconds}")
+        else:
+            data = bytes(int(b, 16) for b in args.bytes)
+            print(port.transact(frame(data)).hex(" "))
+    except ModbusError as error:
+        print(f"error: {error}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""Worst-case response table of the superloop and CMSIS-RTOS2 builds, checked against a baseline.
+
+test/profile_host.c runs the whole firmware on the host in model time (target
+profile_host_superloop and profile_host_rtos2) and prints the App_Profile table
+between "PROFILE BEGIN" and "PROFILE END": a header with the core clock and the
+calibration loop (as in the AppBench.c report), then one JSON object per task
+{"build", "task", "runs", "worst_response", "worst_exec"} in model cycles, which
+are PC cycles of the real calls.
+
+Several logs per build (repeated runs) are merged by the median of each figure,
+the calibration loop included. The table puts the two builds side by side; with
+--baseline a task regresses when its worst response or execution grows by more
+than --threshold percent and more than --slack. With --calibrated the figures are
+compared in steps of the calibration loop, so a baseline from another machine
+still gates (see tools/bench_check.py).
+
+    python3 tools/profile_table.py superloop-*.log rtos2-*.log --save profile.json
+    python3 tools/profile_table.py *.log --baseline test/profile-host.json --calibrated
+"""
+
+import argparse
+import json
+import statistics
+import sys
+
+BUILDS = ("superloop", "rtos2")
+TASKS = ("input", "control", "telemetry", "persist")
+FIGURES = ("worst_response", "worst_exec")
+
+
+def parse_log(path):
+    """Header and {"build/task": record} of the last complete report in the log."""
+    header = None
+    results = None
+    current = None
+
+    with open(path, encoding="ascii", errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if line == "PROFILE BEGIN":
+                current = {"header": None, "results": {}}
+            elif line == "PROFILE END" and current is not None:
+                header, results = current["header"], current["results"]
+                current = None
+            elif current is not None and line.startswith("{"):
+                record = json.loads(line)
+                if "task" in record:
+                    name = f"{record.pop('build')}/{record.pop('task')}"
+                    current["results"][name] = record
+                else:
+                    current["header"] = record
+
+    if results is None:
+        sys.exit(f"{path}: no complete PROFILE BEGIN .. PROFILE END report")
+    return {"header": header or {}, "results": results}
+
+
+def merge(reports):
+    """One report from all runs of both builds: the median of every figure."""
+    header = dict(reports[0]["header"])
+    calib = [r["header"]["calib"] for r in reports if "calib" in r["header"]]
+    if calib:
+        header["calib"] = round(statistics.median(calib))
+    results = {}
+    for name in sorted({name for r in reports for name in r["results"]}):
+        runs = [r["results"][name] for r in reports if name in r["results"]]
+        results[name] = {key: round(statistics.median(run[key] for run in runs))
+                         for key in ("runs",) + FIGURES}
+    return {"header": header, "results": results}
+
+
+def scaled(report, calibrated):
+    """Results in calibration-loop steps (--calibrated) or as they are."""
+    header = report["header"]
+    if not calibrated:
+        return report["results"]
+    if not header.get("calib") or not header.get("calib_loops"):
+        sys.exit("no calibration loop in the report header")
+    scale = header["calib_loops"] / header["calib"]
+    return {name: dict(r, **{key: round(r[key] * scale) for key in FIGURES})
+            for name, r in report["results"].items()}
+
+
+def print_table(report):
+    """Tasks in rows, both builds side by side: worst response and execution, cycles and microseconds."""
+    hclk = report["header"].get("hclk", 20000000)
+    per_us = hclk / 1000000
+    results = report["results"]
+    print(f"{'task':<12}" + "".join(f"{build + ' response':>22}{'exec':>10}" for build in BUILDS))
+    for task in TASKS:
+        row = f"{task:<12}"
+        for build in BUILDS:
+            r = results.get(f"{build}/{task}")
+            if r is None:
+                row += f"{'-':>22}{'-':>10}"
+                continue
+            row += f"{r['worst_response']:>12} ({r['worst_response'] / per_us:>6.1f} us){r['worst_exec']:>10}"
+        print(row)
+
+
+def regressed(old, new, threshold, slack):
+    return new > old + slack and new > old * (1.0 + threshold / 100.0)
+
+
+def compare(report, baseline, threshold, slack, calibrated):
+    """Print the growth over the baseline and return the tasks that regressed."""
+    new_results = scaled(report, calibrated)
+    old_results = scaled(baseline, calibrated)
+    if calibrated:
+        print(f"calibration loop: {report['header']['calib']} cycles now, "
+              f"{baseline['header'].get('calib')} in the baseline; figures in loop steps")
+
+    failed = []
+    print(f"{'task':<22}{'response':>10}{'was':>10}{'exec':>10}{'was':>10}")
+    for name in sorted(set(new_results) | set(old_results)):
+        new = new_results.get(name)
+        old = old_results.get(name)
+        if new is None or old is None:
+            print(f"{name:<22}  {'missing' if new is None else 'new'}")
+            continue
+        mark = ""
+        if any(regressed(old[key], new[key], threshold, slack) for key in FIGURES):
+            failed.append(name)
+            mark = "  REGRESSION"
+        print(f"{name:<22}{new['worst_response']:>10}{old['worst_response']:>10}"
+              f"{new['worst_exec']:>10}{old['worst_exec']:>10}{mark}")
+    return failed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log", nargs="+", help="output of profile_host_superloop / profile_host_rtos2 (repeated runs)")
+    parser.add_argument("--save", help="write the merged table as JSON (baseline for later runs)")
+    parser.add_argument("--baseline", help="JSON written by --save of an earlier run")
+    parser.add_argument("--threshold", type=float, default=25.0, help="allowed growth, percent")
+    parser.add_argument("--slack", type=int, default=50, help="growth ignored below this many cycles (steps)")
+    parser.add_argument("--calibrated", action="store_true",
+                        help="compare in calibration-loop steps, not cycles (baseline from another machine)")
+    args = parser.parse_args()
+
+    report = merge([parse_log(path) for path in args.log])
+    print_table(report)
+
+    if args.save:
+        with open(args.save, "w", encoding="utf-8") as f:
+            json.dump(report, f, indent=1, sort_keys=True)
+
+    if args.baseline:
+        with open(args.baseline, encoding="utf-8") as f:
+            baseline = json.load(f)
+        failed = compare(report, baseline, args.threshold, args.slack, args.calibrated)
+        if failed:
+            sys.exit(f"{len(failed)} task(s) over {args.threshold:g}% of the baseline: " + ", ".join(failed))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""RAM cost of the code executed from SRAM (.ramfunc) and calls leaving it.
+
+With APP_RAMFUNC (Core/Inc/AppRamFunc.h) the TIM3 multiplex interrupt, the
+SysTick button step and the flash busy loops are linked into the .ramfunc
+output section: stored in flash, copied to RAM by the startup code. They
+keep running while a flash sector is erased only if nothing they execute
+is fetched from flash.
+
+The report lists every function and table of .ramfunc with its size (each
+byte costs the same in RAM and, as the load copy, in flash) and checks the
+disassembly: a direct branch or call to an address outside .ramfunc, or a
+linker veneer inside it, would stall on the flash during an erase and fails
+the check (exit code 1). Indirect calls (blx rN) are counted, not checked.
+
+    python3 tools/ramfunc_report.py build/Release/7_Seg.elf
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+SECTION = ".ramfunc"
+
+_SYMBOL = re.compile(r"^([0-9a-fA-F]+)\s+\S+\s+([FO])\s+(\S+)\s+([0-9a-fA-F]+)\s+(\S+)$")
+_HEADER = re.compile(r"^\s*\d+\s+(\S+)\s+([0-9a-fA-F]+)\s+([0-9a-fA-F]+)\s+([0-9a-fA-F]+)")
+_FUNCTION = re.compile(r"^[0-9a-fA-F]+ <(\S+)>:\s*$")
+_BRANCH = re.compile(r"^\s*([0-9a-fA-F]+):\s+(b[a-z]*)(?:\.[nw])?\s+(?:\S+,\s*)?([0-9a-fA-F]+)\s+<([^>]+)>")
+_INDIRECT = re.compile(r"^\s*[0-9a-fA-F]+:\s+blx\s+r\d+")
+
+
+def _objdump(objdump, *args):
+    return subprocess.run([objdump, *args], check=True, capture_output=True, text=True).stdout
+
+
+def section_range(objdump, elf):
+    """(VMA, LMA, size) of .ramfunc, None when the ELF has no such section."""
+    for line in _objdump(objdump, "-h", elf).splitlines():
+        match = _HEADER.match(line)
+        if match and match.group(1) == SECTION:
+            size, vma, lma = (int(match.group(i), 16) for i in (2, 3, 4))
+            return vma, lma, size
+    return None
+
+
+def symbols(objdump, elf):
+    """[(name, kind, size)] of the functions and objects in .ramfunc, largest first."""
+    found = []
+    for line in _objdump(objdump, "-t", "-j", SECTION, elf).splitlines():
+        match = _SYMBOL.match(line.strip())
+        if match and match.group(3) == SECTION:
+            kind = "code" if match.group(2) == "F" else "table"
+            found.append((match.group(5), kind, int(match.group(4), 16)))
+    return sorted(found, key=lambda item: -item[2])
+
+
+def leaving_calls(objdump, elf, start, end):
+    """([(function, instruction, target)] leaving [start, end), indirect call count)."""
+    leaving = []
+    indirect = 0
+    current = None
+    for line in _objdump(objdump, "-d", "--no-show-raw-insn", "-j", SECTION, elf).splitlines():
+        match = _FUNCTION.match(line)
+        if match:
+            current = match.group(1)
+            if current.endswith("_veneer"):
+                leaving.append((current, "veneer", current))
+            continue
+        if _INDIRECT.match(line):
+            indirect += 1
+            continue
+        match = _BRANCH.match(line)
+        if match and not start <= int(match.group(3), 16) < end:
+            leaving.append((current or "?", match.group(2), match.group(4)))
+    return leaving, indirect
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="firmware ELF linked with APP_RAMFUNC")
+    parser.add_argument("--objdump", default="arm-none-eabi-objdump", help="objdump executable")
+    args = parser.parse_args()
+
+    layout = section_range(args.objdump, args.elf)
+    if layout is None or layout[2] == 0:
+        print(f"{args.elf}: no {SECTION} code, nothing runs from RAM")
+        return
+    vma, lma, size = layout
+
+    print(f"{SECTION}: {size} bytes at 0x{vma:08X} (RAM), load copy at 0x{lma:08X} (flash)")
+    print(f"{'symbol':<40}{'kind':>8}{'bytes':>8}")
+    listed = 0
+    for name, kind, nbytes in symbols(args.objdump, args.elf):
+        print(f"{name:<40}{kind:>8}{nbytes:>8}")
+        listed += nbytes
+    if listed != size:
+        print(f"{'(literal pools, padding)':<40}{'':>8}{size - listed:>8}")
+
+    leaving, indirect = leaving_calls(args.objdump, args.elf, vma, vma + size)
+    if indirect:
+        print(f"\n{indirect} indirect call(s): targets not checked")
+    if leaving:
+        print()
+        for function, insn, target in leaving:
+            print(f"{function:<40} {insn:<8} -> {target} (flash)")
+        sys.exit(f"{len(leaving)} branch(es) from {SECTION} into flash: "
+                 "the callee stalls while a sector is erased")
+
+
+if __name__ == "__main__":
+    main()
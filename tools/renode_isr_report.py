@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Instruction counts of the hot interrupt handlers from a Renode PC trace.
+
+The trace is written by the "trace" macro of renode/7_seg.resc
+(cpu CreateExecutionTracing ... PC): one executed address per line.
+Every address is attributed to the function containing it (symbols of
+the same ELF via nm). For each handler the report gives the number of
+entries and the instructions per entry, counting the handler together
+with the functions it calls (ISR_CHAINS). A callee also used outside
+the handler is counted in full, so chains are an upper bound.
+
+    python3 tools/renode_isr_report.py build/Release/7_Seg.elf 7_seg_trace.txt
+"""
+
+import argparse
+import bisect
+import re
+import subprocess
+import sys
+from collections import Counter
+
+ISR_CHAINS = {
+    "TIM3_IRQHandler": ("HAL_TIM_IRQHandler", "HAL_TIM_PeriodElapsedCallback", "Seg7_UpdateIndicator"),
+    "SysTick_Handler": ("HAL_IncTick", "HAL_SYSTICK_IRQHandler", "HAL_SYSTICK_Callback", "Button_Poll_1ms"),
+    "USART6_IRQHandler": ("Modbus_IRQHandler",),
+    "DMA2_Stream4_IRQHandler": (),
+    "TIM4_IRQHandler": (),
+}
+
+_NM_LINE = re.compile(r"^([0-9a-fA-F]+)\s+([0-9a-fA-F]+)\s+[tTwW]\s+(\S+)$")
+_PC = re.compile(r"(?:0x)?([0-9a-fA-F]+)")
+
+
+def load_functions(nm, elf):
+    """Sorted (start, end, name) of the functions in the ELF."""
+    out = subprocess.run([nm, "-S", "-n", "--defined-only", elf],
+                         check=True, capture_output=True, text=True).stdout
+    functions = []
+    for line in out.splitlines():
+        match = _NM_LINE.match(line.strip())
+        if match:
+            start = int(match.group(1), 16) & ~1  # Thumb bit
+            functions.append((start, start + int(match.group(2), 16), match.group(3)))
+    functions.sort()
+    return functions
+
+
+def count(trace, functions):
+    """Per function: executed instructions and entries (PC at its first instruction)."""
+    starts = [f[0] for f in functions]
+    executed = Counter()
+    entries = Counter()
+
+    with open(trace, encoding="ascii", errors="replace") as f:
+        for line in f:
+            match = _PC.match(line.strip())
+            if not match:
+                continue
+            pc = int(match.group(1), 16)
+            i = bisect.bisect_right(starts, pc) - 1
+            if i < 0 or pc >= functions[i][1]:
+                continue
+            name = functions[i][2]
+            executed[name] += 1
+            if pc == functions[i][0]:
+                entries[name] += 1
+    return executed, entries
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="the ELF that produced the trace")
+    parser.add_argument("trace", help="Renode execution trace (PC format)")
+    parser.add_argument("--nm", default="arm-none-eabi-nm", help="nm executable")
+    parser.add_argument("--top", type=int, default=10, help="also list the N busiest functions")
+    args = parser.parse_args()
+
+    functions = load_functions(args.nm, args.elf)
+    if not functions:
+        sys.exit(f"{args.elf}: no function symbols")
+    executed, entries = count(args.trace, functions)
+    total = sum(executed.values())
+    if total == 0:
+        sys.exit(f"{args.trace}: no addresses inside {args.elf}")
+
+    print(f"{'handler':<28}{'entries':>10}{'insns':>12}{'per entry':>12}{'share':>8}")
+    for root, callees in ISR_CHAINS.items():
+        if not entries[root]:
+            continue
+        insns = executed[root] + sum(executed[c] for c in callees)
+        print(f"{root:<28}{entries[root]:>10}{insns:>12}{insns / entries[root]:>12.1f}"
+              f"{100.0 * insns / total:>7.1f}%")
+
+    print()
+    print(f"{'function':<40}{'entries':>10}{'insns':>12}{'share':>8}")
+    for name, insns in executed.most_common(args.top):
+        print(f"{name:<40}{entries[name]:>10}{insns:>12}{100.0 * insns / total:>7.1f}%")
+    print(f"{'total':<40}{'':>10}{total:>12}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,269 @@
+#!/usr/bin/env python3
+"""Per-module size budgets of a firmware link, with a size history.
+
+Every input section of the GNU ld map is attributed to a module and a
+group: Core/<file> (application, startup), Boot/<file>, HAL/<file>,
+CMSIS-DSP/<file>, RTX/<file> and lib/<archive> (libc, libgcc, libm).
+Sizes are split into text, rodata, data (stored in flash and copied to
+RAM, including the RAM code of .ramfunc) and bss.
+
+The build fails (exit code 1) when
+  - a budget of tools/size_budget.json is exceeded: the sum over all
+    modules matching a pattern ("HAL/*", "CMSIS-DSP/arm_common_tables*"),
+    flash and RAM separately;
+  - a module with flash or RAM bytes matches no budget pattern (every
+    group linked into the image needs an entry);
+  - the image (last byte loaded into FLASH, including the .data copy and
+    the CRC footer) ends past the FLASH region, i.e. reaches the config
+    sector FLASH_CFG_ADDR (slot B with the bootloader).
+
+With --history every link appends group totals to a JSON-lines file and
+prints the change against the previous entry.
+
+    python3 tools/size_budget.py --map build/Release/7_Seg.map \\
+        --budget tools/size_budget.json --history build/Release/size_history.jsonl
+"""
+
+import argparse
+import datetime
+import fnmatch
+import json
+import os
+import re
+import subprocess
+import sys
+
+from size_report import map_sections, _module
+
+KINDS = ("text", "rodata", "data", "bss")
+_RAM_BASE = 0x20000000  # loaded sections below it (and above the FLASH origin) are in flash
+
+_REGION = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+_OUTPUT = re.compile(r"^(\.\S+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+load address 0x([0-9a-fA-F]+))?\s*$")
+_OUTPUT_NAME_ONLY = re.compile(r"^(\.\S+)\s*$")
+
+
+def _kind(section):
+    """Which of KINDS an input section counts as (None - not loaded)."""
+    if section.startswith((".text", ".isr_vector", ".ARM", ".glue", ".vfp11", ".fw_footer")):
+        return "text"
+    if section.startswith(".rodata"):
+        return "rodata"
+    if section.startswith((".data", ".ramfunc", ".RamFunc", ".tdata")):
+        return "data"
+    if section.startswith((".bss", "COMMON", ".noinit", ".tbss")):
+        return "bss"
+    return None
+
+
+def _group(obj):
+    """Group of an object file path as printed in the map."""
+    path = obj.replace("\\", "/")
+    name = os.path.basename(path)
+    if ".a(" in name:
+        return "lib", name[: name.index("(")]
+    module = _module(path)
+    if "/STM32F4xx_HAL_Driver/" in path or module.startswith(("stm32f4xx_hal", "stm32f4xx_ll")):
+        return "HAL", module
+    if "/DSP/" in path or module.startswith("arm_"):
+        return "CMSIS-DSP", module
+    if module.startswith(("rtx_", "RTX_Config", "irq_armv7m", "os_systick")):
+        return "RTX", module
+    if "/Boot/" in path:
+        return "Boot", module
+    return "Core", module
+
+
+def parse_modules(path):
+    """{"<group>/<module>": {kind: bytes}}."""
+    modules = {}
+    for section, _, size, obj in map_sections(path):
+        kind = _kind(section)
+        if kind is None or not size:
+            continue
+        group, module = _group(obj)
+        entry = modules.setdefault(f"{group}/{module}", dict.fromkeys(KINDS, 0))
+        entry[kind] += size
+    return modules
+
+
+def flash_ram(sizes):
+    """(flash, ram) bytes: .data is stored in flash and occupies RAM."""
+    return (sizes["text"] + sizes["rodata"] + sizes["data"],
+            sizes["data"] + sizes["bss"])
+
+
+def parse_layout(path):
+    """(FLASH origin, FLASH end, end of the last section loaded into FLASH)."""
+    regions = {}
+    image_end = 0
+    in_regions = False
+    in_map = False
+    pending = None
+
+    with open(path, encoding="utf-8", errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if line.startswith("Memory Configuration"):
+                in_regions = True
+                continue
+            if line.startswith("Linker script and memory map"):
+                in_regions = False
+                in_map = True
+                continue
+            if in_regions:
+                match = _REGION.match(line)
+                if match:
+                    regions[match.group(1)] = (int(match.group(2), 16), int(match.group(3), 16))
+                continue
+            if not in_map:
+                continue
+
+            # Output sections start in column 0; a long name is alone on its line
+            name_only = _OUTPUT_NAME_ONLY.match(line)
+            if name_only:
+                pending = name_only.group(1)
+                continue
+            match = _OUTPUT.match(line)
+            name = match.group(1) if match else None
+            if match and (name or (pending and line.startswith(" "))):
+                address = int(match.group(4) or match.group(2), 16)
+                size = int(match.group(3), 16)
+                if "FLASH" in regions and size and regions["FLASH"][0] <= address < _RAM_BASE:
+                    image_end = max(image_end, address + size)
+            pending = None
+
+    if "FLASH" not in regions:
+        sys.exit(f"{path}: no FLASH region in the memory configuration")
+    origin, length = regions["FLASH"]
+    return origin, origin + length, image_end
+
+
+def check_budgets(modules, budget):
+    """Print the budget table and return the exceeded budgets."""
+    failed = []
+    print(f"{'budget':<36}{'flash':>8}{'limit':>8}{'ram':>8}{'limit':>8}")
+    patterns = sorted(set(budget.get("flash", {})) | set(budget.get("ram", {})))
+    for pattern in patterns:
+        used = [0, 0]
+        for name, sizes in modules.items():
+            if fnmatch.fnmatchcase(name, pattern):
+                flash, ram = flash_ram(sizes)
+                used[0] += flash
+                used[1] += ram
+        limits = (budget.get("flash", {}).get(pattern), budget.get("ram", {}).get(pattern))
+        marks = []
+        for value, limit, what in zip(used, limits, ("flash", "ram")):
+            if limit is not None and value > limit:
+                failed.append(f"{pattern} {what} {value} > {limit}")
+                marks.append(what)
+        print(f"{pattern:<36}{used[0]:>8}{limits[0] if limits[0] is not None else '-':>8}"
+              f"{used[1]:>8}{limits[1] if limits[1] is not None else '-':>8}"
+              + ("  OVER: " + ", ".join(marks) if marks else ""))
+    for name, sizes in sorted(modules.items()):
+        if any(flash_ram(sizes)) and not any(fnmatch.fnmatchcase(name, p) for p in patterns):
+            failed.append(f"{name} matches no budget pattern")
+    return failed
+
+
+def print_modules(modules, top):
+    print(f"{'module':<36}" + "".join(f"{k:>8}" for k in KINDS) + f"{'flash':>8}{'ram':>8}")
+    ordered = sorted(modules.items(), key=lambda item: -flash_ram(item[1])[0])
+    for name, sizes in ordered[:top]:
+        flash, ram = flash_ram(sizes)
+        print(f"{name:<36}" + "".join(f"{sizes[k]:>8}" for k in KINDS) + f"{flash:>8}{ram:>8}")
+
+
+def group_totals(modules):
+    groups = {}
+    for name, sizes in modules.items():
+        entry = groups.setdefault(name.split("/", 1)[0], [0, 0])
+        flash, ram = flash_ram(sizes)
+        entry[0] += flash
+        entry[1] += ram
+    return groups
+
+
+def _commit():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    try:
+        return subprocess.run(["git", "-C", root, "rev-parse", "--short", "HEAD"],
+                              check=True, capture_output=True, text=True).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def update_history(path, groups, headroom):
+    """Print the change against the last entry and append this link unless it is the same."""
+    last = None
+    if os.path.exists(path):
+        with open(path, encoding="utf-8") as f:
+            lines = [line for line in f if line.strip()]
+        if lines:
+            last = json.loads(lines[-1])
+
+    entry = {
+        "time": datetime.datetime.now().isoformat(timespec="seconds"),
+        "commit": _commit(),
+        "flash": sum(v[0] for v in groups.values()),
+        "ram": sum(v[1] for v in groups.values()),
+        "headroom": headroom,
+        "groups": groups,
+    }
+
+    print()
+    if last is None:
+        print(f"history: first entry, flash {entry['flash']}, ram {entry['ram']}")
+    else:
+        print(f"history: against {last.get('commit') or '?'} ({last['time']})")
+        for name in sorted(set(groups) | set(last["groups"])):
+            now = groups.get(name, [0, 0])
+            was = last["groups"].get(name, [0, 0])
+            if now != was:
+                print(f"  {name:<16} flash {now[0] - was[0]:+d}  ram {now[1] - was[1]:+d}")
+        print(f"  {'total':<16} flash {entry['flash'] - last['flash']:+d}  ram {entry['ram'] - last['ram']:+d}")
+        if last["groups"] == groups and last.get("commit") == entry["commit"]:
+            return
+
+    with open(path, "a", encoding="utf-8") as f:
+        f.write(json.dumps(entry, sort_keys=True) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--map", required=True, help="GNU ld map file of the link")
+    parser.add_argument("--budget", help="JSON with flash/ram budgets per module pattern")
+    parser.add_argument("--history", help="JSON-lines file the totals of every link are appended to")
+    parser.add_argument("--top", type=int, default=12, help="list the N largest modules")
+    args = parser.parse_args()
+
+    modules = parse_modules(args.map)
+    if not modules:
+        sys.exit(f"{args.map}: no memory map found")
+    origin, flash_end, image_end = parse_layout(args.map)
+    headroom = flash_end - image_end
+
+    print_modules(modules, args.top)
+    print()
+    print(f"image 0x{origin:08X}..0x{image_end:08X}, FLASH ends at 0x{flash_end:08X}: "
+          f"{headroom} bytes left")
+
+    failed = []
+    if headroom < 0:
+        failed.append(f"image ends {-headroom} bytes past the FLASH region (config sector)")
+
+    if args.budget:
+        with open(args.budget, encoding="utf-8") as f:
+            budget = json.load(f)
+        print()
+        failed += check_budgets(modules, budget)
+
+    if args.history:
+        update_history(args.history, group_totals(modules), headroom)
+
+    if failed:
+        sys.exit("size budget exceeded:\n  " + "\n  ".join(failed))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+"""Size and hot-path report of a firmware ELF, optionally against a baseline build.
+
+Size is taken from the GNU ld map file: every input section placed into
+memory is attributed to its object file, so HAL drivers, application
+modules and libc show up separately. FLASH counts .text/.rodata/.data
+(initialised data is stored in flash), RAM counts .data/.bss.
+
+Latency is estimated statically from the disassembly of the hot functions
+(button step, multiplex interrupt, state machine, config save): the number
+of instructions and of out-of-line calls (bl/blx). A register-level layer
+shows up as fewer calls in the same function.
+
+Typical use (see APP_LL_* options in CMakeLists.txt):
+
+    cmake --build build/Release-hal --target size_report   # writes size_report.json
+    cmake -B build/Release -DSIZE_REPORT_BASELINE=build/Release-hal/size_report.json
+    cmake --build build/Release --target size_report        # prints the deltas
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+
+HOT_FUNCTIONS = (
+    "TIM3_IRQHandler",
+    "HAL_TIM_PeriodElapsedCallback",
+    "HAL_SYSTICK_Callback",
+    "Button_Poll_1ms",
+    "Machine_Process",
+    "APP_Save_CFG_Flash",
+)
+
+_SECTION = re.compile(r"^ (\.\S+|COMMON)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S+)\s*$")
+_SECTION_NAME_ONLY = re.compile(r"^ (\.\S+|COMMON)\s*$")
+_SECTION_TAIL = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S+)\s*$")
+_FUNCTION = re.compile(r"^[0-9a-fA-F]+ <(\S+)>:\s*$")
+_CALL = re.compile(r"\sblx?\s")
+
+
+def _module(path):
+    """Object file name without directories and build suffixes."""
+    name = os.path.basename(path)
+    for suffix in (".obj", ".o"):
+        if name.endswith(suffix):
+            name = name[: -len(suffix)]
+    return name
+
+
+def _memory(section):
+    """(flash, ram) weights of an input section."""
+    if section.startswith((".text", ".rodata", ".isr_vector", ".ARM", ".fw_footer")):
+        return 1, 0
+    if section.startswith((".data", ".ramfunc", ".RamFunc")):
+        return 1, 1
+    if section.startswith((".bss", "COMMON", ".noinit")):
+        return 0, 1
+    return 0, 0
+
+
+def map_sections(path):
+    """(section, address, size, object) of every input section placed into memory."""
+    in_map = False
+    pending = None
+
+    with open(path, encoding="utf-8", errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if not in_map:
+                in_map = line.startswith("Linker script and memory map")
+                continue
+
+            match = _SECTION.match(line)
+            if match:
+                section, address, size, obj = match.groups()
+            elif pending is not None and _SECTION_TAIL.match(line):
+                section = pending
+                address, size, obj = _SECTION_TAIL.match(line).groups()
+            else:
+                name_only = _SECTION_NAME_ONLY.match(line)
+                pending = name_only.group(1) if name_only else None
+                continue
+            pending = None
+
+            if int(address, 16) == 0:
+                continue  # debug info and discarded sections
+            yield section, int(address, 16), int(size, 16), obj
+
+
+def parse_map(path):
+    """{module: [flash, ram]} from the memory map part of a GNU ld map file."""
+    modules = {}
+    for section, _, size, obj in map_sections(path):
+        flash, ram = _memory(section)
+        entry = modules.setdefault(_module(obj), [0, 0])
+        entry[0] += size * flash
+        entry[1] += size * ram
+    return modules
+
+
+def parse_hot(objdump, elf, functions):
+    """{function: [instructions, calls]} from the disassembly."""
+    out = subprocess.run([objdump, "-d", "--no-show-raw-insn", elf],
+                         check=True, capture_output=True, text=True).stdout
+    hot = {}
+    current = None
+    for line in out.splitlines():
+        match = _FUNCTION.match(line)
+        if match:
+            current = match.group(1) if match.group(1) in functions else None
+            if current:
+                hot[current] = [0, 0]
+            continue
+        if current is None or not line.strip():
+            continue
+        if ":\t" not in line:
+            continue
+        hot[current][0] += 1
+        if _CALL.search(line):
+            hot[current][1] += 1
+    return hot
+
+
+def _delta(value, base):
+    """Difference to the baseline column ("" without a baseline)."""
+    if base is None:
+        return ""
+    diff = value - base
+    return f"{diff:+d}" if diff else "="
+
+
+def _row(name, value_a, base_a, value_b, base_b):
+    print(f"{name:<36}{value_a:>8}{_delta(value_a, base_a):>8}{value_b:>8}{_delta(value_b, base_b):>8}")
+
+
+def print_report(report, baseline):
+    modules = report["modules"]
+    base_modules = baseline["modules"] if baseline else {}
+    zero = [0, 0] if baseline else [None, None]
+
+    names = sorted(set(modules) | set(base_modules),
+                   key=lambda n: -max(modules.get(n, [0, 0])[0], base_modules.get(n, [0, 0])[0]))
+    print(f"{'module':<36}{'flash':>8}{'d':>8}{'ram':>8}{'d':>8}")
+    for name in names:
+        flash, ram = modules.get(name, [0, 0])
+        base = base_modules.get(name, zero)
+        if flash or ram or base[0] or base[1]:
+            _row(name, flash, base[0], ram, base[1])
+
+    def total(table, prefix=""):
+        return [sum(v[i] for n, v in table.items() if n.startswith(prefix)) for i in (0, 1)]
+
+    for label, prefix in (("HAL drivers", "stm32f4xx_hal"), ("total", "")):
+        now = total(modules, prefix)
+        base = total(base_modules, prefix) if baseline else zero
+        _row(label, now[0], base[0], now[1], base[1])
+
+    print()
+    print(f"{'hot function':<36}{'insns':>8}{'d':>8}{'calls':>8}{'d':>8}")
+    base_hot = baseline["hot"] if baseline else {}
+    for name in HOT_FUNCTIONS:
+        if name in report["hot"]:
+            insns, calls = report["hot"][name]
+            base = base_hot.get(name, zero)
+            _row(name, insns, base[0], calls, base[1])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="linked firmware ELF")
+    parser.add_argument("--map", required=True, help="GNU ld map file of the same link")
+    parser.add_argument("--objdump", default="arm-none-eabi-objdump", help="objdump executable")
+    parser.add_argument("--save", help="write the report as JSON (baseline for another build)")
+    parser.add_argument("--baseline", help="JSON written by --save of the build to compare with")
+    args = parser.parse_args()
+
+    report = {
+        "modules": parse_map(args.map),
+        "hot": parse_hot(args.objdump, args.elf, HOT_FUNCTIONS),
+    }
+    if not report["modules"]:
+        sys.exit(f"{args.map}: no memory map found")
+
+    baseline = None
+    if args.baseline:
+        with open(args.baseline, encoding="utf-8") as f:
+            baseline = json.load(f)
+
+    print_report(report, baseline)
+
+    if args.save:
+        with open(args.save, "w", encoding="utf-8") as f:
+            json.dump(report, f, indent=1, sort_keys=True)
+
+
+if __name__ == "__main__":
+    main()